@@ -26,13 +26,63 @@
 #define INCLUDE_GPU_UTIL_H_
 
 #include <stdint.h>
-#include <vector>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #define KFD_SYS_PATH_NODES              "/sys/class/kfd/kfd/topology/nodes"
 #define KFD_PATH_MAX_LENGTH             256
+//! environment variable prefixing all sysfs paths (e.g. synthetic topology)
+#define RVS_SYSROOT_ENV                 "RVS_SYSROOT"
+
+
+namespace rvs {
 
+/**
+ * @brief Link between two KFD topology nodes
+ */
+struct kfd_iolink {
+  //! link type (as in io_links/<n>/properties)
+  uint32_t type;
+  //! node the link starts in
+  uint16_t node_from;
+  //! node the link leads to
+  uint16_t node_to;
+  //! link weight
+  uint32_t weight;
+};
+
+/**
+ * @brief Snapshot of single KFD topology node
+ */
+struct kfd_node {
+  //! node ID (name of node directory)
+  uint16_t node_id;
+  //! GPU ID (0 for CPU nodes)
+  uint16_t gpu_id;
+  //! PCI location ID (bus/device/function)
+  uint16_t location_id;
+  //! PCI device ID
+  uint16_t device_id;
+  //! PCI vendor ID
+  uint16_t vendor_id;
+  //! closest CPU node (-1 if unknown)
+  int      numa_node;
+  //! all properties in file order
+  std::vector<std::pair<std::string, uint64_t>> properties;
+  //! links to other nodes
+  std::vector<kfd_iolink> io_links;
+
+  bool property(const std::string& Name, uint64_t* pValue) const;
+};
+
+}  // namespace rvs
+
+extern std::string gpu_sysfs_path(const char* path);
 extern int  gpu_num_subdirs(const char* dirpath, const char* prefix);
+extern int  gpu_load_topology(const char* dirpath,
+                              std::vector<rvs::kfd_node>* pnodes);
 extern void gpu_get_all_location_id(std::vector<uint16_t>* pgpus_location_id);
 extern void gpu_get_all_gpu_id(std::vector<uint16_t>* pgpus_id);
 extern void gpu_get_all_device_id(std::vector<uint16_t>* pgpus_device_id);
@@ -48,12 +98,18 @@ namespace rvs {
  *
  * @brief GPU cross-indexing utility class
  *
- * Used to quickly get GPU ID from location ID and vs. versa
+ * Used to quickly get GPU ID from location ID and vs. versa. KFD topology
+ * is read once, in a single pass, into snapshot of all nodes which is then
+ * indexed by GPU ID, location ID and node ID. The gpu_get_all_*() helpers
+ * are served from the same snapshot. Snapshot is kept in persistent
+ * topology cache (see rvs::topocache) and reused while topology
+ * fingerprint does not change.
  *
  */
 class gpulist {
  public:
   static int Initialize();
+  static int Initialize(const char* Path, bool Refresh = false);
 
   static int location2gpu(const uint16_t LocationID, uint16_t* pGpuID);
   static int gpu2location(const uint16_t GpuID, uint16_t* pLocationID);
@@ -62,16 +118,28 @@ class gpulist {
   static int gpu2device(const uint16_t GpuID, uint16_t* pDeviceID);
   static int location2node(const uint16_t LocationID, uint16_t* pNodeID);
   static int gpu2node(const uint16_t GpuID, uint16_t* pNodeID);
+  static int gpu2numa(const uint16_t GpuID, int* pNumaNode);
+
+  static bool loaded();
+  static const std::vector<kfd_node>& nodes();
+  static const kfd_node* gpu2info(const uint16_t GpuID);
+
+ protected:
+  static void build_index();
+  static const kfd_node* find_gpu(const uint16_t GpuID);
+  static const kfd_node* find_location(const uint16_t LocationID);
 
  protected:
-  //! Array of GPU location IDs
-  static std::vector<uint16_t> location_id;
-  //! Array of GPU IDs
-  static std::vector<uint16_t> gpu_id;
-  //! Array of device IDs
-  static std::vector<uint16_t> device_id;
-  //! Array of node IDs
-  static std::vector<uint16_t> node_id;
+  //! true once topology has been read from sysfs
+  static bool initialized;
+  //! snapshot of all topology nodes in node ID order
+  static std::vector<kfd_node> topology;
+  //! GPU ID to index into topology
+  static std::unordered_map<uint16_t, size_t> gpu_index;
+  //! location ID to index into topology (first GPU on the location)
+  static std::unordered_map<uint16_t, size_t> location_index;
+  //! node ID to index into topology of GPU nodes (-1 - not a GPU)
+  static std::vector<int> node_index;
 };
 
 
@@ -0,0 +1,118 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef INCLUDE_PCI_CFG_H_
+#define INCLUDE_PCI_CFG_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+extern "C" {
+#include <pci/pci.h>
+}
+
+//! size of buffer passed to decoders
+#define PCI_CAP_DATA_MAX_BUF_SIZE 1024
+//! decoder output for capabilities which are not present
+#define PCI_CAP_NOT_SUPPORTED "NOT SUPPORTED"
+//! number of extended capability IDs kept in offset table
+#define PCI_CFG_EXT_CAP_IDS 64
+
+namespace rvs {
+
+/**
+ * @class pcicfg
+ *
+ * @brief PCI configuration space view and capability decoder
+ *
+ * Works either as a live view of a pci_dev, where each register is read
+ * through libpci on demand, or on a snapshot of the whole configuration
+ * space (standard and PCI Express extended, up to 4 KiB) which is read
+ * once per device. For a snapshot, standard and extended capability lists
+ * are parsed once into an offset table and all fields are decoded from
+ * memory. Snapshot can also be loaded from a captured config space blob
+ * (e.g. copy of /sys/bus/pci/devices/<BDF>/config).
+ *
+ * Decoders write the same strings as pci_caps.h getters which are thin
+ * wrappers around live view.
+ *
+ */
+class pcicfg {
+ public:
+  explicit pcicfg(struct pci_dev* pDev = nullptr);
+
+  int load(struct pci_dev* pDev);
+  int load(const void* pData, const size_t Size);
+  int load(const std::string& File);
+  bool snapshot() const;
+  size_t size() const;
+
+  unsigned int cap_offset(const unsigned char Cap,
+                          const unsigned char Type) const;
+  uint8_t  read_byte(const int Pos) const;
+  uint16_t read_word(const int Pos) const;
+  uint32_t read_long(const int Pos) const;
+
+  void link_cap_max_speed(char* pBuff) const;
+  void link_cap_max_width(char* pBuff) const;
+  void link_stat_cur_speed(char* pBuff) const;
+  void link_stat_neg_width(char* pBuff) const;
+  void slot_pwr_limit_value(char* pBuff) const;
+  void slot_physical_num(char* pBuff) const;
+  void pci_bus_id(char* pBuff) const;
+  void device_id(char* pBuff) const;
+  void vendor_id(char* pBuff) const;
+  void kernel_driver(char* pBuff) const;
+  void dev_serial_num(char* pBuff) const;
+  void pwr_budgeting(const uint8_t PmState, const uint8_t Type,
+                     const uint8_t PowerRail, char* pBuff) const;
+  void pwr_curr_state(char* pBuff) const;
+  void atomic_op_routing(char* pBuff) const;
+  void atomic_op_32_completer(char* pBuff) const;
+  void atomic_op_64_completer(char* pBuff) const;
+  void atomic_op_128_CAS_completer(char* pBuff) const;
+  int64_t atomic_op_register_value() const;
+
+ protected:
+  void parse();
+  bool has_memory_bar() const;
+  void atomic_op_completer(const uint32_t Mask, char* pBuff) const;
+
+ protected:
+  //! device (nullptr for snapshot loaded from blob)
+  struct pci_dev* dev;
+  //! configuration space snapshot (empty for live view)
+  std::vector<uint8_t> data;
+  //! standard capability offsets indexed by capability ID (0 if absent)
+  uint8_t  cap_std[256];
+  //! extended capability offsets indexed by capability ID (0 if absent)
+  uint16_t cap_ext[PCI_CFG_EXT_CAP_IDS];
+};
+
+}  // namespace rvs
+
+#endif  // INCLUDE_PCI_CFG_H_
@@ -25,12 +25,19 @@
 #ifndef INCLUDE_RVS_UTIL_H_
 #define INCLUDE_RVS_UTIL_H_
 
+#include <stdint.h>
+
+#include <map>
 #include <vector>
 #include <string>
 #include <iostream>
 
 extern bool is_positive_integer(const std::string& str_val);
 
+extern int parse_with_unit(const std::string& Val,
+                           const std::map<char, uint64_t>& Units,
+                           uint64_t* pResult);
+
 extern std::vector<std::string> str_split(const std::string& str_val,
         const std::string& delimiter);
 
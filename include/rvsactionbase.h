@@ -27,9 +27,12 @@
 
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "include/rvs_util.h"
+#include "include/rvs_key_def.h"
+#include "include/rvslibif2.h"
 
 namespace rvs {
 /**
@@ -50,11 +53,17 @@ class actionbase {
  public:
   virtual int     property_set(const char*, const char*);
 
+  virtual int     configure(const T_RVS_CONFIG* pConfig);
+
   //! Virtual action function. To be implemented in every derived class.
   virtual int     run(void) = 0;
+  int             execute(T_RVS_RESULT_SINK* pSink);
   bool has_property(const std::string& key, std::string* pval);
   bool has_property(const std::string& key);
   int property_get_device();
+  int property_get_collection(const std::string& parent,
+                              std::vector<std::string>* pnames);
+  const std::vector<std::string>& property_errors() const;
 
   /**
   * @brief Gets uint16_t list from the module's properties collection
@@ -71,15 +80,14 @@ class actionbase {
                                    const std::string& delimiter,
                                    std::vector<T>* pval,
                                    bool* pball) {
-    std::string strval;
-
     // fetch key value if any
-    if (!has_property(key, &strval)) {
+    const typed_property* p = property_lookup(key);
+    if (!p) {
       return 2;
     }
 
     // found and is "all" - set flag and return
-    if (strval == "all") {
+    if (p->all) {
       *pball = true;
       pval->clear();
       return 0;
@@ -87,16 +95,25 @@ class actionbase {
       *pball = false;
     }
 
-    // parse key value into std::vector<std::string>
-    auto strarray = str_split(strval, delimiter);
-
-    // convert str arary into uint16_t array
-    int sts = rvs_util_strarr_to_uintarr<T>(strarray, pval);
+    // list is pre-parsed for default delimiter only
+    if (delimiter != YAML_DEVICE_PROP_DELIMITER) {
+      auto strarray = str_split(p->text, delimiter);
+      if (rvs_util_strarr_to_uintarr<T>(strarray, pval) < 0) {
+        pval->clear();
+        property_error(key, p->text, "list of positive integers");
+        return 1;
+      }
+      return 0;
+    }
 
-    if (sts < 0) {
-      pval->clear();
+    pval->clear();
+    if (p->list_sts) {
+      property_error(key, p->text, "list of positive integers");
       return 1;
     }
+    for (auto it = p->list.begin(); it != p->list.end(); ++it) {
+      pval->push_back(static_cast<T>(*it));
+    }
 
     return 0;
   }
@@ -108,14 +125,16 @@ class actionbase {
 */    
   template <typename T>
   int property_get_int(const std::string& prop_name, T* key) {
-    std::string val;
-    int error = 0;  // init with 'no error'
-    if (has_property(prop_name, &val)) {
-       error = rvs_util_parse<T>(val, key);
-    } else {
-      error = 2;
+    const typed_property* p = property_lookup(prop_name);
+    if (!p) {
+      return 2;
+    }
+    if (p->uint_sts == 0) {
+      *key = static_cast<T>(p->uval);
+    } else if (p->uint_sts == 1) {
+      property_error(prop_name, p->text, "positive integer");
     }
-    return error;
+    return p->uint_sts;
   }
 
   /**
@@ -126,14 +145,12 @@ class actionbase {
   template <typename T>
   int property_get_int
   (const std::string& prop_name, T* key, T def_value) {
-    std::string val;
-    int error = 0;  // init with 'no error'
-    if (has_property(prop_name, &val)) {
-      error = rvs_util_parse<T>(val, key);
-    } else {
+    const typed_property* p = property_lookup(prop_name);
+    if (!p) {
       *key = def_value;
+      return 0;
     }
-    return error;
+    return property_get_int<T>(prop_name, key);
   }
 
   int property_get(const std::string& prop_name, bool* pVal);
@@ -158,6 +175,48 @@ class actionbase {
     return sts;
   }
 
+ protected:
+  /**
+   * @brief Property value parsed into all supported types
+   *
+   * Built once for all properties (see property_table_build()) so that
+   * getters do not parse strings on each call. Status fields hold what
+   * corresponding getter returns: 0 - OK, 1 - syntax error, 2 - empty.
+   */
+  struct typed_property {
+    //! value as given
+    std::string text;
+    //! status of positive integer conversion
+    int uint_sts;
+    //! positive integer value
+    uint64_t uval;
+    //! status of boolean conversion
+    int bool_sts;
+    //! boolean value
+    bool bval;
+    //! status of floating point conversion
+    int float_sts;
+    //! floating point value
+    float fval;
+    //! true if value is "all"
+    bool all;
+    //! status of conversion to list of positive integers
+    int list_sts;
+    //! list of positive integers (YAML_DEVICE_PROP_DELIMITER separated)
+    std::vector<uint64_t> list;
+  };
+
+  void property_table_build();
+  const typed_property* property_lookup(const std::string& key);
+  void property_error(const std::string& key, const std::string& val,
+                      const std::string& expected);
+
+ protected:
+  void result_device(const uint16_t gpu_id, const bool pass);
+  void result_metric(const uint16_t gpu_id, const std::string& name,
+                     const double value, const std::string& unit);
+  void result_duration(const std::string& name, const double seconds);
+
  protected:
 /**
  *  @brief Collection of properties
@@ -189,12 +248,21 @@ class actionbase {
 
   //! data from config file
   std::map<std::string, std::string> property;
+  //! pre-parsed values of 'property', rebuilt when 'property' changes
+  std::unordered_map<std::string, typed_property> property_table;
+  //! false if 'property_table' needs to be rebuilt
+  bool property_table_valid;
+  //! conversion errors reported by property getters
+  std::vector<std::string> property_error_list;
 
 //   //! List of all gpu_id in the action's "device" property in .config file
 //   std::vector<std::string> device_prop_gpu_id_list;
 
   //! logging level
   int property_log_level;
+
+  //! receiver of structured results (IF2 only, nullptr otherwise)
+  T_RVS_RESULT_SINK* result_sink;
 };
 
 }  // namespace rvs
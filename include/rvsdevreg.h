@@ -0,0 +1,141 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef INCLUDE_RVSDEVREG_H_
+#define INCLUDE_RVSDEVREG_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace rvs {
+
+/**
+ * @brief Identities of a single GPU as seen by KFD, HIP and ROCm SMI
+ */
+struct devinfo {
+  //! GPU ID (KFD)
+  uint16_t gpu_id;
+  //! KFD node ID, also HSA agent node (see rvs::hsa::FindAgent())
+  uint16_t node_id;
+  //! PCI location ID (KFD)
+  uint16_t location_id;
+  //! PCI device ID
+  uint16_t device_id;
+  //! PCI domain
+  uint32_t domain;
+  //! closest CPU node (-1 if unknown)
+  int      numa_node;
+  //! HIP device index
+  int      hip_index;
+  //! ROCm SMI device index (-1 until attach_smi() is called or if unknown)
+  int      smi_index;
+};
+
+/**
+ * @class devreg
+ *
+ * @brief Process wide GPU device registry
+ *
+ * Built once per process from HIP device enumeration and KFD topology
+ * (rvs::gpulist) and shared by all modules through the launcher (see
+ * rvs::lp::Shared()). Gives all cross mappings between GPU ID, node ID,
+ * location ID, HIP and ROCm SMI device index, keeps HIP device properties
+ * so that hipGetDeviceProperties() is called once per device and
+ * implements "device" and "deviceid" selection common to all actions.
+ * The -i command line option is applied by launcher which replaces
+ * "device" value with given GPU IDs.
+ *
+ */
+class devreg {
+ public:
+  //! HIP device as enumerated by HIP runtime
+  struct hipdev {
+    //! HIP device index
+    int      index;
+    //! PCI domain
+    uint32_t domain;
+    //! PCI bus
+    uint32_t bus;
+    //! PCI device
+    uint32_t device;
+  };
+
+  static int Initialize();
+  static int attach_smi();
+
+  static const std::vector<devinfo>& devices();
+  static const devinfo* find_gpu(const uint16_t GpuID);
+  static const devinfo* find_hip(const int HipIndex);
+  static const devinfo* find_node(const uint16_t NodeID);
+
+  static int select(const bool All, const std::vector<uint16_t>& Gpus,
+                    const uint16_t DeviceID,
+                    std::map<int, uint16_t>* pSelected);
+
+  /**
+   * @brief Get cached HIP device properties
+   *
+   * Used as hip_properties<hipDeviceProp_t>(Index) so that this header
+   * does not depend on HIP.
+   *
+   * @param HipIndex HIP device index
+   * @return device properties, nullptr if not known
+   */
+  template <typename T>
+  static const T* hip_properties(const int HipIndex) {
+    return static_cast<const T*>(hip_properties(HipIndex, sizeof(T)));
+  }
+
+ protected:
+  //! registry data shared by all modules
+  struct registry {
+    //! all GPUs known to both HIP and KFD, in HIP index order
+    std::vector<devinfo> devices;
+    //! HIP device properties, indexed by HIP index
+    std::vector<char>    props;
+    //! size of single HIP device properties structure
+    size_t               props_size;
+    //! true once ROCm SMI indexes have been resolved
+    bool                 smi_attached;
+    //! serializes attach_smi()
+    std::mutex           smi_mutex;
+  };
+
+  static registry* build(const std::vector<hipdev>& Hip);
+  static void set_smi(registry* pReg, const std::vector<uint64_t>& Bdf);
+  static const void* hip_properties(const int HipIndex, const size_t Size);
+  static void* create();
+
+ protected:
+  //! registry in use (owned by launcher)
+  static registry* preg;
+};
+
+}  // namespace rvs
+
+#endif  // INCLUDE_RVSDEVREG_H_
@@ -0,0 +1,95 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef INCLUDE_RVSJSONWRITER_H_
+#define INCLUDE_RVSJSONWRITER_H_
+
+#include <stdint.h>
+
+#include <string>
+
+namespace rvs {
+
+/**
+ * @class JsonWriter
+ * @ingroup Launcher
+ *
+ * @brief Streaming JSON writer
+ *
+ * Appends JSON text directly to the given output string (typically the
+ * log sink buffer) so that a tree of log nodes is serialized in a single
+ * pass without intermediate strings. Two layouts are supported:
+ * "pretty" (one member per line, indented) and "compact" (no whitespace).
+ *
+ */
+class JsonWriter {
+ public:
+  //! output layout
+  typedef enum {pretty, compact} elayout;
+
+  JsonWriter(std::string* pOut, const elayout Layout = pretty,
+             const std::string& Lead = "");
+
+  elayout layout() const;
+
+  void  begin_object(const char* Name = nullptr);
+  void  end_object();
+  void  member(const char* Name, const char* Value);
+  void  member(const char* Name, const int64_t Value);
+  void  member(const char* Name, const uint64_t Value);
+  void  member(const char* Name, const double Value);
+  void  member(const char* Name, const bool Value);
+  void  begin_array(const char* Name);
+  void  element(const int64_t Value);
+  void  element(const uint64_t Value);
+  void  element(const double Value);
+  void  end_array();
+  void  separator();
+
+  static void escape(std::string* pOut, const char* Str);
+  static void number(std::string* pOut, const int64_t Value);
+  static void number(std::string* pOut, const uint64_t Value);
+  static void number(std::string* pOut, const double Value);
+
+ protected:
+  void  lead();
+  void  key(const char* Name);
+  void  next_element();
+
+ protected:
+  //! output string
+  std::string*        out;
+  //! output layout
+  elayout             layout_m;
+  //! indentation of the outermost level
+  std::string         base;
+  //! current nesting level
+  int                 depth;
+  //! 'true' until the first element of the current array is output
+  bool                first_element;
+};
+
+}  // namespace rvs
+
+#endif  // INCLUDE_RVSJSONWRITER_H_
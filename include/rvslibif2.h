@@ -0,0 +1,113 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef INCLUDE_RVSLIBIF2_H_
+#define INCLUDE_RVSLIBIF2_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @name Property value types passed through interface IF2
+ * @{
+ */
+//! text only
+#define RVS_PROP_STRING   0
+//! integer, ival (and dval) hold the value
+#define RVS_PROP_INT      1
+//! floating point, dval holds the value
+#define RVS_PROP_DOUBLE   2
+//! "true" or "false", ival holds 1 or 0
+#define RVS_PROP_BOOL     3
+//! list of two or more unsigned integers, list and count hold the values
+#define RVS_PROP_LIST     4
+/** @} */
+
+/**
+ * @brief Single action property, pre-parsed by launcher
+ *
+ * Collection members (e.g. gpup "properties") are passed as
+ * "<collection>.<name>", command line options as "cli.<option>".
+ */
+typedef struct tag_rvs_property {
+  //! property name
+  const char*     key;
+  //! value as given in .conf file or on command line
+  const char*     text;
+  //! value type, one of RVS_PROP_*
+  int             type;
+  //! integer value (RVS_PROP_INT, RVS_PROP_BOOL)
+  int64_t         ival;
+  //! floating point value (RVS_PROP_INT, RVS_PROP_DOUBLE)
+  double          dval;
+  //! list elements (RVS_PROP_LIST)
+  const uint64_t* list;
+  //! number of list elements (RVS_PROP_LIST)
+  size_t          count;
+} T_RVS_PROPERTY;
+
+/**
+ * @brief Complete action configuration passed in one call
+ */
+typedef struct tag_rvs_config {
+  //! action properties
+  const T_RVS_PROPERTY* props;
+  //! number of properties
+  size_t                count;
+} T_RVS_CONFIG;
+
+typedef void  (*t_cbResultDevice)(void* Ctx, const uint16_t GpuId,
+                                  const int Pass);
+typedef void  (*t_cbResultMetric)(void* Ctx, const uint16_t GpuId,
+                                  const char* Name, const double Value,
+                                  const char* Unit);
+typedef void  (*t_cbResultDuration)(void* Ctx, const char* Name,
+                                    const double Seconds);
+
+/**
+ * @brief Receiver of structured action results
+ *
+ * Provided by launcher for the duration of action run. Callbacks may be
+ * called from any module thread.
+ */
+typedef struct tag_rvs_result_sink {
+  //! launcher context passed back to callbacks
+  void*               ctx;
+  //! reports pass/fail of the action on a device
+  t_cbResultDevice    cbDevice;
+  //! reports named numeric metric (GpuId 0 - not device specific)
+  t_cbResultMetric    cbMetric;
+  //! reports duration of a named part of the action
+  t_cbResultDuration  cbDuration;
+} T_RVS_RESULT_SINK;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // INCLUDE_RVSLIBIF2_H_
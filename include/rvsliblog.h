@@ -26,6 +26,7 @@
 #define INCLUDE_RVSLIBLOG_H_
 
 #include <stdint.h>
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -42,10 +43,27 @@ typedef int   (*t_cbLogRecordFlush)( void* pLogRecord);
 typedef void* (*t_cbCreateNode)(void* Parent, const char* Name);
 typedef void  (*t_cbAddString)(void* Parent, const char* Key, const char* Val);
 typedef void  (*t_cbAddInt)(void* Parent, const char* Key, const int Val);
+typedef void  (*t_cbAddInt64)(void* Parent, const char* Key,
+                              const int64_t Val);
+typedef void  (*t_cbAddUint64)(void* Parent, const char* Key,
+                               const uint64_t Val);
+typedef void  (*t_cbAddDouble)(void* Parent, const char* Key,
+                               const double Val);
+typedef void  (*t_cbAddBool)(void* Parent, const char* Key, const bool Val);
+typedef void  (*t_cbAddInt64Array)(void* Parent, const char* Key,
+                                   const int64_t* Vals, const size_t Count);
+typedef void  (*t_cbAddUint64Array)(void* Parent, const char* Key,
+                                    const uint64_t* Vals, const size_t Count);
+typedef void  (*t_cbAddDoubleArray)(void* Parent, const char* Key,
+                                    const double* Vals, const size_t Count);
 typedef void  (*t_cbAddNode)(void* Parent, void* Child);
 typedef void  (*t_cbStop)(uint16_t flags);
 typedef bool  (*t_cbStopping)(void);
 typedef int   (*t_rvs_module_err)(const char*, const char*, const char*);
+typedef int   (*t_cbPhaseBegin)(const char* Phase);
+typedef void  (*t_cbPhaseEnd)(const int Id);
+typedef void* (*t_cbSharedCreate)(void);
+typedef void* (*t_cbShared)(const char* Name, t_cbSharedCreate Create);
 
 
 /**
@@ -74,6 +92,28 @@ typedef struct tag_module_init {
   t_cbStopping         cbStopping;
   //! pointer to rvs::logger::Err() function
   t_rvs_module_err     cbErr;
+  //! pointer to current logging level (updated whenever level changes)
+  const int*           pLogLevel;
+  //! pointer to rvs::logger::AddInt64() function
+  t_cbAddInt64         cbAddInt64;
+  //! pointer to rvs::logger::AddUint64() function
+  t_cbAddUint64        cbAddUint64;
+  //! pointer to rvs::logger::AddDouble() function
+  t_cbAddDouble        cbAddDouble;
+  //! pointer to rvs::logger::AddBool() function
+  t_cbAddBool          cbAddBool;
+  //! pointer to rvs::logger::AddInt64Array() function
+  t_cbAddInt64Array    cbAddInt64Array;
+  //! pointer to rvs::logger::AddUint64Array() function
+  t_cbAddUint64Array   cbAddUint64Array;
+  //! pointer to rvs::logger::AddDoubleArray() function
+  t_cbAddDoubleArray   cbAddDoubleArray;
+  //! pointer to rvs::profiler::PhaseBegin() function
+  t_cbPhaseBegin       cbPhaseBegin;
+  //! pointer to rvs::profiler::PhaseEnd() function
+  t_cbPhaseEnd         cbPhaseEnd;
+  //! pointer to rvs::module::shared() function
+  t_cbShared           cbShared;
 } T_MODULE_INIT;
 
 #ifdef __cplusplus
@@ -26,12 +26,29 @@
 #define INCLUDE_RVSLIBLOGGER_H_
 
 #include <string>
+#include <vector>
 #include <mutex>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+
 #include "include/rvsliblog.h"
+#include "include/rvslogsink.h"
+#include "include/rvslogqueue.h"
+#include "include/rvslogbin.h"
+#include "include/rvslogrotate.h"
+#include "include/rvslogcoalesce.h"
+
+//! max time (in ms) writer thread sleeps while logging queue is empty
+#define RVS_LOGWRITER_IDLE_MS           10
+//! period (in ms) of log file flush checks when logging synchronously
+#define RVS_LOGFLUSHER_IDLE_MS          100
 
 
 namespace rvs {
 
+class LogNodeRec;
 
 /**
  * @class logger
@@ -42,16 +59,49 @@ namespace rvs {
  */
 class logger {
  public:
+  //! action taken when asynchronous logging queue is full
+  typedef enum {block, drop} eoverflow;
+  //! receives level, formatted row and offset of the message within the row
+  typedef std::function<void(const int, const std::string&, const size_t)>
+    t_tap;
+
   static  void  log_level(const int level);
+  static  int   log_level();
+  static  const int* log_level_ptr();
 
   static  void  to_json(const bool flag);
   static  bool  to_json();
 
+  static  void  compact(const bool flag);
+  static  bool  compact();
+
+  static  void  jsonl(const bool flag);
+  static  bool  jsonl();
+
+  static  void  binary(const bool flag);
+  static  bool  binary();
+
+  static  const char* level_name(const int Level);
+
   static  void  append(const bool flag);
   static  bool  append();
 
+  static  void  rotate(const uint64_t Size, const unsigned int Interval,
+                       const bool Compress);
+
+  static  void  coalesce(const int Level, const unsigned int WindowMs,
+                         const unsigned int Burst = 1);
+
+  static  void  tap(t_tap Tap);
+
+  static  void  async(const bool flag, const eoverflow policy = block);
+  static  bool  async();
+  static  uint64_t dropped();
+
   //! set quiet mode
   static  void  quiet() { b_quiet = true; }
+  //! check quiet mode
+  static  bool  is_quiet() { return b_quiet; }
   //! set logging file
   static  void  set_log_file(const std::string& fname);
 
@@ -71,6 +121,16 @@ class logger {
   static  void*  CreateNode(void* Parent, const char* Name);
   static  void   AddString(void* Parent, const char* Key, const char* Val);
   static  void   AddInt(void* Parent, const char* Key, const int Val);
+  static  void   AddInt64(void* Parent, const char* Key, const int64_t Val);
+  static  void   AddUint64(void* Parent, const char* Key, const uint64_t Val);
+  static  void   AddDouble(void* Parent, const char* Key, const double Val);
+  static  void   AddBool(void* Parent, const char* Key, const bool Val);
+  static  void   AddInt64Array(void* Parent, const char* Key,
+                               const int64_t* Vals, const size_t Count);
+  static  void   AddUint64Array(void* Parent, const char* Key,
+                                const uint64_t* Vals, const size_t Count);
+  static  void   AddDoubleArray(void* Parent, const char* Key,
+                                const double* Vals, const size_t Count);
   static  void   AddNode(void* Parent, void* Child);
   static  int    JsonPatchAppend(int*);
   static  void   Stop(uint16_t flags);
@@ -79,16 +139,45 @@ class logger {
                    const char *Module = nullptr, const char *Action = nullptr);
 
  protected:
+  static  int    RowEmit(const char* Message, const int LogLevel,
+                         const uint32_t Sec, const uint32_t uSec);
+  static  void   RepeatsOut(const std::vector<T_LOGREPEAT>& Repeats,
+                            const uint32_t Sec, const uint32_t uSec);
+  static  void   RepeatsDrain();
+  static  int    CloseLog();
   static  int    ToFile(const std::string& Row);
+  static  std::string* FileBuffer();
+  static  int    FileHeader();
+  static  int    FileTrailer();
+  static  void   RotateCheck();
+  static  void   FileUrgent(const int Level);
+  static  int    RowOut(T_LOGQENTRY* pEntry);
+  static  int    RecordOut(LogNodeRec* pRec);
+  static  bool   Enqueue(T_LOGQENTRY* pEntry);
+  static  void   LeaveQueue();
+  static  void   StartWriter();
+  static  void   StopWriter();
+  static  void   WriterRun();
+  static  void   StartFlusher();
+  static  void   StopFlusher();
+  static  void   FlusherRun();
 
   //! Current logging level (0..5)
   static  int    loglevel_m;
   //! 'true' if JSON output is requested
   static  bool   tojson_m;
+  //! 'true' if compact (single line) JSON records are requested
+  static  bool   compact_m;
+  //! 'true' if JSON Lines output (one record per line) is requested
+  static  bool   jsonl_m;
+  //! 'true' if binary log file is requested
+  static  bool   binary_m;
   //! 'true' if append to existing log file is requested
   static  bool   append_m;
   //! 'true' if the incoming record is the first record in this rvs invocation
   static  bool   isfirstrecord_m;
+  //! 'true' if log file segment being written started with existing content
+  static  bool   appending_m;
   //! Array of C std::strings representing logging level names
   static  const char*   loglevelname[6];
   //! Mutex to synchronize cout output
@@ -103,6 +192,54 @@ class logger {
   static char log_file[1024];
   //! quiet mode
   static bool b_quiet;
+  //! buffered log file writer
+  static LogSink sink;
+  //! binary log encoder
+  static LogBinWriter binwriter;
+  //! log file rotation policy
+  static LogRotate rotator;
+  //! repeated messages suppression
+  static LogCoalesce coalescer;
+  //! Function receiving copy of every output row
+  static t_tap tap_m;
+  //! 'true' if asynchronous logging is requested
+  static bool async_m;
+  //! action taken when logging queue is full
+  static eoverflow overflow_m;
+  //! queue of entries waiting for writer thread
+  static LogQueue* queue;
+  //! writer thread
+  static std::thread writer;
+  //! Mutex to synchronize writer thread start/stop
+  static std::mutex async_mutex;
+  //! Mutex used by writer thread to wait for new entries
+  static std::mutex writer_mutex;
+  //! signaled when new entries are queued
+  static std::condition_variable writer_cv;
+  //! 'true' while writer thread accepts new entries
+  static std::atomic<bool> async_on;
+  //! 'true' until writer thread is requested to exit
+  static std::atomic<bool> writer_run;
+  //! number of threads currently passing entries to the queue
+  static std::atomic<int> inflight;
+  //! number of producers waiting for a free queue slot
+  static std::atomic<int> waiting;
+  //! Mutex used by producers and StopWriter() to wait on the queue
+  static std::mutex space_mutex;
+  //! signaled by writer thread when queue slots are freed
+  static std::condition_variable space_cv;
+  //! signaled when the last producer leaves after writer is stopped
+  static std::condition_variable leave_cv;
+  //! number of entries dropped because the queue was full
+  static std::atomic<uint64_t> dropped_m;
+  //! thread flushing log file buffer when logging synchronously
+  static std::thread flusher;
+  //! Mutex used by flusher thread to wait for flush interval
+  static std::mutex flusher_mutex;
+  //! signaled when flusher thread is requested to exit
+  static std::condition_variable flusher_cv;
+  //! 'true' until flusher thread is requested to exit
+  static bool flusher_run;
 };
 
 }  // namespace rvs
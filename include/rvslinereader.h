@@ -0,0 +1,73 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef INCLUDE_RVSLINEREADER_H_
+#define INCLUDE_RVSLINEREADER_H_
+
+#include <stddef.h>
+
+#include <string>
+
+//! size of the read buffer (in bytes)
+#define RVS_LINEREADER_BUFFER_SIZE      (64 * 1024)
+
+namespace rvs {
+
+/**
+ * @class LineReader
+ * @ingroup Launcher
+ *
+ * @brief Sequential reader of line oriented files
+ *
+ * Reads file through a fixed size buffer and returns one line at a time
+ * so that arbitrarily large JSON Lines log files are processed in constant
+ * memory (bounded by the length of the longest line).
+ *
+ */
+class LineReader {
+ public:
+  LineReader();
+  virtual ~LineReader();
+
+  int   open(const std::string& FileName);
+  int   next(std::string* pLine);
+  void  close();
+
+ protected:
+  int   fill();
+
+ protected:
+  //! file descriptor (-1 if not open)
+  int     fd;
+  //! read buffer
+  char*   buffer;
+  //! position of the first unconsumed byte in buffer
+  size_t  pos;
+  //! number of valid bytes in buffer
+  size_t  len;
+};
+
+}  // namespace rvs
+
+#endif  // INCLUDE_RVSLINEREADER_H_
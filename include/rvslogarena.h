@@ -0,0 +1,96 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef INCLUDE_RVSLOGARENA_H_
+#define INCLUDE_RVSLOGARENA_H_
+
+#include <stddef.h>
+
+#include <mutex>
+#include <vector>
+
+//! size of single arena memory chunk (in bytes)
+#define RVS_LOGARENA_CHUNK_SIZE         4096
+//! max number of free arenas kept for reuse
+#define RVS_LOGARENA_POOL_SIZE          64
+
+namespace rvs {
+
+/**
+ * @class LogArena
+ * @ingroup Launcher
+ *
+ * @brief Bump allocator for JSON log record trees
+ *
+ * All nodes, keys and values of one log record are allocated from the same
+ * arena. Memory is never freed per node - the whole arena is reset in
+ * constant time once the record is output, and returned to a pool so that
+ * its chunks can be reused by subsequent records.
+ *
+ * Note: single arena is not thread safe; acquire() and release() are.
+ *
+ */
+class LogArena {
+ public:
+  explicit LogArena(const size_t ChunkSize = RVS_LOGARENA_CHUNK_SIZE);
+  virtual ~LogArena();
+
+  void*       alloc(const size_t Size);
+  const char* strdup(const char* Str);
+  void        reset();
+
+  static LogArena* acquire();
+  static void      release(LogArena* pArena);
+
+ protected:
+  /**
+   * @brief Arena memory chunk header (chunk data follows the header)
+   */
+  struct chunk {
+    //! next chunk in the list
+    chunk*  next;
+    //! size of data area
+    size_t  size;
+  };
+
+  chunk* new_chunk(const size_t Size);
+
+  //! first chunk in the list
+  chunk*  first;
+  //! chunk currently used for allocation
+  chunk*  current;
+  //! offset of the first free byte in the current chunk
+  size_t  offset;
+  //! size of regular chunk
+  size_t  chunk_size;
+
+  //! Mutex to synchronize access to pool of free arenas
+  static std::mutex pool_mutex;
+  //! pool of free arenas
+  static std::vector<LogArena*> pool;
+};
+
+}  // namespace rvs
+
+#endif  // INCLUDE_RVSLOGARENA_H_
@@ -0,0 +1,194 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef INCLUDE_RVSLOGBIN_H_
+#define INCLUDE_RVSLOGBIN_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <string>
+#include <unordered_map>
+
+//! magic string at the start of each logging session
+#define RVS_LOGBIN_MAGIC                "RVSBLOG"
+//! binary log format version
+#define RVS_LOGBIN_VERSION              2
+//! max number of interned string values per session
+#define RVS_LOGBIN_INTERN_MAX           4096
+//! max length of string value eligible for interning
+#define RVS_LOGBIN_INTERN_LEN           32
+//! initial size of binary log read buffer (in bytes)
+#define RVS_LOGBIN_READ_SIZE            (1024 * 1024)
+
+namespace rvs {
+
+/**
+ * @brief Binary log frame types
+ *
+ * Binary log is a sequence of frames. Each frame starts with 32-bit little
+ * endian length of the frame body. The first byte of the body is the frame
+ * type:
+ *   FrameSession - magic string and version, starts new session and clears
+ *                  symbol table
+ *   FrameSymbol  - varint symbol id followed by symbol text
+ *   FrameRow     - level (1 byte), sec and usec (varints), message text
+ *   FrameRecord  - level (1 byte), sec and usec (varints), record items
+ */
+typedef enum eLBF {
+  FrameSession = 'H',
+  FrameSymbol  = 'S',
+  FrameRow     = 'T',
+  FrameRecord  = 'R'
+} T_LBFTYPE;
+
+/**
+ * @brief Binary log record item tags
+ *
+ * Each item starts with the tag, items other than ItemEnd follow it with
+ * varint symbol id of the item name.
+ *   ItemBegin  - start of nested node
+ *   ItemEnd    - end of nested node
+ *   ItemString - varint length followed by string value
+ *   ItemStrRef - varint symbol id of interned string value
+ *   ItemInt    - zig-zag encoded varint integer value
+ *   ItemUint   - varint unsigned integer value (version 2)
+ *   ItemDouble - 8 byte little endian IEEE 754 double value (version 2)
+ *   ItemBool   - single byte, 0 or 1 (version 2)
+ *   ItemArray  - element tag (ItemInt, ItemUint or ItemDouble), varint
+ *                number of elements, elements encoded as above (version 2)
+ */
+typedef enum eLBI {
+  ItemBegin   = '{',
+  ItemEnd     = '}',
+  ItemString  = 's',
+  ItemStrRef  = 'r',
+  ItemInt     = 'i',
+  ItemUint    = 'u',
+  ItemDouble  = 'd',
+  ItemBool    = 'b',
+  ItemArray   = '['
+} T_LBITYPE;
+
+/**
+ * @class LogBinWriter
+ * @ingroup Launcher
+ *
+ * @brief Binary log encoder
+ *
+ * Encodes log rows and records into compact binary frames. Node names and
+ * short string values are interned: each distinct string is written once
+ * per session as Symbol frame and afterwards referenced by its id.
+ *
+ * Note: class is not thread safe. Callers are expected to serialize access.
+ *
+ */
+class LogBinWriter {
+ public:
+  LogBinWriter();
+  virtual ~LogBinWriter();
+
+  void  output(std::string* pOut);
+  void  session();
+  void  row(const int Level, const uint32_t Sec, const uint32_t uSec,
+            const char* Message);
+
+  void  record_begin(const int Level, const uint32_t Sec,
+                     const uint32_t uSec);
+  void  record_end();
+  void  begin_object(const char* Name);
+  void  end_object();
+  void  member(const char* Name, const char* Value);
+  void  member(const char* Name, const int64_t Value);
+  void  member(const char* Name, const uint64_t Value);
+  void  member(const char* Name, const double Value);
+  void  member(const char* Name, const bool Value);
+  void  member(const char* Name, const int64_t* Values, const size_t Count);
+  void  member(const char* Name, const uint64_t* Values, const size_t Count);
+  void  member(const char* Name, const double* Values, const size_t Count);
+
+  static void put_varint(std::string* pOut, uint64_t Value);
+  static void put_double(std::string* pOut, const double Value);
+
+ protected:
+  uint32_t  symbol(const char* Str, const size_t Len);
+  bool      find_value(const char* Str, const size_t Len, uint32_t* pId);
+  void      frame(const char* pBody, const size_t Len);
+
+ protected:
+  //! output string
+  std::string*  out;
+  //! body of the record being encoded
+  std::string   body;
+  //! scratch string used for symbol lookups
+  std::string   key;
+  //! interned strings
+  std::unordered_map<std::string, uint32_t> symbols;
+  //! number of interned string values
+  size_t        values;
+};
+
+/**
+ * @class LogBinReader
+ * @ingroup Launcher
+ *
+ * @brief Sequential reader of binary log frames
+ *
+ * Reads binary log file through a buffer and returns one frame at a time.
+ * Memory used is bounded by the size of the largest frame.
+ *
+ */
+class LogBinReader {
+ public:
+  LogBinReader();
+  virtual ~LogBinReader();
+
+  int   open(const std::string& FileName);
+  int   next(const char** ppBody, size_t* pLen);
+  void  close();
+
+  static bool get_varint(const char** ppData, const char* pEnd,
+                         uint64_t* pValue);
+  static bool get_double(const char** ppData, const char* pEnd,
+                         double* pValue);
+
+ protected:
+  int   fill(const size_t Size);
+
+ protected:
+  //! file descriptor (-1 if not open)
+  int     fd;
+  //! read buffer
+  char*   buffer;
+  //! read buffer size
+  size_t  size;
+  //! position of the first unconsumed byte in buffer
+  size_t  pos;
+  //! number of valid bytes in buffer
+  size_t  len;
+};
+
+}  // namespace rvs
+
+#endif  // INCLUDE_RVSLOGBIN_H_
@@ -0,0 +1,93 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef INCLUDE_RVSLOGCAT_H_
+#define INCLUDE_RVSLOGCAT_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <string>
+#include <vector>
+
+#include "include/rvsjsonwriter.h"
+
+//! size of converted output kept in memory before it is written out
+#define RVS_LOGCAT_BUFFER_SIZE          (1024 * 1024)
+
+namespace rvs {
+
+/**
+ * @class LogCat
+ * @ingroup Launcher
+ *
+ * @brief Binary log converter
+ *
+ * Converts binary log produced by rvs::logger into the text or JSON output
+ * rvs::logger would have produced in the first place. Conversion is done
+ * frame by frame so memory use does not depend on the size of the log.
+ *
+ */
+class LogCat {
+ public:
+  //! output format
+  typedef enum {text, json, compact, jsonl} eformat;
+
+  LogCat(const eformat Format, const int OutFd);
+  virtual ~LogCat();
+
+  int   convert(const std::string& FileName);
+
+ protected:
+  int   do_session(const char* pBody, const char* pEnd);
+  int   do_symbol(const char* pBody, const char* pEnd);
+  int   do_row(const char* pBody, const char* pEnd);
+  int   do_record(const char* pBody, const char* pEnd);
+  int   do_items(JsonWriter* pWriter, const char* pData, const char* pEnd);
+  int   do_array(JsonWriter* pWriter, const char** ppData, const char* pEnd);
+  const char* get_symbol(const char** ppData, const char* pEnd);
+  int   write_out(const bool Force);
+
+ protected:
+  //! output format
+  eformat       format;
+  //! output file descriptor
+  int           fd;
+  //! converted output not yet written
+  std::string   out;
+  //! scratch string for inline string values
+  std::string   value;
+  //! symbol table of current session
+  std::vector<std::string> symbols;
+  //! number of sessions seen so far
+  int           sessions;
+  //! 'true' if no row was output in current session
+  bool          first_row;
+  //! 'true' if no record was output so far
+  bool          first_record;
+};
+
+}  // namespace rvs
+
+#endif  // INCLUDE_RVSLOGCAT_H_
@@ -0,0 +1,128 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef INCLUDE_RVSLOGCOALESCE_H_
+#define INCLUDE_RVSLOGCOALESCE_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//! number of logging levels (lognone..logtrace)
+#define RVS_LOGCOALESCE_LEVELS          6
+//! min time (in ms) between two scans for expired windows
+#define RVS_LOGCOALESCE_SCAN_MS         100
+//! max number of distinct messages tracked at the same time
+#define RVS_LOGCOALESCE_MAX             4096
+
+namespace rvs {
+
+/**
+ * @brief Summary of messages suppressed within one coalescing window
+ */
+typedef struct tag_log_repeat {
+  //! last suppressed message
+  std::string  message;
+  //! action the message originates from (empty if not known)
+  std::string  action;
+  //! module the message originates from (empty if not known)
+  std::string  module;
+  //! logging level
+  int          level;
+  //! number of suppressed messages
+  uint64_t     count;
+  //! time of the first message in the window (ms)
+  uint64_t     first;
+  //! time of the last suppressed message (ms)
+  uint64_t     last;
+} T_LOGREPEAT;
+
+/**
+ * @class LogCoalesce
+ * @ingroup Launcher
+ *
+ * @brief Suppression of repeated log messages
+ *
+ * Messages are matched on (level, action, module, device, template) where
+ * action, module and device are taken from the usual
+ * "[action] module device ..." message prefix and template is the rest of
+ * the message with numbers masked. Once a message is seen, window of
+ * configured length is opened for it. First 'burst' messages within the
+ * window are passed, the rest are counted and suppressed. When the window
+ * closes, summary of suppressed messages is handed back to the caller.
+ *
+ * Class is thread safe.
+ *
+ */
+class LogCoalesce {
+ public:
+  LogCoalesce();
+  virtual ~LogCoalesce();
+
+  void  set_window(const int Level, const unsigned int WindowMs,
+                   const unsigned int Burst);
+  bool  enabled(const int Level) const;
+  bool  enabled() const;
+
+  bool  admit(const char* Message, const int Level, const uint64_t Now,
+              std::vector<T_LOGREPEAT>* pClosed);
+  void  expire(const uint64_t Now, std::vector<T_LOGREPEAT>* pClosed);
+  void  drain(std::vector<T_LOGREPEAT>* pClosed);
+
+  static std::string key(const char* Message, const int Level,
+                         std::string* pAction, std::string* pModule);
+
+ protected:
+  /**
+   * @brief State of a single coalescing window
+   */
+  struct window {
+    //! number of messages passed in this window
+    unsigned int passed;
+    //! suppressed messages
+    T_LOGREPEAT  repeat;
+  };
+
+  void  close(const window& Window, std::vector<T_LOGREPEAT>* pClosed);
+  void  scan(const uint64_t Now, std::vector<T_LOGREPEAT>* pClosed);
+
+  //! window length per logging level (ms, 0 - no coalescing)
+  unsigned int window_ms[RVS_LOGCOALESCE_LEVELS];
+  //! number of messages passed per window per logging level
+  unsigned int burst[RVS_LOGCOALESCE_LEVELS];
+  //! open windows
+  std::unordered_map<std::string, window> windows;
+  //! time of the last scan for expired windows (ms)
+  std::atomic<uint64_t> last_scan;
+  //! Mutex protecting open windows
+  std::mutex   mtx;
+};
+
+}  // namespace rvs
+
+#endif  // INCLUDE_RVSLOGCOALESCE_H_
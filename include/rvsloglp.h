@@ -26,15 +26,17 @@
 #define INCLUDE_RVSLOGLP_H_
 
 #include <string>
+#include <vector>
 
 #include "include/rvsliblog.h"
 
 #define RVSDEBUG_(ATTR, VAL) \
-{std::string msg = std::string(__FILE__)+"   "+__func__+":" \
+{if (rvs::lp::Enabled(rvs::logdebug)) { \
+std::string msg = std::string(__FILE__)+"   "+__func__+":" \
 +std::to_string(__LINE__) + "\n" + std::string(ATTR) + ": " + \
 std::string(VAL); \
 rvs::lp::Log(msg, rvs::logdebug); \
-}
+}}
 
 #ifdef RVS_DO_TRACE
   #define RVSTRACE_ rvs::lp::Log(std::string(__FILE__)+"   "+__func__+":"\
@@ -67,6 +69,33 @@ class lp {
   static int   Log(const std::string& Msg, const int LogLevel,
                    const unsigned int Sec, const unsigned int uSec);
   static int   Initialize(const T_MODULE_INIT* pMi);
+  static bool  Enabled(const int level);
+
+/**
+ * @brief Output log message built from a list of values
+ *
+ * Values are converted to text and concatenated only if messages of the
+ * given level are going to be output, so disabled (e.g. trace) messages
+ * cost a single level check. Numbers are formatted as std::to_string().
+ *
+ * Example:
+ *   rvs::lp::LogLazy(rvs::logtrace, "[", action_name, "] gpu ", gpu_id);
+ *
+ * @param level Logging level
+ * @param args values making up the message
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+  template <typename... Args>
+  static int   LogLazy(const int level, const Args&... args) {
+    if (!Enabled(level)) {
+      return 0;
+    }
+    std::string msg;
+    Append(&msg, args...);
+    return Log(msg, level);
+  }
+
   static void* LogRecordCreate(const char* Module, const char* Action,
                                const int LogLevel, const unsigned int Sec,
                                const unsigned int uSec);
@@ -76,6 +105,22 @@ class lp {
                          const std::string& Val);
   static void  AddString(void* Parent, const char* Key, const char* Val);
   static void  AddInt(void* Parent, const char* Key, const int Val);
+  static void  AddInt64(void* Parent, const char* Key, const int64_t Val);
+  static void  AddUint64(void* Parent, const char* Key, const uint64_t Val);
+  static void  AddDouble(void* Parent, const char* Key, const double Val);
+  static void  AddBool(void* Parent, const char* Key, const bool Val);
+  static void  AddArray(void* Parent, const char* Key, const int64_t* Vals,
+                        const size_t Count);
+  static void  AddArray(void* Parent, const char* Key, const uint64_t* Vals,
+                        const size_t Count);
+  static void  AddArray(void* Parent, const char* Key, const double* Vals,
+                        const size_t Count);
+  static void  AddArray(void* Parent, const char* Key,
+                        const std::vector<int64_t>& Vals);
+  static void  AddArray(void* Parent, const char* Key,
+                        const std::vector<uint64_t>& Vals);
+  static void  AddArray(void* Parent, const char* Key,
+                        const std::vector<double>& Vals);
   static void  AddNode(void* Parent, void* Child);
   static bool  get_ticks(unsigned int* psec, unsigned int* pusec);
   static void  Stop(uint16_t flags);
@@ -83,8 +128,33 @@ class lp {
   static int   Err(const std::string &Msg, const std::string &Module);
   static int   Err(const std::string &Msg, const std::string &Module,
                    const std::string &Action);
+  static int   PhaseBegin(const char* Phase);
+  static void  PhaseEnd(const int Id);
+  static void* Shared(const char* Name, t_cbSharedCreate Create);
 
  protected:
+  static void  Append(std::string*) {
+  }
+
+  template <typename T, typename... Args>
+  static void  Append(std::string* pMsg, const T& Val, const Args&... args) {
+    AppendValue(pMsg, Val);
+    Append(pMsg, args...);
+  }
+
+  static void  AppendValue(std::string* pMsg, const char* Val) {
+    pMsg->append(Val);
+  }
+
+  static void  AppendValue(std::string* pMsg, const std::string& Val) {
+    pMsg->append(Val);
+  }
+
+  template <typename T>
+  static void  AppendValue(std::string* pMsg, const T& Val) {
+    pMsg->append(std::to_string(Val));
+  }
+
   //! Module init structure passed through Initialize() method
   static T_MODULE_INIT mi;
 };
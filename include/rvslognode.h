@@ -25,8 +25,6 @@
 #ifndef INCLUDE_RVSLOGNODE_H_
 #define INCLUDE_RVSLOGNODE_H_
 
-#include <vector>
-#include <memory>
 #include <string>
 
 #include "include/rvslognodebase.h"
@@ -44,17 +42,19 @@ namespace rvs {
  */
 class LogNode : public LogNodeBase {
  public:
-  explicit LogNode(const char* Name, const LogNodeBase* Parent = nullptr);
+  explicit LogNode(const char* Name, const LogNodeBase* Parent = nullptr,
+                   LogArena* Arena = nullptr);
   virtual ~LogNode();
 
-  virtual std::string ToJson(const std::string& Lead = "");
+  virtual void WriteJson(JsonWriter* pWriter);
+  virtual void WriteBin(LogBinWriter* pWriter);
 
  public:
   void Add(LogNodeBase* spChild);
 
  public:
   //! list of child nodes
-  std::vector<LogNodeBase*> Child;
+  LogNodeList Child;
 };
 
 }  // namespace rvs
@@ -25,19 +25,30 @@
 #ifndef INCLUDE_RVSLOGNODEBASE_H_
 #define INCLUDE_RVSLOGNODEBASE_H_
 
+#include <stddef.h>
+
 #include <string>
 
+#include "include/rvslogarena.h"
+
 #define RVSENDL "\n"
 #define RVSINDENT "  "
 
 namespace rvs {
 
+class JsonWriter;
+class LogBinWriter;
+
 typedef enum eLN {
   Unknown = 0,
   List    = 1,
   String  = 2,
   Integer = 3,
-  Record  = 4
+  Record  = 4,
+  Unsigned = 5,
+  Double  = 6,
+  Boolean = 7,
+  Array   = 8
 } T_LNTYPE;
 
 /**
@@ -51,29 +62,82 @@ class LogNodeBase {
  public:
   virtual ~LogNodeBase();
 
+  LogArena* Arena() const;
+
+  std::string ToJson(const std::string& Lead = "");
+
 /**
- * @brief Provides JSON representation of Node
+ * @brief Writes JSON representation of Node
  *
- * Converts node into proper string representation.
+ * Streams node into JSON writer.
  * This method has to be implemented in every derived class.
  *
- * @param Lead String of blanks " " representing current indentation
- * @return Node as JSON string
+ * @param pWriter JSON writer
  *
  */
-  virtual std::string ToJson(const std::string& Lead = "") = 0;
+  virtual void WriteJson(JsonWriter* pWriter) = 0;
+
+/**
+ * @brief Writes binary representation of Node
+ *
+ * Encodes node into binary log writer.
+ * This method has to be implemented in every derived class.
+ *
+ * @param pWriter binary log writer
+ *
+ */
+  virtual void WriteBin(LogBinWriter* pWriter) = 0;
 
  protected:
   explicit LogNodeBase(const char* rName,
-                       const LogNodeBase* pParent = nullptr);
+                       const LogNodeBase* pParent = nullptr,
+                       LogArena* pArena = nullptr);
+
+  const char* CopyString(const char* Str);
+  void        FreeString(const char* Str);
 
  protected:
   //! Node name
-  std::string     Name;
+  const char*     Name;
   //! Parent node
   const LogNodeBase*   Parent;
   //! Node type
   T_LNTYPE       Type;
+  //! Arena node is allocated from (nullptr for heap allocated nodes)
+  LogArena*      pArena;
+  //! Next sibling in the list of parent's child nodes
+  LogNodeBase*   Next;
+
+  friend class LogNodeList;
+};
+
+/**
+ * @class LogNodeList
+ * @ingroup Launcher
+ *
+ * @brief List of child nodes
+ *
+ * Intrusive singly linked list threaded through LogNodeBase::Next so that
+ * adding a child never allocates memory.
+ *
+ */
+class LogNodeList {
+ public:
+  LogNodeList();
+
+  void          push_back(LogNodeBase* pNode);
+  size_t        size() const;
+  LogNodeBase*  operator[](const size_t Index) const;
+  LogNodeBase*  first() const;
+  static LogNodeBase* next(const LogNodeBase* pNode);
+
+ protected:
+  //! first node in the list
+  LogNodeBase*  head;
+  //! last node in the list
+  LogNodeBase*  tail;
+  //! number of nodes in the list
+  size_t        count;
 };
 
 
@@ -25,6 +25,8 @@
 #ifndef INCLUDE_RVSLOGNODEINT_H_
 #define INCLUDE_RVSLOGNODEINT_H_
 
+#include <stdint.h>
+
 #include <string>
 
 #include "include/rvslognodebase.h"
@@ -41,16 +43,18 @@ namespace rvs {
  */
 class LogNodeInt : public LogNodeBase {
  public:
-  explicit LogNodeInt(const char* Name, const int Val,
-                      const LogNodeBase* pParent = nullptr);
+  explicit LogNodeInt(const char* Name, const int64_t Val,
+                      const LogNodeBase* pParent = nullptr,
+                      LogArena* pArena = nullptr);
 
   virtual ~LogNodeInt();
 
-  virtual std::string ToJson(const std::string& Lead = "");
+  virtual void WriteJson(JsonWriter* pWriter);
+  virtual void WriteBin(LogBinWriter* pWriter);
 
  protected:
   //! Node value
-  int Value;
+  int64_t Value;
 };
 
 }  // namespace rvs
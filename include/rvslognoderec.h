@@ -25,7 +25,6 @@
 #ifndef INCLUDE_RVSLOGNODEREC_H_
 #define INCLUDE_RVSLOGNODEREC_H_
 
-#include <vector>
 #include <string>
 
 #include "include/rvslognode.h"
@@ -43,14 +42,20 @@ namespace rvs {
 class LogNodeRec : public LogNode {
  public:
   LogNodeRec(const char* Name, int LogLevel, unsigned Sec,
-             unsigned uSec, const LogNodeBase* Parent = nullptr);
+             unsigned uSec, const LogNodeBase* Parent = nullptr,
+             LogArena* Arena = nullptr);
   virtual ~LogNodeRec();
 
-  virtual std::string ToJson(const std::string& Lead = "");
+  virtual void WriteJson(JsonWriter* pWriter);
+  virtual void WriteBin(LogBinWriter* pWriter);
 
  public:
   int LogLevel();
 
+  static LogNodeRec* Create(const char* Name, int LogLevel, unsigned Sec,
+                            unsigned uSec);
+  static void        Destroy(LogNodeRec* pRec);
+
  protected:
   //! Logging Level
   int Level;
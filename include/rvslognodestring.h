@@ -41,15 +41,17 @@ namespace rvs {
 class LogNodeString : public LogNodeBase {
  public:
   explicit LogNodeString(const char* Name, const char* Val,
-                         const LogNodeBase* Parent = nullptr);
+                         const LogNodeBase* Parent = nullptr,
+                         LogArena* Arena = nullptr);
 
   virtual ~LogNodeString();
 
-  virtual std::string ToJson(const std::string& Lead = "");
+  virtual void WriteJson(JsonWriter* pWriter);
+  virtual void WriteBin(LogBinWriter* pWriter);
 
  protected:
   //! Node value
-  std::string Value;
+  const char* Value;
 };
 
 }  // namespace rvs
@@ -0,0 +1,62 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef INCLUDE_RVSLOGNODEUINT_H_
+#define INCLUDE_RVSLOGNODEUINT_H_
+
+#include <stdint.h>
+
+#include <string>
+
+#include "include/rvslognodebase.h"
+
+namespace rvs {
+
+
+/**
+ * @class LogNodeUint
+ * @ingroup Launcher
+ *
+ * @brief Loger node holding unsigned 64-bit integer value
+ *
+ */
+class LogNodeUint : public LogNodeBase {
+ public:
+  explicit LogNodeUint(const char* Name, const uint64_t Val,
+                       const LogNodeBase* pParent = nullptr,
+                       LogArena* pArena = nullptr);
+
+  virtual ~LogNodeUint();
+
+  virtual void WriteJson(JsonWriter* pWriter);
+  virtual void WriteBin(LogBinWriter* pWriter);
+
+ protected:
+  //! Node value
+  uint64_t Value;
+};
+
+}  // namespace rvs
+
+#endif  // INCLUDE_RVSLOGNODEUINT_H_
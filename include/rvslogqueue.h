@@ -0,0 +1,106 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef INCLUDE_RVSLOGQUEUE_H_
+#define INCLUDE_RVSLOGQUEUE_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+//! default number of entries in asynchronous logging queue
+#define RVS_LOGQUEUE_SIZE               8192
+
+namespace rvs {
+
+class LogNodeRec;
+
+/**
+ * @brief Single entry in asynchronous logging queue
+ *
+ * Holds either preformatted text row or JSON log record.
+ */
+typedef struct tag_log_queue_entry {
+  //! preformatted text row (used when rec is nullptr)
+  std::string  row;
+  //! offset of the message text within the row
+  size_t       msg;
+  //! logging level of the row
+  int          level;
+  //! row timestamp - seconds since system start
+  uint32_t     sec;
+  //! row timestamp - microseconds in current second
+  uint32_t     usec;
+  //! JSON record created through LogRecordCreate() (owned by the entry)
+  LogNodeRec*  rec;
+} T_LOGQENTRY;
+
+/**
+ * @class LogQueue
+ * @ingroup Launcher
+ *
+ * @brief Bounded lock-free multi-producer/single-consumer queue
+ *
+ * Used to pass log entries from module worker threads to logger writer
+ * thread. Each slot carries sequence number which tells producers and the
+ * consumer whether the slot is free or holds data, so neither side ever
+ * takes a lock.
+ *
+ */
+class LogQueue {
+ public:
+  explicit LogQueue(const size_t Size = RVS_LOGQUEUE_SIZE);
+  virtual ~LogQueue();
+
+  bool  push(T_LOGQENTRY* pEntry);
+  bool  pop(T_LOGQENTRY* pEntry);
+  bool  empty() const;
+  size_t capacity() const;
+
+ protected:
+  /**
+   * @brief Queue slot
+   */
+  struct slot {
+    //! slot sequence number
+    std::atomic<size_t> seq;
+    //! slot payload
+    T_LOGQENTRY         entry;
+  };
+
+  //! ring of slots
+  std::vector<slot> ring;
+  //! capacity - 1 (capacity is always power of 2)
+  size_t mask;
+  //! next position to be written by producers
+  std::atomic<size_t> head;
+  //! next position to be read by consumer
+  std::atomic<size_t> tail;
+};
+
+}  // namespace rvs
+
+#endif  // INCLUDE_RVSLOGQUEUE_H_
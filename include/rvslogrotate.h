@@ -0,0 +1,110 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef INCLUDE_RVSLOGROTATE_H_
+#define INCLUDE_RVSLOGROTATE_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+//! buffer size used when compressing closed log segments (in bytes)
+#define RVS_LOGROTATE_CHUNK             (256 * 1024)
+
+namespace rvs {
+
+/**
+ * @class LogRotate
+ * @ingroup Launcher
+ *
+ * @brief Log file rotation policy
+ *
+ * Decides when the active log file is to be rolled over (size and/or time
+ * limit) and moves closed segments out of the way. Active segment is always
+ * written under the configured log file name. When rotated, it is renamed to
+ * \<log file\>.\<N\> where N is sequence number starting with 1 (the oldest
+ * segment) and continuing after segments already present on disk.
+ *
+ * Closed segments are optionally compressed into \<log file\>.\<N\>.gz by
+ * a background thread so that rotation itself never waits for compression.
+ *
+ * Note: except for the compression queue, class is not thread safe.
+ * Callers are expected to serialize access.
+ *
+ */
+class LogRotate {
+ public:
+  LogRotate();
+  virtual ~LogRotate();
+
+  void  set_max_size(const uint64_t Size);
+  void  set_interval(const unsigned int Sec);
+  void  set_compress(const bool Flag);
+  bool  enabled() const;
+
+  void  start(const std::string& FileName);
+  bool  due(const uint64_t Size) const;
+  int   rotate(std::string* pSegment);
+  void  retire(const std::string& Segment);
+  void  stop();
+
+  static int compress(const std::string& FileName);
+
+ protected:
+  static uint64_t now_sec();
+  unsigned int last_sequence() const;
+  void  CompressorRun();
+
+ protected:
+  //! segment size (in bytes) which triggers rotation (0 - no limit)
+  uint64_t     max_size;
+  //! segment age (in seconds) which triggers rotation (0 - no limit)
+  unsigned int interval;
+  //! 'true' if closed segments are to be compressed
+  bool         compress_m;
+  //! active log file name
+  std::string  file_name;
+  //! sequence number of the last closed segment
+  unsigned int sequence;
+  //! time active segment was started (seconds)
+  uint64_t     started;
+  //! closed segments waiting for compression
+  std::deque<std::string> pending;
+  //! compressor thread
+  std::thread  compressor;
+  //! Mutex protecting compression queue
+  std::mutex   compress_mutex;
+  //! signaled when segment is queued or compressor is to exit
+  std::condition_variable compress_cv;
+  //! 'true' until compressor thread is requested to exit
+  bool         compressor_run;
+};
+
+}  // namespace rvs
+
+#endif  // INCLUDE_RVSLOGROTATE_H_
@@ -0,0 +1,94 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef INCLUDE_RVSLOGSINK_H_
+#define INCLUDE_RVSLOGSINK_H_
+
+#include <stdint.h>
+
+#include <string>
+
+//! default size of sink buffer (in bytes) before it is flushed to file
+#define RVS_LOGSINK_BUFFER_SIZE         (64 * 1024)
+//! default max time (in ms) buffered data is kept before flush to file
+#define RVS_LOGSINK_FLUSH_INTERVAL      1000
+
+namespace rvs {
+
+/**
+ * @class LogSink
+ * @ingroup Launcher
+ *
+ * @brief Buffered log file writer
+ *
+ * Keeps log file open for the duration of logging and accumulates
+ * output in user-space buffer. Buffer is written to the file when it
+ * exceeds configured size, when configured time interval since the last
+ * flush has passed, or when flush() / close() is called.
+ *
+ * Note: class is not thread safe. Callers are expected to serialize access.
+ *
+ */
+class LogSink {
+ public:
+  LogSink();
+  virtual ~LogSink();
+
+  int   open(const std::string& FileName, const bool Truncate);
+  int   write(const std::string& Row);
+  std::string* output();
+  int   commit();
+  int   flush();
+  int   flush_expired();
+  void  close();
+  bool  is_open() const;
+  uint64_t size() const;
+
+  void  set_buffer_size(const size_t Size);
+  void  set_flush_interval(const unsigned int Ms);
+
+ protected:
+  static uint64_t now_ms();
+  int   write_fd(const char* pData, const size_t Size);
+
+ protected:
+  //! file descriptor of the log file (-1 if not open)
+  int          fd;
+  //! log file name
+  std::string  file_name;
+  //! buffered data not yet written to the file
+  std::string  buffer;
+  //! buffer size which triggers flush
+  size_t       buffer_size;
+  //! max time (ms) data is kept in buffer
+  unsigned int flush_interval;
+  //! time of last flush (ms)
+  uint64_t     last_flush;
+  //! number of bytes already in the file
+  uint64_t     file_size;
+};
+
+}  // namespace rvs
+
+#endif  // INCLUDE_RVSLOGSINK_H_
@@ -0,0 +1,69 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef INCLUDE_RVSTOPOCACHE_H_
+#define INCLUDE_RVSTOPOCACHE_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "include/gpu_util.h"
+
+//! environment variable overriding topology cache file (empty - no cache)
+#define RVS_TOPOLOGY_CACHE_ENV          "RVS_TOPOLOGY_CACHE"
+//! default topology cache file
+#define RVS_TOPOLOGY_CACHE_FILE         "/var/cache/rvs/topology.cache"
+//! cache file format version, bump on any layout change
+#define RVS_TOPOLOGY_CACHE_VERSION      1
+
+namespace rvs {
+
+/**
+ * @class topocache
+ *
+ * @brief Persistent KFD topology cache
+ *
+ * Keeps snapshot of KFD topology in a versioned binary file so that
+ * launcher and modules do not walk the whole sysfs tree on every start.
+ * Cache is keyed by a fingerprint made of topology path, node IDs, their
+ * GPU IDs and the amdgpu driver version, which is cheap to compute and
+ * changes whenever hardware or driver changes. Cache file is mapped into
+ * memory when read and replaced atomically when written.
+ *
+ */
+class topocache {
+ public:
+  static std::string file();
+  static int fingerprint(const std::string& NodesPath, uint64_t* pPrint);
+  static int load(const std::string& File, uint64_t Print,
+                  std::vector<kfd_node>* pNodes);
+  static int save(const std::string& File, uint64_t Print,
+                  const std::vector<kfd_node>& Nodes);
+};
+
+}  // namespace rvs
+
+#endif  // INCLUDE_RVSTOPOCACHE_H_
@@ -0,0 +1,84 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef INCLUDE_RVSTOPOGEN_H_
+#define INCLUDE_RVSTOPOGEN_H_
+
+#include <stdint.h>
+
+#include <string>
+
+namespace rvs {
+
+/**
+ * @class topogen
+ *
+ * @brief Synthetic KFD topology generator
+ *
+ * Writes KFD topology tree (nodes, properties, io_links) under given
+ * sysroot so that topology discovery can be exercised and timed on
+ * machines without GPUs (see RVS_SYSROOT). CPU nodes come first, followed
+ * by GPU nodes which are spread round robin over CPU nodes. Each GPU has
+ * PCIe link to its CPU node and XGMI links to all other GPUs of its hive.
+ *
+ */
+class topogen {
+ public:
+  //! KFD io_link types used by generator
+  enum { iolink_pcie = 2, iolink_qpi = 5, iolink_xgmi = 11 };
+
+  topogen();
+
+  //! number of GPU nodes
+  int      gpus;
+  //! number of CPU nodes
+  int      cpus;
+  //! number of GPUs per XGMI hive (0 or 1 - no XGMI links)
+  int      hive_size;
+  //! PCI device ID of generated GPUs
+  uint16_t device_id;
+  //! weight of GPU to CPU link
+  int      pcie_weight;
+  //! weight of GPU to GPU link
+  int      xgmi_weight;
+  //! weight of CPU to CPU link
+  int      cpu_weight;
+
+  int generate(const std::string& Root);
+
+  static uint16_t gpu_id(int Gpu);
+  static uint16_t location_id(int Gpu);
+  static uint32_t domain(int Gpu);
+
+ protected:
+  int write_node(const std::string& Path, int Node);
+  int write_link(const std::string& Path, int Link, int Type, int From,
+                 int To, int Weight);
+  int cpu_of(int Gpu) const;
+  int hive_of(int Gpu) const;
+};
+
+}  // namespace rvs
+
+#endif  // INCLUDE_RVSTOPOGEN_H_
@@ -0,0 +1,88 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef RVS_INCLUDE_RVSACTIONCONFIG_H_
+#define RVS_INCLUDE_RVSACTIONCONFIG_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "include/rvslibif2.h"
+
+namespace rvs {
+
+/**
+ * @class actionconfig
+ * @ingroup Launcher
+ *
+ * @brief Action properties collected from .conf file and command line
+ *
+ * Keeps properties in the order they were added. Values are parsed once,
+ * when added, so that IF2 modules receive typed values and do not have to
+ * parse strings themselves.
+ *
+ */
+class actionconfig {
+ public:
+  actionconfig();
+
+  void  add(const std::string& Key, const std::string& Val);
+  void  set(const std::string& Key, const std::string& Val);
+  size_t size() const;
+  const std::string& key(const size_t Index) const;
+  const std::string& text(const size_t Index) const;
+  const T_RVS_CONFIG* get();
+
+  static int parse(const std::string& Val, int64_t* pInt, double* pDouble,
+                   std::vector<uint64_t>* pList);
+
+ protected:
+  //! single property
+  struct entry {
+    //! property name
+    std::string key;
+    //! property value as given
+    std::string text;
+    //! property type (RVS_PROP_*)
+    int type;
+    //! integer value
+    int64_t ival;
+    //! floating point value
+    double dval;
+    //! list elements
+    std::vector<uint64_t> list;
+  };
+
+  //! properties in order of addition
+  std::vector<entry> entries;
+  //! C view of entries passed to module
+  std::vector<T_RVS_PROPERTY> props;
+  //! C view of complete configuration passed to module
+  T_RVS_CONFIG config;
+};
+
+}  // namespace rvs
+
+#endif  // RVS_INCLUDE_RVSACTIONCONFIG_H_
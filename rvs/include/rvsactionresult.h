@@ -0,0 +1,136 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef RVS_INCLUDE_RVSACTIONRESULT_H_
+#define RVS_INCLUDE_RVSACTIONRESULT_H_
+
+#include <stdint.h>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "include/rvslibif2.h"
+
+namespace rvs {
+
+/**
+ * @class resulttotals
+ * @ingroup Launcher
+ *
+ * @brief Totals over all actions of one .conf file run
+ *
+ * Owned by the executor running the .conf file, so concurrent runs (e.g.
+ * jobs in resident mode) keep separate totals.
+ *
+ */
+class resulttotals {
+ public:
+  resulttotals();
+
+  void   reset();
+  void   add(const size_t Passed, const size_t Failed);
+  void   report() const;
+  size_t actions() const;
+  size_t passed() const;
+  size_t failed() const;
+
+ protected:
+  //! protects totals (actions may complete concurrently)
+  mutable std::mutex mtx;
+  //! number of actions that reported results
+  size_t total_actions;
+  //! number of passed devices over all actions
+  size_t total_passed;
+  //! number of failed devices over all actions
+  size_t total_failed;
+};
+
+/**
+ * @class actionresult
+ * @ingroup Launcher
+ *
+ * @brief Structured results reported by IF2 action
+ *
+ * Provides result sink to the module and collects pass/fail status per
+ * device, named metrics and durations. Module may report from several
+ * threads. Reported results are added to totals of the run, if given.
+ *
+ */
+class actionresult {
+ public:
+  //! reported metric
+  struct metric {
+    //! GPU ID (0 if not device specific)
+    uint16_t gpu_id;
+    //! metric name
+    std::string name;
+    //! metric value
+    double value;
+    //! unit of measure
+    std::string unit;
+  };
+
+  actionresult(const std::string& Module, const std::string& Action,
+               resulttotals* Totals = nullptr);
+
+  T_RVS_RESULT_SINK* sink();
+  bool   empty() const;
+  size_t passed() const;
+  size_t failed() const;
+  std::map<uint16_t, bool> devices() const;
+  std::vector<metric> metrics() const;
+  std::vector<std::pair<std::string, double>> durations() const;
+  std::string summary() const;
+  void   report();
+
+ protected:
+  static void cbDevice(void* Ctx, const uint16_t GpuId, const int Pass);
+  static void cbMetric(void* Ctx, const uint16_t GpuId, const char* Name,
+                       const double Value, const char* Unit);
+  static void cbDuration(void* Ctx, const char* Name, const double Seconds);
+
+ protected:
+  //! module name
+  std::string module_name;
+  //! action name
+  std::string action_name;
+  //! totals of the run (nullptr if not kept)
+  resulttotals* totals;
+  //! sink passed to module
+  T_RVS_RESULT_SINK result_sink;
+  //! protects collected results
+  mutable std::mutex mtx;
+  //! pass/fail per device, device fails if any report fails
+  std::map<uint16_t, bool> device_pass;
+  //! metrics in order of reporting
+  std::vector<metric> metric_list;
+  //! durations in order of reporting
+  std::vector<std::pair<std::string, double>> duration_list;
+};
+
+}  // namespace rvs
+
+#endif  // RVS_INCLUDE_RVSACTIONRESULT_H_
@@ -0,0 +1,122 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef RVS_INCLUDE_RVSBUDGET_H_
+#define RVS_INCLUDE_RVSBUDGET_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "yaml-cpp/yaml.h"
+
+namespace rvs {
+
+/**
+ * @class budget
+ * @ingroup Launcher
+ *
+ * @brief Fitting of whole .conf file into wall-clock time budget
+ *
+ * With top level "time_budget" key (seconds, optional m or h suffix), the
+ * "duration" of actions is not taken as is but scaled so that all actions
+ * fit into the budget. Time is shared in proportion to configured duration
+ * times "count" (and number of sweep variants) times optional "weight"
+ * (default 1), but action never gets less than its "min_duration" (ms,
+ * default 1). "wait" time is kept as configured.
+ *
+ * Share of each action is computed again right before it starts, from
+ * time actually left, so overrun of earlier actions shrinks later ones.
+ * Actions without "duration" (or with "count: 0" or swept duration) are
+ * not scaled, only time they take is accounted for.
+ *
+ */
+class budget {
+ public:
+  budget();
+  virtual ~budget();
+
+  static bool has_budget(const YAML::Node& Config);
+
+  int       build(const YAML::Node& Config);
+  uint64_t  total() const;
+  double    elapsed() const;
+  bool      scaled(const std::string& Action) const;
+  uint64_t  allocate(const std::string& Action);
+  uint64_t  allocate(const std::string& Action, double Elapsed);
+  void      complete(const std::string& Action, double Actual);
+  std::string table() const;
+  void      report() const;
+
+ protected:
+  /**
+   * @brief Action accounted for in the budget
+   */
+  struct item {
+    //! action name
+    std::string name;
+    //! 'true' if action duration is scaled
+    bool scalable;
+    //! configured duration of single run (ms)
+    uint64_t configured;
+    //! number of runs (count times sweep variants)
+    uint64_t runs;
+    //! waiting time of all runs (ms)
+    uint64_t overhead;
+    //! relative weight
+    double weight;
+    //! minimal duration of single run (ms)
+    uint64_t minimum;
+    //! duration of single run planned before first action (ms)
+    uint64_t planned;
+    //! duration of single run given to action (ms)
+    uint64_t allocated;
+    //! time action actually took (ms, < 0 - not completed)
+    double actual;
+    //! 'true' once action started
+    bool started;
+  };
+
+  int   build_item(const YAML::Node& Action, item* Item);
+  void  distribute(double Available);
+  item* find(const std::string& Action);
+
+ protected:
+  //! time budget (ms)
+  uint64_t budget_ms;
+  //! accounted actions in .conf file order
+  std::vector<item> items;
+  //! time when budget was built
+  std::chrono::steady_clock::time_point start;
+  //! protects items when actions run concurrently
+  mutable std::mutex mtx;
+};
+
+}  // namespace rvs
+
+#endif  // RVS_INCLUDE_RVSBUDGET_H_
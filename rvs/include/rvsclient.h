@@ -0,0 +1,74 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef RVS_INCLUDE_RVSCLIENT_H_
+#define RVS_INCLUDE_RVSCLIENT_H_
+
+#include <stdint.h>
+
+#include <functional>
+#include <map>
+#include <string>
+
+namespace rvs {
+
+/**
+ * @class client
+ * @ingroup Launcher
+ *
+ * @brief Submits job to resident mode server (see rvs::server)
+ *
+ */
+class client {
+ public:
+  //! receives logging level and text of each row sent back by server
+  typedef std::function<void(const int, const std::string&)> t_output;
+
+  explicit client(t_output Out);
+  virtual ~client();
+
+  int   submit(const std::string& Socket,
+               const std::map<std::string, std::string>& Options);
+
+  uint64_t job_id() const;
+  double   seconds_queued() const;
+  double   seconds_run() const;
+
+ protected:
+  int   connect_socket(const std::string& Socket);
+
+ protected:
+  //! output of rows sent back by server
+  t_output  out;
+  //! number assigned to the job by server
+  uint64_t  id;
+  //! time job waited for its devices (s)
+  double    queued;
+  //! time job was running (s)
+  double    run;
+};
+
+}  // namespace rvs
+
+#endif  // RVS_INCLUDE_RVSCLIENT_H_
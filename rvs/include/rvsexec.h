@@ -26,12 +26,20 @@
 #define RVS_INCLUDE_RVSEXEC_H_
 
 #include <string>
+#include <utility>
+#include <vector>
 #include "yaml-cpp/node/node.h"
 
+#include "include/rvsactionresult.h"
+
 
 namespace rvs {
 
-class if1;
+class actionconfig;
+class actionresult;
+class budget;
+class journal;
+class repeatstats;
 
 /**
  * @class exec
@@ -49,20 +57,53 @@ class exec {
   ~exec();
 
   int run();
+  int run_config(const std::string& config_file);
 
  protected:
   void  do_help(void);
   void  do_version(void);
   int   do_gpu_list(void);
+  int   do_log_rotation(void);
+  int   do_log_coalesce(void);
+  int   do_serve(void);
+  int   do_submit(void);
+  int   do_journal(const std::string& config_file);
+  int   do_repeat(const std::string& config_file);
 
+  int   do_plan(const std::string& config_file);
+  static bool is_reentrant(const std::string& module_name);
   int   do_yaml(const std::string& config_file);
+  int   do_yaml_action(const YAML::Node& action, const size_t index);
+  int   do_yaml_sweep(const YAML::Node& action, const size_t index,
+                      const std::string& module_name,
+                      const std::string& action_name,
+                      const std::vector<std::pair<std::string, std::string>>&
+                        overrides);
+  int   do_yaml_run(const YAML::Node& action, const std::string& rvsmodule,
+                    const std::string& name,
+                    const std::vector<std::pair<std::string, std::string>>&
+                      overrides,
+                    actionresult* presult);
   int   do_yaml_properties(const YAML::Node& node,
-                           const std::string& module_name, if1* pif1);
+                           const std::string& module_name,
+                           actionconfig* pconfig);
   bool  is_yaml_properties_collection(const std::string& module_name,
                                       const std::string& proprty_name);
   int   do_yaml_properties_collection(const YAML::Node& node,
                                       const std::string& parent_name,
-                                      if1* pif1);
+                                      actionconfig* pconfig);
+
+ protected:
+  //! progress journal (nullptr if not used)
+  journal* pjournal;
+  //! time budget of current .conf file (nullptr if not used)
+  budget* pbudget;
+  //! metric statistics over repeated runs (nullptr if not used)
+  repeatstats* pstats;
+  //! current iteration of repeated runs
+  size_t iteration;
+  //! totals over actions of current .conf file run
+  resulttotals totals;
 };
 
 }  // namespace rvs
@@ -44,6 +44,8 @@ class if0 : public ifbase {
   virtual const char*  get_description(void);
   virtual const char*  get_config(void);
   virtual const char*  get_output(void);
+  virtual const char*  get_schema(void);
+  virtual bool         is_reentrant(void);
 
  protected:
   if0();
@@ -59,6 +61,10 @@ class if0 : public ifbase {
   t_rvs_module_get_config      rvs_module_get_config;
   //! Pointer to module function returning output info
   t_rvs_module_get_output      rvs_module_get_output;
+  //! Pointer to module function returning property schema (optional)
+  t_rvs_module_get_schema      rvs_module_get_schema;
+  //! Pointer to module function telling if actions may overlap (optional)
+  t_rvs_module_is_reentrant    rvs_module_is_reentrant;
 
 friend class module;
 };
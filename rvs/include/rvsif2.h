@@ -0,0 +1,68 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef RVS_INCLUDE_RVSIF2_H_
+#define RVS_INCLUDE_RVSIF2_H_
+
+#include "include/rvsmodule_if2.h"
+#include "include/rvsif_base.h"
+
+
+namespace rvs {
+
+/**
+ * @class if2
+ * @ingroup Launcher
+ *
+ * @brief RVS IF2 interface
+ *
+ * Passes complete, pre-parsed action configuration in one call and
+ * collects structured results while the action runs.
+ *
+ */
+class if2 : public ifbase {
+ public:
+  virtual ~if2();
+  virtual int   configure(const T_RVS_CONFIG* pConfig);
+  virtual int   execute(T_RVS_RESULT_SINK* pSink);
+
+ protected:
+  if2();
+  if2(const if2&);
+
+  virtual if2& operator= (const if2& rhs);
+  virtual ifbase* clone(void);
+
+ protected:
+  //! Pointer to module function setting all action properties
+  t_rvs_module_action_configure  rvs_module_action_configure;
+  //! Pointer to module function running action with result sink
+  t_rvs_module_action_execute    rvs_module_action_execute;
+
+friend class module;
+};
+
+}  // namespace rvs
+
+#endif  // RVS_INCLUDE_RVSIF2_H_
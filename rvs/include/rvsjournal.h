@@ -0,0 +1,121 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef RVS_INCLUDE_RVSJOURNAL_H_
+#define RVS_INCLUDE_RVSJOURNAL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace rvs {
+
+/**
+ * @class journal
+ * @ingroup Launcher
+ *
+ * @brief Progress journal of .conf file execution
+ *
+ * Records completed actions (and completed variants of sweep actions)
+ * together with their results so that an interrupted run can be resumed
+ * without repeating completed work. Actions are identified by their
+ * position in .conf file "actions" list and their name, so the same action
+ * listed more than once is run every time. Journal is small text file rewritten
+ * atomically (temporary file, fsync, rename) after each record, so it is
+ * always either in previous or in new state.
+ *
+ * File format (one record per line):
+ *
+ *     RVS-JOURNAL 2
+ *     config <hash of config file content> <config file>
+ *     action <index> <status> <passed> <failed> <action name>
+ *     variant <index> <variant> <status> <passed> <failed> <action name>
+ *
+ */
+class journal {
+ public:
+  //! no variant - record refers to whole action
+  static const size_t npos = static_cast<size_t>(-1);
+
+  journal();
+  virtual ~journal();
+
+  int   open(const std::string& Path, const std::string& ConfigFile,
+             const bool Resume);
+  bool  done(const size_t Index, const std::string& Action,
+             const size_t Variant = npos) const;
+  int   complete(const size_t Index, const std::string& Action,
+                 const int Status, const size_t Passed, const size_t Failed,
+                 const size_t Variant = npos);
+  bool  resuming() const;
+  size_t size() const;
+  const std::string& path() const;
+
+  static uint64_t hash(const std::string& Content);
+  static int write_atomic(const std::string& Path,
+                          const std::string& Content);
+
+ protected:
+  /**
+   * @brief Completed action or sweep variant
+   */
+  struct entry {
+    //! position of the action in .conf file
+    size_t index;
+    //! action name
+    std::string action;
+    //! sweep variant index or npos
+    size_t variant;
+    //! action return code
+    int status;
+    //! number of devices that passed
+    size_t passed;
+    //! number of devices that failed
+    size_t failed;
+  };
+
+  int   load(const std::string& ConfigFile, const uint64_t Hash);
+  int   save();
+
+ protected:
+  //! journal file name
+  std::string file_name;
+  //! config file name
+  std::string config_file;
+  //! hash of config file content
+  uint64_t config_hash;
+  //! 'true' if records of previous run were loaded (--resume)
+  bool resume;
+  //! completed actions and variants
+  std::vector<entry> entries;
+  //! protects entries (actions may complete concurrently)
+  mutable std::mutex mtx;
+};
+
+}  // namespace rvs
+
+#endif  // RVS_INCLUDE_RVSJOURNAL_H_
@@ -29,6 +29,7 @@
 #include <utility>
 #include <string>
 #include <memory>
+#include <mutex>
 
 #include "yaml-cpp/yaml.h"
 
@@ -54,10 +55,12 @@ typedef std::pair<std::string, module*> t_mmpair;
   // collection related members
  public:
   static int     initialize(const char* pConfigName);
+  static int     load_all();
   static action* action_create(const char* pModuleShortName);
   static int     action_destroy(action*);
   static int     terminate();
   static void    do_list_modules(void);
+  static void*   shared(const char* Name, void* (*Create)(void));
 
  protected:
   static module* find_create_module(const char* pShortName);
@@ -71,6 +74,15 @@ typedef std::pair<std::string, module*> t_mmpair;
   //! short name -> .so filename mapping
   static std::map<std::string, std::string> filemap;
 
+  //! Mutex serializing module loading and action creation/destruction
+  static std::mutex module_mutex;
+
+  //! objects shared by all modules (see shared())
+  static std::map<std::string, void*> shared_objects;
+
+  //! Mutex serializing creation of shared objects
+  static std::mutex shared_mutex;
+
  protected:
   module(const char* pModuleName, void* pSoLib);
   //! Destructor
@@ -87,6 +99,7 @@ typedef std::pair<std::string, module*> t_mmpair;
   int     init_interface_method(void** ppfunc, const char* pMethodName);
   int     init_interface_0(void);
   int     init_interface_1(void);
+  int     init_interface_2(void);
 
  protected:
   //! collection of interfaces supported by this module
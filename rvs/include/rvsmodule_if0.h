@@ -32,6 +32,8 @@ extern const char* rvs_module_get_name(void);
 extern const char* rvs_module_get_description(void);
 extern const char* rvs_module_get_config(void);
 extern const char* rvs_module_get_output(void);
+extern const char* rvs_module_get_schema(void);
+extern int   rvs_module_is_reentrant(void);
 
 
 // define function pointer types to ease late binding usage
@@ -40,6 +42,8 @@ typedef const char* (*t_rvs_module_get_name)(void);
 typedef const char* (*t_rvs_module_get_description)(void);
 typedef const char* (*t_rvs_module_get_config)(void);
 typedef const char* (*t_rvs_module_get_output)(void);
+typedef const char* (*t_rvs_module_get_schema)(void);
+typedef int   (*t_rvs_module_is_reentrant)(void);
 
 }
 
@@ -47,9 +47,14 @@ class options {
   static bool has_option(const std::string& Option, std::string* pval);
   static const std::map<std::string, std::string>& get(void);
 
+  static void  set_scope(const std::map<std::string, std::string>* pScope);
+  static const std::map<std::string, std::string>* scope(void);
+
  protected:
   //! Collection of options
   static std::map<std::string, std::string> opt;
+  //! Options replacing the collection for current thread (if not nullptr)
+  static thread_local const std::map<std::string, std::string>* scope_m;
 
 friend class cli;
 };
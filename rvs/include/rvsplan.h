@@ -0,0 +1,142 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef RVS_INCLUDE_RVSPLAN_H_
+#define RVS_INCLUDE_RVSPLAN_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "yaml-cpp/yaml.h"
+
+namespace rvs {
+
+/**
+ * @class plan
+ * @ingroup Launcher
+ *
+ * @brief Validation of whole .conf file before any action is run
+ *
+ * Every action is checked against property schema of its module (see
+ * rvs_module_get_schema()), its device selection is resolved against GPUs
+ * present in the system and its execution time is estimated from
+ * "duration", "wait", "count" and "sweep" keys. Problems which would make
+ * action fail are reported as errors, suspicious settings as warnings.
+ *
+ * Schema is list of "<key>:<type>[=<value>|<value>...]" entries separated
+ * by ';'. Type is one of int, float, bool, string, list (of integers),
+ * device ("all" or list of GPU IDs) or collection (map of sub-keys).
+ *
+ */
+class plan {
+ public:
+  /**
+   * @brief Provides schema of given module
+   *
+   * Returns 0 and sets schema (empty if module does not declare one) if
+   * module could be loaded, non-zero otherwise.
+   */
+  typedef std::function<int(const std::string&, std::string*)> t_schema;
+
+  /**
+   * @brief Planned action
+   */
+  struct step {
+    //! action name
+    std::string name;
+    //! module name
+    std::string module;
+    //! resolved devices (empty - none or not resolved)
+    std::vector<uint16_t> devices;
+    //! number of parameter variants (sweep)
+    size_t variants;
+    //! estimated execution time in ms (< 0 - unknown)
+    double estimate;
+  };
+
+  plan();
+  virtual ~plan();
+
+  int     build(const YAML::Node& Actions, t_schema Schema,
+                const std::vector<uint16_t>& Gpus);
+  const std::vector<step>& steps() const;
+  const std::vector<std::string>& errors() const;
+  const std::vector<std::string>& warnings() const;
+  double  estimate() const;
+  std::string table() const;
+  void    report() const;
+
+ protected:
+  /**
+   * @brief Schema entry for single property
+   */
+  struct rule {
+    //! property type
+    std::string type;
+    //! allowed values (empty - any value of the type)
+    std::vector<std::string> choices;
+  };
+  //! property name to rule map
+  typedef std::map<std::string, rule> t_rules;
+
+  static int  parse_schema(const std::string& Text, t_rules* Rules);
+  static bool check_value(const rule& Rule, const std::string& Value,
+                          std::string* Why);
+
+  void  build_action(const YAML::Node& Action, t_schema Schema,
+                     const std::vector<uint16_t>& Gpus);
+  void  check_property(const std::string& Action, const t_rules& Rules,
+                       bool Strict, const std::string& Key,
+                       const YAML::Node& Value);
+  void  check_sweep(const std::string& Action, const t_rules& Rules,
+                    bool Strict, const YAML::Node& Sweep, size_t* Variants);
+  int   resolve_devices(const std::string& Action, const std::string& Device,
+                        const std::vector<uint16_t>& Gpus,
+                        std::vector<uint16_t>* Devices);
+  void  error(const std::string& Action, const std::string& Message);
+  void  warning(const std::string& Action, const std::string& Message);
+
+ protected:
+  //! planned actions in .conf file order
+  std::vector<step> plan_steps;
+  //! errors found
+  std::vector<std::string> plan_errors;
+  //! warnings found
+  std::vector<std::string> plan_warnings;
+  //! module schemas already loaded
+  std::map<std::string, t_rules> schemas;
+  //! modules declaring their schema (unknown properties are reported)
+  std::map<std::string, bool> strict;
+  //! modules which could not be loaded
+  std::map<std::string, int> broken;
+};
+
+}  // namespace rvs
+
+#endif  // RVS_INCLUDE_RVSPLAN_H_
@@ -0,0 +1,102 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef RVS_INCLUDE_RVSPROFILER_H_
+#define RVS_INCLUDE_RVSPROFILER_H_
+
+#include <stdint.h>
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace rvs {
+
+/**
+ * @class profiler
+ * @ingroup Launcher
+ *
+ * @brief Startup phase timer
+ *
+ * Records monotonic start and end time of launcher phases (command line
+ * parsing, module loading and initialization, action creation, property
+ * parsing, ...) and of phases reported by modules through T_MODULE_INIT.
+ * Phases started while another phase is open on the same thread are nested
+ * in it and inherit its module and action.
+ *
+ * When not enabled, begin() and end() return immediately.
+ *
+ */
+class profiler {
+ public:
+  static void  enable(const bool flag);
+  static bool  enabled();
+
+  static int64_t now();
+  static int   begin(const std::string& Phase,
+                     const std::string& Module = "",
+                     const std::string& Action = "");
+  static void  end(const int Id);
+  static void  record(const std::string& Phase, const int64_t Start,
+                      const int64_t End);
+  static std::string table();
+  static void  report();
+  static void  clear();
+
+  static int   PhaseBegin(const char* Phase);
+  static void  PhaseEnd(const int Id);
+
+ protected:
+  /**
+   * @brief Single timed phase
+   */
+  struct phase {
+    //! phase name
+    std::string  name;
+    //! module the phase belongs to (empty - launcher)
+    std::string  module;
+    //! action the phase belongs to (empty - none)
+    std::string  action;
+    //! nesting level
+    int          depth;
+    //! start time (ns since process start)
+    int64_t      start;
+    //! end time (ns since process start, -1 if still open)
+    int64_t      end;
+  };
+
+ protected:
+  //! 'true' if phases are to be recorded
+  static bool                enabled_m;
+  //! recorded phases in order of start
+  static std::vector<phase>  phases;
+  //! Mutex protecting recorded phases
+  static std::mutex          mtx;
+  //! phases open on current thread, innermost last
+  static thread_local std::vector<int> open;
+};
+
+}  // namespace rvs
+
+#endif  // RVS_INCLUDE_RVSPROFILER_H_
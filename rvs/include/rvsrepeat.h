@@ -0,0 +1,121 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef RVS_INCLUDE_RVSREPEAT_H_
+#define RVS_INCLUDE_RVSREPEAT_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace rvs {
+
+class actionresult;
+
+/**
+ * @class repeatstats
+ * @ingroup Launcher
+ *
+ * @brief Statistics of action metrics over repeated runs of .conf file
+ *
+ * Collects numeric results (IF2 metrics) reported by every action in every
+ * iteration of --repeat mode. Values of the same metric reported several
+ * times within one iteration (e.g. "count" > 1) are averaged, so every
+ * iteration contributes one sample. At the end, mean, standard deviation,
+ * min/max and coefficient of variation (CoV) of the samples are computed
+ * per action, metric and GPU, and metrics whose CoV exceeds given
+ * threshold are flagged as noisy.
+ *
+ */
+class repeatstats {
+ public:
+  /**
+   * @brief Statistics of single metric
+   */
+  struct stat {
+    //! action name
+    std::string action;
+    //! metric name
+    std::string metric;
+    //! unit of measure
+    std::string unit;
+    //! GPU ID (0 if not device specific)
+    uint16_t gpu_id;
+    //! number of iterations the metric was reported in
+    size_t count;
+    //! mean over iterations
+    double mean;
+    //! sample standard deviation
+    double stddev;
+    //! minimum over iterations
+    double min;
+    //! maximum over iterations
+    double max;
+    //! coefficient of variation in % (stddev / |mean|)
+    double cov;
+  };
+
+  repeatstats();
+  virtual ~repeatstats();
+
+  void    add(const size_t Iteration, const std::string& Action,
+              const actionresult& Result);
+  void    add(const size_t Iteration, const std::string& Action,
+              const uint16_t GpuId, const std::string& Metric,
+              const double Value, const std::string& Unit);
+  std::vector<stat> stats() const;
+  std::string table(const double MaxCov) const;
+  size_t  report(const double MaxCov) const;
+
+ protected:
+  //! action, metric and GPU identifying series of samples
+  typedef std::tuple<std::string, std::string, uint16_t> t_key;
+
+  /**
+   * @brief Values of single metric
+   */
+  struct series {
+    //! unit of measure
+    std::string unit;
+    //! sum and number of values reported in each iteration
+    std::map<size_t, std::pair<double, size_t>> iterations;
+  };
+
+ protected:
+  //! metrics in order of first report
+  std::vector<t_key> order;
+  //! values of all metrics
+  std::map<t_key, series> values;
+  //! protects collected values
+  mutable std::mutex mtx;
+};
+
+}  // namespace rvs
+
+#endif  // RVS_INCLUDE_RVSREPEAT_H_
@@ -0,0 +1,145 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef RVS_INCLUDE_RVSSCHEDULER_H_
+#define RVS_INCLUDE_RVSSCHEDULER_H_
+
+#include <stddef.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "yaml-cpp/yaml.h"
+
+namespace rvs {
+
+/**
+ * @class scheduler
+ * @ingroup Launcher
+ *
+ * @brief Concurrent executor of actions listed in .conf file
+ *
+ * Actions form a directed acyclic graph:
+ *  - actions with the same "group" key run one after another in .conf file
+ *    order (actions without "group" form one default group),
+ *  - "depends_on" key (single action name or list of names) makes action
+ *    wait until all listed actions complete.
+ *
+ * Actions not ordered this way run concurrently on a pool of threads,
+ * except that actions of the same module never overlap unless the module
+ * declares itself re-entrant (modules keep per-process state). Before
+ * anything is run, graph is checked for unknown dependencies, cycles and
+ * device conflicts between actions which may run concurrently.
+ *
+ */
+class scheduler {
+ public:
+  //! function executing single action given its definition and position
+  //! in .conf file, returns 0 on success
+  typedef std::function<int(const YAML::Node&, const size_t)> t_runner;
+  //! tells if actions of given module may run concurrently
+  typedef std::function<bool(const std::string&)> t_reentrant;
+
+  scheduler();
+  virtual ~scheduler();
+
+  static bool is_scheduled(const YAML::Node& Actions);
+
+  int   build(const YAML::Node& Actions, t_reentrant Reentrant = nullptr);
+  int   run(t_runner Runner);
+
+  size_t  size() const;
+  size_t  threads() const;
+  bool    depends(const std::string& Action, const std::string& On) const;
+
+ protected:
+  /**
+   * @brief Single action in the graph
+   */
+  struct node {
+    //! action name
+    std::string          name;
+    //! module name
+    std::string          module;
+    //! group name (empty - default group)
+    std::string          group;
+    //! action definition from .conf file
+    YAML::Node           yaml;
+    //! 'true' if module allows concurrent actions
+    bool                 reentrant;
+    //! 'true' if action runs on all devices
+    bool                 all_devices;
+    //! devices the action runs on
+    std::set<std::string> devices;
+    //! indexes of actions this action waits for
+    std::vector<size_t>  deps;
+    //! indexes of actions waiting for this action
+    std::vector<size_t>  dependents;
+    //! number of dependencies not yet completed
+    size_t               pending;
+    //! action execution time (s)
+    double               seconds;
+  };
+
+  int   resolve_dependencies();
+  int   check_cycles();
+  int   check_conflicts();
+  void  worker(t_runner Runner);
+  size_t pick() const;
+  std::string describe(const node& Node) const;
+
+  static bool is_exclusive(const node& Node);
+  static bool overlaps(const node& A, const node& B);
+
+ protected:
+  //! actions in .conf file order
+  std::vector<node>   nodes;
+  //! reach[i][j] is 'true' if action j (transitively) depends on action i
+  std::vector<std::vector<bool>> reach;
+  //! number of distinct groups
+  size_t              groups;
+  //! actions ready to run
+  std::deque<size_t>  ready;
+  //! number of actions started or waiting to be started
+  size_t              remaining;
+  //! number of actions currently running
+  size_t              running;
+  //! non re-entrant modules with an action currently running
+  std::set<std::string> busy;
+  //! status of the first failed action (0 if none)
+  int                 status;
+  //! Mutex protecting scheduling state
+  std::mutex          mtx;
+  //! signaled when action completes
+  std::condition_variable cv;
+};
+
+}  // namespace rvs
+
+#endif  // RVS_INCLUDE_RVSSCHEDULER_H_
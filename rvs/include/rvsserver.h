@@ -0,0 +1,168 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef RVS_INCLUDE_RVSSERVER_H_
+#define RVS_INCLUDE_RVSSERVER_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+
+//! first line of job request sent over the socket
+#define RVS_SERVE_PROTOCOL   "RVS-JOB 1"
+
+//! time (ms) between checks of the stop request while waiting for clients
+#define RVS_SERVE_POLL_MS    200
+
+//! max time (s) output to client may block before client is dropped
+#define RVS_SERVE_SEND_TMO   5
+
+namespace rvs {
+
+/**
+ * @class server
+ * @ingroup Launcher
+ *
+ * @brief Resident mode (--serve) job server
+ *
+ * Accepts jobs over local Unix domain socket. Each job is a .conf file plus
+ * a few command line overrides. Jobs run in the server process, so modules
+ * and runtimes they initialize stay loaded between jobs. Log rows of a job
+ * are streamed back to the client which submitted it, followed by the exit
+ * status.
+ *
+ * Jobs touching the same device, using the same module (modules keep
+ * per-process state unless they declare themselves re-entrant) or using
+ * the same action name (which is how rows produced by module threads are
+ * told apart) never run at the same time; such job waits until the
+ * conflicting one completes. Output to a slow client only holds the job
+ * it belongs to.
+ *
+ * Protocol (text lines, client to server):
+ *  - RVS_SERVE_PROTOCOL
+ *  - "opt <option> <value>" for each command line option
+ *  - "end"
+ *
+ * Server to client:
+ *  - "queued <id>" if job waits for another job
+ *  - "started <id>"
+ *  - "row <level> <length>" followed by row text and newline
+ *  - "error <message>"
+ *  - "exit <status> <seconds queued> <seconds running>"
+ *
+ */
+class server {
+ public:
+  //! function running .conf file in current thread, returns 0 on success
+  typedef std::function<int(const std::string&)> t_runner;
+  //! tells if jobs using given module may run concurrently
+  typedef std::function<bool(const std::string&)> t_reentrant;
+
+  server();
+  virtual ~server();
+
+  int   serve(const std::string& Socket, t_runner Runner,
+              t_reentrant Reentrant = nullptr);
+  void  stop();
+
+  static bool  send_line(int Fd, const std::string& Line);
+  static bool  send_row(int Fd, const int Level, const std::string& Row);
+  static bool  read_line(int Fd, std::string* pLine);
+  static bool  read_bytes(int Fd, size_t Size, std::string* pData);
+
+ protected:
+  /**
+   * @brief Single job
+   */
+  struct job {
+    //! job number
+    uint64_t             id;
+    //! client connection
+    int                  fd;
+    //! 'false' once client stopped reading (protected by out_mtx)
+    bool                 connected;
+    //! serializes output to client
+    std::mutex           out_mtx;
+    //! number of threads sending rows to client (protected by mtx)
+    size_t               senders;
+    //! command line options job runs with
+    std::map<std::string, std::string> opts;
+    //! .conf file
+    std::string          config;
+    //! max level of rows sent to client
+    int                  level;
+    //! 'true' if any action runs on all devices
+    bool                 all_devices;
+    //! devices used by job actions
+    std::set<std::string> devices;
+    //! job action names
+    std::set<std::string> actions;
+    //! modules used by job actions which are not re-entrant
+    std::set<std::string> modules;
+  };
+
+  int   open_socket(const std::string& Socket);
+  void  session(int Fd);
+  int   read_job(job* pJob, std::string* pError);
+  int   resources(job* pJob, std::string* pError);
+  void  acquire(job* pJob);
+  void  release(job* pJob);
+  void  reply(job* pJob, const std::string& Line);
+  void  on_row(const int Level, const std::string& Row, const size_t Msg);
+
+  static bool  conflicts(const job& A, const job& B);
+
+ protected:
+  //! function running jobs
+  t_runner            runner;
+  //! tells which modules allow concurrent jobs
+  t_reentrant         reentrant;
+  //! listening socket
+  int                 listen_fd;
+  //! set when server is to stop accepting jobs
+  std::atomic<bool>   stopping;
+  //! number of the last job accepted
+  uint64_t            last_id;
+  //! number of connections being served
+  size_t              sessions;
+  //! jobs waiting for their devices in order of arrival
+  std::list<job*>     waiting;
+  //! jobs currently running
+  std::list<job*>     running;
+  //! Mutex protecting job lists
+  std::mutex          mtx;
+  //! signaled when job or session completes
+  std::condition_variable cv;
+};
+
+}  // namespace rvs
+
+#endif  // RVS_INCLUDE_RVSSERVER_H_
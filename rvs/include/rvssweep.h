@@ -0,0 +1,109 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef RVS_INCLUDE_RVSSWEEP_H_
+#define RVS_INCLUDE_RVSSWEEP_H_
+
+#include <stddef.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "yaml-cpp/yaml.h"
+
+namespace rvs {
+
+class actionresult;
+
+/**
+ * @class sweep
+ * @ingroup Launcher
+ *
+ * @brief Expansion of action "sweep" key into parameter variants
+ *
+ * Each key in "sweep" block (except "mode", "metric" and "output") names
+ * action property and lists its values. Variants are either cartesian
+ * product of all lists (mode: product, default; first key changes slowest)
+ * or lists taken element by element (mode: zip, lists must be of the same
+ * length). Results of all variants are collected into one table.
+ *
+ */
+class sweep {
+ public:
+  //! property name/value pairs of one variant
+  typedef std::vector<std::pair<std::string, std::string>> t_params;
+
+  sweep();
+  virtual ~sweep();
+
+  static bool has_sweep(const YAML::Node& Action);
+
+  int     build(const YAML::Node& Sweep);
+  size_t  size() const;
+  t_params variant(const size_t Index) const;
+  void    add_result(const size_t Index, const int Status,
+                     const actionresult& Result);
+  std::string table() const;
+  void    report(const std::string& Module, const std::string& Action);
+
+ protected:
+  /**
+   * @brief Result of one variant
+   */
+  struct row {
+    //! variant parameters
+    t_params params;
+    //! action return code
+    int status;
+    //! number of devices that passed
+    size_t passed;
+    //! number of devices that failed
+    size_t failed;
+    //! number of values of key metric
+    size_t count;
+    //! mean value of key metric
+    double value;
+  };
+
+ protected:
+  //! true for "zip" mode, false for "product"
+  bool zip;
+  //! name of key metric ("" - first metric reported)
+  std::string metric;
+  //! unit of key metric
+  std::string unit;
+  //! CSV output file ("" - log only)
+  std::string output;
+  //! swept property names
+  std::vector<std::string> names;
+  //! values of swept properties
+  std::vector<std::vector<std::string>> values;
+  //! results in order of variants
+  std::vector<row> rows;
+};
+
+}  // namespace rvs
+
+#endif  // RVS_INCLUDE_RVSSWEEP_H_
@@ -39,6 +39,8 @@
 #include "include/rvscli.h"
 #include "include/rvsexec.h"
 #include "include/rvsliblogger.h"
+#include "include/rvsoptions.h"
+#include "include/rvsprofiler.h"
 #include "include/rvstrace.h"
 
 #define MODULE_NAME_CAPS "CLI"
@@ -60,7 +62,12 @@ int main(int Argc, char**Argv) {
   int sts;
   rvs::cli cli;
 
+  int64_t parse_start = rvs::profiler::now();
   sts =  cli.parse(Argc, Argv);
+  if (rvs::options::has_option("-ps")) {
+    rvs::profiler::enable(true);
+    rvs::profiler::record("cli parse", parse_start, rvs::profiler::now());
+  }
   if (sts) {
     char buff[1024];
     snprintf(buff, sizeof(buff),
@@ -0,0 +1,236 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvsactionconfig.h"
+
+#include <stdlib.h>
+#include <errno.h>
+#include <string>
+#include <vector>
+
+using std::string;
+
+namespace {
+
+/**
+ * @brief Checks if string is a (possibly signed) decimal integer
+ *
+ */
+bool is_integer(const string& Val) {
+  size_t i = (Val[0] == '-' || Val[0] == '+') ? 1 : 0;
+  if (i >= Val.size()) {
+    return false;
+  }
+  for (; i < Val.size(); i++) {
+    if (Val[i] < '0' || Val[i] > '9') {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Checks if string is a decimal floating point number
+ *
+ * Hex floats, "inf" and "nan" accepted by strtod() are not considered
+ * numbers here.
+ *
+ */
+bool is_double(const string& Val) {
+  if (Val.find_first_not_of("0123456789.eE+-") != string::npos ||
+      Val.find_first_of("0123456789") == string::npos) {
+    return false;
+  }
+  char* end = nullptr;
+  errno = 0;
+  strtod(Val.c_str(), &end);
+  return errno == 0 && *end == '\0';
+}
+
+}  // namespace
+
+//! Default constructor
+rvs::actionconfig::actionconfig() {
+  config.props = nullptr;
+  config.count = 0;
+}
+
+/**
+ * @brief Parses property value
+ *
+ * Recognized types (in this order): "true"/"false", decimal integer,
+ * decimal floating point number, list of two or more unsigned integers
+ * separated by spaces and/or commas. Anything else is a string.
+ *
+ * @param Val property value
+ * @param pInt integer value (RVS_PROP_INT, RVS_PROP_BOOL)
+ * @param pDouble floating point value (RVS_PROP_INT, RVS_PROP_DOUBLE)
+ * @param pList list elements (RVS_PROP_LIST)
+ * @return property type, one of RVS_PROP_*
+ *
+ */
+int rvs::actionconfig::parse(const std::string& Val, int64_t* pInt,
+                             double* pDouble, std::vector<uint64_t>* pList) {
+  *pInt = 0;
+  *pDouble = 0;
+  pList->clear();
+
+  if (Val == "true" || Val == "false") {
+    *pInt = Val == "true" ? 1 : 0;
+    return RVS_PROP_BOOL;
+  }
+
+  if (Val.empty()) {
+    return RVS_PROP_STRING;
+  }
+
+  if (is_integer(Val)) {
+    errno = 0;
+    int64_t v = strtoll(Val.c_str(), nullptr, 10);
+    if (errno == 0) {
+      *pInt = v;
+      *pDouble = static_cast<double>(v);
+      return RVS_PROP_INT;
+    }
+  }
+
+  if (is_double(Val)) {
+    *pDouble = strtod(Val.c_str(), nullptr);
+    return RVS_PROP_DOUBLE;
+  }
+
+  // list: at least two unsigned integers
+  if (Val.find_first_not_of("0123456789 ,") != string::npos) {
+    return RVS_PROP_STRING;
+  }
+  size_t pos = 0;
+  while (pos < Val.size()) {
+    size_t start = Val.find_first_of("0123456789", pos);
+    if (start == string::npos) {
+      break;
+    }
+    size_t end = Val.find_first_of(" ,", start);
+    if (end == string::npos) {
+      end = Val.size();
+    }
+    errno = 0;
+    uint64_t v = strtoull(Val.substr(start, end - start).c_str(), nullptr, 10);
+    if (errno) {
+      pList->clear();
+      return RVS_PROP_STRING;
+    }
+    pList->push_back(v);
+    pos = end;
+  }
+  if (pList->size() < 2) {
+    pList->clear();
+    return RVS_PROP_STRING;
+  }
+
+  return RVS_PROP_LIST;
+}
+
+/**
+ * @brief Adds property
+ *
+ * @param Key property name
+ * @param Val property value
+ *
+ */
+void rvs::actionconfig::add(const std::string& Key, const std::string& Val) {
+  entry e;
+  e.key = Key;
+  e.text = Val;
+  e.type = parse(Val, &e.ival, &e.dval, &e.list);
+  entries.push_back(e);
+}
+
+/**
+ * @brief Sets property, replacing value of existing property if any
+ *
+ * @param Key property name
+ * @param Val property value
+ *
+ */
+void rvs::actionconfig::set(const std::string& Key, const std::string& Val) {
+  for (auto it = entries.begin(); it != entries.end(); ++it) {
+    if (it->key == Key) {
+      it->text = Val;
+      it->type = parse(Val, &it->ival, &it->dval, &it->list);
+      return;
+    }
+  }
+  add(Key, Val);
+}
+
+/**
+ * @brief Returns number of properties
+ *
+ */
+size_t rvs::actionconfig::size() const {
+  return entries.size();
+}
+
+/**
+ * @brief Returns name of property at given position
+ *
+ */
+const std::string& rvs::actionconfig::key(const size_t Index) const {
+  return entries[Index].key;
+}
+
+/**
+ * @brief Returns value of property at given position
+ *
+ */
+const std::string& rvs::actionconfig::text(const size_t Index) const {
+  return entries[Index].text;
+}
+
+/**
+ * @brief Builds configuration to be passed to IF2 module
+ *
+ * Returned structure points into this instance and is valid until the next
+ * call to add() or until this instance is destroyed.
+ *
+ * @return pointer to configuration
+ *
+ */
+const T_RVS_CONFIG* rvs::actionconfig::get() {
+  props.resize(entries.size());
+  for (size_t i = 0; i < entries.size(); i++) {
+    T_RVS_PROPERTY& p = props[i];
+    const entry& e = entries[i];
+    p.key = e.key.c_str();
+    p.text = e.text.c_str();
+    p.type = e.type;
+    p.ival = e.ival;
+    p.dval = e.dval;
+    p.list = e.list.empty() ? nullptr : e.list.data();
+    p.count = e.list.size();
+  }
+  config.props = props.empty() ? nullptr : props.data();
+  config.count = props.size();
+  return &config;
+}
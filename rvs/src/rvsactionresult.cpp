@@ -0,0 +1,298 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvsactionresult.h"
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "include/rvsliblogger.h"
+
+#define MODULE_NAME_CAPS "CLI"
+
+//! Default constructor
+rvs::resulttotals::resulttotals()
+: total_actions(0), total_passed(0), total_failed(0) {
+}
+
+/**
+ * @brief Clears totals
+ *
+ */
+void rvs::resulttotals::reset() {
+  std::lock_guard<std::mutex> lk(mtx);
+  total_actions = 0;
+  total_passed = 0;
+  total_failed = 0;
+}
+
+/**
+ * @brief Adds results of one action
+ *
+ * @param Passed number of devices that passed
+ * @param Failed number of devices that failed
+ *
+ */
+void rvs::resulttotals::add(const size_t Passed, const size_t Failed) {
+  std::lock_guard<std::mutex> lk(mtx);
+  total_actions++;
+  total_passed += Passed;
+  total_failed += Failed;
+}
+
+/**
+ * @brief Logs totals over all actions that reported structured results
+ *
+ */
+void rvs::resulttotals::report() const {
+  std::lock_guard<std::mutex> lk(mtx);
+  if (total_actions == 0) {
+    return;
+  }
+  rvs::logger::log("[" MODULE_NAME_CAPS "] summary actions: " +
+                   std::to_string(total_actions) + " device passes: " +
+                   std::to_string(total_passed) + " device fails: " +
+                   std::to_string(total_failed), rvs::logresults);
+}
+
+//! Returns number of actions that reported results
+size_t rvs::resulttotals::actions() const {
+  std::lock_guard<std::mutex> lk(mtx);
+  return total_actions;
+}
+
+//! Returns number of passed devices over all actions
+size_t rvs::resulttotals::passed() const {
+  std::lock_guard<std::mutex> lk(mtx);
+  return total_passed;
+}
+
+//! Returns number of failed devices over all actions
+size_t rvs::resulttotals::failed() const {
+  std::lock_guard<std::mutex> lk(mtx);
+  return total_failed;
+}
+
+/**
+ * @brief Constructor
+ *
+ * @param Module module name
+ * @param Action action name
+ * @param Totals totals of the run results are added to (may be nullptr)
+ *
+ */
+rvs::actionresult::actionresult(const std::string& Module,
+                                const std::string& Action,
+                                resulttotals* Totals)
+: module_name(Module), action_name(Action), totals(Totals) {
+  result_sink.ctx = this;
+  result_sink.cbDevice = &cbDevice;
+  result_sink.cbMetric = &cbMetric;
+  result_sink.cbDuration = &cbDuration;
+}
+
+/**
+ * @brief Returns sink to be passed to IF2 execute()
+ *
+ */
+T_RVS_RESULT_SINK* rvs::actionresult::sink() {
+  return &result_sink;
+}
+
+/**
+ * @brief Device pass/fail callback
+ *
+ */
+void rvs::actionresult::cbDevice(void* Ctx, const uint16_t GpuId,
+                                 const int Pass) {
+  actionresult* p = static_cast<actionresult*>(Ctx);
+  std::lock_guard<std::mutex> lk(p->mtx);
+  auto it = p->device_pass.find(GpuId);
+  if (it == p->device_pass.end()) {
+    p->device_pass.insert(std::make_pair(GpuId, Pass != 0));
+  } else {
+    it->second = it->second && Pass != 0;
+  }
+}
+
+/**
+ * @brief Metric callback
+ *
+ */
+void rvs::actionresult::cbMetric(void* Ctx, const uint16_t GpuId,
+                                 const char* Name, const double Value,
+                                 const char* Unit) {
+  actionresult* p = static_cast<actionresult*>(Ctx);
+  metric m;
+  m.gpu_id = GpuId;
+  m.name = Name ? Name : "";
+  m.value = Value;
+  m.unit = Unit ? Unit : "";
+  std::lock_guard<std::mutex> lk(p->mtx);
+  p->metric_list.push_back(m);
+}
+
+/**
+ * @brief Duration callback
+ *
+ */
+void rvs::actionresult::cbDuration(void* Ctx, const char* Name,
+                                   const double Seconds) {
+  actionresult* p = static_cast<actionresult*>(Ctx);
+  std::lock_guard<std::mutex> lk(p->mtx);
+  p->duration_list.push_back(std::make_pair(std::string(Name ? Name : ""),
+                                            Seconds));
+}
+
+/**
+ * @brief Checks if anything was reported
+ *
+ */
+bool rvs::actionresult::empty() const {
+  std::lock_guard<std::mutex> lk(mtx);
+  return device_pass.empty() && metric_list.empty() && duration_list.empty();
+}
+
+/**
+ * @brief Returns number of devices that passed
+ *
+ */
+size_t rvs::actionresult::passed() const {
+  std::lock_guard<std::mutex> lk(mtx);
+  size_t n = 0;
+  for (auto it = device_pass.begin(); it != device_pass.end(); ++it) {
+    n += it->second ? 1 : 0;
+  }
+  return n;
+}
+
+/**
+ * @brief Returns number of devices that failed
+ *
+ */
+size_t rvs::actionresult::failed() const {
+  std::lock_guard<std::mutex> lk(mtx);
+  size_t n = 0;
+  for (auto it = device_pass.begin(); it != device_pass.end(); ++it) {
+    n += it->second ? 0 : 1;
+  }
+  return n;
+}
+
+/**
+ * @brief Returns pass/fail status per device
+ *
+ */
+std::map<uint16_t, bool> rvs::actionresult::devices() const {
+  std::lock_guard<std::mutex> lk(mtx);
+  return device_pass;
+}
+
+/**
+ * @brief Returns reported metrics
+ *
+ */
+std::vector<rvs::actionresult::metric> rvs::actionresult::metrics() const {
+  std::lock_guard<std::mutex> lk(mtx);
+  return metric_list;
+}
+
+/**
+ * @brief Returns reported durations
+ *
+ */
+std::vector<std::pair<std::string, double>>
+rvs::actionresult::durations() const {
+  std::lock_guard<std::mutex> lk(mtx);
+  return duration_list;
+}
+
+/**
+ * @brief Returns one line summary of the action results
+ *
+ */
+std::string rvs::actionresult::summary() const {
+  size_t npass = passed();
+  size_t nfail = failed();
+  std::lock_guard<std::mutex> lk(mtx);
+  return "[" + action_name + "] " + module_name + " result passed: " +
+         std::to_string(npass) + " failed: " + std::to_string(nfail) +
+         " metrics: " + std::to_string(metric_list.size());
+}
+
+/**
+ * @brief Logs summary row and JSON record and adds results to totals
+ *
+ * Does nothing if module did not report any result.
+ *
+ */
+void rvs::actionresult::report() {
+  if (empty()) {
+    return;
+  }
+
+  rvs::logger::log(summary(), rvs::logresults);
+
+  uint32_t sec;
+  uint32_t usec;
+  rvs::logger::get_ticks(&sec, &usec);
+  void* r = rvs::logger::LogRecordCreate(module_name.c_str(),
+                                         action_name.c_str(),
+                                         rvs::logresults, sec, usec);
+
+  std::lock_guard<std::mutex> lk(mtx);
+  size_t npass = 0;
+  void* n = rvs::logger::CreateNode(r, "devices");
+  for (auto it = device_pass.begin(); it != device_pass.end(); ++it) {
+    rvs::logger::AddBool(n, std::to_string(it->first).c_str(), it->second);
+    npass += it->second ? 1 : 0;
+  }
+  rvs::logger::AddNode(r, n);
+
+  n = rvs::logger::CreateNode(r, "metrics");
+  for (size_t i = 0; i < metric_list.size(); i++) {
+    const metric& m = metric_list[i];
+    void* mn = rvs::logger::CreateNode(n, std::to_string(i).c_str());
+    rvs::logger::AddInt(mn, "gpu_id", m.gpu_id);
+    rvs::logger::AddString(mn, "name", m.name.c_str());
+    rvs::logger::AddDouble(mn, "value", m.value);
+    rvs::logger::AddString(mn, "unit", m.unit.c_str());
+    rvs::logger::AddNode(n, mn);
+  }
+  rvs::logger::AddNode(r, n);
+
+  n = rvs::logger::CreateNode(r, "durations (sec)");
+  for (auto it = duration_list.begin(); it != duration_list.end(); ++it) {
+    rvs::logger::AddDouble(n, it->first.c_str(), it->second);
+  }
+  rvs::logger::AddNode(r, n);
+  rvs::logger::LogRecordFlush(r);
+
+  if (totals) {
+    totals->add(npass, device_pass.size() - npass);
+  }
+}
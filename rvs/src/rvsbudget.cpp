@@ -0,0 +1,423 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvsbudget.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "include/rvsliblogger.h"
+#include "include/rvssweep.h"
+#include "include/rvs_util.h"
+
+#define MODULE_NAME_CAPS "CLI"
+
+using std::string;
+
+//! Default constructor
+rvs::budget::budget()
+  : budget_ms(0), start(std::chrono::steady_clock::now()) {
+}
+
+//! Default destructor
+rvs::budget::~budget() {
+}
+
+/**
+ * @brief Checks if .conf file has "time_budget" key
+ *
+ * @param Config root node of .conf file
+ * @return true if actions are to be fitted into time budget
+ *
+ */
+bool rvs::budget::has_budget(const YAML::Node& Config) {
+  return Config.IsMap() && static_cast<bool>(Config["time_budget"]);
+}
+
+/**
+ * @brief Reads time budget and actions and plans duration of actions
+ *
+ * Clock measuring spent budget is started here.
+ *
+ * @param Config root node of .conf file
+ * @return 0 if successful, non-zero otherwise
+ *
+ */
+int rvs::budget::build(const YAML::Node& Config) {
+  std::lock_guard<std::mutex> lk(mtx);
+  items.clear();
+  budget_ms = 0;
+
+  const std::map<char, uint64_t> units = {{'s', 1}, {'m', 60}, {'h', 3600}};
+  string val;
+  try {
+    val = Config["time_budget"].as<string>();
+  } catch(...) {
+  }
+  uint64_t seconds = 0;
+  if (parse_with_unit(val, units, &seconds) || seconds == 0) {
+    string msg = "time_budget not a positive time: '" + val + "'.";
+    rvs::logger::Err(msg.c_str(), MODULE_NAME_CAPS);
+    return -1;
+  }
+  budget_ms = seconds * 1000;
+
+  const YAML::Node& actions = Config["actions"];
+  uint64_t reserved = 0;
+  for (YAML::const_iterator it = actions.begin(); it != actions.end(); ++it) {
+    item i;
+    if (build_item(*it, &i)) {
+      return -1;
+    }
+    reserved += i.overhead + (i.scalable ? i.minimum * i.runs : 0);
+    items.push_back(i);
+  }
+
+  if (reserved > budget_ms) {
+    char buff[256];
+    snprintf(buff, sizeof(buff),
+             "minimal durations and waits take %.1f s, more than "
+             "time_budget of %.1f s.", reserved / 1000.0, budget_ms / 1000.0);
+    rvs::logger::log(buff, rvs::logresults);
+  }
+
+  distribute(budget_ms);
+  for (auto it = items.begin(); it != items.end(); ++it) {
+    it->planned = it->allocated;
+  }
+
+  start = std::chrono::steady_clock::now();
+  return 0;
+}
+
+/**
+ * @brief Reads budget related keys of single action
+ *
+ * @param Action action node from .conf file
+ * @param Item [out] accounted action
+ * @return 0 if successful, non-zero otherwise
+ *
+ */
+int rvs::budget::build_item(const YAML::Node& Action, item* Item) {
+  Item->name = Action["name"] ? Action["name"].as<string>() : string();
+  Item->scalable = false;
+  Item->configured = 0;
+  Item->runs = 1;
+  Item->overhead = 0;
+  Item->weight = 1;
+  Item->minimum = 1;
+  Item->planned = 0;
+  Item->allocated = 0;
+  Item->actual = -1;
+  Item->started = false;
+
+  string msg;
+  if (Action["weight"]) {
+    string val = Action["weight"].as<string>();
+    size_t pos = 0;
+    try {
+      Item->weight = std::stod(val, &pos);
+    } catch(...) {
+    }
+    if (pos == 0 || pos != val.size() || !(Item->weight > 0)) {
+      msg = "weight not a positive number: '" + val + "'.";
+    }
+  }
+  if (Action["min_duration"]) {
+    string val = Action["min_duration"].as<string>();
+    if (!is_positive_integer(val) || val.size() > 18) {
+      msg = "min_duration not a non-negative integer: '" + val + "'.";
+    } else {
+      Item->minimum = std::max<uint64_t>(std::stoull(val), 1);
+    }
+  }
+  if (!msg.empty()) {
+    rvs::logger::Err(msg.c_str(), MODULE_NAME_CAPS, Item->name.c_str());
+    return -1;
+  }
+
+  // malformed values are reported by the action itself
+  uint64_t count = 1;
+  if (Action["count"] && is_positive_integer(Action["count"].as<string>())) {
+    count = std::stoull(Action["count"].as<string>());
+  }
+  uint64_t wait = 0;
+  if (Action["wait"] && is_positive_integer(Action["wait"].as<string>())) {
+    wait = std::stoull(Action["wait"].as<string>());
+  }
+  if (Action["duration"] &&
+      is_positive_integer(Action["duration"].as<string>())) {
+    Item->configured = std::stoull(Action["duration"].as<string>());
+  }
+
+  bool swept = false;
+  uint64_t variants = 1;
+  if (rvs::sweep::has_sweep(Action)) {
+    rvs::sweep sw;
+    if (!sw.build(Action["sweep"])) {
+      variants = sw.size();
+    }
+    swept = static_cast<bool>(Action["sweep"]["duration"]);
+  }
+
+  Item->runs = count * variants;
+  Item->overhead = wait * Item->runs;
+  // count 0 means "run until stopped"
+  Item->scalable = Item->configured > 0 && count > 0 && !swept;
+
+  return 0;
+}
+
+/**
+ * @brief Shares available time among actions not started yet
+ *
+ * Each action gets share proportional to its configured time times
+ * weight. Actions whose share would be below their minimum get the
+ * minimum and the rest is shared again among remaining actions.
+ *
+ * @param Available time left (ms), may be negative if budget is overrun
+ *
+ */
+void rvs::budget::distribute(double Available) {
+  std::vector<item*> open;
+  for (auto it = items.begin(); it != items.end(); ++it) {
+    if (it->started) {
+      continue;
+    }
+    Available -= it->overhead;
+    if (it->scalable) {
+      it->allocated = it->minimum;
+      open.push_back(&*it);
+    }
+  }
+
+  bool clamped = true;
+  while (clamped && !open.empty()) {
+    double weights = 0;
+    for (auto it = open.begin(); it != open.end(); ++it) {
+      weights += (*it)->weight * (*it)->configured * (*it)->runs;
+    }
+
+    clamped = false;
+    std::vector<item*> rest;
+    for (auto it = open.begin(); it != open.end(); ++it) {
+      item* i = *it;
+      double share = Available * i->weight * i->configured / weights;
+      if (share < i->minimum) {
+        // keeps its minimum, remaining time is shared again
+        Available -= static_cast<double>(i->minimum) * i->runs;
+        clamped = true;
+      } else {
+        i->allocated = static_cast<uint64_t>(share);
+        rest.push_back(i);
+      }
+    }
+    open.swap(rest);
+  }
+}
+
+//! Returns time budget in ms
+uint64_t rvs::budget::total() const {
+  return budget_ms;
+}
+
+//! Returns time spent since budget was built in ms
+double rvs::budget::elapsed() const {
+  return std::chrono::duration<double, std::milli>(
+    std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief Checks if action duration is scaled to fit budget
+ *
+ * @param Action action name
+ * @return true if "duration" of the action is to be replaced
+ *
+ */
+bool rvs::budget::scaled(const std::string& Action) const {
+  std::lock_guard<std::mutex> lk(mtx);
+  for (auto it = items.begin(); it != items.end(); ++it) {
+    if (it->name == Action && it->actual < 0) {
+      return it->scalable;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Marks action as started and returns its duration
+ *
+ * @param Action action name
+ * @return duration of single run in ms (0 if action is not scaled)
+ *
+ */
+uint64_t rvs::budget::allocate(const std::string& Action) {
+  return allocate(Action, elapsed());
+}
+
+/**
+ * @brief Marks action as started and returns its duration
+ *
+ * Time left is shared again among all actions not started yet.
+ *
+ * @param Action action name
+ * @param Elapsed time spent so far (ms)
+ * @return duration of single run in ms (0 if action is not scaled)
+ *
+ */
+uint64_t rvs::budget::allocate(const std::string& Action, double Elapsed) {
+  std::lock_guard<std::mutex> lk(mtx);
+  item* i = find(Action);
+  if (!i) {
+    return 0;
+  }
+  distribute(static_cast<double>(budget_ms) - Elapsed);
+  i->started = true;
+  return i->scalable ? i->allocated : 0;
+}
+
+/**
+ * @brief Records time action actually took
+ *
+ * @param Action action name
+ * @param Actual time in ms
+ *
+ */
+void rvs::budget::complete(const std::string& Action, double Actual) {
+  std::lock_guard<std::mutex> lk(mtx);
+  item* i = find(Action);
+  if (i) {
+    i->started = true;
+    i->actual = Actual;
+  }
+}
+
+/**
+ * @brief Finds first not yet completed action of given name
+ *
+ * @param Action action name
+ * @return pointer to item, nullptr if not found
+ *
+ */
+rvs::budget::item* rvs::budget::find(const std::string& Action) {
+  for (auto it = items.begin(); it != items.end(); ++it) {
+    if (it->name == Action && it->actual < 0) {
+      return &*it;
+    }
+  }
+  return nullptr;
+}
+
+/**
+ * @brief Formats budget spending as text table
+ *
+ * Times are in seconds and include all runs and waits of the action;
+ * "-" marks actions which are not scaled or not (yet) run.
+ *
+ * @return one line per action preceded by header and followed by total
+ *
+ */
+std::string rvs::budget::table() const {
+  std::lock_guard<std::mutex> lk(mtx);
+  std::ostringstream os;
+  char buff[256];
+  snprintf(buff, sizeof(buff), "%-24s %10s %10s %10s %10s\n",
+           "action", "configured", "planned", "allocated", "actual");
+  os << buff;
+
+  auto secs = [](bool valid, double ms) {
+    char b[32];
+    if (!valid) {
+      return string("-");
+    }
+    snprintf(b, sizeof(b), "%.1f", ms / 1000);
+    return string(b);
+  };
+
+  double spent = 0;
+  for (auto it = items.begin(); it != items.end(); ++it) {
+    double runs = static_cast<double>(it->runs);
+    snprintf(buff, sizeof(buff), "%-24s %10s %10s %10s %10s\n",
+             it->name.c_str(),
+             secs(it->scalable, it->configured * runs + it->overhead).c_str(),
+             secs(it->scalable, it->planned * runs + it->overhead).c_str(),
+             secs(it->scalable && it->started,
+                  it->allocated * runs + it->overhead).c_str(),
+             secs(it->actual >= 0, it->actual).c_str());
+    os << buff;
+    if (it->actual > 0) {
+      spent += it->actual;
+    }
+  }
+
+  double used = std::max(spent, elapsed());
+  double left = static_cast<double>(budget_ms) - used;
+  snprintf(buff, sizeof(buff), "budget %.1f s, used %.1f s, %s %.1f s\n",
+           budget_ms / 1000.0, used / 1000,
+           left >= 0 ? "left" : "overrun by", std::abs(left) / 1000);
+  os << buff;
+
+  return os.str();
+}
+
+/**
+ * @brief Logs how time budget was spent
+ *
+ * Table is logged as results and emitted as JSON record.
+ *
+ */
+void rvs::budget::report() const {
+  std::istringstream is(table());
+  string line;
+  while (std::getline(is, line)) {
+    rvs::logger::log("budget " + line, rvs::logresults);
+  }
+
+  std::lock_guard<std::mutex> lk(mtx);
+  uint32_t sec;
+  uint32_t usec;
+  rvs::logger::get_ticks(&sec, &usec);
+  void* r = rvs::logger::LogRecordCreate("CLI", "budget", rvs::logresults,
+                                         sec, usec);
+  for (size_t i = 0; i < items.size(); i++) {
+    const item& t = items[i];
+    void* n = rvs::logger::CreateNode(r, std::to_string(i).c_str());
+    rvs::logger::AddString(n, "name", t.name.c_str());
+    rvs::logger::AddBool(n, "scaled", t.scalable);
+    rvs::logger::AddUint64(n, "configured (ms)", t.configured);
+    rvs::logger::AddUint64(n, "planned (ms)", t.planned);
+    rvs::logger::AddUint64(n, "allocated (ms)", t.allocated);
+    rvs::logger::AddDouble(n, "actual (ms)", t.actual);
+    rvs::logger::AddNode(r, n);
+  }
+  rvs::logger::AddUint64(r, "budget (ms)", budget_ms);
+  rvs::logger::AddDouble(r, "elapsed (ms)", elapsed());
+  rvs::logger::LogRecordFlush(r);
+}
@@ -135,6 +135,12 @@ void rvs::cli::init_grammar() {
   grammar.insert(gpair("-a", sp));
   grammar.insert(gpair("--appendLog", sp));
 
+  sp = std::make_shared<optbase>("-al", command, value);
+  grammar.insert(gpair("--asyncLog", sp));
+
+  sp = std::make_shared<optbase>("-bl", command);
+  grammar.insert(gpair("--binaryLog", sp));
+
   sp = std::make_shared<optbase>("-c", command, value);
   grammar.insert(gpair("-c", sp));
   grammar.insert(gpair("--config", sp));
@@ -142,6 +148,9 @@ void rvs::cli::init_grammar() {
 //   sp = std::make_shared<optbase>("--configless", command);
 //   grammar.insert(gpair("--configless", sp));
 
+  sp = std::make_shared<optbase>("-cj", command);
+  grammar.insert(gpair("--compactJson", sp));
+
   sp = std::make_shared<optbase>("-d", command, value);
   grammar.insert(gpair("-d", sp));
   grammar.insert(gpair("--debugLevel", sp));
@@ -158,10 +167,46 @@ void rvs::cli::init_grammar() {
   grammar.insert(gpair("-j", sp));
   grammar.insert(gpair("--json", sp));
 
+  sp = std::make_shared<optbase>("-jl", command);
+  grammar.insert(gpair("--jsonl", sp));
+
   sp = std::make_shared<optbase>("-l", command, value);
   grammar.insert(gpair("-l", sp));
   grammar.insert(gpair("--debugLogFile", sp));
 
+  sp = std::make_shared<optbase>("-lc", command, value);
+  grammar.insert(gpair("--logCoalesce", sp));
+
+  sp = std::make_shared<optbase>("-lrs", command, value);
+  grammar.insert(gpair("--logRotateSize", sp));
+
+  sp = std::make_shared<optbase>("-lrt", command, value);
+  grammar.insert(gpair("--logRotateTime", sp));
+
+  sp = std::make_shared<optbase>("-lz", command);
+  grammar.insert(gpair("--logCompress", sp));
+
+  sp = std::make_shared<optbase>("-ps", command);
+  grammar.insert(gpair("--profileStartup", sp));
+
+  sp = std::make_shared<optbase>("-rs", command);
+  grammar.insert(gpair("--resume", sp));
+
+  sp = std::make_shared<optbase>("-dr", command);
+  grammar.insert(gpair("--dry-run", sp));
+
+  sp = std::make_shared<optbase>("-rp", command, value);
+  grammar.insert(gpair("--repeat", sp));
+
+  sp = std::make_shared<optbase>("-mc", command, value);
+  grammar.insert(gpair("--maxCov", sp));
+
+  sp = std::make_shared<optbase>("-sr", command, value);
+  grammar.insert(gpair("--sysroot", sp));
+
+  sp = std::make_shared<optbase>("-rt", command);
+  grammar.insert(gpair("--refresh-topology", sp));
+
   sp = std::make_shared<optbase>("-q", command);
   grammar.insert(gpair("-q", sp));
   grammar.insert(gpair("--quiet", sp));
@@ -170,6 +215,12 @@ void rvs::cli::init_grammar() {
   grammar.insert(gpair("-m", sp));
   grammar.insert(gpair("--modulepath", sp));
 
+  sp = std::make_shared<optbase>("-srv", command, value);
+  grammar.insert(gpair("--serve", sp));
+
+  sp = std::make_shared<optbase>("-sub", command, value);
+  grammar.insert(gpair("--submit", sp));
+
   //  sp = std::make_shared<optbase>("-s", command);
   //  grammar.insert(gpair("-s", sp));
   //  grammar.insert(gpair("--scriptable", sp));
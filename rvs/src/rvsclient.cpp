@@ -0,0 +1,203 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvsclient.h"
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "include/rvsliblogger.h"
+#include "include/rvsserver.h"
+
+#define MODULE_NAME_CAPS "CLI"
+
+using std::string;
+
+/**
+ * @brief Constructor
+ *
+ * @param Out function receiving rows sent back by server
+ *
+ */
+rvs::client::client(t_output Out)
+:
+out(Out),
+id(0),
+queued(0),
+run(0) {
+}
+
+//! Default destructor
+rvs::client::~client() {
+}
+
+/**
+ * @brief Submits job and waits for its completion
+ *
+ * @param Socket path of Unix domain socket server listens on
+ * @param Options command line options of the job
+ * @return job exit status, -1 if job could not be submitted
+ *
+ */
+int rvs::client::submit(const std::string& Socket,
+                        const std::map<std::string, std::string>& Options) {
+  char buff[1024];
+
+  id = 0;
+  queued = 0;
+  run = 0;
+
+  string req(RVS_SERVE_PROTOCOL "\n");
+  for (auto it = Options.begin(); it != Options.end(); ++it) {
+    if (it->first.find_first_of(" \n") != string::npos ||
+        it->second.find('\n') != string::npos) {
+      snprintf(buff, sizeof(buff), "invalid option for job: %s",
+               it->first.c_str());
+      rvs::logger::Err(buff, MODULE_NAME_CAPS);
+      return -1;
+    }
+    req += "opt " + it->first + " " + it->second + "\n";
+  }
+  req += "end";
+
+  int fd = connect_socket(Socket);
+  if (fd < 0) {
+    return -1;
+  }
+
+  if (!rvs::server::send_line(fd, req)) {
+    snprintf(buff, sizeof(buff), "could not send job to %s",
+             Socket.c_str());
+    rvs::logger::Err(buff, MODULE_NAME_CAPS);
+    close(fd);
+    return -1;
+  }
+
+  string line;
+  while (rvs::server::read_line(fd, &line)) {
+    int    level;
+    size_t size;
+    int    sts;
+
+    if (sscanf(line.c_str(), "row %d %zu", &level, &size) == 2) {
+      string row;
+      if (!rvs::server::read_bytes(fd, size + 1, &row)) {
+        break;
+      }
+      row.resize(size);
+      out(level, row);
+    } else if (sscanf(line.c_str(), "queued %" SCNu64, &id) == 1) {
+      snprintf(buff, sizeof(buff),
+               "[%s] job %" PRIu64 " waits for devices used by other job",
+               MODULE_NAME_CAPS, id);
+      rvs::logger::log(buff, rvs::loginfo);
+    } else if (sscanf(line.c_str(), "started %" SCNu64, &id) == 1) {
+      continue;
+    } else if (!line.compare(0, 6, "error ")) {
+      rvs::logger::Err(line.substr(6).c_str(), MODULE_NAME_CAPS);
+    } else if (sscanf(line.c_str(), "exit %d %lf %lf", &sts, &queued,
+                      &run) == 3) {
+      close(fd);
+      return sts;
+    }
+  }
+
+  snprintf(buff, sizeof(buff), "connection to %s closed unexpectedly",
+           Socket.c_str());
+  rvs::logger::Err(buff, MODULE_NAME_CAPS);
+  close(fd);
+  return -1;
+}
+
+/**
+ * @brief Connects to server
+ *
+ * @param Socket path of Unix domain socket server listens on
+ * @return connected socket, -1 on error
+ *
+ */
+int rvs::client::connect_socket(const std::string& Socket) {
+  char buff[1024];
+  struct sockaddr_un addr;
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (Socket.empty() || Socket.size() >= sizeof(addr.sun_path)) {
+    snprintf(buff, sizeof(buff), "invalid socket path: %s", Socket.c_str());
+    rvs::logger::Err(buff, MODULE_NAME_CAPS);
+    return -1;
+  }
+  strncpy(addr.sun_path, Socket.c_str(), sizeof(addr.sun_path) - 1);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0 || connect(fd, reinterpret_cast<struct sockaddr*>(&addr),
+                        sizeof(addr))) {
+    snprintf(buff, sizeof(buff), "could not connect to %s: %s",
+             Socket.c_str(), strerror(errno));
+    rvs::logger::Err(buff, MODULE_NAME_CAPS);
+    if (fd >= 0) {
+      close(fd);
+    }
+    return -1;
+  }
+
+  return fd;
+}
+
+/**
+ * @brief Get number of the last submitted job
+ *
+ * @return job number assigned by server (0 if job was not accepted)
+ *
+ */
+uint64_t rvs::client::job_id() const {
+  return id;
+}
+
+/**
+ * @brief Get time the last submitted job waited for its devices
+ *
+ * @return time in seconds
+ *
+ */
+double rvs::client::seconds_queued() const {
+  return queued;
+}
+
+/**
+ * @brief Get time the last submitted job was running
+ *
+ * @return time in seconds
+ *
+ */
+double rvs::client::seconds_run() const {
+  return run;
+}
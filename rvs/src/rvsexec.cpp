@@ -25,19 +25,37 @@
 
 #include "include/rvsexec.h"
 
+#include <inttypes.h>
+#include <limits.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
 #include <iostream>
 #include <memory>
 #include <string>
 #include <fstream>
+#include <map>
 #include "yaml-cpp/yaml.h"
 
 #include "include/rvsif0.h"
 #include "include/rvsif1.h"
+#include "include/rvsbudget.h"
+#include "include/rvsjournal.h"
 #include "include/rvsaction.h"
+#include "include/rvsclient.h"
 #include "include/rvsmodule.h"
 #include "include/rvsliblogger.h"
 #include "include/rvsoptions.h"
+#include "include/rvsprofiler.h"
+#include "include/rvsrepeat.h"
+#include "include/rvsserver.h"
 #include "include/rvstrace.h"
+#include "include/gpu_util.h"
+#include "include/rvs_util.h"
 
 #define MODULE_NAME_CAPS "CLI"
 
@@ -45,12 +63,29 @@ using std::string;
 using std::cout;
 using std::endl;
 
+namespace {
+
+//! server to be stopped on SIGINT/SIGTERM
+rvs::server* pserver = nullptr;
+
+//! Stops resident mode server
+void on_stop_signal(int) {
+  if (pserver) {
+    pserver->stop();
+  }
+}
+
+}  // namespace
+
 //! Default constructor
-rvs::exec::exec() {
+rvs::exec::exec()
+  : pjournal(nullptr), pbudget(nullptr), pstats(nullptr), iteration(0) {
 }
 
 //! Default destructor
 rvs::exec::~exec() {
+  delete pjournal;
+  delete pbudget;
 }
 
 
@@ -108,8 +143,9 @@ int rvs::exec::run() {
     logger::log_level(5);
   }
 
-  // check -a option
-  if (rvs::options::has_option("-a", &val)) {
+  // check -a option (resumed run appends to existing log)
+  if (rvs::options::has_option("-a", &val) ||
+      rvs::options::has_option("-rs")) {
     logger::append(true);
   }
 
@@ -124,6 +160,79 @@ int rvs::exec::run() {
     logger::to_json(true);
   }
 
+  // check --jsonl option
+  if (rvs::options::has_option("-jl", &val)) {
+    logger::to_json(true);
+    logger::jsonl(true);
+  }
+
+  // check --binaryLog option
+  if (rvs::options::has_option("-bl", &val)) {
+    logger::binary(true);
+  }
+
+  // check --compactJson option
+  if (rvs::options::has_option("-cj", &val)) {
+    logger::compact(true);
+  }
+
+  // check --asyncLog option
+  if (rvs::options::has_option("-al", &val)) {
+    if (val == "block") {
+      logger::async(true, logger::eoverflow::block);
+    } else if (val == "drop") {
+      logger::async(true, logger::eoverflow::drop);
+    } else {
+      char buff[1024];
+      snprintf(buff, sizeof(buff),
+                "asynchronous logging policy not 'block' or 'drop': %s",
+                val.c_str());
+      rvs::logger::Err(buff, MODULE_NAME_CAPS);
+      return -1;
+    }
+  }
+
+  // check --sysroot option (exported so that modules see it too)
+  if (rvs::options::has_option("-sr", &val)) {
+    struct stat st;
+    if (stat(val.c_str(), &st) || !S_ISDIR(st.st_mode)) {
+      char buff[1024];
+      snprintf(buff, sizeof(buff),
+                "sysroot is not a directory: %s", val.c_str());
+      rvs::logger::Err(buff, MODULE_NAME_CAPS);
+      return -1;
+    }
+    setenv(RVS_SYSROOT_ENV, val.c_str(), 1);
+  }
+
+  // rebuild topology cache before any module reads it
+  if (rvs::options::has_option("-rt")) {
+    rvs::gpulist::Initialize(gpu_sysfs_path(KFD_SYS_PATH_NODES).c_str(),
+                             true);
+  }
+
+  if (do_log_rotation()) {
+    return -1;
+  }
+
+  if (do_log_coalesce()) {
+    return -1;
+  }
+
+  // thin client: job runs in resident mode server
+  if (rvs::options::has_option("-sub")) {
+    if (rvs::options::has_option("-q")) {
+      rvs::logger::quiet();
+    }
+    if (logger::init_log_file()) {
+      rvs::logger::Err("could not access log file", MODULE_NAME_CAPS);
+      return -1;
+    }
+    sts = do_submit();
+    logger::terminate();
+    return sts;
+  }
+
   string config_file;
   if (rvs::options::has_option("-c", &val)) {
     config_file = val;
@@ -132,10 +241,10 @@ int rvs::exec::run() {
     config_file = path + config_file;
   }
 
-  // Check if pConfig file exists
+  // Check if pConfig file exists (served jobs bring their own)
   std::ifstream file(config_file);
 
-  if (!file.good()) {
+  if (!file.good() && !rvs::options::has_option("-srv")) {
     char buff[1024];
     snprintf(buff, sizeof(buff),
               "%s file is missing.", config_file.c_str());
@@ -178,20 +287,40 @@ int rvs::exec::run() {
     return sts;
   }
 
+  if (rvs::options::has_option("-srv")) {
+    sts = do_serve();
+    rvs::module::terminate();
+    logger::terminate();
+    return sts;
+  }
+
+  // nothing is run if .conf file is known to be invalid
+  sts = do_plan(config_file);
+  if (sts || rvs::options::has_option("-dr")) {
+    if (sts) {
+      rvs::logger::Err("configuration not valid, no action run",
+                       MODULE_NAME_CAPS);
+    }
+    rvs::module::terminate();
+    logger::terminate();
+    return sts ? -1 : 0;
+  }
+
+  if (do_journal(config_file)) {
+    rvs::module::terminate();
+    logger::terminate();
+    return -1;
+  }
+
   DTRACE_
-  try {
-    sts = do_yaml(config_file);
-  } catch(std::exception& e) {
-    sts = -999;
-    char buff[1024];
-    snprintf(buff, sizeof(buff),
-             "error processing configuration file: %s", config_file.c_str());
-    rvs::logger::Err(buff, MODULE_NAME_CAPS);
-    snprintf(buff, sizeof(buff),
-             "exception: %s", e.what());
-    rvs::logger::Err(buff, MODULE_NAME_CAPS);
+  if (rvs::options::has_option("-rp")) {
+    sts = do_repeat(config_file);
+  } else {
+    sts = run_config(config_file);
   }
 
+  rvs::profiler::report();
+
   rvs::module::terminate();
   logger::terminate();
 
@@ -211,6 +340,123 @@ int rvs::exec::run() {
   return 0;
 }
 
+/**
+ * @brief Executes actions listed in .conf file
+ *
+ * @param config_file .conf file
+ * @return 0 if successful, non-zero otherwise
+ *
+ */
+int rvs::exec::run_config(const std::string& config_file) {
+  int sts;
+
+  try {
+    sts = do_yaml(config_file);
+  } catch(std::exception& e) {
+    sts = -999;
+    char buff[1024];
+    snprintf(buff, sizeof(buff),
+             "error processing configuration file: %s", config_file.c_str());
+    rvs::logger::Err(buff, MODULE_NAME_CAPS);
+    snprintf(buff, sizeof(buff),
+             "exception: %s", e.what());
+    rvs::logger::Err(buff, MODULE_NAME_CAPS);
+  }
+
+  return sts;
+}
+
+/**
+ * @brief Opens progress journal next to the log file.
+ *
+ * Journal is kept only when log file is given (-l). With --resume,
+ * actions completed in previous run of the same .conf file are skipped.
+ *
+ * @param config_file .conf file to be executed
+ * @return 0 if successful, non-zero otherwise
+ *
+ */
+int rvs::exec::do_journal(const std::string& config_file) {
+  bool resume = rvs::options::has_option("-rs");
+
+  // every iteration of repeated run executes all actions
+  if (rvs::options::has_option("-rp")) {
+    if (resume) {
+      rvs::logger::Err("--resume can not be used with --repeat",
+                       MODULE_NAME_CAPS);
+      return -1;
+    }
+    return 0;
+  }
+
+  string log_file;
+  if (!rvs::options::has_option("-l", &log_file) || log_file.empty()) {
+    if (resume) {
+      rvs::logger::Err("--resume requires log file (-l)", MODULE_NAME_CAPS);
+      return -1;
+    }
+    return 0;
+  }
+
+  pjournal = new rvs::journal();
+  return pjournal->open(log_file + ".journal", config_file, resume);
+}
+
+/**
+ * @brief Executes actions listed in .conf file repeatedly
+ *
+ * Runs .conf file number of times given by --repeat, with modules staying
+ * loaded between iterations, and reports statistics of metrics reported
+ * by actions over all iterations. Metrics varying more than --maxCov
+ * percent (default 5) are flagged. Stops at first failed iteration.
+ *
+ * @param config_file .conf file
+ * @return 0 if all iterations were successful, non-zero otherwise
+ *
+ */
+int rvs::exec::do_repeat(const std::string& config_file) {
+  string val;
+  uint64_t repeat = 0;
+  rvs::options::has_option("-rp", &val);
+  if (parse_with_unit(val, {}, &repeat) || repeat == 0) {
+    string msg = "number of repetitions not a positive integer: " + val;
+    rvs::logger::Err(msg.c_str(), MODULE_NAME_CAPS);
+    return -1;
+  }
+
+  double maxcov = 5;
+  if (rvs::options::has_option("-mc", &val)) {
+    size_t pos = 0;
+    try {
+      maxcov = std::stod(val, &pos);
+    } catch(...) {
+    }
+    if (pos == 0 || pos != val.size() || maxcov < 0) {
+      string msg = "CoV threshold not a non-negative number: " + val;
+      rvs::logger::Err(msg.c_str(), MODULE_NAME_CAPS);
+      return -1;
+    }
+  }
+
+  rvs::repeatstats stats;
+  pstats = &stats;
+
+  int sts = 0;
+  for (iteration = 1; iteration <= repeat; iteration++) {
+    rvs::logger::log("repeat iteration " + std::to_string(iteration) + "/" +
+                     std::to_string(repeat), rvs::logresults);
+    sts = run_config(config_file);
+    if (sts || rvs::logger::Stopping()) {
+      break;
+    }
+  }
+
+  pstats = nullptr;
+  stats.report(maxcov);
+
+  return sts;
+}
+
 //! Reports version strin
 void rvs::exec::do_version() {
   cout << LIB_VERSION_STRING << '\n';
@@ -224,8 +470,22 @@ void rvs::exec::do_help() {
                               "overwrite the contents\n";
   cout << "                   of a current log. Used in conjuction with the"
                                "-d and -l options.\n";
+  cout << "   --asyncLog      Output log messages from a dedicated writer "
+                              "thread. Value is\n";
+  cout << "                   'block' (wait when logging queue is full) or "
+                              "'drop' (discard\n";
+  cout << "                   and count messages when logging queue is "
+                              "full).\n";
+  cout << "   --binaryLog     Write log file in compact binary format. "
+                              "Use rvs-logcat to\n";
+  cout << "                   convert it into text or JSON log. Used in "
+                              "conjunction with\n";
+  cout << "                   the -l option.\n";
   cout << "-c --config        Specify the configuration file to be used.\n";
   cout << "                   The default is <install base>/conf/RVS.conf\n";
+  cout << "   --compactJson   Output each JSON record on a single line "
+                              "without indentation.\n";
+  cout << "                   Used in conjunction with the -j option.\n";
   cout << "   --configless    Run RVS in a configless mode. Executes a "
                               "\"long\" test on all\n";
   cout << "                   supported GPUs.\n";
@@ -233,6 +493,12 @@ void rvs::exec::do_help() {
                               "The range is\n";
   cout << "                   0 to 5 with 5 being the most verbose.\n";
   cout << "                   Used in conjunction with the -l flag.\n";
+  cout << "   --dry-run       Validate the configuration file (modules, "
+                              "property values and\n";
+  cout << "                   device selections), print execution plan "
+                              "with estimated\n";
+  cout << "                   durations and exit without running any "
+                              "action.\n";
   cout << "-g --listGpus      List the GPUs available and exit. This will "
                               "only list GPUs\n";
   cout << "                   that are supported by RVS.\n";
@@ -243,13 +509,89 @@ void rvs::exec::do_help() {
   cout << "                   every action in the configuration file, "
                               "including the ‘all’ value.\n";
   cout << "-j --json          Output should use the JSON format.\n";
+  cout << "   --jsonl         Output should use the JSON Lines format: one "
+                              "JSON record per line\n";
+  cout << "                   without enclosing array. Log file may be "
+                              "appended to by\n";
+  cout << "                   concurrent runs and processed while RVS is "
+                              "still running.\n";
   cout << "-l --debugLogFile  Specify the logfile for debug information. "
                               "This will produce a log\n";
   cout << "                   file intended for post-run analysis after "
                               "an error.\n";
+  cout << "   --logCoalesce   Suppress repeats of the same message and "
+                              "output single summary\n";
+  cout << "                   row when the window closes. Value is comma "
+                              "separated list of\n";
+  cout << "                   [<level>=]<window>[/<burst>] where window is "
+                              "in seconds with\n";
+  cout << "                   optional m or h suffix and burst is number of "
+                              "messages passed\n";
+  cout << "                   in each window (default 1). Without level, "
+                              "applies to all\n";
+  cout << "                   levels.\n";
+  cout << "   --logRotateSize Roll the log file over once it reaches given "
+                              "size. Value is in bytes\n";
+  cout << "                   with optional K, M or G suffix. Closed "
+                              "segments are renamed to\n";
+  cout << "                   <log file>.1, <log file>.2, ... Used in "
+                              "conjunction with the -l\n";
+  cout << "                   option.\n";
+  cout << "   --logRotateTime Roll the log file over once it is older than "
+                              "given time. Value\n";
+  cout << "                   is in seconds with optional m or h suffix. "
+                              "Used in conjunction\n";
+  cout << "                   with the -l option.\n";
+  cout << "   --logCompress   Compress closed log file segments with gzip "
+                              "in the background.\n";
+  cout << "                   Used in conjunction with --logRotateSize or "
+                              "--logRotateTime.\n";
+  cout << "   --profileStartup Record time spent in launcher and module "
+                              "startup phases (module\n";
+  cout << "                   loading and initialization, action creation, "
+                              "property parsing,\n";
+  cout << "                   ...) and output it as table and JSON record "
+                              "at the end of run.\n";
   cout << "   --quiet         No console output given. See logs and return "
                               "code for errors.\n";
+  cout << "   --repeat        Run the whole configuration file given "
+                              "number of times with\n";
+  cout << "                   modules kept loaded, then output mean, "
+                              "standard deviation,\n";
+  cout << "                   min/max and coefficient of variation of each "
+                              "action metric\n";
+  cout << "                   over all runs as table and JSON record.\n";
+  cout << "   --refresh-topology Rediscover GPU topology and rebuild "
+                              "topology cache even if\n";
+  cout << "                   topology fingerprint (node and GPU IDs, "
+                              "driver version) has\n";
+  cout << "                   not changed.\n";
+  cout << "   --resume        Continue interrupted run of the same .conf "
+                              "file. Actions (and sweep\n";
+  cout << "                   variants) recorded as completed in journal "
+                              "<log file>.journal\n";
+  cout << "                   are skipped and log is appended to. Used in "
+                              "conjunction with -l.\n";
   cout << "-m --modulepath    Specify a custom path for the RVS modules.\n";
+  cout << "   --maxCov        Coefficient of variation, in percent, above "
+                              "which a metric is\n";
+  cout << "                   flagged as noisy. Default is 5. Used in "
+                              "conjunction with --repeat.\n";
+  cout << "   --sysroot       Prefix all sysfs paths used for topology "
+                              "discovery with given\n";
+  cout << "                   directory (e.g. tree made by rvs-topogen). "
+                              "Same as RVS_SYSROOT\n";
+  cout << "                   environment variable.\n";
+  cout << "   --serve         Stay resident with all modules loaded and run "
+                              "jobs submitted\n";
+  cout << "                   through given Unix domain socket. Jobs using "
+                              "the same device run\n";
+  cout << "                   one after another. Stops on SIGINT or "
+                              "SIGTERM.\n";
+  cout << "   --submit        Run the job (-c, -i, -d and -v options) in "
+                              "server started with\n";
+  cout << "                   --serve listening on given socket. Job log "
+                              "is output to console.\n";
   cout << "   --specifiedtest Run a specific test in a configless mode. "
                               "Multiple word tests\n";
   cout << "                   should be in quotes. This action will default "
@@ -267,6 +609,231 @@ void rvs::exec::do_help() {
   cout << "-h --help          Display usage information and exit.\n";
 }
 
+/**
+ * @brief Configures log file rotation from command line options
+ *
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int rvs::exec::do_log_rotation() {
+  string   val;
+  uint64_t size = 0;
+  uint64_t interval = 0;
+  char     buff[1024];
+
+  if (rvs::options::has_option("-lrs", &val)) {
+    const std::map<char, uint64_t> units = {
+      {'K', 1ull << 10}, {'M', 1ull << 20}, {'G', 1ull << 30}};
+    if (parse_with_unit(val, units, &size) || size == 0) {
+      snprintf(buff, sizeof(buff),
+                "log rotation size not a positive size: %s", val.c_str());
+      rvs::logger::Err(buff, MODULE_NAME_CAPS);
+      return -1;
+    }
+  }
+
+  if (rvs::options::has_option("-lrt", &val)) {
+    const std::map<char, uint64_t> units = {{'s', 1}, {'m', 60}, {'h', 3600}};
+    if (parse_with_unit(val, units, &interval) || interval == 0 ||
+        interval > UINT32_MAX) {
+      snprintf(buff, sizeof(buff),
+                "log rotation time not a positive interval: %s", val.c_str());
+      rvs::logger::Err(buff, MODULE_NAME_CAPS);
+      return -1;
+    }
+  }
+
+  logger::rotate(size, static_cast<unsigned int>(interval),
+                 rvs::options::has_option("-lz"));
+
+  return 0;
+}
+
+/**
+ * @brief Configures coalescing of repeated log messages from command line
+ *
+ * Value of --logCoalesce option is comma separated list of
+ * [level=]window[/burst] items, e.g. "3=10,4=5/3" or "30s".
+ *
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int rvs::exec::do_log_coalesce() {
+  string val;
+  char   buff[1024];
+
+  if (!rvs::options::has_option("-lc", &val)) {
+    return 0;
+  }
+
+  const std::map<char, uint64_t> units = {{'s', 1}, {'m', 60}, {'h', 3600}};
+  std::vector<string> items = str_split(val, ",");
+  if (items.empty()) {
+    items.push_back(val);
+  }
+
+  for (auto it = items.begin(); it != items.end(); ++it) {
+    string item = *it;
+    int level = -1;
+    uint64_t window = 0;
+    uint64_t burst = 1;
+
+    size_t pos = item.find('=');
+    if (pos != string::npos) {
+      string slevel = item.substr(0, pos);
+      if (slevel.size() != 1 || slevel[0] < '0' || slevel[0] > '5') {
+        snprintf(buff, sizeof(buff),
+                  "log coalescing level not in range [0..5]: %s",
+                  item.c_str());
+        rvs::logger::Err(buff, MODULE_NAME_CAPS);
+        return -1;
+      }
+      level = slevel[0] - '0';
+      item = item.substr(pos + 1);
+    }
+
+    int sts = 0;
+    pos = item.find('/');
+    if (pos != string::npos) {
+      sts = parse_with_unit(item.substr(pos + 1), {}, &burst);
+      item = item.substr(0, pos);
+    }
+    sts = sts || parse_with_unit(item, units, &window);
+
+    if (sts || window == 0 || window > UINT32_MAX / 1000 ||
+        burst == 0 || burst > UINT32_MAX) {
+      snprintf(buff, sizeof(buff),
+                "log coalescing not [<level>=]<window>[/<burst>]: %s",
+                it->c_str());
+      rvs::logger::Err(buff, MODULE_NAME_CAPS);
+      return -1;
+    }
+
+    for (int l = 0; l <= rvs::logtrace; l++) {
+      if (level < 0 || level == l) {
+        logger::coalesce(l, static_cast<unsigned int>(window * 1000),
+                         static_cast<unsigned int>(burst));
+      }
+    }
+  }
+
+  return 0;
+}
+
+/**
+ * @brief Runs resident mode server
+ *
+ * All modules are loaded and initialized upfront and stay loaded until
+ * server is stopped by SIGINT or SIGTERM, so jobs submitted through
+ * --submit do not pay for module loading and runtime initialization.
+ *
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int rvs::exec::do_serve() {
+  string socket;
+  char   buff[1024];
+
+  rvs::options::has_option("-srv", &socket);
+
+  auto start = std::chrono::steady_clock::now();
+  int failed = rvs::module::load_all();
+  std::chrono::duration<double> load =
+    std::chrono::steady_clock::now() - start;
+
+  snprintf(buff, sizeof(buff),
+           "[%s] serve: modules loaded and initialized in %.3f s "
+           "(%d could not be loaded)", MODULE_NAME_CAPS, load.count(),
+           failed);
+  rvs::logger::log(buff, rvs::loginfo);
+
+  rvs::server srv;
+  pserver = &srv;
+  struct sigaction sa;
+  struct sigaction old_int;
+  struct sigaction old_term;
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_handler = on_stop_signal;
+  sigemptyset(&sa.sa_mask);
+  sigaction(SIGINT, &sa, &old_int);
+  sigaction(SIGTERM, &sa, &old_term);
+
+  int sts = srv.serve(socket, [](const std::string& Config) {
+    rvs::exec executor;
+
+    // nothing is run if .conf file is known to be invalid
+    if (executor.do_plan(Config)) {
+      rvs::logger::Err("configuration not valid, no action run",
+                       MODULE_NAME_CAPS);
+      return -1;
+    }
+    return executor.run_config(Config);
+  }, &is_reentrant);
+
+  sigaction(SIGINT, &old_int, nullptr);
+  sigaction(SIGTERM, &old_term, nullptr);
+  pserver = nullptr;
+
+  return sts;
+}
+
+/**
+ * @brief Submits job to resident mode server
+ *
+ * Rows logged by the job are output to console as they arrive. Relative
+ * path of configuration file is resolved here, as server runs in its own
+ * working directory.
+ *
+ * @return job exit status, -1 if job could not be submitted
+ *
+ */
+int rvs::exec::do_submit() {
+  string socket;
+  char   buff[1024];
+
+  rvs::options::has_option("-sub", &socket);
+
+  // other options apply to the client itself
+  std::map<string, string> opts;
+  for (auto it = rvs::options::get().begin();
+       it != rvs::options::get().end(); ++it) {
+    if (it->first == "-c" || it->first == "-i" || it->first == "-d" ||
+        it->first == "-v") {
+      opts.insert(*it);
+    }
+  }
+
+  auto it = opts.find("-c");
+  if (it != opts.end() && !it->second.empty() && it->second[0] != '/') {
+    char cwd[PATH_MAX];
+    if (getcwd(cwd, sizeof(cwd))) {
+      it->second = string(cwd) + "/" + it->second;
+    }
+  }
+
+  bool quiet = rvs::options::has_option("-q");
+  rvs::client cl([quiet](const int, const std::string& Row) {
+    if (!quiet) {
+      cout << Row << '\n';
+    }
+  });
+
+  auto start = std::chrono::steady_clock::now();
+  int sts = cl.submit(socket, opts);
+  std::chrono::duration<double> total =
+    std::chrono::steady_clock::now() - start;
+
+  if (cl.job_id()) {
+    snprintf(buff, sizeof(buff),
+             "[%s] job %" PRIu64 " completed with status %d, queued %.3f s, "
+             "ran %.3f s, round trip %.3f s", MODULE_NAME_CAPS, cl.job_id(),
+             sts, cl.seconds_queued(), cl.seconds_run(), total.count());
+    rvs::logger::log(buff, rvs::loginfo);
+  }
+
+  return sts;
+}
+
 //! Reports list of AMD GPUs presnt in the system
 int rvs::exec::do_gpu_list() {
   cout << "\nROCm Validation Suite (version " << LIB_VERSION_STRING << ")\n\n";
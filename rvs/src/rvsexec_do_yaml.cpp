@@ -26,17 +26,29 @@
 #include <memory>
 #include <string>
 #include <algorithm>
+#include <chrono>
 
 #include "include/rvsexec.h"
 #include "yaml-cpp/yaml.h"
 
 #include "include/rvsif0.h"
 #include "include/rvsif1.h"
+#include "include/rvsif2.h"
+#include "include/rvsbudget.h"
+#include "include/rvsjournal.h"
+#include "include/rvsactionconfig.h"
+#include "include/rvsactionresult.h"
 #include "include/rvsaction.h"
 #include "include/rvsmodule.h"
+#include "include/rvsplan.h"
 #include "include/rvsliblogger.h"
 #include "include/rvsoptions.h"
+#include "include/rvsprofiler.h"
+#include "include/rvsrepeat.h"
+#include "include/rvsscheduler.h"
+#include "include/rvssweep.h"
 #include "include/rvs_util.h"
+#include "include/gpu_util.h"
 
 #define MODULE_NAME_CAPS "CLI"
 
@@ -54,11 +66,136 @@ actions:
   module: gpup
   device: all
 
+Actions are run one after another unless "group" or "depends_on" keys are
+used. Then actions of the same group (or without group) still run in order,
+but different groups run concurrently, and "depends_on" (action name or list
+of names) delays action until listed actions complete:
+
+actions:
+- name: mem_0_3
+  module: mem
+  device: 0 1 2 3
+  group: a
+- name: babel_4_7
+  module: babel
+  device: 4 5 6 7
+  group: b
+- name: monitor
+  module: gm
+  device: all
+  group: c
+- name: report
+  module: gpup
+  device: all
+  depends_on: [mem_0_3, babel_4_7]
+
+With top level "time_budget" key, "duration" of actions is scaled so that
+all actions fit into given time (see rvs::budget):
+
+time_budget: 45m
+actions:
+- name: gst_1
+  module: gst
+  device: all
+  duration: 600000
+  min_duration: 60000
+- name: iet_1
+  module: iet
+  device: all
+  duration: 300000
+  weight: 2
+
 ***/
 
 
 using std::string;
 
+/**
+ * @brief Validates whole .conf file before any action is run.
+ *
+ * Loads all modules referenced in .conf file, checks action properties
+ * against module schemas, resolves device selections and estimates
+ * execution time. With --dry-run, plan is printed on standard output.
+ *
+ * @param config_file .conf file
+ * @return 0 if no errors were found, non-zero otherwise
+ *
+ */
+int rvs::exec::do_plan(const std::string& config_file) {
+  int prof = rvs::profiler::begin("plan");
+
+  YAML::Node config;
+  try {
+    config = YAML::LoadFile(config_file);
+  } catch(std::exception& e) {
+    rvs::profiler::end(prof);
+    string msg = "error processing configuration file: " + config_file +
+                 ": " + e.what();
+    rvs::logger::Err(msg.c_str(), MODULE_NAME_CAPS);
+    return -1;
+  }
+
+  // schema is obtained through IF0 of a temporary action object
+  rvs::plan::t_schema schema = [](const std::string& module_name,
+                                  std::string* text) {
+    rvs::action* pa = module::action_create(module_name.c_str());
+    if (!pa) {
+      return -1;
+    }
+    if0* pif0 = dynamic_cast<if0*>(pa->get_interface(0));
+    *text = pif0 ? pif0->get_schema() : "";
+    module::action_destroy(pa);
+    return 0;
+  };
+
+  std::vector<uint16_t> gpus;
+  gpu_get_all_gpu_id(&gpus);
+
+  rvs::plan p;
+  int sts = p.build(config["actions"], schema, gpus);
+
+  // budget errors are reported by budget itself
+  rvs::budget b;
+  bool budgeted = rvs::budget::has_budget(config);
+  if (budgeted && b.build(config)) {
+    sts++;
+    budgeted = false;
+  }
+  rvs::profiler::end(prof);
+
+  p.report();
+  if (rvs::options::has_option("-dr") && !rvs::logger::is_quiet()) {
+    std::cout << p.table();
+    if (budgeted) {
+      std::cout << b.table();
+    }
+    std::cout << p.warnings().size() << " warning(s), " << p.errors().size()
+         << " error(s)\n";
+  }
+
+  return sts;
+}
+
+/**
+ * @brief Checks if actions of a module may run concurrently
+ *
+ * Re-entrancy is obtained through IF0 of a temporary action object.
+ *
+ * @param module_name module name
+ * @return true if module declares itself re-entrant
+ *
+ */
+bool rvs::exec::is_reentrant(const std::string& module_name) {
+  rvs::action* pa = module::action_create(module_name.c_str());
+  if (!pa) {
+    return false;
+  }
+  if0* pif0 = dynamic_cast<if0*>(pa->get_interface(0));
+  bool sts = pif0 ? pif0->is_reentrant() : false;
+  module::action_destroy(pa);
+  return sts;
+}
+
 /**
  * @brief Executes actions listed in .conf file.
  *
@@ -68,102 +205,345 @@ using std::string;
 int rvs::exec::do_yaml(const std::string& config_file) {
   int sts = 0;
 
+  int prof = rvs::profiler::begin("config load");
   YAML::Node config = YAML::LoadFile(config_file);
+  rvs::profiler::end(prof);
 
   // find "actions" map
   const YAML::Node& actions = config["actions"];
 
+  totals.reset();
 
-  // for all actions...
-  for (YAML::const_iterator it = actions.begin(); it != actions.end(); ++it) {
-    const YAML::Node& action = *it;
-
-    rvs::logger::log("Action name :" + action["name"].as<std::string>(), rvs::logresults);
+  delete pbudget;
+  pbudget = nullptr;
+  if (rvs::budget::has_budget(config)) {
+    pbudget = new rvs::budget();
+    if (pbudget->build(config)) {
+      return -1;
+    }
+  }
 
-    // if stop was requested
-    if (rvs::logger::Stopping()) {
+  // run actions concurrently if execution order is given explicitly
+  if (rvs::scheduler::is_scheduled(actions)) {
+    rvs::scheduler sched;
+    if (sched.build(actions, &is_reentrant)) {
       return -1;
     }
+    sts = sched.run([this](const YAML::Node& action, const size_t index) {
+      return do_yaml_action(action, index);
+    });
+    totals.report();
+    if (pbudget) {
+      pbudget->report();
+    }
+    return sts;
+  }
+
+  // for all actions...
+  size_t index = 0;
+  for (YAML::const_iterator it = actions.begin(); it != actions.end();
+       ++it, ++index) {
+    sts = do_yaml_action(*it, index);
 
-    // find module name
-    std::string rvsmodule;
-    try {
-      rvsmodule = action["module"].as<std::string>();
-    } catch(...) {
+    // errors?
+    if (sts) {
+      // cancel actions and return
+      if (pbudget) {
+        pbudget->report();
+      }
+      return sts;
     }
+  }
 
-    // not found or empty
-    if (rvsmodule == "") {
-      // report error and go to next action
-      char buff[1024];
-      snprintf(buff, sizeof(buff), "action '%s' does not specify module.",
-               action["name"].as<std::string>().c_str());
-      rvs::logger::Err(buff, MODULE_NAME_CAPS);
-      return -1;
+  totals.report();
+  if (pbudget) {
+    pbudget->report();
+  }
+
+  return 0;
+}
+
+/**
+ * @brief Executes single action listed in .conf file.
+ *
+ * Runs action once or, if it has "sweep" key, once for each parameter
+ * variant.
+ *
+ * @param action action node from .conf file
+ * @param index position of the action in .conf file
+ * @return 0 if successful, non-zero otherwise
+ *
+ */
+int rvs::exec::do_yaml_action(const YAML::Node& action, const size_t index) {
+
+  rvs::logger::log("Action name :" + action["name"].as<std::string>(), rvs::logresults);
+
+  // if stop was requested
+  if (rvs::logger::Stopping()) {
+    return -1;
+  }
+
+  // find module name
+  std::string rvsmodule;
+  try {
+    rvsmodule = action["module"].as<std::string>();
+  } catch(...) {
+  }
+
+  // not found or empty
+  if (rvsmodule == "") {
+    // report error and go to next action
+    char buff[1024];
+    snprintf(buff, sizeof(buff), "action '%s' does not specify module.",
+             action["name"].as<std::string>().c_str());
+    rvs::logger::Err(buff, MODULE_NAME_CAPS);
+    return -1;
+  }
+
+  std::string name = action["name"].as<std::string>();
+
+  // completed in interrupted run which is being resumed
+  if (pjournal && pjournal->resuming() && pjournal->done(index, name)) {
+    rvs::logger::log("[" + name + "] skipped, completed in previous run",
+                     rvs::logresults);
+    if (pbudget) {
+      pbudget->complete(name, 0);
     }
+    return 0;
+  }
 
-    // create action excutor in .so
-    rvs::action* pa = module::action_create(rvsmodule.c_str());
-    if (!pa) {
-      char buff[1024];
-      snprintf(buff, sizeof(buff),
-               "action '%s' could not crate action object in module '%s'",
-               action["name"].as<std::string>().c_str(),
-               rvsmodule.c_str());
-      rvs::logger::Err(buff, MODULE_NAME_CAPS);
-      return -1;
+  // duration given by time budget replaces configured one
+  rvs::sweep::t_params overrides;
+  if (pbudget) {
+    uint64_t duration = pbudget->allocate(name);
+    if (duration) {
+      overrides.push_back({"duration", std::to_string(duration)});
+      rvs::logger::log("[" + name + "] duration " + std::to_string(duration) +
+                       " ms given by time_budget", rvs::logresults);
     }
+  }
+  auto t0 = std::chrono::steady_clock::now();
 
-    if1* pif1 = dynamic_cast<if1*>(pa->get_interface(1));
-    if (!pif1) {
-      char buff[1024];
-      snprintf(buff, sizeof(buff),
-               "action '%s' could not obtain interface if1",
-               action["name"].as<std::string>().c_str());
-      module::action_destroy(pa);
-      return -1;
+  int sts;
+  if (rvs::sweep::has_sweep(action)) {
+    sts = do_yaml_sweep(action, index, rvsmodule, name, overrides);
+    if (pjournal) {
+      pjournal->complete(index, name, sts, 0, 0);
     }
+  } else {
+    rvs::actionresult result(rvsmodule, name, &totals);
+    sts = do_yaml_run(action, rvsmodule, name, overrides, &result);
+    result.report();
+    if (pstats) {
+      pstats->add(iteration, name, result);
+    }
+    if (pjournal) {
+      pjournal->complete(index, name, sts, result.passed(),
+                         result.failed());
+    }
+  }
 
-    // load action properties from yaml file
-    sts += do_yaml_properties(action, rvsmodule, pif1);
-    if (sts) {
-      module::action_destroy(pa);
-      return sts;
+  if (pbudget) {
+    pbudget->complete(name, std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - t0).count());
+  }
+
+  return sts;
+}
+
+/**
+ * @brief Executes action for all parameter variants listed in its "sweep"
+ * key and reports consolidated result table.
+ *
+ * Module stays loaded for all variants. Remaining variants are run even if
+ * one of them fails. Variants completed in resumed run are not repeated.
+ *
+ * @param action action node from .conf file
+ * @param index position of the action in .conf file
+ * @param module_name module name
+ * @param action_name action name
+ * @param overrides properties replacing those given in .conf file for all
+ * variants
+ * @return 0 if all variants were successful, non-zero otherwise
+ *
+ */
+int rvs::exec::do_yaml_sweep(const YAML::Node& action, const size_t index,
+                             const std::string& module_name,
+                             const std::string& action_name,
+                             const std::vector<std::pair<std::string,
+                                                         std::string>>&
+                               overrides) {
+  rvs::sweep sw;
+  if (sw.build(action["sweep"])) {
+    return -1;
+  }
+
+  int sts = 0;
+  size_t size = sw.size();
+  for (size_t i = 0; i < size; i++) {
+    if (rvs::logger::Stopping()) {
+      sts = -1;
+      break;
     }
 
-    // set also command line options:
-    for (auto clit = rvs::options::get().begin();
-         clit != rvs::options::get().end(); ++clit) {
-      std::string p(clit->first);
-      p = "cli." + p;
-      pif1->property_set(p, clit->second);
+    rvs::sweep::t_params params = sw.variant(i);
+    params.insert(params.end(), overrides.begin(), overrides.end());
+    std::string msg = "[" + action_name + "] sweep variant " +
+                      std::to_string(i + 1) + "/" + std::to_string(size);
+    for (auto it = params.begin(); it != params.end(); ++it) {
+      msg += " " + it->first + ": " + it->second;
     }
 
-    // execute action
-    sts = pif1->run();
+    rvs::actionresult result(module_name, action_name, &totals);
+    if (pjournal && pjournal->resuming() &&
+        pjournal->done(index, action_name, i)) {
+      rvs::logger::log(msg + " skipped, completed in previous run",
+                       rvs::logresults);
+      sw.add_result(i, 0, result);
+      continue;
+    }
+    rvs::logger::log(msg, rvs::logresults);
+
+    int vsts = do_yaml_run(action, module_name, action_name, params,
+                           &result);
+    result.report();
+    sw.add_result(i, vsts, result);
+    if (pstats) {
+      pstats->add(iteration, action_name + "[" + std::to_string(i) + "]",
+                  result);
+    }
+    if (pjournal) {
+      pjournal->complete(index, action_name, vsts, result.passed(),
+                         result.failed(), i);
+    }
+    if (vsts) {
+      sts = vsts;
+    }
+  }
 
-    // processing finished, release action object
+  sw.report(module_name, action_name);
+
+  return sts;
+}
+
+/**
+ * @brief Executes single action instance.
+ *
+ * Creates action object in the module, passes properties to it, runs it
+ * and releases it.
+ *
+ * @param action action node from .conf file
+ * @param rvsmodule module name
+ * @param name action name
+ * @param overrides properties replacing those given in .conf file
+ * @param presult receiver of structured results (IF2 only)
+ * @return 0 if successful, non-zero otherwise
+ *
+ */
+int rvs::exec::do_yaml_run(const YAML::Node& action,
+                           const std::string& rvsmodule,
+                           const std::string& name,
+                           const std::vector<std::pair<std::string,
+                                                       std::string>>&
+                             overrides,
+                           rvs::actionresult* presult) {
+  int sts = 0;
+  int prof_action = rvs::profiler::begin("action", rvsmodule, name);
+
+  // create action excutor in .so
+  int prof = rvs::profiler::begin("action create");
+  rvs::action* pa = module::action_create(rvsmodule.c_str());
+  rvs::profiler::end(prof);
+  if (!pa) {
+    rvs::profiler::end(prof_action);
+    char buff[1024];
+    snprintf(buff, sizeof(buff),
+             "action '%s' could not crate action object in module '%s'",
+             action["name"].as<std::string>().c_str(),
+             rvsmodule.c_str());
+    rvs::logger::Err(buff, MODULE_NAME_CAPS);
+    return -1;
+  }
+
+  // IF2 is used when module provides it, IF1 otherwise
+  if2* pif2 = dynamic_cast<if2*>(pa->get_interface(2));
+  if1* pif1 = dynamic_cast<if1*>(pa->get_interface(1));
+  if (!pif2 && !pif1) {
+    char buff[1024];
+    snprintf(buff, sizeof(buff),
+             "action '%s' could not obtain interface if1",
+             action["name"].as<std::string>().c_str());
     module::action_destroy(pa);
+    rvs::profiler::end(prof_action);
+    return -1;
+  }
 
-    // errors?
-    if (sts) {
-      // cancel actions and return
-      return sts;
+  // load action properties from yaml file
+  prof = rvs::profiler::begin("action properties");
+  rvs::actionconfig config;
+  sts += do_yaml_properties(action, rvsmodule, &config);
+  if (sts) {
+    rvs::profiler::end(prof);
+    module::action_destroy(pa);
+    rvs::profiler::end(prof_action);
+    return sts;
+  }
+
+  // sweep variant and time budget values replace those from .conf file
+  for (auto it = overrides.begin(); it != overrides.end(); ++it) {
+    config.set(it->first, it->second);
+  }
+
+  // set also command line options:
+  for (auto clit = rvs::options::get().begin();
+       clit != rvs::options::get().end(); ++clit) {
+    std::string p(clit->first);
+    p = "cli." + p;
+    config.add(p, clit->second);
+  }
+
+  // pass properties to action
+  if (pif2) {
+    sts = pif2->configure(config.get());
+  } else {
+    for (size_t i = 0; i < config.size(); i++) {
+      sts += pif1->property_set(config.key(i), config.text(i));
     }
   }
+  rvs::profiler::end(prof);
+  if (sts) {
+    module::action_destroy(pa);
+    rvs::profiler::end(prof_action);
+    return sts;
+  }
 
-  return 0;
+  // execute action
+  prof = rvs::profiler::begin("action run");
+  if (pif2) {
+    sts = pif2->execute(presult->sink());
+  } else {
+    sts = pif1->run();
+  }
+  rvs::profiler::end(prof);
+
+  // processing finished, release action object
+  prof = rvs::profiler::begin("action destroy");
+  module::action_destroy(pa);
+  rvs::profiler::end(prof);
+  rvs::profiler::end(prof_action);
+
+  return sts;
 }
 
 /**
- * @brief Loads action properties.
+ * @brief Collects action properties from .conf file.
  *
  * @return 0 if successful, non-zero otherwise
  *
  */
 int rvs::exec::do_yaml_properties(const YAML::Node& node,
                                   const std::string& module_name,
-                                  rvs::if1* pif1) {
+                                  rvs::actionconfig* pconfig) {
   int sts = 0;
 
   string indexes;
@@ -175,21 +555,30 @@ int rvs::exec::do_yaml_properties(const YAML::Node& node,
 
   // for all child nodes
   for (YAML::const_iterator it = node.begin(); it != node.end(); it++) {
+    // scheduling, sweep and budget keys are not passed to modules
+    if (it->first.as<std::string>() == "group" ||
+        it->first.as<std::string>() == "depends_on" ||
+        it->first.as<std::string>() == "sweep" ||
+        it->first.as<std::string>() == "weight" ||
+        it->first.as<std::string>() == "min_duration") {
+      continue;
+    }
+
     // if property is collection of module specific properties,
     if (is_yaml_properties_collection(module_name,
         it->first.as<std::string>())) {
       // pass properties collection to .so action object
       sts += do_yaml_properties_collection(it->second,
                                            it->first.as<std::string>(),
-                                           pif1);
+                                           pconfig);
     } else {
       // just set this one propertiy
       if (indexes_provided && it->first.as<std::string>() == "device") {
         std::replace(indexes.begin(), indexes.end(), ',', ' ');
-        sts += pif1->property_set("device", indexes);
+        pconfig->add("device", indexes);
       } else {
-        sts += pif1->property_set(it->first.as<std::string>(),
-                                it->second.as<std::string>());
+        pconfig->add(it->first.as<std::string>(),
+                     it->second.as<std::string>());
       }
     }
   }
@@ -198,20 +587,21 @@ int rvs::exec::do_yaml_properties(const YAML::Node& node,
 }
 
 /**
- * @brief Loads property collection for collection type node in .conf file.
+ * @brief Collects property collection for collection type node in .conf
+ * file.
  *
  * @return 0 if successful, non-zero otherwise
  *
  */
 int rvs::exec::do_yaml_properties_collection(const YAML::Node& node,
                                              const std::string& parent_name,
-                                             if1* pif1) {
+                                             actionconfig* pconfig) {
   int sts = 0;
 
   // for all child nodes
   for (YAML::const_iterator it = node.begin(); it != node.end(); it++) {
     // prepend dot separated parent name and pass property to module
-    sts += pif1->property_set(parent_name + "." + it->first.as<std::string>(),
+    pconfig->add(parent_name + "." + it->first.as<std::string>(),
     it->second.IsNull() ? std::string("") : it->second.as<std::string>());
   }
 
@@ -29,7 +29,9 @@ rvs::if0::if0()
 :
 rvs_module_get_description(nullptr),
 rvs_module_get_config(nullptr),
-rvs_module_get_output(nullptr) {
+rvs_module_get_output(nullptr),
+rvs_module_get_schema(nullptr),
+rvs_module_is_reentrant(nullptr) {
 }
 
 //! Default destructor
@@ -60,6 +62,8 @@ rvs::if0& rvs::if0::operator=(const rvs::if0& rhs) {
     rvs_module_get_description  = rhs.rvs_module_get_description;
     rvs_module_get_config    = rhs.rvs_module_get_config;
     rvs_module_get_output    = rhs.rvs_module_get_output;
+    rvs_module_get_schema    = rhs.rvs_module_get_schema;
+    rvs_module_is_reentrant  = rhs.rvs_module_is_reentrant;
   }
 
   return *this;
@@ -105,5 +109,35 @@ const char* rvs::if0::get_output() {
   return (*rvs_module_get_output)();
 }
 
+/**
+ * @brief Returns machine readable description of configuration properties
+ *
+ * Schema is list of "<key>:<type>[=<value>|<value>...]" entries separated
+ * by ';' where type is int, float, bool, string, list or collection.
+ * Optional - empty string is returned if module does not declare it.
+ *
+ * @return pointer to C string holding schema
+ *
+ */
+const char* rvs::if0::get_schema() {
+  if (!rvs_module_get_schema) {
+    return "";
+  }
+  return (*rvs_module_get_schema)();
+}
 
-
+/**
+ * @brief Tells if actions of the module may run concurrently
+ *
+ * Optional - modules which do not declare it keep per-process state and
+ * their actions are run one at a time.
+ *
+ * @return true if module is re-entrant
+ *
+ */
+bool rvs::if0::is_reentrant() {
+  if (!rvs_module_is_reentrant) {
+    return false;
+  }
+  return (*rvs_module_is_reentrant)() != 0;
+}
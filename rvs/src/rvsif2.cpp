@@ -0,0 +1,102 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvsif2.h"
+
+#include <string>
+#include "include/rvsliblogger.h"
+
+//! Default constructor
+rvs::if2::if2()
+:
+rvs_module_action_configure(nullptr),
+rvs_module_action_execute(nullptr) {
+}
+
+//! Default descrutor
+rvs::if2::~if2() {
+}
+
+
+/**
+ * @brief Copy constructor
+ *
+ * @param rhs reference to RHS instance
+ *
+ */
+rvs::if2::if2(const if2& rhs) : ifbase(rhs) {
+  *this = rhs;
+}
+
+/**
+ * @brief Assignment operator
+ *
+ * @param rhs reference to RHS instance
+ * @return reference to LHS instance
+ *
+ */
+rvs::if2& rvs::if2::operator=(const rvs::if2& rhs) {
+  // self-assignment check
+  if (this != &rhs) {
+    ifbase::operator=(rhs);
+    rvs_module_action_configure = rhs.rvs_module_action_configure;
+    rvs_module_action_execute = rhs.rvs_module_action_execute;
+  }
+
+  return *this;
+}
+
+/**
+ * @brief Clone instance
+ *
+ * @return pointer to newly created instance
+ *
+ */
+rvs::ifbase* rvs::if2::clone(void) {
+  return new rvs::if2(*this);
+}
+
+/**
+ * @brief Sets all action properties
+ *
+ * @param pConfig pre-parsed action configuration
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int rvs::if2::configure(const T_RVS_CONFIG* pConfig) {
+  rvs::logger::log("configure: " + std::to_string(pConfig->count) +
+                   " properties", rvs::logdebug);
+  return (*rvs_module_action_configure)(plibaction, pConfig);
+}
+
+/**
+ * @brief Execute action
+ *
+ * @param pSink receiver of structured results
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int rvs::if2::execute(T_RVS_RESULT_SINK* pSink) {
+  return (*rvs_module_action_execute)(plibaction, pSink);
+}
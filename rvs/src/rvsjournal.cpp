@@ -0,0 +1,339 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvsjournal.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "include/rvsliblogger.h"
+
+#define MODULE_NAME_CAPS "CLI"
+#define JOURNAL_HEADER   "RVS-JOURNAL 2"
+
+using std::string;
+
+//! Default constructor
+rvs::journal::journal() : config_hash(0), resume(false) {
+}
+
+//! Default destructor
+rvs::journal::~journal() {
+}
+
+/**
+ * @brief Computes 64-bit FNV-1a hash of given content
+ *
+ */
+uint64_t rvs::journal::hash(const std::string& Content) {
+  uint64_t h = 14695981039346656037ull;
+  for (size_t i = 0; i < Content.size(); i++) {
+    h ^= static_cast<unsigned char>(Content[i]);
+    h *= 1099511628211ull;
+  }
+  return h;
+}
+
+/**
+ * @brief Replaces file content so that it is never seen partially written
+ *
+ * Content is written into temporary file in the same directory, flushed to
+ * disk and renamed over the target file.
+ *
+ * @param Path file name
+ * @param Content new file content
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int rvs::journal::write_atomic(const std::string& Path,
+                               const std::string& Content) {
+  string tmp_name = Path + ".tmp";
+  int fd = ::open(tmp_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    return -1;
+  }
+
+  const char* p = Content.data();
+  size_t left = Content.size();
+  while (left) {
+    ssize_t n = ::write(fd, p, left);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      ::close(fd);
+      ::unlink(tmp_name.c_str());
+      return -1;
+    }
+    p += n;
+    left -= n;
+  }
+
+  if (::fsync(fd) || ::close(fd)) {
+    ::unlink(tmp_name.c_str());
+    return -1;
+  }
+
+  if (::rename(tmp_name.c_str(), Path.c_str())) {
+    ::unlink(tmp_name.c_str());
+    return -1;
+  }
+
+  // make rename itself durable
+  size_t slash = Path.rfind('/');
+  string dir = slash == string::npos ? "." : Path.substr(0, slash + 1);
+  int dfd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+  if (dfd >= 0) {
+    ::fsync(dfd);
+    ::close(dfd);
+  }
+
+  return 0;
+}
+
+/**
+ * @brief Opens journal
+ *
+ * When resuming, records of previous run are loaded provided that journal
+ * was written for the same configuration. Otherwise journal starts empty.
+ *
+ * @param Path journal file name
+ * @param ConfigFile .conf file being executed
+ * @param Resume true to continue previous run
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int rvs::journal::open(const std::string& Path, const std::string& ConfigFile,
+                       const bool Resume) {
+  std::ifstream cf(ConfigFile);
+  std::stringstream content;
+  content << cf.rdbuf();
+
+  std::lock_guard<std::mutex> lk(mtx);
+  file_name = Path;
+  config_file = ConfigFile;
+  config_hash = hash(content.str());
+  resume = Resume;
+  entries.clear();
+
+  if (Resume && load(ConfigFile, config_hash)) {
+    return -1;
+  }
+
+  if (save()) {
+    string msg = "could not write journal: " + file_name;
+    rvs::logger::Err(msg.c_str(), MODULE_NAME_CAPS);
+    return -1;
+  }
+
+  return 0;
+}
+
+/**
+ * @brief Loads records of previous run
+ *
+ * Missing journal is not an error (nothing was completed).
+ *
+ * @param ConfigFile .conf file being executed
+ * @param Hash hash of .conf file content
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int rvs::journal::load(const std::string& ConfigFile, const uint64_t Hash) {
+  char buff[1024];
+  std::ifstream f(file_name);
+  if (!f.good()) {
+    snprintf(buff, sizeof(buff),
+             "no journal %s found, starting from the first action",
+             file_name.c_str());
+    rvs::logger::log(buff, rvs::loginfo);
+    return 0;
+  }
+
+  string line;
+  if (!std::getline(f, line) || line != JOURNAL_HEADER) {
+    snprintf(buff, sizeof(buff), "%s is not a journal file",
+             file_name.c_str());
+    rvs::logger::Err(buff, MODULE_NAME_CAPS);
+    return -1;
+  }
+
+  while (std::getline(f, line)) {
+    std::istringstream is(line);
+    string kind;
+    is >> kind;
+
+    if (kind == "config") {
+      uint64_t h = 0;
+      is >> std::hex >> h;
+      if (h != Hash) {
+        snprintf(buff, sizeof(buff),
+                 "journal %s was written for different configuration than "
+                 "%s, can not resume", file_name.c_str(), ConfigFile.c_str());
+        rvs::logger::Err(buff, MODULE_NAME_CAPS);
+        return -1;
+      }
+      continue;
+    }
+
+    entry e;
+    e.variant = npos;
+    if (kind != "action" && kind != "variant") {
+      continue;
+    }
+    is >> e.index;
+    if (kind == "variant") {
+      is >> e.variant;
+    }
+    is >> e.status >> e.passed >> e.failed;
+    is.get();
+    std::getline(is, e.action);
+    if (is.fail() || e.action.empty()) {
+      continue;
+    }
+    entries.push_back(e);
+  }
+
+  snprintf(buff, sizeof(buff), "resuming from journal %s (%zu records)",
+           file_name.c_str(), entries.size());
+  rvs::logger::log(buff, rvs::logresults);
+
+  return 0;
+}
+
+/**
+ * @brief Writes all records into journal file
+ *
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int rvs::journal::save() {
+  std::ostringstream os;
+  os << JOURNAL_HEADER << "\n";
+  os << "config " << std::hex << config_hash << std::dec << " "
+     << config_file << "\n";
+  for (auto it = entries.begin(); it != entries.end(); ++it) {
+    if (it->variant == npos) {
+      os << "action " << it->index << " ";
+    } else {
+      os << "variant " << it->index << " " << it->variant << " ";
+    }
+    os << it->status << " " << it->passed << " " << it->failed << " "
+       << it->action << "\n";
+  }
+  return write_atomic(file_name, os.str());
+}
+
+/**
+ * @brief Checks if action (or sweep variant) completed successfully
+ *
+ * @param Index position of the action in .conf file
+ * @param Action action name
+ * @param Variant sweep variant index, npos for whole action
+ * @return true if work can be skipped
+ *
+ */
+bool rvs::journal::done(const size_t Index, const std::string& Action,
+                        const size_t Variant) const {
+  std::lock_guard<std::mutex> lk(mtx);
+  for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+    if (it->index == Index && it->action == Action &&
+        it->variant == Variant) {
+      return it->status == 0;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Records completed action (or sweep variant)
+ *
+ * @param Index position of the action in .conf file
+ * @param Action action name
+ * @param Status action return code
+ * @param Passed number of devices that passed
+ * @param Failed number of devices that failed
+ * @param Variant sweep variant index, npos for whole action
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int rvs::journal::complete(const size_t Index, const std::string& Action,
+                           const int Status, const size_t Passed,
+                           const size_t Failed, const size_t Variant) {
+  entry e;
+  e.index = Index;
+  e.action = Action;
+  e.variant = Variant;
+  e.status = Status;
+  e.passed = Passed;
+  e.failed = Failed;
+
+  std::lock_guard<std::mutex> lk(mtx);
+  entries.push_back(e);
+  if (save()) {
+    string msg = "could not write journal: " + file_name;
+    rvs::logger::Err(msg.c_str(), MODULE_NAME_CAPS);
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * @brief Checks if journal continues interrupted run
+ *
+ * Completed work is skipped only when resuming, otherwise every action is
+ * run even if journal already records it (e.g. listed twice in .conf file).
+ *
+ * @return true if opened with --resume
+ *
+ */
+bool rvs::journal::resuming() const {
+  std::lock_guard<std::mutex> lk(mtx);
+  return resume;
+}
+
+/**
+ * @brief Returns number of records
+ *
+ */
+size_t rvs::journal::size() const {
+  std::lock_guard<std::mutex> lk(mtx);
+  return entries.size();
+}
+
+/**
+ * @brief Returns journal file name
+ *
+ */
+const std::string& rvs::journal::path() const {
+  return file_name;
+}
@@ -0,0 +1,118 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+
+#include <iostream>
+#include <string>
+
+#include "include/rvslogcat.h"
+
+using std::cout;
+using std::cerr;
+
+//! Prints help
+static void do_help() {
+  cout << "\nUsage: rvs-logcat [options] <binary log file>\n";
+  cout << "\nConverts binary log written by 'rvs --binaryLog' into text or "
+          "JSON log.\n";
+  cout << "\nOptions:\n\n";
+  cout << "-j --json          Output should use the JSON format.\n";
+  cout << "   --jsonl         Output should use the JSON Lines format: one "
+                              "JSON record per line.\n";
+  cout << "   --compactJson   Output each JSON record on a single line "
+                              "without indentation.\n";
+  cout << "-o --output        Output file name. Default is standard "
+                              "output.\n";
+  cout << "-h --help          Display usage information and exit.\n";
+}
+
+/**
+ *
+ * @ingroup Launcher
+ * @brief Main method of rvs-logcat utility
+ *
+ * @param Argc standard C argc parameter to main()
+ * @param Argv standard C argv parameter to main()
+ * @return 0 - all OK, non-zero error
+ *
+ * */
+int main(int Argc, char**Argv) {
+  rvs::LogCat::eformat format = rvs::LogCat::text;
+  std::string in_file;
+  std::string out_file;
+
+  for (int i = 1; i < Argc; i++) {
+    std::string arg(Argv[i]);
+    if (arg == "-j" || arg == "--json") {
+      format = rvs::LogCat::json;
+    } else if (arg == "--jsonl") {
+      format = rvs::LogCat::jsonl;
+    } else if (arg == "--compactJson") {
+      format = rvs::LogCat::compact;
+    } else if ((arg == "-o" || arg == "--output") && i + 1 < Argc) {
+      out_file = Argv[++i];
+    } else if (arg == "-h" || arg == "--help") {
+      do_help();
+      return 0;
+    } else if (arg[0] != '-' && in_file.empty()) {
+      in_file = arg;
+    } else {
+      cerr << "rvs-logcat: invalid option: " << arg << "\n";
+      do_help();
+      return -1;
+    }
+  }
+
+  if (in_file.empty()) {
+    do_help();
+    return -1;
+  }
+
+  int fd = STDOUT_FILENO;
+  if (!out_file.empty()) {
+    fd = open(out_file.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+              0644);
+    if (fd < 0) {
+      cerr << "rvs-logcat: could not open " << out_file << ": "
+           << strerror(errno) << "\n";
+      return -1;
+    }
+  }
+
+  rvs::LogCat logcat(format, fd);
+  int sts = logcat.convert(in_file);
+  if (sts) {
+    cerr << "rvs-logcat: could not convert " << in_file << "\n";
+  }
+
+  if (fd != STDOUT_FILENO) {
+    close(fd);
+  }
+
+  return sts ? -1 : 0;
+}
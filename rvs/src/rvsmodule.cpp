@@ -37,15 +37,20 @@
 #include "include/rvsliblogger.h"
 #include "include/rvsif0.h"
 #include "include/rvsif1.h"
+#include "include/rvsif2.h"
 #include "include/rvsaction.h"
 #include "include/rvsliblog.h"
 #include "include/rvsoptions.h"
+#include "include/rvsprofiler.h"
 
 #define MODULE_NAME_CAPS "CLI"
 
 std::map<std::string, rvs::module*> rvs::module::modulemap;
 std::map<std::string, std::string>  rvs::module::filemap;
 YAML::Node rvs::module::config;
+std::mutex rvs::module::module_mutex;
+std::map<std::string, void*> rvs::module::shared_objects;
+std::mutex rvs::module::shared_mutex;
 
 using std::string;
 
@@ -90,7 +95,9 @@ int rvs::module::initialize(const char* pConfig) {
   }
 
   // load list of supported modules from config file
+  int prof = rvs::profiler::begin("module config load");
   YAML::Node config = YAML::LoadFile(pConfig);
+  rvs::profiler::end(prof);
 
   // verify that that the file format is supported
   YAML::const_iterator it = config.begin();
@@ -127,6 +134,29 @@ int rvs::module::initialize(const char* pConfig) {
   return 0;
 }
 
+/**
+ * @brief Loads and initializes all modules listed in configuration
+ *
+ * Normally modules are loaded on first use. Resident (--serve) mode loads
+ * them upfront so that runtimes initialized by modules are shared by all
+ * jobs.
+ *
+ * @return number of modules which could not be loaded
+ *
+ */
+int rvs::module::load_all() {
+  std::lock_guard<std::mutex> lk(module_mutex);
+
+  int failed = 0;
+  for (auto it = filemap.begin(); it != filemap.end(); ++it) {
+    if (!find_create_module(it->first.c_str())) {
+      failed++;
+    }
+  }
+
+  return failed;
+}
+
 /**
  * @brief Given module name, return pointer to module instance
  *
@@ -168,7 +198,9 @@ rvs::module* rvs::module::find_create_module(const char* name) {
       libpath += "/";
     }
     string sofullname(libpath + it->second);
+    int prof = rvs::profiler::begin("dlopen", name);
     void* psolib = dlopen(sofullname.c_str(), RTLD_NOW);
+    rvs::profiler::end(prof);
 
     // error?
     if (!psolib) {
@@ -190,7 +222,10 @@ rvs::module* rvs::module::find_create_module(const char* name) {
     }
 
     // initialize API function pointers
-    if (m->init_interfaces()) {
+    prof = rvs::profiler::begin("init_interfaces", name);
+    int sts = m->init_interfaces();
+    rvs::profiler::end(prof);
+    if (sts) {
       char buff[1024];
       snprintf(buff, sizeof(buff),
                "could not init interfaces for '%s'", it->second.c_str());
@@ -201,7 +236,10 @@ rvs::module* rvs::module::find_create_module(const char* name) {
     }
 
     // initialize newly loaded module
-    if (m->initialize()) {
+    prof = rvs::profiler::begin("rvs_module_init", name);
+    sts = m->initialize();
+    rvs::profiler::end(prof);
+    if (sts) {
       char buff[1024];
       snprintf(buff, sizeof(buff),
                "could not initialize '%s'", it->second.c_str());
@@ -243,11 +281,43 @@ int rvs::module::initialize() {
   d.cbStop            = rvs::logger::Stop;
   d.cbStopping        = rvs::logger::Stopping;
   d.cbErr             = rvs::logger::Err;
+  d.pLogLevel         = rvs::logger::log_level_ptr();
+  d.cbAddInt64        = rvs::logger::AddInt64;
+  d.cbAddUint64       = rvs::logger::AddUint64;
+  d.cbAddDouble       = rvs::logger::AddDouble;
+  d.cbAddBool         = rvs::logger::AddBool;
+  d.cbAddInt64Array   = rvs::logger::AddInt64Array;
+  d.cbAddUint64Array  = rvs::logger::AddUint64Array;
+  d.cbAddDoubleArray  = rvs::logger::AddDoubleArray;
+  d.cbPhaseBegin      = rvs::profiler::PhaseBegin;
+  d.cbPhaseEnd        = rvs::profiler::PhaseEnd;
+  d.cbShared          = rvs::module::shared;
 
   return (*rvs_module_init)(reinterpret_cast<void*>(&d));
 }
 
 
+/**
+ * @brief Get object shared by all modules
+ *
+ * Passed to modules through T_MODULE_INIT. Object is created on first
+ * request by the requesting module and kept until the process exits.
+ *
+ * @param Name object name
+ * @param Create function creating the object
+ * @return object, nullptr if it could not be created
+ *
+ */
+void* rvs::module::shared(const char* Name, void* (*Create)(void)) {
+  std::lock_guard<std::mutex> lk(shared_mutex);
+  auto it = shared_objects.find(Name);
+  if (it == shared_objects.end()) {
+    it = shared_objects.emplace(Name, (*Create)()).first;
+  }
+  return it->second;
+}
+
+
 /**
  * @brief Given module name, create module action
  *
@@ -256,6 +326,9 @@ int rvs::module::initialize() {
  *
  */
 rvs::action* rvs::module::action_create(const char* name) {
+  // actions may be created from concurrently running scheduler threads
+  std::lock_guard<std::mutex> lk(module_mutex);
+
   // find module
   rvs::module* m = module::find_create_module(name);
   if (!m) {
@@ -321,6 +394,8 @@ void* rvs::module::action_create() {
  *
  */
 int rvs::module::action_destroy(rvs::action* paction) {
+  std::lock_guard<std::mutex> lk(module_mutex);
+
   // find module
   rvs::module* m = module::find_create_module(paction->name.c_str());
   if (!m)
@@ -429,6 +504,13 @@ int rvs::module::init_interfaces() {
     --sts;
   }
 
+  // IF2 is optional, launcher falls back to IF1 if not available
+  if ((*rvs_module_has_interface)(2)) {
+    if (init_interface_2()) {
+      --sts;
+    }
+  }
+
   return sts;
 }
 
@@ -496,6 +578,14 @@ int rvs::module::init_interface_0(void) {
                             "rvs_module_get_output"))
     sts--;
 
+  // property schema is optional
+  pif0->rvs_module_get_schema = reinterpret_cast<t_rvs_module_get_schema>(
+    dlsym(psolib, "rvs_module_get_schema"));
+
+  // re-entrancy declaration is optional
+  pif0->rvs_module_is_reentrant = reinterpret_cast<t_rvs_module_is_reentrant>(
+    dlsym(psolib, "rvs_module_is_reentrant"));
+
   if (sts) {
     delete pif0;
     return sts;
@@ -548,6 +638,42 @@ int rvs::module::init_interface_1(void) {
   return 0;
 }
 
+/**
+ * @brief Init RVS IF2 interfaces
+ *
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int rvs::module::init_interface_2(void) {
+  rvs::if2* pif2 = new rvs::if2();
+  if (!pif2)
+    return -1;
+
+  int sts = 0;
+
+  pif2->rvs_module_has_interface = rvs_module_has_interface;
+
+  if (init_interface_method(
+    reinterpret_cast<void**>(&(pif2->rvs_module_action_configure)),
+                            "rvs_module_action_configure"))
+    sts--;
+
+  if (init_interface_method(
+    reinterpret_cast<void**>(&(pif2->rvs_module_action_execute)),
+                            "rvs_module_action_execute"))
+    sts--;
+
+  if (sts) {
+    delete pif2;
+    return sts;
+  }
+
+  std::shared_ptr<rvs::ifbase> sptr((rvs::ifbase*)pif2);
+  ifmap.insert(rvs::action::t_impair(2, sptr));
+
+  return 0;
+}
+
 /**
  * @brief Lists available modules
  *
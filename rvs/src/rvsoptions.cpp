@@ -29,6 +29,8 @@
 #include <string>
 
 std::map<std::string, std::string> rvs::options::opt;
+thread_local const std::map<std::string, std::string>*
+  rvs::options::scope_m = nullptr;
 
 /**
  * @brief Check and retrieve option.
@@ -39,8 +41,9 @@ std::map<std::string, std::string> rvs::options::opt;
  *
  */
 bool  rvs::options::has_option(const std::string& Option, std::string* pval) {
-  auto it = opt.find(std::string(Option));
-  if (it == opt.end())
+  const std::map<std::string, std::string>& o = get();
+  auto it = o.find(std::string(Option));
+  if (it == o.end())
     return false;
 
   *pval = it->second;
@@ -55,8 +58,9 @@ bool  rvs::options::has_option(const std::string& Option, std::string* pval) {
  *
  */
 bool  rvs::options::has_option(const std::string& Option) {
-  auto it = opt.find(std::string(Option));
-  if (it == opt.end())
+  const std::map<std::string, std::string>& o = get();
+  auto it = o.find(std::string(Option));
+  if (it == o.end())
     return false;
 
   return true;
@@ -69,7 +73,33 @@ bool  rvs::options::has_option(const std::string& Option) {
  *
  */
 const std::map<std::string, std::string>& rvs::options::get(void) {
-  return opt;
+  return scope_m ? *scope_m : opt;
+}
+
+/**
+ * @brief Set options for current thread
+ *
+ * Used when several jobs with different command line options run in one
+ * process. Options in pScope are used instead of the process wide
+ * collection by all calls made from current thread.
+ *
+ * @param pScope options for current thread, nullptr to revert to process
+ * wide options
+ *
+ */
+void rvs::options::set_scope(
+  const std::map<std::string, std::string>* pScope) {
+  scope_m = pScope;
+}
+
+/**
+ * @brief Get options set for current thread
+ *
+ * @return options set by set_scope(), nullptr if none
+ *
+ */
+const std::map<std::string, std::string>* rvs::options::scope(void) {
+  return scope_m;
 }
 
 
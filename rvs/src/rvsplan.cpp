@@ -0,0 +1,590 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvsplan.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "include/rvsliblogger.h"
+#include "include/rvsoptions.h"
+#include "include/rvsscheduler.h"
+#include "include/rvssweep.h"
+#include "include/rvs_util.h"
+
+#define MODULE_NAME_CAPS "CLI"
+
+//! properties handled by launcher or common to all modules
+#define RVS_PLAN_COMMON_SCHEMA "name:string;module:string;device:device;" \
+  "deviceid:int;parallel:bool;count:int;wait:int;duration:int;" \
+  "log_interval:int;group:string;weight:float;min_duration:int"
+
+using std::string;
+
+//! Default constructor
+rvs::plan::plan() {
+}
+
+//! Default destructor
+rvs::plan::~plan() {
+}
+
+/**
+ * @brief Validates all actions and builds execution plan
+ *
+ * @param Actions "actions" node from .conf file
+ * @param Schema provider of module property schemas
+ * @param Gpus IDs of GPUs present in the system (empty - not checked)
+ * @return number of errors found
+ *
+ */
+int rvs::plan::build(const YAML::Node& Actions, t_schema Schema,
+                     const std::vector<uint16_t>& Gpus) {
+  plan_steps.clear();
+  plan_errors.clear();
+  plan_warnings.clear();
+  schemas.clear();
+  strict.clear();
+  broken.clear();
+
+  if (!Actions.IsSequence() || Actions.size() == 0) {
+    error("", "no actions found");
+    return plan_errors.size();
+  }
+
+  if (Gpus.empty()) {
+    warning("", "no GPUs found, device selections not checked");
+  }
+
+  std::map<string, size_t> names;
+  for (YAML::const_iterator it = Actions.begin(); it != Actions.end(); ++it) {
+    const YAML::Node& action = *it;
+    if (!action.IsMap()) {
+      error("", "action #" + std::to_string(plan_steps.size() + 1) +
+                " is not a map of properties");
+      continue;
+    }
+    build_action(action, Schema, Gpus);
+    const string& name = plan_steps.back().name;
+    if (names[name]++ == 1) {
+      warning(name, "action name used more than once");
+    }
+  }
+
+  // execution graph errors are reported by scheduler itself
+  if (rvs::scheduler::is_scheduled(Actions)) {
+    rvs::scheduler sched;
+    if (sched.build(Actions)) {
+      error("", "invalid 'group'/'depends_on' execution order");
+    }
+  }
+
+  return plan_errors.size();
+}
+
+/**
+ * @brief Validates single action and appends it to the plan
+ *
+ * @param Action action node from .conf file
+ * @param Schema provider of module property schemas
+ * @param Gpus IDs of GPUs present in the system
+ *
+ */
+void rvs::plan::build_action(const YAML::Node& Action, t_schema Schema,
+                             const std::vector<uint16_t>& Gpus) {
+  step s;
+  s.variants = 1;
+  s.estimate = -1;
+
+  try {
+    s.name = Action["name"].as<string>();
+  } catch(...) {
+    s.name = "#" + std::to_string(plan_steps.size() + 1);
+    error(s.name, "action does not specify name");
+  }
+  try {
+    s.module = Action["module"].as<string>();
+  } catch(...) {
+  }
+  plan_steps.push_back(s);
+  step& ps = plan_steps.back();
+
+  if (ps.module.empty()) {
+    error(ps.name, "action does not specify module");
+    return;
+  }
+
+  // load module schema once per module
+  if (schemas.find(ps.module) == schemas.end() &&
+      broken.find(ps.module) == broken.end()) {
+    string text;
+    if (Schema(ps.module, &text)) {
+      broken[ps.module] = 1;
+    } else {
+      t_rules rules;
+      parse_schema(RVS_PLAN_COMMON_SCHEMA, &rules);
+      if (parse_schema(text, &rules)) {
+        warning(ps.name, "module '" + ps.module +
+                "' declares invalid property schema");
+      }
+      schemas[ps.module] = rules;
+      strict[ps.module] = !text.empty();
+    }
+  }
+  if (broken.find(ps.module) != broken.end()) {
+    error(ps.name, "module '" + ps.module + "' could not be loaded");
+    return;
+  }
+  const t_rules& rules = schemas[ps.module];
+  bool is_strict = strict[ps.module];
+
+  for (YAML::const_iterator it = Action.begin(); it != Action.end(); ++it) {
+    string key = it->first.as<string>();
+    if (key == "depends_on") {
+      continue;
+    }
+    if (key == "sweep") {
+      check_sweep(ps.name, rules, is_strict, it->second, &ps.variants);
+      continue;
+    }
+    check_property(ps.name, rules, is_strict, key, it->second);
+  }
+
+  // -i command line option replaces device selection of all actions
+  string device;
+  string indexes;
+  if (rvs::options::has_option("-i", &indexes) && !indexes.empty()) {
+    std::replace(indexes.begin(), indexes.end(), ',', ' ');
+    device = indexes;
+  } else if (Action["device"] && Action["device"].IsScalar()) {
+    device = Action["device"].as<string>();
+  }
+  if (!device.empty()) {
+    resolve_devices(ps.name, device, Gpus, &ps.devices);
+  }
+
+  // estimate execution time
+  uint64_t duration = 0;
+  uint64_t wait = 0;
+  uint64_t count = 1;
+  bool known = false;
+  if (Action["duration"] && Action["duration"].IsScalar() &&
+      is_positive_integer(Action["duration"].as<string>())) {
+    duration = std::stoull(Action["duration"].as<string>());
+    known = true;
+  }
+  if (Action["wait"] && Action["wait"].IsScalar() &&
+      is_positive_integer(Action["wait"].as<string>())) {
+    wait = std::stoull(Action["wait"].as<string>());
+  }
+  if (Action["count"] && Action["count"].IsScalar() &&
+      is_positive_integer(Action["count"].as<string>())) {
+    count = std::stoull(Action["count"].as<string>());
+  }
+  // count 0 means "run until stopped"
+  if (known && count > 0) {
+    ps.estimate = static_cast<double>(duration + wait) * count * ps.variants;
+  }
+}
+
+/**
+ * @brief Validates single property of an action
+ *
+ * @param Action action name
+ * @param Rules property rules of the module
+ * @param Strict report properties not found in Rules
+ * @param Key property name
+ * @param Value property value
+ *
+ */
+void rvs::plan::check_property(const std::string& Action,
+                               const t_rules& Rules, bool Strict,
+                               const std::string& Key,
+                               const YAML::Node& Value) {
+  auto it = Rules.find(Key);
+  if (it == Rules.end()) {
+    if (Strict) {
+      warning(Action, "unknown property '" + Key + "'");
+    }
+    // whatever it is, it still has to be passed to module as string
+    if (!Value.IsScalar() && !Value.IsNull()) {
+      error(Action, "property '" + Key + "' is not a single value");
+    }
+    return;
+  }
+
+  if (it->second.type == "collection") {
+    if (!Value.IsMap() && !Value.IsNull()) {
+      error(Action, "property '" + Key + "' is not a collection");
+    }
+    return;
+  }
+
+  if (!Value.IsScalar()) {
+    error(Action, "property '" + Key + "' is not a single value");
+    return;
+  }
+
+  string why;
+  if (!check_value(it->second, Value.as<string>(), &why)) {
+    error(Action, "property '" + Key + "': " + why);
+  }
+}
+
+/**
+ * @brief Validates "sweep" key of an action
+ *
+ * @param Action action name
+ * @param Rules property rules of the module
+ * @param Strict report properties not found in Rules
+ * @param Sweep "sweep" node of the action
+ * @param Variants [out] number of parameter variants
+ *
+ */
+void rvs::plan::check_sweep(const std::string& Action, const t_rules& Rules,
+                            bool Strict, const YAML::Node& Sweep,
+                            size_t* Variants) {
+  rvs::sweep sw;
+  if (sw.build(Sweep)) {
+    error(Action, "invalid 'sweep' key");
+    return;
+  }
+  *Variants = sw.size();
+
+  for (YAML::const_iterator it = Sweep.begin(); it != Sweep.end(); ++it) {
+    string key = it->first.as<string>();
+    if (key == "mode" || key == "metric" || key == "output") {
+      continue;
+    }
+    auto r = Rules.find(key);
+    if (r == Rules.end()) {
+      if (Strict) {
+        warning(Action, "sweep of unknown property '" + key + "'");
+      }
+      continue;
+    }
+    for (size_t i = 0; i < it->second.size(); i++) {
+      string why;
+      if (!check_value(r->second, it->second[i].as<string>(), &why)) {
+        error(Action, "sweep of property '" + key + "': " + why);
+      }
+    }
+  }
+}
+
+/**
+ * @brief Resolves device selection against GPUs present in the system
+ *
+ * @param Action action name
+ * @param Device value of "device" key
+ * @param Gpus IDs of GPUs present in the system (empty - not checked)
+ * @param Devices [out] selected GPUs
+ * @return 0 if successful, non-zero otherwise
+ *
+ */
+int rvs::plan::resolve_devices(const std::string& Action,
+                               const std::string& Device,
+                               const std::vector<uint16_t>& Gpus,
+                               std::vector<uint16_t>* Devices) {
+  if (Device == "all") {
+    *Devices = Gpus;
+    return 0;
+  }
+
+  int sts = 0;
+  std::vector<string> ids = str_split(Device, " ");
+  for (auto it = ids.begin(); it != ids.end(); ++it) {
+    if (!is_positive_integer(*it) || it->size() > 5 ||
+        std::stoul(*it) > 0xFFFF) {
+      // already reported as property error
+      sts = -1;
+      continue;
+    }
+    uint16_t id = static_cast<uint16_t>(std::stoul(*it));
+    if (!Gpus.empty() &&
+        std::find(Gpus.begin(), Gpus.end(), id) == Gpus.end()) {
+      error(Action, "GPU ID " + *it + " not present in the system");
+      sts = -1;
+      continue;
+    }
+    Devices->push_back(id);
+  }
+
+  return sts;
+}
+
+/**
+ * @brief Parses module property schema
+ *
+ * Rules already present in the map are replaced by those from Text.
+ *
+ * @param Text schema as returned by rvs_module_get_schema()
+ * @param Rules [out] property rules
+ * @return 0 if successful, non-zero if some entry is malformed
+ *
+ */
+int rvs::plan::parse_schema(const std::string& Text, t_rules* Rules) {
+  static const char* types[] = {
+    "int", "float", "bool", "string", "list", "device", "collection"
+  };
+
+  int sts = 0;
+  std::vector<string> entries = str_split(Text, ";");
+  for (auto it = entries.begin(); it != entries.end(); ++it) {
+    size_t colon = it->find(':');
+    if (colon == string::npos || colon == 0) {
+      sts = -1;
+      continue;
+    }
+    rule r;
+    string key = it->substr(0, colon);
+    r.type = it->substr(colon + 1);
+    size_t eq = r.type.find('=');
+    if (eq != string::npos) {
+      r.choices = str_split(r.type.substr(eq + 1), "|");
+      r.type = r.type.substr(0, eq);
+    }
+    if (std::find(std::begin(types), std::end(types), r.type) ==
+        std::end(types)) {
+      sts = -1;
+      continue;
+    }
+    (*Rules)[key] = r;
+  }
+
+  return sts;
+}
+
+/**
+ * @brief Checks property value against its rule
+ *
+ * @param Rule property rule
+ * @param Value property value
+ * @param Why [out] reason if value is not valid
+ * @return true if value is valid
+ *
+ */
+bool rvs::plan::check_value(const rule& Rule, const std::string& Value,
+                            std::string* Why) {
+  if (!Rule.choices.empty()) {
+    if (std::find(Rule.choices.begin(), Rule.choices.end(), Value) ==
+        Rule.choices.end()) {
+      string allowed;
+      for (auto it = Rule.choices.begin(); it != Rule.choices.end(); ++it) {
+        allowed += (allowed.empty() ? "" : ", ") + *it;
+      }
+      *Why = "'" + Value + "' is not one of: " + allowed;
+      return false;
+    }
+    return true;
+  }
+
+  if (Rule.type == "int") {
+    if (!is_positive_integer(Value)) {
+      *Why = "'" + Value + "' is not a non-negative integer";
+      return false;
+    }
+  } else if (Rule.type == "float") {
+    size_t pos = 0;
+    try {
+      std::stod(Value, &pos);
+    } catch(...) {
+    }
+    if (pos == 0 || pos != Value.size()) {
+      *Why = "'" + Value + "' is not a number";
+      return false;
+    }
+  } else if (Rule.type == "bool") {
+    if (Value != "true" && Value != "false") {
+      *Why = "'" + Value + "' is not 'true' or 'false'";
+      return false;
+    }
+  } else if (Rule.type == "list" || Rule.type == "device") {
+    if (Rule.type == "device" && Value == "all") {
+      return true;
+    }
+    string list(Value);
+    std::replace(list.begin(), list.end(), ',', ' ');
+    std::vector<string> items = str_split(list, " ");
+    if (items.empty()) {
+      *Why = "empty list";
+      return false;
+    }
+    for (auto it = items.begin(); it != items.end(); ++it) {
+      if (!is_positive_integer(*it)) {
+        *Why = "'" + Value + "' is not a list of non-negative integers";
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+//! Returns planned actions in .conf file order
+const std::vector<rvs::plan::step>& rvs::plan::steps() const {
+  return plan_steps;
+}
+
+//! Returns errors found
+const std::vector<std::string>& rvs::plan::errors() const {
+  return plan_errors;
+}
+
+//! Returns warnings found
+const std::vector<std::string>& rvs::plan::warnings() const {
+  return plan_warnings;
+}
+
+/**
+ * @brief Estimated execution time of all actions run one after another
+ *
+ * @return time in ms, actions with unknown duration excluded
+ *
+ */
+double rvs::plan::estimate() const {
+  double total = 0;
+  for (auto it = plan_steps.begin(); it != plan_steps.end(); ++it) {
+    if (it->estimate > 0) {
+      total += it->estimate;
+    }
+  }
+  return total;
+}
+
+/**
+ * @brief Formats plan as text table
+ *
+ * @return one line per action preceded by header and followed by total
+ *
+ */
+std::string rvs::plan::table() const {
+  std::ostringstream os;
+  char buff[256];
+  snprintf(buff, sizeof(buff), "%-24s %-8s %-20s %8s %12s\n",
+           "action", "module", "devices", "variants", "estimate");
+  os << buff;
+
+  size_t unknown = 0;
+  for (auto it = plan_steps.begin(); it != plan_steps.end(); ++it) {
+    string devices;
+    for (auto d = it->devices.begin(); d != it->devices.end(); ++d) {
+      devices += (devices.empty() ? "" : ",") + std::to_string(*d);
+    }
+    if (devices.empty()) {
+      devices = "-";
+    }
+    string est("?");
+    if (it->estimate >= 0) {
+      snprintf(buff, sizeof(buff), "%.1f s", it->estimate / 1000);
+      est = buff;
+    } else {
+      unknown++;
+    }
+    snprintf(buff, sizeof(buff), "%-24s %-8s %-20s %8zu %12s\n",
+             it->name.c_str(), it->module.c_str(), devices.c_str(),
+             it->variants, est.c_str());
+    os << buff;
+  }
+
+  snprintf(buff, sizeof(buff), "estimated total: %.1f s", estimate() / 1000);
+  os << buff;
+  if (unknown) {
+    os << " + " << unknown << " action(s) of unknown duration";
+  }
+  os << "\n";
+
+  return os.str();
+}
+
+/**
+ * @brief Logs plan, warnings and errors
+ *
+ * Plan is logged at info level, warnings as results and errors as errors.
+ * Plan is also emitted as JSON record.
+ *
+ */
+void rvs::plan::report() const {
+  std::istringstream is(table());
+  string line;
+  while (std::getline(is, line)) {
+    rvs::logger::log("plan " + line, rvs::loginfo);
+  }
+  for (auto it = plan_warnings.begin(); it != plan_warnings.end(); ++it) {
+    rvs::logger::log("plan warning: " + *it, rvs::logresults);
+  }
+  for (auto it = plan_errors.begin(); it != plan_errors.end(); ++it) {
+    rvs::logger::Err(("plan: " + *it).c_str(), MODULE_NAME_CAPS);
+  }
+
+  uint32_t sec;
+  uint32_t usec;
+  rvs::logger::get_ticks(&sec, &usec);
+  void* r = rvs::logger::LogRecordCreate("CLI", "plan", rvs::loginfo,
+                                         sec, usec);
+  for (size_t i = 0; i < plan_steps.size(); i++) {
+    const step& s = plan_steps[i];
+    void* n = rvs::logger::CreateNode(r, std::to_string(i).c_str());
+    rvs::logger::AddString(n, "name", s.name.c_str());
+    rvs::logger::AddString(n, "module", s.module.c_str());
+    rvs::logger::AddUint64(n, "devices", s.devices.size());
+    rvs::logger::AddUint64(n, "variants", s.variants);
+    rvs::logger::AddDouble(n, "estimate (ms)", s.estimate);
+    rvs::logger::AddNode(r, n);
+  }
+  rvs::logger::AddUint64(r, "errors", plan_errors.size());
+  rvs::logger::AddUint64(r, "warnings", plan_warnings.size());
+  rvs::logger::LogRecordFlush(r);
+}
+
+/**
+ * @brief Records error
+ *
+ * @param Action action name ("" - whole .conf file)
+ * @param Message error description
+ *
+ */
+void rvs::plan::error(const std::string& Action, const std::string& Message) {
+  plan_errors.push_back(Action.empty() ? Message
+                                       : "[" + Action + "] " + Message);
+}
+
+/**
+ * @brief Records warning
+ *
+ * @param Action action name ("" - whole .conf file)
+ * @param Message warning description
+ *
+ */
+void rvs::plan::warning(const std::string& Action,
+                        const std::string& Message) {
+  plan_warnings.push_back(Action.empty() ? Message
+                                         : "[" + Action + "] " + Message);
+}
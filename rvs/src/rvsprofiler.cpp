@@ -0,0 +1,300 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvsprofiler.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "include/rvsliblogger.h"
+
+#define MODULE_NAME_CAPS "CLI"
+
+using std::string;
+
+namespace {
+
+//! time all phases are measured from (taken before main() is entered)
+const std::chrono::steady_clock::time_point origin =
+  std::chrono::steady_clock::now();
+
+}  // namespace
+
+bool rvs::profiler::enabled_m = false;
+std::vector<rvs::profiler::phase> rvs::profiler::phases;
+std::mutex rvs::profiler::mtx;
+thread_local std::vector<int> rvs::profiler::open;
+
+/**
+ * @brief Enable or disable recording of phases
+ *
+ * @param flag new value
+ *
+ */
+void rvs::profiler::enable(const bool flag) {
+  enabled_m = flag;
+}
+
+/**
+ * @brief Check if phases are recorded
+ *
+ * @return 'true' if enabled
+ *
+ */
+bool rvs::profiler::enabled() {
+  return enabled_m;
+}
+
+/**
+ * @brief Get current time
+ *
+ * @return time in ns since process start
+ *
+ */
+int64_t rvs::profiler::now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now() - origin).count();
+}
+
+/**
+ * @brief Start timing phase
+ *
+ * Module and action not given are taken over from the enclosing phase
+ * open on current thread.
+ *
+ * @param Phase phase name
+ * @param Module module name
+ * @param Action action name
+ * @return phase ID to be passed to end(), -1 if not enabled
+ *
+ */
+int rvs::profiler::begin(const std::string& Phase, const std::string& Module,
+                         const std::string& Action) {
+  if (!enabled_m) {
+    return -1;
+  }
+
+  phase p;
+  p.name = Phase;
+  p.module = Module;
+  p.action = Action;
+  p.depth = static_cast<int>(open.size());
+  p.end = -1;
+
+  std::lock_guard<std::mutex> lk(mtx);
+  if (!open.empty()) {
+    const phase& parent = phases[open.back()];
+    if (p.module.empty()) {
+      p.module = parent.module;
+    }
+    if (p.action.empty()) {
+      p.action = parent.action;
+    }
+  }
+
+  int id = static_cast<int>(phases.size());
+  open.push_back(id);
+  p.start = now();
+  phases.push_back(p);
+
+  return id;
+}
+
+/**
+ * @brief Stop timing phase
+ *
+ * @param Id phase ID returned by begin()
+ *
+ */
+void rvs::profiler::end(const int Id) {
+  if (Id < 0) {
+    return;
+  }
+
+  int64_t t = now();
+  std::lock_guard<std::mutex> lk(mtx);
+  if (static_cast<size_t>(Id) >= phases.size()) {
+    return;
+  }
+  phases[Id].end = t;
+
+  // phases left open inside this one are closed with it
+  while (!open.empty()) {
+    int last = open.back();
+    open.pop_back();
+    if (last == Id) {
+      break;
+    }
+  }
+}
+
+/**
+ * @brief Record phase timed before profiler could be enabled
+ *
+ * @param Phase phase name
+ * @param Start start time as returned by now()
+ * @param End end time as returned by now()
+ *
+ */
+void rvs::profiler::record(const std::string& Phase, const int64_t Start,
+                           const int64_t End) {
+  if (!enabled_m) {
+    return;
+  }
+
+  phase p;
+  p.name = Phase;
+  p.depth = static_cast<int>(open.size());
+  p.start = Start;
+  p.end = End;
+
+  std::lock_guard<std::mutex> lk(mtx);
+  phases.push_back(p);
+}
+
+/**
+ * @brief Format recorded phases as table
+ *
+ * Times are in ms since process start; nested phases are indented.
+ *
+ * @return table text, one phase per line
+ *
+ */
+std::string rvs::profiler::table() {
+  std::lock_guard<std::mutex> lk(mtx);
+  char buff[512];
+  string out;
+
+  snprintf(buff, sizeof(buff), "%10s %10s  %-28s %-10s %s\n",
+           "start (ms)", "time (ms)", "phase", "module", "action");
+  out += buff;
+
+  // phases recorded with record() may be out of order
+  std::vector<phase> sorted(phases);
+  std::stable_sort(sorted.begin(), sorted.end(),
+                   [](const phase& A, const phase& B) {
+    return A.start < B.start;
+  });
+
+  for (auto it = sorted.begin(); it != sorted.end(); ++it) {
+    string name = string(2 * it->depth, ' ') + it->name;
+    if (it->end < 0) {
+      snprintf(buff, sizeof(buff), "%10.3f %10s  %-28s %-10s %s",
+               it->start / 1e6, "-", name.c_str(), it->module.c_str(),
+               it->action.c_str());
+    } else {
+      snprintf(buff, sizeof(buff), "%10.3f %10.3f  %-28s %-10s %s",
+               it->start / 1e6, (it->end - it->start) / 1e6, name.c_str(),
+               it->module.c_str(), it->action.c_str());
+    }
+    string row(buff);
+    row.erase(row.find_last_not_of(' ') + 1);
+    out += row + '\n';
+  }
+
+  return out;
+}
+
+/**
+ * @brief Output recorded phases
+ *
+ * Prints phase table to console (unless in quiet mode) and emits it as
+ * log record with one node per phase.
+ *
+ */
+void rvs::profiler::report() {
+  if (!enabled_m) {
+    return;
+  }
+
+  if (!rvs::logger::is_quiet()) {
+    std::cout << "\nStartup profile:\n" << table() << std::endl;
+  }
+
+  uint32_t sec;
+  uint32_t usec;
+  rvs::logger::get_ticks(&sec, &usec);
+  void* r = rvs::logger::LogRecordCreate(MODULE_NAME_CAPS, "profile",
+                                         rvs::logresults, sec, usec);
+
+  std::lock_guard<std::mutex> lk(mtx);
+  for (size_t i = 0; i < phases.size(); i++) {
+    const phase& p = phases[i];
+    void* n = rvs::logger::CreateNode(r, std::to_string(i).c_str());
+    rvs::logger::AddString(n, "phase", p.name.c_str());
+    if (!p.module.empty()) {
+      rvs::logger::AddString(n, "module", p.module.c_str());
+    }
+    if (!p.action.empty()) {
+      rvs::logger::AddString(n, "action", p.action.c_str());
+    }
+    rvs::logger::AddInt(n, "depth", p.depth);
+    rvs::logger::AddDouble(n, "start (sec)", p.start / 1e9);
+    if (p.end >= 0) {
+      rvs::logger::AddDouble(n, "duration (sec)", (p.end - p.start) / 1e9);
+    }
+    rvs::logger::AddNode(r, n);
+  }
+  rvs::logger::LogRecordFlush(r);
+}
+
+/**
+ * @brief Discard recorded phases
+ *
+ */
+void rvs::profiler::clear() {
+  std::lock_guard<std::mutex> lk(mtx);
+  phases.clear();
+  open.clear();
+}
+
+/**
+ * @brief Start timing phase reported by module
+ *
+ * Passed to modules through T_MODULE_INIT.
+ *
+ * @param Phase phase name
+ * @return phase ID to be passed to PhaseEnd(), -1 if not enabled
+ *
+ */
+int rvs::profiler::PhaseBegin(const char* Phase) {
+  return begin(Phase ? Phase : "");
+}
+
+/**
+ * @brief Stop timing phase reported by module
+ *
+ * Passed to modules through T_MODULE_INIT.
+ *
+ * @param Id phase ID returned by PhaseBegin()
+ *
+ */
+void rvs::profiler::PhaseEnd(const int Id) {
+  end(Id);
+}
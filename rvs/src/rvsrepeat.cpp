@@ -0,0 +1,222 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvsrepeat.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "include/rvsactionresult.h"
+#include "include/rvsliblogger.h"
+
+using std::string;
+
+//! Default constructor
+rvs::repeatstats::repeatstats() {
+}
+
+//! Default destructor
+rvs::repeatstats::~repeatstats() {
+}
+
+/**
+ * @brief Adds all metrics reported by action in given iteration
+ *
+ * @param Iteration iteration number
+ * @param Action action name
+ * @param Result results reported by the action
+ *
+ */
+void rvs::repeatstats::add(const size_t Iteration, const std::string& Action,
+                           const actionresult& Result) {
+  std::vector<actionresult::metric> m = Result.metrics();
+  for (auto it = m.begin(); it != m.end(); ++it) {
+    add(Iteration, Action, it->gpu_id, it->name, it->value, it->unit);
+  }
+}
+
+/**
+ * @brief Adds single metric value
+ *
+ * @param Iteration iteration number
+ * @param Action action name
+ * @param GpuId GPU ID (0 if not device specific)
+ * @param Metric metric name
+ * @param Value metric value
+ * @param Unit unit of measure
+ *
+ */
+void rvs::repeatstats::add(const size_t Iteration, const std::string& Action,
+                           const uint16_t GpuId, const std::string& Metric,
+                           const double Value, const std::string& Unit) {
+  std::lock_guard<std::mutex> lk(mtx);
+  t_key key(Action, Metric, GpuId);
+  auto it = values.find(key);
+  if (it == values.end()) {
+    order.push_back(key);
+    it = values.insert(std::make_pair(key, series())).first;
+    it->second.unit = Unit;
+  }
+  std::pair<double, size_t>& i = it->second.iterations[Iteration];
+  i.first += Value;
+  i.second++;
+}
+
+/**
+ * @brief Computes statistics of all metrics
+ *
+ * @return statistics in order of first report
+ *
+ */
+std::vector<rvs::repeatstats::stat> rvs::repeatstats::stats() const {
+  std::lock_guard<std::mutex> lk(mtx);
+  std::vector<stat> result;
+
+  for (auto k = order.begin(); k != order.end(); ++k) {
+    const series& s = values.at(*k);
+    stat st;
+    st.action = std::get<0>(*k);
+    st.metric = std::get<1>(*k);
+    st.gpu_id = std::get<2>(*k);
+    st.unit = s.unit;
+    st.count = s.iterations.size();
+
+    std::vector<double> samples;
+    for (auto it = s.iterations.begin(); it != s.iterations.end(); ++it) {
+      samples.push_back(it->second.first / it->second.second);
+    }
+
+    double sum = 0;
+    for (auto it = samples.begin(); it != samples.end(); ++it) {
+      sum += *it;
+    }
+    st.mean = sum / samples.size();
+    double sq = 0;
+    for (auto it = samples.begin(); it != samples.end(); ++it) {
+      sq += (*it - st.mean) * (*it - st.mean);
+    }
+    st.stddev = samples.size() > 1 ? std::sqrt(sq / (samples.size() - 1)) : 0;
+    st.min = *std::min_element(samples.begin(), samples.end());
+    st.max = *std::max_element(samples.begin(), samples.end());
+    st.cov = st.mean != 0 ? 100 * st.stddev / std::fabs(st.mean) : 0;
+
+    result.push_back(st);
+  }
+
+  return result;
+}
+
+/**
+ * @brief Formats statistics as text table
+ *
+ * @param MaxCov CoV threshold in %, metrics above it are marked "NOISY"
+ * @return one line per metric preceded by header
+ *
+ */
+std::string rvs::repeatstats::table(const double MaxCov) const {
+  std::ostringstream os;
+  char buff[512];
+  snprintf(buff, sizeof(buff),
+           "%-20s %-24s %6s %4s %12s %12s %12s %12s %8s\n",
+           "action", "metric", "gpu", "n", "mean", "stddev", "min", "max",
+           "cov %");
+  os << buff;
+
+  std::vector<stat> st = stats();
+  for (auto it = st.begin(); it != st.end(); ++it) {
+    string metric = it->metric;
+    if (!it->unit.empty()) {
+      metric += " (" + it->unit + ")";
+    }
+    snprintf(buff, sizeof(buff),
+             "%-20s %-24s %6u %4zu %12.3f %12.3f %12.3f %12.3f %8.2f%s\n",
+             it->action.c_str(), metric.c_str(), it->gpu_id, it->count,
+             it->mean, it->stddev, it->min, it->max, it->cov,
+             it->count > 1 && it->cov > MaxCov ? " NOISY" : "");
+    os << buff;
+  }
+
+  return os.str();
+}
+
+/**
+ * @brief Logs statistics of all metrics
+ *
+ * Table is logged as results and emitted as JSON record. Metrics whose
+ * CoV exceeds the threshold are also logged separately.
+ *
+ * @param MaxCov CoV threshold in %
+ * @return number of metrics exceeding the threshold
+ *
+ */
+size_t rvs::repeatstats::report(const double MaxCov) const {
+  std::istringstream is(table(MaxCov));
+  string line;
+  while (std::getline(is, line)) {
+    rvs::logger::log("repeat " + line, rvs::logresults);
+  }
+
+  size_t noisy = 0;
+  std::vector<stat> st = stats();
+  uint32_t sec;
+  uint32_t usec;
+  rvs::logger::get_ticks(&sec, &usec);
+  void* r = rvs::logger::LogRecordCreate("CLI", "repeat", rvs::logresults,
+                                         sec, usec);
+  for (size_t i = 0; i < st.size(); i++) {
+    const stat& s = st[i];
+    bool flagged = s.count > 1 && s.cov > MaxCov;
+    if (flagged) {
+      noisy++;
+      char buff[256];
+      snprintf(buff, sizeof(buff),
+               "[%s] repeat NOISY %s on GPU %u varies by %.2f %% over %zu "
+               "runs (limit %.2f %%)", s.action.c_str(), s.metric.c_str(),
+               s.gpu_id, s.cov, s.count, MaxCov);
+      rvs::logger::log(buff, rvs::logresults);
+    }
+
+    void* n = rvs::logger::CreateNode(r, std::to_string(i).c_str());
+    rvs::logger::AddString(n, "action", s.action.c_str());
+    rvs::logger::AddString(n, "metric", s.metric.c_str());
+    rvs::logger::AddString(n, "unit", s.unit.c_str());
+    rvs::logger::AddInt(n, "gpu_id", s.gpu_id);
+    rvs::logger::AddUint64(n, "count", s.count);
+    rvs::logger::AddDouble(n, "mean", s.mean);
+    rvs::logger::AddDouble(n, "stddev", s.stddev);
+    rvs::logger::AddDouble(n, "min", s.min);
+    rvs::logger::AddDouble(n, "max", s.max);
+    rvs::logger::AddDouble(n, "cov", s.cov);
+    rvs::logger::AddBool(n, "noisy", flagged);
+    rvs::logger::AddNode(r, n);
+  }
+  rvs::logger::LogRecordFlush(r);
+
+  return noisy;
+}
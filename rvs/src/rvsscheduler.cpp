@@ -0,0 +1,560 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvsscheduler.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "include/rvsliblogger.h"
+#include "include/rvsoptions.h"
+#include "include/rvs_util.h"
+
+#define MODULE_NAME_CAPS "CLI"
+
+using std::string;
+
+//! Default constructor
+rvs::scheduler::scheduler()
+:
+groups(0),
+remaining(0),
+running(0),
+status(0) {
+}
+
+//! Default destructor
+rvs::scheduler::~scheduler() {
+}
+
+/**
+ * @brief Checks if actions are to be run by the scheduler
+ *
+ * @param Actions "actions" list from .conf file
+ * @return 'true' if any action has "group" or "depends_on" key
+ *
+ */
+bool rvs::scheduler::is_scheduled(const YAML::Node& Actions) {
+  for (YAML::const_iterator it = Actions.begin(); it != Actions.end(); ++it) {
+    if ((*it)["group"] || (*it)["depends_on"]) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * @brief Builds and validates action graph
+ *
+ * @param Actions "actions" list from .conf file
+ * @param Reentrant tells which modules allow concurrent actions (none if
+ * not given)
+ * @return 0 if successful, non-zero otherwise
+ *
+ */
+int rvs::scheduler::build(const YAML::Node& Actions, t_reentrant Reentrant) {
+  char buff[1024];
+  string indexes;
+  bool indexes_provided = rvs::options::has_option("-i", &indexes) &&
+                          !indexes.empty();
+
+  nodes.clear();
+  std::map<string, bool> reentrant;
+
+  for (YAML::const_iterator it = Actions.begin(); it != Actions.end(); ++it) {
+    const YAML::Node& action = *it;
+    node n;
+
+    try {
+      n.name = action["name"].as<string>();
+      n.module = action["module"].as<string>();
+      if (action["group"]) {
+        n.group = action["group"].as<string>();
+      }
+    } catch(...) {
+      snprintf(buff, sizeof(buff),
+               "action #%zu must specify name and module.", nodes.size() + 1);
+      rvs::logger::Err(buff, MODULE_NAME_CAPS);
+      return -1;
+    }
+
+    string device("all");
+    if (indexes_provided) {
+      device = indexes;
+      std::replace(device.begin(), device.end(), ',', ' ');
+    } else if (action["device"]) {
+      device = action["device"].as<string>();
+    }
+    std::vector<string> ids = str_split(device, " ");
+    n.all_devices = ids.empty() ||
+                    std::find(ids.begin(), ids.end(), "all") != ids.end();
+    n.devices.insert(ids.begin(), ids.end());
+
+    auto rit = reentrant.find(n.module);
+    if (rit == reentrant.end()) {
+      rit = reentrant.insert(std::make_pair(n.module,
+        Reentrant ? Reentrant(n.module) : false)).first;
+    }
+    n.reentrant = rit->second;
+
+    n.yaml = action;
+    n.pending = 0;
+    n.seconds = 0;
+    nodes.push_back(n);
+  }
+
+  if (resolve_dependencies() || check_cycles() || check_conflicts()) {
+    return -1;
+  }
+
+  return 0;
+}
+
+/**
+ * @brief Runs all actions
+ *
+ * Actions which are ready are picked up by a pool of threads. After the
+ * first failure no new actions are started, actions already running are
+ * waited for.
+ *
+ * @param Runner function executing single action
+ * @return 0 if successful, status of the first failed action otherwise
+ *
+ */
+int rvs::scheduler::run(t_runner Runner) {
+  auto start = std::chrono::steady_clock::now();
+
+  ready.clear();
+  for (size_t i = 0; i < nodes.size(); i++) {
+    nodes[i].pending = nodes[i].deps.size();
+    if (nodes[i].pending == 0) {
+      ready.push_back(i);
+    }
+  }
+  remaining = nodes.size();
+  running = 0;
+  busy.clear();
+  status = 0;
+
+  // workers see the same command line options as the calling thread
+  const std::map<string, string>* scope = rvs::options::scope();
+
+  std::vector<std::thread> pool;
+  for (size_t i = 0; i < threads(); i++) {
+    pool.push_back(std::thread([this, Runner, scope]() {
+      rvs::options::set_scope(scope);
+      worker(Runner);
+    }));
+  }
+  for (auto it = pool.begin(); it != pool.end(); ++it) {
+    it->join();
+  }
+
+  std::chrono::duration<double> wall =
+    std::chrono::steady_clock::now() - start;
+  double total = 0;
+  for (auto it = nodes.begin(); it != nodes.end(); ++it) {
+    total += it->seconds;
+  }
+
+  char buff[1024];
+  snprintf(buff, sizeof(buff),
+           "[%s] scheduler: %zu actions in %zu groups, wall-clock %.3f s, "
+           "sum of action time %.3f s (speedup %.2fx)", MODULE_NAME_CAPS,
+           nodes.size() - remaining, groups, wall.count(), total,
+           wall.count() > 0 ? total / wall.count() : 1.0);
+  rvs::logger::log(buff, rvs::logresults);
+
+  return status;
+}
+
+/**
+ * @brief Get number of actions
+ *
+ * @return number of actions in the graph
+ *
+ */
+size_t rvs::scheduler::size() const {
+  return nodes.size();
+}
+
+/**
+ * @brief Get number of threads used to run actions
+ *
+ * Actions of the same group never run concurrently, so one thread per group
+ * is enough.
+ *
+ * @return size of thread pool
+ *
+ */
+size_t rvs::scheduler::threads() const {
+  return std::max<size_t>(std::min(groups, nodes.size()), 1);
+}
+
+/**
+ * @brief Checks if action (transitively) depends on another action
+ *
+ * @param Action dependent action name
+ * @param On action name
+ * @return 'true' if Action can only start after On completes
+ *
+ */
+bool rvs::scheduler::depends(const string& Action, const string& On) const {
+  for (size_t i = 0; i < nodes.size(); i++) {
+    for (size_t j = 0; j < nodes.size(); j++) {
+      if (nodes[i].name == On && nodes[j].name == Action) {
+        return reach[i][j];
+      }
+    }
+  }
+
+  return false;
+}
+
+/**
+ * @brief Converts "depends_on" and "group" keys into graph edges
+ *
+ * @return 0 if successful, non-zero otherwise
+ *
+ */
+int rvs::scheduler::resolve_dependencies() {
+  char buff[1024];
+  std::map<string, size_t> index;
+  std::map<string, size_t> last_in_group;
+
+  for (size_t i = 0; i < nodes.size(); i++) {
+    if (!index.insert(std::make_pair(nodes[i].name, i)).second) {
+      snprintf(buff, sizeof(buff), "action name '%s' is not unique.",
+               nodes[i].name.c_str());
+      rvs::logger::Err(buff, MODULE_NAME_CAPS);
+      return -1;
+    }
+  }
+
+  for (size_t i = 0; i < nodes.size(); i++) {
+    node& n = nodes[i];
+    std::vector<string> names;
+
+    // actions of the same group run in .conf file order
+    auto git = last_in_group.find(n.group);
+    if (git != last_in_group.end()) {
+      n.deps.push_back(git->second);
+    }
+    last_in_group[n.group] = i;
+
+    const YAML::Node& deps = n.yaml["depends_on"];
+    try {
+      if (deps && deps.IsSequence()) {
+        for (YAML::const_iterator it = deps.begin(); it != deps.end(); ++it) {
+          names.push_back(it->as<string>());
+        }
+      } else if (deps) {
+        names.push_back(deps.as<string>());
+      }
+    } catch(...) {
+      snprintf(buff, sizeof(buff),
+               "action '%s': depends_on is not action name or list of names.",
+               n.name.c_str());
+      rvs::logger::Err(buff, MODULE_NAME_CAPS);
+      return -1;
+    }
+
+    for (auto it = names.begin(); it != names.end(); ++it) {
+      auto dit = index.find(*it);
+      if (dit == index.end() || dit->second == i) {
+        snprintf(buff, sizeof(buff),
+                 "action '%s' depends on unknown action '%s'.",
+                 n.name.c_str(), it->c_str());
+        rvs::logger::Err(buff, MODULE_NAME_CAPS);
+        return -1;
+      }
+      if (std::find(n.deps.begin(), n.deps.end(), dit->second) ==
+          n.deps.end()) {
+        n.deps.push_back(dit->second);
+      }
+    }
+
+    for (auto it = n.deps.begin(); it != n.deps.end(); ++it) {
+      nodes[*it].dependents.push_back(i);
+    }
+  }
+
+  groups = last_in_group.size();
+
+  return 0;
+}
+
+/**
+ * @brief Checks that action graph has no cycles
+ *
+ * Also computes transitive dependencies used to tell which actions may run
+ * concurrently.
+ *
+ * @return 0 if successful, non-zero otherwise
+ *
+ */
+int rvs::scheduler::check_cycles() {
+  std::vector<size_t> pending(nodes.size());
+  std::vector<size_t> order;
+
+  for (size_t i = 0; i < nodes.size(); i++) {
+    pending[i] = nodes[i].deps.size();
+    if (pending[i] == 0) {
+      order.push_back(i);
+    }
+  }
+
+  for (size_t k = 0; k < order.size(); k++) {
+    for (auto it = nodes[order[k]].dependents.begin();
+         it != nodes[order[k]].dependents.end(); ++it) {
+      if (--pending[*it] == 0) {
+        order.push_back(*it);
+      }
+    }
+  }
+
+  if (order.size() != nodes.size()) {
+    string names;
+    for (size_t i = 0; i < nodes.size(); i++) {
+      if (pending[i]) {
+        names += (names.empty() ? "'" : ", '") + nodes[i].name + "'";
+      }
+    }
+    string msg = "circular dependency between actions " + names + ".";
+    rvs::logger::Err(msg.c_str(), MODULE_NAME_CAPS);
+    return -1;
+  }
+
+  // in reverse topological order, each action reaches its dependents and
+  // everything they reach
+  reach.assign(nodes.size(), std::vector<bool>(nodes.size(), false));
+  for (auto it = order.rbegin(); it != order.rend(); ++it) {
+    for (auto dit = nodes[*it].dependents.begin();
+         dit != nodes[*it].dependents.end(); ++dit) {
+      reach[*it][*dit] = true;
+      for (size_t j = 0; j < nodes.size(); j++) {
+        if (reach[*dit][j]) {
+          reach[*it][j] = true;
+        }
+      }
+    }
+  }
+
+  return 0;
+}
+
+/**
+ * @brief Checks that actions which may run concurrently use distinct devices
+ *
+ * Actions of the same non re-entrant module are never run concurrently, so
+ * they do not conflict.
+ *
+ * @return 0 if successful, non-zero otherwise
+ *
+ */
+int rvs::scheduler::check_conflicts() {
+  int sts = 0;
+
+  for (size_t i = 0; i < nodes.size(); i++) {
+    for (size_t j = i + 1; j < nodes.size(); j++) {
+      if (reach[i][j] || reach[j][i]) {
+        continue;
+      }
+
+      if (nodes[i].module == nodes[j].module && !nodes[i].reentrant) {
+        string msg = "[" MODULE_NAME_CAPS "] actions '" + nodes[i].name +
+                     "' and '" + nodes[j].name + "' use module " +
+                     nodes[i].module + " and will not run concurrently";
+        rvs::logger::log(msg, rvs::loginfo);
+        continue;
+      }
+
+      if (!is_exclusive(nodes[i]) || !is_exclusive(nodes[j]) ||
+          !overlaps(nodes[i], nodes[j])) {
+        continue;
+      }
+
+      string msg = "device conflict: action " + describe(nodes[i]) +
+                   " may run concurrently with action " + describe(nodes[j]) +
+                   ", order them using 'group' or 'depends_on'.";
+      rvs::logger::Err(msg.c_str(), MODULE_NAME_CAPS);
+      sts = -1;
+    }
+  }
+
+  return sts;
+}
+
+/**
+ * @brief Thread pool worker
+ *
+ * @param Runner function executing single action
+ *
+ */
+void rvs::scheduler::worker(t_runner Runner) {
+  std::unique_lock<std::mutex> lk(mtx);
+
+  for (;;) {
+    size_t k = 0;
+    cv.wait(lk, [this, &k] {
+      k = pick();
+      return status || k < ready.size() || remaining == 0;
+    });
+    if (status || k >= ready.size()) {
+      break;
+    }
+
+    size_t i = ready[k];
+    ready.erase(ready.begin() + k);
+    remaining--;
+    running++;
+    if (!nodes[i].reentrant) {
+      busy.insert(nodes[i].module);
+    }
+    lk.unlock();
+
+    int sts;
+    auto start = std::chrono::steady_clock::now();
+    if (rvs::logger::Stopping()) {
+      sts = -1;
+    } else {
+      sts = Runner(nodes[i].yaml, i);
+    }
+    std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+    char buff[1024];
+    snprintf(buff, sizeof(buff), "[%s] action '%s' %s in %.3f s",
+             MODULE_NAME_CAPS, nodes[i].name.c_str(),
+             sts ? "failed" : "completed", elapsed.count());
+    rvs::logger::log(buff, rvs::loginfo);
+
+    lk.lock();
+    running--;
+    busy.erase(nodes[i].module);
+    nodes[i].seconds = elapsed.count();
+    if (sts) {
+      if (!status) {
+        status = sts;
+      }
+    } else {
+      for (auto it = nodes[i].dependents.begin();
+           it != nodes[i].dependents.end(); ++it) {
+        if (--nodes[*it].pending == 0) {
+          ready.push_back(*it);
+        }
+      }
+    }
+    cv.notify_all();
+  }
+}
+
+/**
+ * @brief Finds ready action which may be started now
+ *
+ * Called with mtx held.
+ *
+ * @return position in ready queue, ready.size() if no action can start
+ *
+ */
+size_t rvs::scheduler::pick() const {
+  for (size_t k = 0; k < ready.size(); k++) {
+    if (!busy.count(nodes[ready[k]].module)) {
+      return k;
+    }
+  }
+
+  return ready.size();
+}
+
+/**
+ * @brief Describes action for error messages
+ *
+ * @param Node action
+ * @return action name, module and devices
+ *
+ */
+string rvs::scheduler::describe(const node& Node) const {
+  string devices;
+  if (Node.all_devices) {
+    devices = "all";
+  } else {
+    for (auto it = Node.devices.begin(); it != Node.devices.end(); ++it) {
+      devices += (devices.empty() ? "" : " ") + *it;
+    }
+  }
+
+  return "'" + Node.name + "' (" + Node.module + " on device " + devices + ")";
+}
+
+/**
+ * @brief Checks if action needs its devices for itself
+ *
+ * Monitoring and query modules only read device state and may share
+ * devices with any other action.
+ *
+ * @param Node action
+ * @return 'true' if device sharing is a conflict
+ *
+ */
+bool rvs::scheduler::is_exclusive(const node& Node) {
+  static const char* shared[] = {"gm", "pesm", "gpup", "peqt", "smqt"};
+
+  for (size_t i = 0; i < sizeof(shared) / sizeof(shared[0]); i++) {
+    if (Node.module == shared[i]) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * @brief Checks if two actions use at least one common device
+ *
+ * @param A first action
+ * @param B second action
+ * @return 'true' if device sets intersect
+ *
+ */
+bool rvs::scheduler::overlaps(const node& A, const node& B) {
+  if (A.all_devices || B.all_devices) {
+    return true;
+  }
+
+  for (auto it = A.devices.begin(); it != A.devices.end(); ++it) {
+    if (B.devices.count(*it)) {
+      return true;
+    }
+  }
+
+  return false;
+}
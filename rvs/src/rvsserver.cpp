@@ -0,0 +1,709 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvsserver.h"
+
+#include <errno.h>
+#include <inttypes.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "yaml-cpp/yaml.h"
+
+#include "include/rvsliblogger.h"
+#include "include/rvsoptions.h"
+#include "include/rvs_util.h"
+
+#define MODULE_NAME_CAPS "CLI"
+
+//! max length of a single protocol line
+#define RVS_SERVE_MAX_LINE   65536
+
+//! max number of options in a job request
+#define RVS_SERVE_MAX_OPTS   64
+
+using std::string;
+
+//! Default constructor
+rvs::server::server()
+:
+listen_fd(-1),
+stopping(false),
+last_id(0),
+sessions(0) {
+}
+
+//! Default destructor
+rvs::server::~server() {
+  if (listen_fd >= 0) {
+    close(listen_fd);
+  }
+}
+
+/**
+ * @brief Accepts and runs jobs until stop is requested
+ *
+ * Each client connection is served in its own thread. After stop is
+ * requested no new jobs are accepted; jobs already accepted are run to
+ * completion before this method returns.
+ *
+ * @param Socket path of Unix domain socket to listen on
+ * @param Runner function running .conf file of a job
+ * @param Reentrant tells which modules allow concurrent jobs (none if not
+ * given)
+ * @return 0 if successful, non-zero otherwise
+ *
+ */
+int rvs::server::serve(const std::string& Socket, t_runner Runner,
+                       t_reentrant Reentrant) {
+  char buff[1024];
+
+  runner = Runner;
+  reentrant = Reentrant;
+  if (open_socket(Socket)) {
+    return -1;
+  }
+
+  rvs::logger::tap([this](const int Level, const std::string& Row,
+                          const size_t Msg) {
+    on_row(Level, Row, Msg);
+  });
+
+  snprintf(buff, sizeof(buff), "[%s] serve: accepting jobs on %s",
+           MODULE_NAME_CAPS, Socket.c_str());
+  rvs::logger::log(buff, rvs::loginfo);
+
+  while (!stopping && !rvs::logger::Stopping()) {
+    struct pollfd pfd;
+    pfd.fd = listen_fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    if (poll(&pfd, 1, RVS_SERVE_POLL_MS) <= 0) {
+      continue;
+    }
+
+    int fd = accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+    if (fd < 0) {
+      continue;
+    }
+
+    {
+      std::lock_guard<std::mutex> lk(mtx);
+      sessions++;
+    }
+    std::thread(&rvs::server::session, this, fd).detach();
+  }
+
+  close(listen_fd);
+  listen_fd = -1;
+  unlink(Socket.c_str());
+
+  // let accepted jobs complete
+  {
+    std::unique_lock<std::mutex> lk(mtx);
+    cv.wait(lk, [this]{ return sessions == 0; });
+  }
+
+  rvs::logger::tap(rvs::logger::t_tap());
+
+  snprintf(buff, sizeof(buff), "[%s] serve: %" PRIu64 " jobs served",
+           MODULE_NAME_CAPS, last_id);
+  rvs::logger::log(buff, rvs::loginfo);
+
+  return 0;
+}
+
+/**
+ * @brief Requests server to stop accepting jobs
+ *
+ * Safe to call from signal handler.
+ *
+ */
+void rvs::server::stop() {
+  stopping = true;
+}
+
+/**
+ * @brief Creates listening socket
+ *
+ * Socket file left over by a server which did not exit cleanly is removed.
+ * Socket is accessible to the owner only.
+ *
+ * @param Socket path of Unix domain socket
+ * @return 0 if successful, non-zero otherwise
+ *
+ */
+int rvs::server::open_socket(const std::string& Socket) {
+  char buff[1024];
+  struct sockaddr_un addr;
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (Socket.empty() || Socket.size() >= sizeof(addr.sun_path)) {
+    snprintf(buff, sizeof(buff), "invalid socket path: %s", Socket.c_str());
+    rvs::logger::Err(buff, MODULE_NAME_CAPS);
+    return -1;
+  }
+  strncpy(addr.sun_path, Socket.c_str(), sizeof(addr.sun_path) - 1);
+
+  struct stat st;
+  if (lstat(Socket.c_str(), &st) == 0) {
+    if (!S_ISSOCK(st.st_mode)) {
+      snprintf(buff, sizeof(buff), "%s exists and is not a socket",
+               Socket.c_str());
+      rvs::logger::Err(buff, MODULE_NAME_CAPS);
+      return -1;
+    }
+
+    int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    bool alive = probe >= 0 &&
+      connect(probe, reinterpret_cast<struct sockaddr*>(&addr),
+              sizeof(addr)) == 0;
+    if (probe >= 0) {
+      close(probe);
+    }
+    if (alive) {
+      snprintf(buff, sizeof(buff), "server already running on %s",
+               Socket.c_str());
+      rvs::logger::Err(buff, MODULE_NAME_CAPS);
+      return -1;
+    }
+    unlink(Socket.c_str());
+  }
+
+  listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (listen_fd < 0 ||
+      bind(listen_fd, reinterpret_cast<struct sockaddr*>(&addr),
+           sizeof(addr)) ||
+      chmod(Socket.c_str(), S_IRUSR | S_IWUSR) ||
+      listen(listen_fd, SOMAXCONN)) {
+    snprintf(buff, sizeof(buff), "could not listen on %s: %s",
+             Socket.c_str(), strerror(errno));
+    rvs::logger::Err(buff, MODULE_NAME_CAPS);
+    if (listen_fd >= 0) {
+      close(listen_fd);
+      listen_fd = -1;
+    }
+    return -1;
+  }
+
+  return 0;
+}
+
+/**
+ * @brief Serves single client connection
+ *
+ * Reads job request, waits until job devices are free, runs the job and
+ * reports its status.
+ *
+ * @param Fd client connection
+ *
+ */
+void rvs::server::session(int Fd) {
+  char   buff[1024];
+  string err;
+  job    j;
+
+  j.id = 0;
+  j.fd = Fd;
+  j.connected = true;
+  j.senders = 0;
+  j.level = rvs::logerror;
+  j.all_devices = false;
+
+  // neither silent nor stalled client may hold the server
+  struct timeval tmo;
+  tmo.tv_sec = RVS_SERVE_SEND_TMO;
+  tmo.tv_usec = 0;
+  setsockopt(Fd, SOL_SOCKET, SO_RCVTIMEO, &tmo, sizeof(tmo));
+  setsockopt(Fd, SOL_SOCKET, SO_SNDTIMEO, &tmo, sizeof(tmo));
+
+  if (read_job(&j, &err) || resources(&j, &err)) {
+    send_line(Fd, "error " + err);
+    send_line(Fd, "exit -1 0 0");
+  } else {
+    {
+      std::lock_guard<std::mutex> lk(mtx);
+      j.id = ++last_id;
+    }
+
+    auto queued = std::chrono::steady_clock::now();
+    acquire(&j);
+    auto started = std::chrono::steady_clock::now();
+    reply(&j, "started " + std::to_string(j.id));
+
+    snprintf(buff, sizeof(buff), "[%s] serve: job %" PRIu64 " started: %s",
+             MODULE_NAME_CAPS, j.id, j.config.c_str());
+    rvs::logger::log(buff, rvs::loginfo);
+
+    rvs::options::set_scope(&j.opts);
+    int sts = runner(j.config);
+    rvs::options::set_scope(nullptr);
+
+    auto done = std::chrono::steady_clock::now();
+    release(&j);
+
+    std::chrono::duration<double> wait = started - queued;
+    std::chrono::duration<double> run = done - started;
+    snprintf(buff, sizeof(buff),
+             "[%s] serve: job %" PRIu64 " completed with status %d, "
+             "queued %.3f s, ran %.3f s", MODULE_NAME_CAPS, j.id, sts,
+             wait.count(), run.count());
+    rvs::logger::log(buff, rvs::loginfo);
+
+    snprintf(buff, sizeof(buff), "exit %d %.6f %.6f", sts, wait.count(),
+             run.count());
+    reply(&j, buff);
+
+    // module requested RVS to stop
+    if (rvs::logger::Stopping()) {
+      stop();
+    }
+  }
+
+  close(Fd);
+
+  std::lock_guard<std::mutex> lk(mtx);
+  sessions--;
+  cv.notify_all();
+}
+
+/**
+ * @brief Reads job request from client
+ *
+ * Job runs with the options server was started with, except for
+ * configuration file (-c), device indexes (-i) and logging level (-d, -v)
+ * which are taken from the request. Other options are not supported
+ * per job.
+ *
+ * @param pJob [in,out] job to fill in
+ * @param pError [out] error description
+ * @return 0 if successful, non-zero otherwise
+ *
+ */
+int rvs::server::read_job(job* pJob, std::string* pError) {
+  string line;
+
+  if (!read_line(pJob->fd, &line) || line != RVS_SERVE_PROTOCOL) {
+    *pError = "unsupported request";
+    return -1;
+  }
+
+  std::map<string, string> req;
+  for (;;) {
+    if (!read_line(pJob->fd, &line)) {
+      *pError = "incomplete request";
+      return -1;
+    }
+    if (line == "end") {
+      break;
+    }
+    if (line.compare(0, 4, "opt ") || req.size() >= RVS_SERVE_MAX_OPTS) {
+      *pError = "unexpected request line: " + line;
+      return -1;
+    }
+    size_t pos = line.find(' ', 4);
+    if (pos == string::npos) {
+      req[line.substr(4)] = "";
+    } else {
+      req[line.substr(4, pos - 4)] = line.substr(pos + 1);
+    }
+  }
+
+  pJob->opts = rvs::options::get();
+  pJob->opts.erase("-srv");
+  pJob->opts.erase("-c");
+  pJob->opts.erase("-i");
+  pJob->opts.erase("-d");
+  pJob->opts.erase("-v");
+
+  for (auto it = req.begin(); it != req.end(); ++it) {
+    if (it->first == "-c" || it->first == "-i") {
+      pJob->opts[it->first] = it->second;
+    } else if (it->first == "-d") {
+      if (it->second.size() != 1 || it->second[0] < '0' ||
+          it->second[0] > '5') {
+        *pError = "logging level not in range [0..5]: " + it->second;
+        return -1;
+      }
+      if (!req.count("-v")) {
+        pJob->level = it->second[0] - '0';
+      }
+      pJob->opts[it->first] = it->second;
+    } else if (it->first == "-v") {
+      pJob->level = rvs::logtrace;
+      pJob->opts[it->first] = "";
+    } else {
+      *pError = "option not supported for served jobs: " + it->first;
+      return -1;
+    }
+  }
+
+  auto it = pJob->opts.find("-c");
+  if (it != pJob->opts.end()) {
+    pJob->config = it->second;
+  } else {
+    rvs::options::has_option("pwd", &pJob->config);
+    pJob->config += "conf/rvs.conf";
+  }
+
+  if (pJob->config.empty() || pJob->config[0] != '/') {
+    *pError = "configuration file path must be absolute: " + pJob->config;
+    return -1;
+  }
+
+  return 0;
+}
+
+/**
+ * @brief Collects devices, modules and action names used by job
+ *
+ * @param pJob [in,out] job
+ * @param pError [out] error description
+ * @return 0 if successful, non-zero otherwise
+ *
+ */
+int rvs::server::resources(job* pJob, std::string* pError) {
+  string indexes;
+  auto opt = pJob->opts.find("-i");
+  if (opt != pJob->opts.end()) {
+    indexes = opt->second;
+  }
+
+  try {
+    YAML::Node config = YAML::LoadFile(pJob->config);
+    const YAML::Node& actions = config["actions"];
+    if (!actions || !actions.IsSequence() || actions.size() == 0) {
+      *pError = "no actions in " + pJob->config;
+      return -1;
+    }
+
+    for (YAML::const_iterator it = actions.begin(); it != actions.end();
+         ++it) {
+      const YAML::Node& action = *it;
+      if (!action["name"]) {
+        *pError = "action without name in " + pJob->config;
+        return -1;
+      }
+      pJob->actions.insert(action["name"].as<string>());
+
+      if (action["module"]) {
+        string module = action["module"].as<string>();
+        if (!reentrant || !reentrant(module)) {
+          pJob->modules.insert(module);
+        }
+      }
+
+      string device("all");
+      if (!indexes.empty()) {
+        device = indexes;
+        std::replace(device.begin(), device.end(), ',', ' ');
+      } else if (action["device"]) {
+        device = action["device"].as<string>();
+      }
+      std::vector<string> ids = str_split(device, " ");
+      if (ids.empty() ||
+          std::find(ids.begin(), ids.end(), "all") != ids.end()) {
+        pJob->all_devices = true;
+      }
+      pJob->devices.insert(ids.begin(), ids.end());
+    }
+  } catch(std::exception& e) {
+    *pError = "error processing configuration file " + pJob->config + ": " +
+              e.what();
+    return -1;
+  }
+
+  return 0;
+}
+
+/**
+ * @brief Checks if two jobs may not run at the same time
+ *
+ * @param A job
+ * @param B another job
+ * @return 'true' if jobs share a device, a module or an action name
+ *
+ */
+bool rvs::server::conflicts(const job& A, const job& B) {
+  if (A.all_devices || B.all_devices) {
+    return true;
+  }
+
+  for (auto it = A.devices.begin(); it != A.devices.end(); ++it) {
+    if (B.devices.count(*it)) {
+      return true;
+    }
+  }
+
+  for (auto it = A.modules.begin(); it != A.modules.end(); ++it) {
+    if (B.modules.count(*it)) {
+      return true;
+    }
+  }
+
+  for (auto it = A.actions.begin(); it != A.actions.end(); ++it) {
+    if (B.actions.count(*it)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * @brief Waits until job may run
+ *
+ * Job starts once it conflicts neither with a running job nor with a job
+ * which arrived earlier and is still waiting, so jobs on busy devices are
+ * run in order of arrival.
+ *
+ * @param pJob job
+ *
+ */
+void rvs::server::acquire(job* pJob) {
+  std::unique_lock<std::mutex> lk(mtx);
+  bool reported = false;
+
+  waiting.push_back(pJob);
+  for (;;) {
+    bool free = true;
+    for (auto it = running.begin(); free && it != running.end(); ++it) {
+      free = !conflicts(**it, *pJob);
+    }
+    for (auto it = waiting.begin(); free && *it != pJob; ++it) {
+      free = !conflicts(**it, *pJob);
+    }
+    if (free) {
+      break;
+    }
+
+    if (!reported) {
+      // client output must not hold other jobs
+      reported = true;
+      lk.unlock();
+      reply(pJob, "queued " + std::to_string(pJob->id));
+      lk.lock();
+      continue;
+    }
+    cv.wait(lk);
+  }
+
+  waiting.remove(pJob);
+  running.push_back(pJob);
+}
+
+/**
+ * @brief Marks job completed and wakes up waiting jobs
+ *
+ * Returns once no thread is sending rows to the job client any more.
+ *
+ * @param pJob job
+ *
+ */
+void rvs::server::release(job* pJob) {
+  std::unique_lock<std::mutex> lk(mtx);
+  running.remove(pJob);
+  cv.notify_all();
+  cv.wait(lk, [pJob]{ return pJob->senders == 0; });
+}
+
+/**
+ * @brief Sends line to job client
+ *
+ * @param pJob job
+ * @param Line line to send
+ *
+ */
+void rvs::server::reply(job* pJob, const std::string& Line) {
+  std::lock_guard<std::mutex> lk(pJob->out_mtx);
+  if (pJob->connected) {
+    pJob->connected = send_line(pJob->fd, Line);
+  }
+}
+
+/**
+ * @brief Forwards log row to client of the job it belongs to
+ *
+ * Rows logged by launcher threads running a job are recognized by job
+ * options set for the thread. Other rows are matched by the action name
+ * the message starts with. Row is sent without holding the job lists, so
+ * a slow client only delays rows of its own job.
+ *
+ * @param Level logging level
+ * @param Row formatted row
+ * @param Msg offset of the message within the row
+ *
+ */
+void rvs::server::on_row(const int Level, const std::string& Row,
+                         const size_t Msg) {
+  const std::map<string, string>* scope = rvs::options::scope();
+  std::unique_lock<std::mutex> lk(mtx);
+  job* pjob = nullptr;
+
+  for (auto it = running.begin(); !pjob && it != running.end(); ++it) {
+    if (scope == &(*it)->opts) {
+      pjob = *it;
+    }
+  }
+
+  if (!pjob && Msg < Row.size() && Row[Msg] == '[') {
+    size_t end = Row.find(']', Msg);
+    if (end != string::npos) {
+      string name = Row.substr(Msg + 1, end - Msg - 1);
+      for (auto it = running.begin(); !pjob && it != running.end(); ++it) {
+        if ((*it)->actions.count(name)) {
+          pjob = *it;
+        }
+      }
+    }
+  }
+
+  if (!pjob || Level > pjob->level) {
+    return;
+  }
+
+  // job is not released while its rows are being sent
+  pjob->senders++;
+  lk.unlock();
+  {
+    std::lock_guard<std::mutex> olk(pjob->out_mtx);
+    if (pjob->connected) {
+      pjob->connected = send_row(pjob->fd, Level, Row);
+    }
+  }
+  lk.lock();
+  pjob->senders--;
+  cv.notify_all();
+}
+
+/**
+ * @brief Sends protocol line
+ *
+ * @param Fd socket
+ * @param Line line to send (without newline)
+ * @return 'true' if successful
+ *
+ */
+bool rvs::server::send_line(int Fd, const std::string& Line) {
+  string out = Line + '\n';
+  size_t done = 0;
+
+  while (done < out.size()) {
+    ssize_t n = send(Fd, out.data() + done, out.size() - done, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    done += static_cast<size_t>(n);
+  }
+
+  return true;
+}
+
+/**
+ * @brief Sends log row
+ *
+ * @param Fd socket
+ * @param Level logging level
+ * @param Row formatted row
+ * @return 'true' if successful
+ *
+ */
+bool rvs::server::send_row(int Fd, const int Level, const std::string& Row) {
+  return send_line(Fd, "row " + std::to_string(Level) + " " +
+                       std::to_string(Row.size()) + "\n" + Row);
+}
+
+/**
+ * @brief Reads protocol line
+ *
+ * @param Fd socket
+ * @param pLine [out] line read (without newline)
+ * @return 'true' if successful
+ *
+ */
+bool rvs::server::read_line(int Fd, std::string* pLine) {
+  pLine->clear();
+
+  for (;;) {
+    char c;
+    ssize_t n = recv(Fd, &c, 1, 0);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    if (c == '\n') {
+      return true;
+    }
+    if (pLine->size() >= RVS_SERVE_MAX_LINE) {
+      return false;
+    }
+    *pLine += c;
+  }
+}
+
+/**
+ * @brief Reads given number of bytes
+ *
+ * @param Fd socket
+ * @param Size number of bytes to read
+ * @param pData [out] bytes read
+ * @return 'true' if successful
+ *
+ */
+bool rvs::server::read_bytes(int Fd, size_t Size, std::string* pData) {
+  pData->resize(Size);
+  size_t done = 0;
+
+  while (done < Size) {
+    ssize_t n = recv(Fd, &(*pData)[done], Size - done, 0);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    done += static_cast<size_t>(n);
+  }
+
+  return true;
+}
@@ -0,0 +1,314 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvssweep.h"
+
+#include <stdio.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "include/rvsactionresult.h"
+#include "include/rvsliblogger.h"
+
+#define MODULE_NAME_CAPS "CLI"
+
+using std::string;
+
+//! Default constructor
+rvs::sweep::sweep() : zip(false) {
+}
+
+//! Default destructor
+rvs::sweep::~sweep() {
+}
+
+/**
+ * @brief Checks if action has "sweep" key
+ *
+ * @param Action action node from .conf file
+ * @return true if action is to be run for several parameter variants
+ *
+ */
+bool rvs::sweep::has_sweep(const YAML::Node& Action) {
+  return static_cast<bool>(Action["sweep"]);
+}
+
+/**
+ * @brief Parses "sweep" block
+ *
+ * @param Sweep content of "sweep" key
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int rvs::sweep::build(const YAML::Node& Sweep) {
+  char buff[1024];
+
+  zip = false;
+  metric.clear();
+  unit.clear();
+  output.clear();
+  names.clear();
+  values.clear();
+  rows.clear();
+
+  if (!Sweep.IsMap()) {
+    rvs::logger::Err("sweep must be a map of property value lists.",
+                     MODULE_NAME_CAPS);
+    return -1;
+  }
+
+  for (YAML::const_iterator it = Sweep.begin(); it != Sweep.end(); ++it) {
+    string key = it->first.as<string>();
+
+    if (key == "mode" || key == "metric" || key == "output") {
+      string val = it->second.as<string>();
+      if (key == "metric") {
+        metric = val;
+      } else if (key == "output") {
+        output = val;
+      } else if (val == "zip" || val == "product") {
+        zip = val == "zip";
+      } else {
+        snprintf(buff, sizeof(buff),
+                 "sweep mode '%s' is not supported (product, zip).",
+                 val.c_str());
+        rvs::logger::Err(buff, MODULE_NAME_CAPS);
+        return -1;
+      }
+      continue;
+    }
+
+    std::vector<string> list;
+    if (it->second.IsSequence()) {
+      for (size_t i = 0; i < it->second.size(); i++) {
+        list.push_back(it->second[i].as<string>());
+      }
+    } else if (it->second.IsScalar()) {
+      list.push_back(it->second.as<string>());
+    }
+    if (list.empty()) {
+      snprintf(buff, sizeof(buff),
+               "sweep property '%s' has no values.", key.c_str());
+      rvs::logger::Err(buff, MODULE_NAME_CAPS);
+      return -1;
+    }
+
+    names.push_back(key);
+    values.push_back(list);
+  }
+
+  if (names.empty()) {
+    rvs::logger::Err("sweep does not list any property.", MODULE_NAME_CAPS);
+    return -1;
+  }
+
+  if (zip) {
+    for (size_t i = 1; i < values.size(); i++) {
+      if (values[i].size() != values[0].size()) {
+        snprintf(buff, sizeof(buff),
+                 "sweep mode zip: '%s' has %zu values, '%s' has %zu.",
+                 names[0].c_str(), values[0].size(),
+                 names[i].c_str(), values[i].size());
+        rvs::logger::Err(buff, MODULE_NAME_CAPS);
+        return -1;
+      }
+    }
+  }
+
+  return 0;
+}
+
+/**
+ * @brief Returns number of variants
+ *
+ */
+size_t rvs::sweep::size() const {
+  if (values.empty()) {
+    return 0;
+  }
+  if (zip) {
+    return values[0].size();
+  }
+  size_t n = 1;
+  for (auto it = values.begin(); it != values.end(); ++it) {
+    n *= it->size();
+  }
+  return n;
+}
+
+/**
+ * @brief Returns property values of given variant
+ *
+ * @param Index variant index, 0 .. size() - 1
+ * @return property name/value pairs
+ *
+ */
+rvs::sweep::t_params rvs::sweep::variant(const size_t Index) const {
+  t_params params;
+  size_t rest = Index;
+
+  // last property changes fastest
+  std::vector<size_t> pos(values.size());
+  for (size_t i = values.size(); i-- > 0;) {
+    if (zip) {
+      pos[i] = Index;
+    } else {
+      pos[i] = rest % values[i].size();
+      rest /= values[i].size();
+    }
+  }
+
+  for (size_t i = 0; i < names.size(); i++) {
+    params.push_back(std::make_pair(names[i], values[i][pos[i]]));
+  }
+  return params;
+}
+
+/**
+ * @brief Stores result of a variant
+ *
+ * Key metric is "metric" given in sweep block or, if not given, the first
+ * metric reported by any variant. Its values reported for all devices are
+ * averaged.
+ *
+ * @param Index variant index
+ * @param Status action return code
+ * @param Result structured results reported by action (IF2 only)
+ *
+ */
+void rvs::sweep::add_result(const size_t Index, const int Status,
+                            const actionresult& Result) {
+  row r;
+  r.params = variant(Index);
+  r.status = Status;
+  r.passed = Result.passed();
+  r.failed = Result.failed();
+  r.count = 0;
+  r.value = 0;
+
+  auto metrics = Result.metrics();
+  for (auto it = metrics.begin(); it != metrics.end(); ++it) {
+    if (metric.empty()) {
+      metric = it->name;
+    }
+    if (it->name != metric) {
+      continue;
+    }
+    unit = it->unit;
+    r.value += it->value;
+    r.count++;
+  }
+  if (r.count) {
+    r.value /= r.count;
+  }
+
+  rows.push_back(r);
+}
+
+/**
+ * @brief Returns results of all variants as CSV table
+ *
+ */
+std::string rvs::sweep::table() const {
+  std::ostringstream os;
+  for (size_t i = 0; i < names.size(); i++) {
+    os << names[i] << ",";
+  }
+  os << "status,passed,failed";
+  if (!metric.empty()) {
+    os << "," << metric;
+    if (!unit.empty()) {
+      os << " (" << unit << ")";
+    }
+  }
+  os << "\n";
+
+  for (auto it = rows.begin(); it != rows.end(); ++it) {
+    for (auto p = it->params.begin(); p != it->params.end(); ++p) {
+      os << p->second << ",";
+    }
+    os << it->status << "," << it->passed << "," << it->failed;
+    if (!metric.empty()) {
+      os << ",";
+      if (it->count) {
+        os << it->value;
+      }
+    }
+    os << "\n";
+  }
+  return os.str();
+}
+
+/**
+ * @brief Logs result table, emits JSON record and writes CSV file if
+ * requested
+ *
+ * @param Module module name
+ * @param Action action name
+ *
+ */
+void rvs::sweep::report(const std::string& Module, const std::string& Action) {
+  string csv = table();
+
+  std::istringstream is(csv);
+  string line;
+  while (std::getline(is, line)) {
+    rvs::logger::log("[" + Action + "] sweep " + line, rvs::logresults);
+  }
+
+  if (!output.empty()) {
+    std::ofstream f(output);
+    f << csv;
+    if (!f) {
+      string msg = "could not write sweep table to '" + output + "'.";
+      rvs::logger::Err(msg.c_str(), MODULE_NAME_CAPS, Action.c_str());
+    }
+  }
+
+  uint32_t sec;
+  uint32_t usec;
+  rvs::logger::get_ticks(&sec, &usec);
+  void* r = rvs::logger::LogRecordCreate(Module.c_str(), Action.c_str(),
+                                         rvs::logresults, sec, usec);
+  for (size_t i = 0; i < rows.size(); i++) {
+    const row& w = rows[i];
+    void* n = rvs::logger::CreateNode(r, std::to_string(i).c_str());
+    for (auto p = w.params.begin(); p != w.params.end(); ++p) {
+      rvs::logger::AddString(n, p->first.c_str(), p->second.c_str());
+    }
+    rvs::logger::AddInt(n, "status", w.status);
+    rvs::logger::AddUint64(n, "passed", w.passed);
+    rvs::logger::AddUint64(n, "failed", w.failed);
+    if (w.count) {
+      rvs::logger::AddDouble(n, (metric + " (" + unit + ")").c_str(),
+                             w.value);
+    }
+    rvs::logger::AddNode(r, n);
+  }
+  rvs::logger::LogRecordFlush(r);
+}
@@ -0,0 +1,168 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <stdlib.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "include/gpu_util.h"
+#include "include/rvstopocache.h"
+#include "include/rvstopogen.h"
+
+using std::cout;
+using std::cerr;
+
+//! Prints help
+static void do_help() {
+  cout << "\nUsage: rvs-topogen [options] <sysroot>\n";
+  cout << "\nGenerates synthetic KFD topology under <sysroot> which can then "
+          "be used with\n'rvs --sysroot <sysroot>' or RVS_SYSROOT=<sysroot> "
+          "on machines without GPUs.\n";
+  cout << "\nOptions:\n\n";
+  cout << "-g --gpus          Number of GPU nodes. Default is 8.\n";
+  cout << "-c --cpus          Number of CPU nodes. Default is 2.\n";
+  cout << "-x --hive          Number of GPUs per XGMI hive, 0 for no XGMI "
+                              "links. Default is 8.\n";
+  cout << "-d --deviceId      PCI device ID of generated GPUs. Default is "
+                              "0x74a1.\n";
+  cout << "-b --bench         Time topology discovery, with and without "
+                              "topology cache, on\n";
+  cout << "                   generated tree.\n";
+  cout << "-h --help          Display usage information and exit.\n";
+}
+
+/**
+ * @brief Time topology discovery (with and without cache) and lookups on
+ * generated tree
+ * @param Root sysroot with generated tree
+ * @param Gpus expected number of GPUs
+ * @return 0 - all OK, non-zero error
+ */
+static int do_bench(const std::string& Root, int Gpus) {
+  const int loops = 10;
+  const int lookups = 100000;
+
+  setenv(RVS_SYSROOT_ENV, Root.c_str(), 1);
+  setenv(RVS_TOPOLOGY_CACHE_ENV, (Root + "/topology.cache").c_str(), 1);
+  std::string path = gpu_sysfs_path(KFD_SYS_PATH_NODES);
+
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < loops; i++) {
+    rvs::gpulist::Initialize(path.c_str(), true);
+  }
+  auto tc = std::chrono::steady_clock::now();
+  for (int i = 0; i < loops; i++) {
+    rvs::gpulist::Initialize();
+  }
+  auto t1 = std::chrono::steady_clock::now();
+
+  std::vector<uint16_t> gpus;
+  gpu_get_all_gpu_id(&gpus);
+  if (static_cast<int>(gpus.size()) != Gpus) {
+    cerr << "rvs-topogen: found " << gpus.size() << " GPUs instead of "
+         << Gpus << "\n";
+    return -1;
+  }
+
+  uint64_t sum = 0;
+  auto t2 = std::chrono::steady_clock::now();
+  for (int i = 0; i < lookups && Gpus; i++) {
+    uint16_t val = 0;
+    int numa = 0;
+    uint16_t gpu = rvs::topogen::gpu_id(i % Gpus);
+    rvs::gpulist::gpu2location(gpu, &val);
+    sum += val;
+    rvs::gpulist::gpu2node(gpu, &val);
+    sum += val;
+    rvs::gpulist::gpu2numa(gpu, &numa);
+    sum += numa;
+  }
+  auto t3 = std::chrono::steady_clock::now();
+
+  cout << "nodes: " << rvs::gpulist::nodes().size()
+       << "  init: "
+       << std::chrono::duration<double, std::milli>(tc - t0).count() / loops
+       << " ms  cached init: "
+       << std::chrono::duration<double, std::milli>(t1 - tc).count() / loops
+       << " ms  lookup: "
+       << std::chrono::duration<double, std::nano>(t3 - t2).count() /
+          lookups / 3
+       << " ns  (checksum " << sum << ")\n";
+  return 0;
+}
+
+/**
+ *
+ * @ingroup Launcher
+ * @brief Main method of rvs-topogen utility
+ *
+ * @param Argc standard C argc parameter to main()
+ * @param Argv standard C argv parameter to main()
+ * @return 0 - all OK, non-zero error
+ *
+ * */
+int main(int Argc, char**Argv) {
+  rvs::topogen gen;
+  std::string root;
+  bool bench = false;
+
+  for (int i = 1; i < Argc; i++) {
+    std::string arg(Argv[i]);
+    if ((arg == "-g" || arg == "--gpus") && i + 1 < Argc) {
+      gen.gpus = strtol(Argv[++i], nullptr, 0);
+    } else if ((arg == "-c" || arg == "--cpus") && i + 1 < Argc) {
+      gen.cpus = strtol(Argv[++i], nullptr, 0);
+    } else if ((arg == "-x" || arg == "--hive") && i + 1 < Argc) {
+      gen.hive_size = strtol(Argv[++i], nullptr, 0);
+    } else if ((arg == "-d" || arg == "--deviceId") && i + 1 < Argc) {
+      gen.device_id = strtol(Argv[++i], nullptr, 0);
+    } else if (arg == "-b" || arg == "--bench") {
+      bench = true;
+    } else if (arg == "-h" || arg == "--help") {
+      do_help();
+      return 0;
+    } else if (arg[0] != '-' && root.empty()) {
+      root = arg;
+    } else {
+      cerr << "rvs-topogen: invalid option: " << arg << "\n";
+      do_help();
+      return -1;
+    }
+  }
+
+  if (root.empty()) {
+    do_help();
+    return -1;
+  }
+
+  if (gen.generate(root)) {
+    cerr << "rvs-topogen: could not generate topology in " << root << "\n";
+    return -1;
+  }
+
+  return bench ? do_bench(root, gen.gpus) : 0;
+}
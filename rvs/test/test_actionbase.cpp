@@ -0,0 +1,186 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/rvsactionbase.h"
+#include "include/rvs_util.h"
+
+namespace {
+
+class typed_action : public rvs::actionbase {
+ public:
+  int run(void) override {
+    return 0;
+  }
+  // changes property collection bypassing property_set()
+  void set_direct(const std::string& key, const std::string& val) {
+    property[key] = val;
+  }
+  using rvs::actionbase::property_get_int;
+  using rvs::actionbase::property_get_uint_list;
+};
+
+// gpup like action: "properties" collection plus common keys
+void fill_config(rvs::actionbase* p) {
+  p->property_set("name", "action_1");
+  p->property_set("device", "1 2 3 4 5 6 7 8");
+  p->property_set("deviceid", "26720");
+  p->property_set("count", "10");
+  p->property_set("duration", "5000");
+  p->property_set("parallel", "true");
+  p->property_set("target_power", "150.5");
+  p->property_set("cli.-j", "");
+  p->property_set("cli.-d", "3");
+  for (int i = 0; i < 64; i++) {
+    std::string n = std::to_string(i);
+    p->property_set(("properties.prop_" + n).c_str(), "");
+    p->property_set(("io_links-properties.link_" + n).c_str(), "");
+  }
+}
+
+}  // namespace
+
+TEST(actionbase_typed, getters) {
+  typed_action a;
+  fill_config(&a);
+  a.property_set("block_size", "1024,2048");
+  a.property_set("bad_int", "12a");
+
+  uint16_t u16 = 0;
+  EXPECT_EQ(0, a.property_get_int<uint16_t>("deviceid", &u16));
+  EXPECT_EQ(26720u, u16);
+  EXPECT_EQ(1, a.property_get_int<uint16_t>("bad_int", &u16));
+  EXPECT_EQ(26720u, u16);
+  EXPECT_EQ(0, a.property_get_int<uint16_t>("missing", &u16, 7));
+  EXPECT_EQ(7u, u16);
+  EXPECT_EQ(2, a.property_get_int<uint16_t>("cli.-j", &u16, 7));
+
+  bool b = false;
+  EXPECT_EQ(0, a.property_get("parallel", &b));
+  EXPECT_TRUE(b);
+  float f = 0;
+  EXPECT_EQ(0, a.property_get("target_power", &f));
+  EXPECT_FLOAT_EQ(150.5f, f);
+  EXPECT_EQ(1, a.property_get("name", &f));
+
+  std::vector<uint32_t> list;
+  bool all = true;
+  EXPECT_EQ(0, a.property_get_uint_list<uint32_t>("block_size", ",", &list,
+                                                  &all));
+  EXPECT_FALSE(all);
+  ASSERT_EQ(2u, list.size());
+  EXPECT_EQ(2048u, list[1]);
+  EXPECT_EQ(0, a.property_get_device());
+
+  EXPECT_EQ(2u, a.property_errors().size());
+  EXPECT_EQ("property 'bad_int': value '12a' is not a positive integer",
+            a.property_errors()[0]);
+}
+
+TEST(actionbase_typed, rebuild) {
+  typed_action a;
+  a.property_set("device", "all");
+  std::vector<uint16_t> list;
+  bool all = false;
+  EXPECT_EQ(0, a.property_get_uint_list<uint16_t>("device", " ", &list,
+                                                  &all));
+  EXPECT_TRUE(all);
+
+  // new keys are seen by getters
+  a.set_direct("monitor", "true");
+  bool b = false;
+  EXPECT_EQ(0, a.property_get("monitor", &b));
+  EXPECT_TRUE(b);
+  a.property_set("count", "3");
+  uint64_t count = 0;
+  EXPECT_EQ(0, a.property_get_int<uint64_t>("count", &count));
+  EXPECT_EQ(3u, count);
+}
+
+TEST(actionbase_typed, collection) {
+  typed_action a;
+  fill_config(&a);
+  std::vector<std::string> names;
+  EXPECT_EQ(64, a.property_get_collection("properties", &names));
+  EXPECT_EQ("prop_0", names[0]);
+  EXPECT_EQ(0, a.property_get_collection("missing", &names));
+}
+
+// compares typed getters with per-call parsing of string map
+TEST(actionbase_typed, benchmark) {
+  const int loops = 20000;
+  typed_action a;
+  fill_config(&a);
+
+  auto t0 = std::chrono::steady_clock::now();
+  uint64_t sum = 0;
+  for (int i = 0; i < loops; i++) {
+    std::string val;
+    uint64_t v = 0;
+    bool b = false;
+    std::vector<uint16_t> dev;
+    a.has_property("count", &val);
+    rvs_util_parse<uint64_t>(val, &v);
+    sum += v;
+    a.has_property("duration", &val);
+    rvs_util_parse<uint64_t>(val, &v);
+    sum += v;
+    a.has_property("parallel", &val);
+    rvs_util_parse(val, &b);
+    a.has_property("device", &val);
+    rvs_util_strarr_to_uintarr<uint16_t>(str_split(val, " "), &dev);
+    sum += dev.size() + a.has_property("cli.-j");
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  uint64_t sum_typed = 0;
+  for (int i = 0; i < loops; i++) {
+    uint64_t v = 0;
+    bool b = false;
+    std::vector<uint16_t> dev;
+    bool all;
+    a.property_get_int<uint64_t>("count", &v);
+    sum_typed += v;
+    a.property_get_int<uint64_t>("duration", &v);
+    sum_typed += v;
+    a.property_get("parallel", &b);
+    a.property_get_uint_list<uint16_t>("device", " ", &dev, &all);
+    sum_typed += dev.size() + a.has_property("cli.-j");
+  }
+  auto t2 = std::chrono::steady_clock::now();
+
+  EXPECT_EQ(sum, sum_typed);
+  std::cout << "string parse: "
+            << std::chrono::duration<double, std::micro>(t1 - t0).count() /
+               loops
+            << " us/action  typed: "
+            << std::chrono::duration<double, std::micro>(t2 - t1).count() /
+               loops
+            << " us/action" << std::endl;
+}
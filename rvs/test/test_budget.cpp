@@ -0,0 +1,124 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <string>
+
+#include "gtest/gtest.h"
+#include "yaml-cpp/yaml.h"
+
+#include "include/rvsbudget.h"
+#include "include/rvsliblogger.h"
+
+TEST(budget, proportional) {
+  rvs::logger::quiet();
+  YAML::Node config = YAML::Load(
+    "time_budget: 1m\n"
+    "actions:\n"
+    "- name: a\n"
+    "  module: gst\n"
+    "  duration: 10000\n"
+    "- name: b\n"
+    "  module: iet\n"
+    "  duration: 5000\n"
+    "  count: 2\n"
+    "  wait: 1000\n"
+    "- name: c\n"
+    "  module: gpup\n");
+  ASSERT_TRUE(rvs::budget::has_budget(config));
+
+  rvs::budget b;
+  ASSERT_EQ(0, b.build(config));
+  EXPECT_EQ(60000u, b.total());
+  EXPECT_TRUE(b.scaled("a"));
+  EXPECT_TRUE(b.scaled("b"));
+  EXPECT_FALSE(b.scaled("c"));
+
+  // 58 s left after waits, a and b configured for the same time
+  EXPECT_EQ(29000u, b.allocate("a", 0));
+  b.complete("a", 29000);
+  EXPECT_EQ(14500u, b.allocate("b", 29000));
+  b.complete("b", 31000);
+  EXPECT_EQ(0u, b.allocate("c", 60000));
+  b.complete("c", 500);
+
+  std::string t = b.table();
+  EXPECT_NE(std::string::npos, t.find("overrun by"));
+}
+
+TEST(budget, overrun) {
+  rvs::logger::quiet();
+  rvs::budget b;
+  ASSERT_EQ(0, b.build(YAML::Load(
+    "time_budget: 100\n"
+    "actions:\n"
+    "- name: a\n"
+    "  duration: 50000\n"
+    "- name: b\n"
+    "  duration: 30000\n"
+    "  weight: 2\n"
+    "- name: c\n"
+    "  duration: 20000\n"
+    "  min_duration: 30000\n")));
+
+  // a: 50, b: 2 * 30, c: 20 shares of 100 s, but c keeps its minimum
+  EXPECT_EQ(31818u, b.allocate("a", 0));
+  b.complete("a", 31818);
+
+  // a took 30 s longer than planned, b shrinks and c keeps its minimum
+  EXPECT_EQ(8182u, b.allocate("b", 61818));
+  b.complete("b", 8182);
+  EXPECT_EQ(30000u, b.allocate("c", 70000));
+}
+
+TEST(budget, invalid) {
+  rvs::logger::quiet();
+  rvs::budget b;
+  EXPECT_NE(0, b.build(YAML::Load("time_budget: soon\nactions: []\n")));
+  EXPECT_NE(0, b.build(YAML::Load("time_budget: 0\nactions: []\n")));
+  EXPECT_NE(0, b.build(YAML::Load(
+    "time_budget: 1h\n"
+    "actions:\n"
+    "- name: a\n"
+    "  duration: 1000\n"
+    "  weight: -1\n")));
+  EXPECT_NE(0, b.build(YAML::Load(
+    "time_budget: 1h\n"
+    "actions:\n"
+    "- name: a\n"
+    "  min_duration: x\n")));
+
+  // swept duration and endless actions are not scaled
+  ASSERT_EQ(0, b.build(YAML::Load(
+    "time_budget: 1h\n"
+    "actions:\n"
+    "- name: a\n"
+    "  duration: 1000\n"
+    "  sweep:\n"
+    "    duration: [1000, 2000]\n"
+    "- name: b\n"
+    "  duration: 1000\n"
+    "  count: 0\n")));
+  EXPECT_FALSE(b.scaled("a"));
+  EXPECT_FALSE(b.scaled("b"));
+}
@@ -0,0 +1,150 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <stdlib.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/gpu_util.h"
+#include "include/rvsdevreg.h"
+#include "include/rvstopocache.h"
+#include "include/rvstopogen.h"
+
+//! enough GPUs to span two PCI domains
+static const int kGpus = 260;
+
+class DevRegTest : public ::testing::Test,
+                   public rvs::gpulist, public rvs::devreg {
+ protected:
+  void SetUp() override {
+    char name[] = "/tmp/rvs_devreg_XXXXXX";
+    ASSERT_NE(mkdtemp(name), nullptr);
+    root = name;
+    setenv(RVS_SYSROOT_ENV, root.c_str(), 1);
+    setenv(RVS_TOPOLOGY_CACHE_ENV, "", 1);
+    rvs::topogen gen;
+    gen.gpus = kGpus;
+    ASSERT_EQ(0, gen.generate(root));
+    ASSERT_EQ(0, rvs::gpulist::Initialize());
+
+    // HIP enumerates GPUs in reverse KFD order, last GPU is not visible
+    // to KFD
+    for (int g = kGpus - 1; g >= 0; g--) {
+      hipdev dev;
+      dev.index = kGpus - 1 - g;
+      dev.domain = rvs::topogen::domain(g);
+      dev.bus = rvs::topogen::location_id(g) >> 8;
+      dev.device = 0;
+      hip.push_back(dev);
+    }
+    hipdev ghost = {kGpus, 0, 0xff, 0x1f};
+    hip.push_back(ghost);
+    preg = build(hip);
+  }
+
+  void TearDown() override {
+    delete preg;
+    preg = nullptr;
+    unsetenv(RVS_SYSROOT_ENV);
+    unsetenv(RVS_TOPOLOGY_CACHE_ENV);
+    topology.clear();
+    build_index();
+    rvs::gpulist::initialized = false;
+    std::string cmd = "rm -rf " + root;
+    ASSERT_EQ(0, system(cmd.c_str()));
+  }
+
+  std::string root;
+  std::vector<hipdev> hip;
+};
+
+TEST_F(DevRegTest, lookup) {
+  ASSERT_EQ(static_cast<size_t>(kGpus), devices().size());
+  for (int g = 0; g < kGpus; g++) {
+    uint16_t gpu_id = rvs::topogen::gpu_id(g);
+    const rvs::devinfo* dev = rvs::devreg::find_gpu(gpu_id);
+    ASSERT_NE(nullptr, dev);
+    EXPECT_EQ(kGpus - 1 - g, dev->hip_index);
+    EXPECT_EQ(rvs::topogen::location_id(g), dev->location_id);
+    EXPECT_EQ(rvs::topogen::domain(g), dev->domain);
+    EXPECT_EQ(-1, dev->smi_index);
+    EXPECT_EQ(dev, find_hip(dev->hip_index));
+    EXPECT_EQ(dev, find_node(dev->node_id));
+
+    uint16_t node_id;
+    int numa_node;
+    ASSERT_EQ(0, rvs::gpulist::gpu2node(gpu_id, &node_id));
+    ASSERT_EQ(0, rvs::gpulist::gpu2numa(gpu_id, &numa_node));
+    EXPECT_EQ(node_id, dev->node_id);
+    EXPECT_EQ(numa_node, dev->numa_node);
+  }
+  EXPECT_EQ(nullptr, find_hip(kGpus));
+  EXPECT_EQ(nullptr, rvs::devreg::find_gpu(0));
+  EXPECT_EQ(nullptr, hip_properties<int>(0));
+}
+
+TEST_F(DevRegTest, select) {
+  std::map<int, uint16_t> selected;
+  std::vector<uint16_t> gpus;
+
+  EXPECT_EQ(kGpus, select(true, gpus, 0, &selected));
+  EXPECT_EQ(0, selected.begin()->first);
+  EXPECT_EQ(rvs::topogen::gpu_id(kGpus - 1), selected.begin()->second);
+
+  gpus.push_back(rvs::topogen::gpu_id(3));
+  gpus.push_back(rvs::topogen::gpu_id(255));
+  gpus.push_back(0xBEEF);
+  EXPECT_EQ(2, select(false, gpus, 0, &selected));
+  EXPECT_EQ(rvs::topogen::gpu_id(3), selected[kGpus - 1 - 3]);
+  EXPECT_EQ(rvs::topogen::gpu_id(255), selected[kGpus - 1 - 255]);
+
+  rvs::topogen gen;
+  EXPECT_EQ(2, select(false, gpus, gen.device_id, &selected));
+  EXPECT_EQ(0, select(true, gpus, gen.device_id + 1, &selected));
+  EXPECT_TRUE(selected.empty());
+}
+
+TEST_F(DevRegTest, smi) {
+  // ROCm SMI enumerates GPUs in KFD order, with one unknown device first
+  std::vector<uint64_t> bdf;
+  bdf.push_back(0xFFFF);
+  for (int g = 0; g < kGpus; g++) {
+    bdf.push_back((static_cast<uint64_t>(rvs::topogen::domain(g)) << 32) |
+                  rvs::topogen::location_id(g));
+  }
+  set_smi(preg, bdf);
+  for (int g = 0; g < kGpus; g++) {
+    const rvs::devinfo* dev = rvs::devreg::find_gpu(rvs::topogen::gpu_id(g));
+    ASSERT_NE(nullptr, dev);
+    EXPECT_EQ(g + 1, dev->smi_index);
+  }
+
+  bdf.resize(1);
+  set_smi(preg, bdf);
+  EXPECT_EQ(-1, devices()[0].smi_index);
+}
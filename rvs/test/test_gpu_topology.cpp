@@ -0,0 +1,364 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <stdlib.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/gpu_util.h"
+#include "include/rvstopocache.h"
+
+namespace {
+
+const int num_cpus = 4;
+const int num_nodes = 64;
+
+// legacy per-field scan of topology (one pass per field), kept as reference
+void legacy_get(const std::string& Path, const std::string& Field,
+                std::vector<uint16_t>* pVals) {
+  int count = gpu_num_subdirs(Path.c_str(), "");
+  for (int node = 0; node < count; node++) {
+    std::string node_path = Path + "/" + std::to_string(node);
+    std::ifstream f_id(node_path + "/gpu_id");
+    int gpu_id = 0;
+    f_id >> gpu_id;
+    if (gpu_id == 0) {
+      continue;
+    }
+    if (Field == "gpu_id") {
+      pVals->push_back(gpu_id);
+      continue;
+    }
+    if (Field == "node_id") {
+      pVals->push_back(node);
+      continue;
+    }
+    std::ifstream f_prop(node_path + "/properties");
+    std::string name;
+    uint32_t val;
+    while (f_prop >> name) {
+      if (name == Field) {
+        f_prop >> val;
+        pVals->push_back(val);
+        break;
+      }
+    }
+  }
+}
+
+// legacy style NUMA lookup: scan io_links of GPU node for a CPU node
+int legacy_numa(const std::string& Path, int Node) {
+  std::string links_path = Path + "/" + std::to_string(Node) + "/io_links";
+  int count = gpu_num_subdirs(links_path.c_str(), "");
+  for (int link = 0; link < count; link++) {
+    std::ifstream f_prop(links_path + "/" + std::to_string(link) +
+                         "/properties");
+    std::string name;
+    int node_to = -1;
+    while (f_prop >> name) {
+      if (name == "node_to") {
+        f_prop >> node_to;
+        break;
+      }
+      f_prop >> name;
+    }
+    std::ifstream f_id(Path + "/" + std::to_string(node_to) + "/gpu_id");
+    int gpu_id = -1;
+    f_id >> gpu_id;
+    if (gpu_id == 0) {
+      return node_to;
+    }
+  }
+  return -1;
+}
+
+int legacy_find(const std::vector<uint16_t>& From,
+                const std::vector<uint16_t>& To, uint16_t Key,
+                uint16_t* pVal) {
+  auto it = std::find(From.cbegin(), From.cend(), Key);
+  if (it == From.cend()) {
+    return -1;
+  }
+  *pVal = To[std::distance(From.cbegin(), it)];
+  return 0;
+}
+
+class GpuTopologyTest : public ::testing::Test, public rvs::gpulist {
+ protected:
+  void SetUp() override {
+    char name[] = "/tmp/rvs_topology_XXXXXX";
+    ASSERT_NE(mkdtemp(name), nullptr);
+    dir_name = name;
+    setenv(RVS_TOPOLOGY_CACHE_ENV, "", 1);
+    // CPU nodes first, then GPUs spread evenly over CPU nodes; every GPU has
+    // a PCIe link to its CPU and XGMI links to the other GPUs of the hive
+    for (int node = 0; node < num_nodes; node++) {
+      std::string node_path = dir_name + "/" + std::to_string(node);
+      mkdir(node_path.c_str(), 0755);
+      mkdir((node_path + "/io_links").c_str(), 0755);
+      bool gpu = node >= num_cpus;
+      write(node_path + "/gpu_id", gpu ? std::to_string(gpu_id(node)) : "0");
+
+      std::string props;
+      props += "cpu_cores_count " + std::to_string(gpu ? 0 : 16) + "\n";
+      props += "simd_count " + std::to_string(gpu ? 240 : 0) + "\n";
+      props += "mem_banks_count 1\ncaches_count 206\nio_links_count 1\n";
+      props += "cpu_core_id_base 0\nsimd_id_base 2147487744\n";
+      props += "max_waves_per_simd 10\nlds_size_in_kb 64\ngds_size_in_kb 0\n";
+      props += "num_gws 64\nwave_front_size 64\narray_count 4\n";
+      props += "simd_arrays_per_engine 1\ncu_per_simd_array 10\n";
+      props += "simd_per_cu 4\nmax_slots_scratch_cu 32\n";
+      props += "vendor_id " + std::to_string(gpu ? 4098 : 0) + "\n";
+      props += "device_id " + std::to_string(gpu ? 0x66a0 + node : 0) + "\n";
+      props += "location_id " + std::to_string(gpu ? location(node) : 0) +
+               "\n";
+      props += "drm_render_minor 128\nhive_id 0\nnum_sdma_engines 2\n";
+      props += "num_sdma_xgmi_engines 6\nnum_cp_queues 24\n";
+      props += "max_engine_clk_fcompute 1700\nlocal_mem_size 0\n";
+      props += "fw_version 433\ncapability 671588992\n";
+      props += "max_engine_clk_ccompute 2200\n";
+      write(node_path + "/properties", props);
+
+      int link = 0;
+      if (gpu) {
+        add_link(node_path, link++, 2, node, cpu(node), 20);
+        for (int peer = num_cpus; peer < num_nodes; peer++) {
+          if (peer != node && hive(peer) == hive(node)) {
+            add_link(node_path, link++, 11, node, peer, 15);
+          }
+        }
+      } else {
+        for (int peer = 0; peer < num_cpus; peer++) {
+          if (peer != node) {
+            add_link(node_path, link++, 2, node, peer, 21);
+          }
+        }
+      }
+    }
+  }
+
+  void TearDown() override {
+    topology.clear();
+    build_index();
+    initialized = false;
+    unsetenv(RVS_TOPOLOGY_CACHE_ENV);
+    std::string cmd = "rm -rf " + dir_name;
+    ASSERT_EQ(0, system(cmd.c_str()));
+  }
+
+  static uint16_t gpu_id(int Node) { return 1000 + Node * 7; }
+  static uint16_t location(int Node) { return (Node << 8) | 0x10; }
+  static int cpu(int Node) { return Node % num_cpus; }
+  static int hive(int Node) { return (Node - num_cpus) / 8; }
+
+  void write(const std::string& Path, const std::string& Content) {
+    std::ofstream f(Path);
+    f << Content;
+  }
+
+  void add_link(const std::string& NodePath, int Link, int Type, int From,
+                int To, int Weight) {
+    std::string link_path = NodePath + "/io_links/" + std::to_string(Link);
+    mkdir(link_path.c_str(), 0755);
+    write(link_path + "/properties",
+          "type " + std::to_string(Type) + "\nversion_major 0\n"
+          "version_minor 0\nnode_from " + std::to_string(From) +
+          "\nnode_to " + std::to_string(To) + "\nweight " +
+          std::to_string(Weight) + "\nmin_latency 0\nmax_latency 0\n"
+          "min_bandwidth 312\nmax_bandwidth 64000\n"
+          "recommended_transfer_size 0\nflags 1\n");
+  }
+
+  std::string dir_name;
+};
+
+}  // namespace
+
+TEST_F(GpuTopologyTest, snapshot) {
+  std::vector<rvs::kfd_node> nodes;
+  ASSERT_EQ(0, gpu_load_topology(dir_name.c_str(), &nodes));
+  ASSERT_EQ(static_cast<size_t>(num_nodes), nodes.size());
+
+  for (int i = 0; i < num_nodes; i++) {
+    const rvs::kfd_node& node = nodes[i];
+    bool gpu = i >= num_cpus;
+    EXPECT_EQ(i, node.node_id);
+    EXPECT_EQ(gpu ? gpu_id(i) : 0, node.gpu_id);
+    EXPECT_EQ(gpu ? location(i) : 0, node.location_id);
+    EXPECT_EQ(gpu ? 0x66a0 + i : 0, node.device_id);
+    EXPECT_EQ(gpu ? 4098 : 0, node.vendor_id);
+    EXPECT_EQ(gpu ? cpu(i) : i, node.numa_node);
+    EXPECT_EQ(30u, node.properties.size());
+    size_t links = 3;
+    if (gpu) {
+      links = hive(i) == hive(num_nodes - 1) ? 4 : 8;
+    }
+    EXPECT_EQ(links, node.io_links.size());
+  }
+
+  uint64_t val;
+  EXPECT_TRUE(nodes[10].property("simd_id_base", &val));
+  EXPECT_EQ(2147487744u, val);
+  EXPECT_FALSE(nodes[10].property("missing", &val));
+
+  const rvs::kfd_iolink& link = nodes[10].io_links[1];
+  EXPECT_EQ(11u, link.type);
+  EXPECT_EQ(10, link.node_from);
+  EXPECT_EQ(4, link.node_to);
+  EXPECT_EQ(15u, link.weight);
+
+  EXPECT_EQ(-1, gpu_load_topology((dir_name + "/none").c_str(), &nodes));
+  EXPECT_TRUE(nodes.empty());
+}
+
+TEST_F(GpuTopologyTest, lookup) {
+  ASSERT_EQ(0, Initialize(dir_name.c_str()));
+  EXPECT_EQ(static_cast<size_t>(num_nodes), nodes().size());
+
+  for (int i = num_cpus; i < num_nodes; i++) {
+    uint16_t val;
+    int numa;
+    EXPECT_EQ(0, gpu2location(gpu_id(i), &val));
+    EXPECT_EQ(location(i), val);
+    EXPECT_EQ(0, location2gpu(location(i), &val));
+    EXPECT_EQ(gpu_id(i), val);
+    EXPECT_EQ(0, node2gpu(i, &val));
+    EXPECT_EQ(gpu_id(i), val);
+    EXPECT_EQ(0, gpu2node(gpu_id(i), &val));
+    EXPECT_EQ(i, val);
+    EXPECT_EQ(0, location2node(location(i), &val));
+    EXPECT_EQ(i, val);
+    EXPECT_EQ(0, gpu2device(gpu_id(i), &val));
+    EXPECT_EQ(0x66a0 + i, val);
+    EXPECT_EQ(0, gpu2numa(gpu_id(i), &numa));
+    EXPECT_EQ(cpu(i), numa);
+    ASSERT_NE(nullptr, gpu2info(gpu_id(i)));
+    EXPECT_EQ(gpu2info(gpu_id(i))->numa_node, numa);
+  }
+
+  // gpu_get_all_*() helpers are served from the same snapshot
+  std::vector<uint16_t> ids;
+  gpu_get_all_node_id(&ids);
+  ASSERT_EQ(static_cast<size_t>(num_nodes - num_cpus), ids.size());
+  EXPECT_EQ(num_cpus, ids[0]);
+  ids.clear();
+  gpu_get_all_location_id(&ids);
+  ASSERT_EQ(static_cast<size_t>(num_nodes - num_cpus), ids.size());
+  EXPECT_EQ(location(num_cpus), ids[0]);
+
+  // CPU nodes are not GPUs
+  uint16_t val;
+  EXPECT_EQ(-1, node2gpu(0, &val));
+  EXPECT_EQ(-1, location2gpu(0, &val));
+  EXPECT_EQ(-1, gpu2node(0, &val));
+  EXPECT_EQ(-1, node2gpu(1000, &val));
+  EXPECT_EQ(nullptr, gpu2info(1));
+}
+
+// compares legacy per-field scans and linear lookups with single pass
+// snapshot and indexed lookups
+TEST_F(GpuTopologyTest, benchmark) {
+  const int loops = 20;
+  const int lookups = 100000;
+  std::vector<uint16_t> loc, gpu, dev, node;
+  std::vector<int> numa;
+  uint64_t sum = 0;
+
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < loops; i++) {
+    loc.clear();
+    gpu.clear();
+    dev.clear();
+    node.clear();
+    numa.clear();
+    legacy_get(dir_name, "location_id", &loc);
+    legacy_get(dir_name, "gpu_id", &gpu);
+    legacy_get(dir_name, "device_id", &dev);
+    legacy_get(dir_name, "node_id", &node);
+    for (uint16_t n : node) {
+      numa.push_back(legacy_numa(dir_name, n));
+    }
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  for (int j = 0; j < lookups; j++) {
+    uint16_t val = 0;
+    int n = num_cpus + j % (num_nodes - num_cpus);
+    legacy_find(gpu, loc, gpu_id(n), &val);
+    sum += val;
+    legacy_find(loc, node, location(n), &val);
+    sum += val;
+    legacy_find(node, gpu, n, &val);
+    sum += val;
+    legacy_find(gpu, dev, gpu_id(n), &val);
+    sum += val;
+  }
+  auto t2 = std::chrono::steady_clock::now();
+  for (int i = 0; i < loops; i++) {
+    Initialize(dir_name.c_str());
+  }
+  auto t3 = std::chrono::steady_clock::now();
+  uint64_t sum_snapshot = 0;
+  for (int j = 0; j < lookups; j++) {
+    uint16_t val = 0;
+    int n = num_cpus + j % (num_nodes - num_cpus);
+    gpu2location(gpu_id(n), &val);
+    sum_snapshot += val;
+    location2node(location(n), &val);
+    sum_snapshot += val;
+    node2gpu(n, &val);
+    sum_snapshot += val;
+    gpu2device(gpu_id(n), &val);
+    sum_snapshot += val;
+  }
+  auto t4 = std::chrono::steady_clock::now();
+
+  EXPECT_EQ(sum, sum_snapshot);
+  for (size_t i = 0; i < node.size(); i++) {
+    int val;
+    EXPECT_EQ(0, gpu2numa(gpu[i], &val));
+    EXPECT_EQ(numa[i], val);
+  }
+  std::cout << "legacy init: "
+            << std::chrono::duration<double, std::milli>(t1 - t0).count() /
+               loops
+            << " ms  lookup: "
+            << std::chrono::duration<double, std::nano>(t2 - t1).count() /
+               lookups / 4
+            << " ns" << std::endl;
+  std::cout << "snapshot init: "
+            << std::chrono::duration<double, std::milli>(t3 - t2).count() /
+               loops
+            << " ms  lookup: "
+            << std::chrono::duration<double, std::nano>(t4 - t3).count() /
+               lookups / 4
+            << " ns" << std::endl;
+}
@@ -39,14 +39,29 @@ class GpuUtilTest : public ::testing::Test , public rvs::gpulist {
     gpu_id      = {1, 2, 5, 4, 9, 7};
     device_id   = {3, 0, 2, 7, 5, 1};
     node_id     = {2, 1, 3, 7, 4, 9};
+
+    for (size_t i = 0; i < gpu_id.size(); i++) {
+      rvs::kfd_node node;
+      node.node_id = node_id[i];
+      node.gpu_id = gpu_id[i];
+      node.location_id = location_id[i];
+      node.device_id = device_id[i];
+      node.vendor_id = 0x1002;
+      node.numa_node = -1;
+      topology.push_back(node);
+    }
+    build_index();
   }
 
   void TearDown() override {
-    location_id.clear();
-    gpu_id.clear();
-    device_id.clear();
-    node_id.clear();
+    topology.clear();
+    build_index();
   }
+
+  std::vector<uint16_t> location_id;
+  std::vector<uint16_t> gpu_id;
+  std::vector<uint16_t> device_id;
+  std::vector<uint16_t> node_id;
 };
 
 TEST_F(GpuUtilTest, gpu_util) {
@@ -0,0 +1,190 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/rvsactionconfig.h"
+#include "include/rvsactionresult.h"
+#include "include/rvsactionbase.h"
+#include "include/rvsliblogger.h"
+#include "include/rvs_unit_testing_defs.h"
+
+namespace {
+
+// action reporting results through IF2 helpers
+class if2_test_action : public rvs::actionbase {
+ public:
+  int run(void) override {
+    std::string val;
+    if (!has_property("count", &val) || val != "3") {
+      return -1;
+    }
+    result_device(1, true);
+    result_device(2, false);
+    result_metric(1, "bandwidth", 12.5, "GBps");
+    result_duration("run", 0.25);
+    return 0;
+  }
+};
+
+}  // namespace
+
+TEST(if2, config_types) {
+  int64_t ival;
+  double dval;
+  std::vector<uint64_t> list;
+
+  EXPECT_EQ(RVS_PROP_BOOL, rvs::actionconfig::parse("true", &ival, &dval,
+                                                     &list));
+  EXPECT_EQ(1, ival);
+  EXPECT_EQ(RVS_PROP_BOOL, rvs::actionconfig::parse("false", &ival, &dval,
+                                                     &list));
+  EXPECT_EQ(0, ival);
+
+  EXPECT_EQ(RVS_PROP_INT, rvs::actionconfig::parse("-42", &ival, &dval,
+                                                    &list));
+  EXPECT_EQ(-42, ival);
+  EXPECT_DOUBLE_EQ(-42.0, dval);
+
+  EXPECT_EQ(RVS_PROP_DOUBLE, rvs::actionconfig::parse("0.75", &ival, &dval,
+                                                       &list));
+  EXPECT_DOUBLE_EQ(0.75, dval);
+  EXPECT_EQ(RVS_PROP_DOUBLE, rvs::actionconfig::parse("1e3", &ival, &dval,
+                                                       &list));
+  EXPECT_DOUBLE_EQ(1000.0, dval);
+
+  EXPECT_EQ(RVS_PROP_LIST, rvs::actionconfig::parse("0 1,  2", &ival, &dval,
+                                                     &list));
+  ASSERT_EQ(3u, list.size());
+  EXPECT_EQ(2u, list[2]);
+
+  EXPECT_EQ(RVS_PROP_STRING, rvs::actionconfig::parse("all", &ival, &dval,
+                                                       &list));
+  EXPECT_EQ(RVS_PROP_STRING, rvs::actionconfig::parse("nan", &ival, &dval,
+                                                       &list));
+  EXPECT_EQ(RVS_PROP_STRING, rvs::actionconfig::parse("", &ival, &dval,
+                                                       &list));
+  EXPECT_EQ(RVS_PROP_STRING, rvs::actionconfig::parse("1-2", &ival, &dval,
+                                                       &list));
+}
+
+TEST(if2, config_view) {
+  rvs::actionconfig config;
+  config.add("name", "action_1");
+  config.add("device", "3 4");
+  config.add("count", "3");
+
+  const T_RVS_CONFIG* p = config.get();
+  ASSERT_EQ(3u, p->count);
+  EXPECT_STREQ("name", p->props[0].key);
+  EXPECT_EQ(RVS_PROP_STRING, p->props[0].type);
+  EXPECT_EQ(RVS_PROP_LIST, p->props[1].type);
+  ASSERT_EQ(2u, p->props[1].count);
+  EXPECT_EQ(4u, p->props[1].list[1]);
+  EXPECT_EQ(3, p->props[2].ival);
+  EXPECT_STREQ("3", p->props[2].text);
+}
+
+TEST(if2, result_sink) {
+  rvs::logger::quiet();
+  rvs::actionresult result("gst", "action_1");
+  EXPECT_TRUE(result.empty());
+
+  T_RVS_RESULT_SINK* sink = result.sink();
+  std::vector<std::thread> threads;
+  for (uint16_t i = 0; i < 8; i++) {
+    threads.push_back(std::thread([sink, i]() {
+      (*sink->cbDevice)(sink->ctx, i % 4, i != 5);
+      (*sink->cbMetric)(sink->ctx, i % 4, "gflops", i, "GFLOPS");
+    }));
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  (*sink->cbDuration)(sink->ctx, "test", 1.5);
+
+  EXPECT_FALSE(result.empty());
+  EXPECT_EQ(3u, result.passed());
+  EXPECT_EQ(1u, result.failed());
+  EXPECT_FALSE(result.devices()[1]);
+  EXPECT_EQ(8u, result.metrics().size());
+  ASSERT_EQ(1u, result.durations().size());
+  EXPECT_DOUBLE_EQ(1.5, result.durations()[0].second);
+  EXPECT_NE(std::string::npos,
+            result.summary().find("passed: 3 failed: 1 metrics: 8"));
+}
+
+TEST(if2, result_totals) {
+  rvs::logger::quiet();
+  // each run keeps its own totals
+  rvs::resulttotals run_a;
+  rvs::resulttotals run_b;
+
+  for (int i = 0; i < 2; i++) {
+    rvs::actionresult result("gst", "action_1", &run_a);
+    T_RVS_RESULT_SINK* sink = result.sink();
+    (*sink->cbDevice)(sink->ctx, 1, 1);
+    (*sink->cbDevice)(sink->ctx, 2, i);
+    result.report();
+  }
+  {
+    rvs::actionresult result("mem", "action_2", &run_b);
+    T_RVS_RESULT_SINK* sink = result.sink();
+    (*sink->cbDevice)(sink->ctx, 1, 0);
+    result.report();
+  }
+
+  EXPECT_EQ(2u, run_a.actions());
+  EXPECT_EQ(3u, run_a.passed());
+  EXPECT_EQ(1u, run_a.failed());
+  EXPECT_EQ(1u, run_b.actions());
+  EXPECT_EQ(0u, run_b.passed());
+  EXPECT_EQ(1u, run_b.failed());
+
+  run_a.reset();
+  EXPECT_EQ(0u, run_a.actions());
+  EXPECT_EQ(1u, run_b.actions());
+}
+
+TEST(if2, action_execute) {
+  if2_test_action action;
+  rvs::actionconfig config;
+  config.add("count", "3");
+  ASSERT_EQ(0, action.configure(config.get()));
+
+  rvs::actionresult result("test", "action_1");
+  EXPECT_EQ(0, action.execute(result.sink()));
+  EXPECT_EQ(1u, result.passed());
+  EXPECT_EQ(1u, result.failed());
+  ASSERT_EQ(1u, result.metrics().size());
+  EXPECT_EQ("GBps", result.metrics()[0].unit);
+
+  // results are not reported outside of execute()
+  EXPECT_EQ(0, action.run());
+  EXPECT_EQ(1u, result.metrics().size());
+}
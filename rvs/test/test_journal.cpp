@@ -0,0 +1,151 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "include/rvsjournal.h"
+#include "include/rvsliblogger.h"
+#include "include/rvs_unit_testing_defs.h"
+
+class JournalTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char name[] = "/tmp/rvs_journal_XXXXXX";
+    ASSERT_NE(mkdtemp(name), nullptr);
+    dir_name = name;
+    conf_name = dir_name + "/suite.conf";
+    journal_name = dir_name + "/rvs.log.journal";
+    write_conf("actions:\n- name: a\n  module: gpup\n");
+    rvs::logger::quiet();
+  }
+
+  void TearDown() override {
+    unlink(conf_name.c_str());
+    unlink(journal_name.c_str());
+    unlink((journal_name + ".tmp").c_str());
+    rmdir(dir_name.c_str());
+  }
+
+  void write_conf(const std::string& Content) {
+    std::ofstream f(conf_name);
+    f << Content;
+  }
+
+  std::string read_journal() {
+    std::ifstream f(journal_name);
+    std::stringstream ss;
+    ss << f.rdbuf();
+    return ss.str();
+  }
+
+  std::string dir_name;
+  std::string conf_name;
+  std::string journal_name;
+};
+
+TEST_F(JournalTest, record) {
+  rvs::journal j;
+  ASSERT_EQ(0, j.open(journal_name, conf_name, false));
+  EXPECT_EQ(0u, j.size());
+  EXPECT_EQ(0, access(journal_name.c_str(), F_OK));
+
+  EXPECT_FALSE(j.resuming());
+  EXPECT_FALSE(j.done(0, "gst stress"));
+  ASSERT_EQ(0, j.complete(0, "gst stress", 0, 8, 0));
+  ASSERT_EQ(0, j.complete(1, "mem", -1, 7, 1));
+  ASSERT_EQ(0, j.complete(2, "sweep", 0, 1, 0, 2));
+  EXPECT_TRUE(j.done(0, "gst stress"));
+  EXPECT_FALSE(j.done(1, "mem"));
+  EXPECT_TRUE(j.done(2, "sweep", 2));
+  EXPECT_FALSE(j.done(2, "sweep"));
+  EXPECT_FALSE(j.done(2, "sweep", 1));
+
+  // same action listed again later in .conf file
+  EXPECT_FALSE(j.done(3, "gst stress"));
+
+  // temporary file is renamed over journal
+  EXPECT_NE(0, access((journal_name + ".tmp").c_str(), F_OK));
+  std::string content = read_journal();
+  EXPECT_EQ(0u, content.find("RVS-JOURNAL 2\nconfig "));
+  EXPECT_NE(std::string::npos, content.find("action 0 0 8 0 gst stress\n"));
+  EXPECT_NE(std::string::npos, content.find("action 1 -1 7 1 mem\n"));
+  EXPECT_NE(std::string::npos, content.find("variant 2 2 0 1 0 sweep\n"));
+}
+
+TEST_F(JournalTest, resume) {
+  {
+    rvs::journal j;
+    ASSERT_EQ(0, j.open(journal_name, conf_name, false));
+    j.complete(0, "gst stress", 0, 8, 0);
+    j.complete(1, "mem", -1, 7, 1);
+    j.complete(2, "sweep", 0, 1, 0, 3);
+  }
+
+  rvs::journal j;
+  ASSERT_EQ(0, j.open(journal_name, conf_name, true));
+  EXPECT_TRUE(j.resuming());
+  EXPECT_EQ(3u, j.size());
+  EXPECT_TRUE(j.done(0, "gst stress"));
+  EXPECT_FALSE(j.done(1, "mem"));
+  EXPECT_TRUE(j.done(2, "sweep", 3));
+  EXPECT_FALSE(j.done(4, "gst stress"));
+
+  // failed action succeeds on rerun
+  j.complete(1, "mem", 0, 8, 0);
+  EXPECT_TRUE(j.done(1, "mem"));
+
+  // without resume previous records are dropped
+  rvs::journal fresh;
+  ASSERT_EQ(0, fresh.open(journal_name, conf_name, false));
+  EXPECT_EQ(0u, fresh.size());
+}
+
+TEST_F(JournalTest, resume_refused) {
+  {
+    rvs::journal j;
+    ASSERT_EQ(0, j.open(journal_name, conf_name, false));
+    j.complete(0, "a", 0, 1, 0);
+  }
+
+  write_conf("actions:\n- name: b\n  module: gpup\n");
+  rvs::journal j;
+  EXPECT_NE(0, j.open(journal_name, conf_name, true));
+
+  // not a journal
+  std::ofstream(journal_name) << "garbage\n";
+  EXPECT_NE(0, j.open(journal_name, conf_name, true));
+}
+
+TEST_F(JournalTest, resume_missing) {
+  rvs::journal j;
+  ASSERT_EQ(0, j.open(journal_name, conf_name, true));
+  EXPECT_EQ(0u, j.size());
+}
@@ -0,0 +1,152 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "include/rvsliblogger.h"
+#include "include/rvslinereader.h"
+#include "include/rvs_unit_testing_defs.h"
+
+class JsonlTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char name[] = "/tmp/rvs_jsonl_XXXXXX";
+    int fd = mkstemp(name);
+    ::close(fd);
+    file_name = name;
+
+    rvs::logger::set_log_file(file_name);
+    rvs::logger::to_json(true);
+    rvs::logger::jsonl(true);
+    rvs::logger::append(false);
+  }
+
+  void TearDown() override {
+    rvs::logger::set_log_file("");
+    rvs::logger::to_json(false);
+    rvs::logger::jsonl(false);
+    rvs::logger::append(false);
+    unlink(file_name.c_str());
+  }
+
+  static void write_records(int Count, int Id) {
+    for (int i = 0; i < Count; i++) {
+      void* r = rvs::logger::LogRecordCreate("test", "jsonl",
+                                             rvs::logresults, 1, 2);
+      rvs::logger::AddInt(r, "id", Id);
+      rvs::logger::AddInt(r, "seq", i);
+      rvs::logger::AddString(r, "msg", "quoted \"value\"");
+      rvs::logger::LogRecordFlush(r);
+    }
+  }
+
+  // check that every line is one complete record, return number of lines
+  int check_lines() {
+    rvs::LineReader reader;
+    std::string line;
+    int lines = 0;
+
+    EXPECT_EQ(reader.open(file_name), 0);
+    while (reader.next(&line) == 1) {
+      EXPECT_EQ(line.front(), '{');
+      EXPECT_EQ(line.back(), '}');
+      EXPECT_NE(line.find("\"module\":\"test\""), std::string::npos);
+      EXPECT_NE(line.find("\"msg\":\"quoted \\\"value\\\"\"}"),
+                std::string::npos);
+      lines++;
+    }
+
+    return lines;
+  }
+
+  std::string file_name;
+};
+
+TEST_F(JsonlTest, append_without_patching) {
+  EXPECT_EQ(rvs::logger::init_log_file(), 0);
+  write_records(100, 0);
+  EXPECT_EQ(rvs::logger::terminate(), 0);
+  EXPECT_EQ(check_lines(), 100);
+
+  // second run appends to the same file
+  rvs::logger::append(true);
+  EXPECT_EQ(rvs::logger::init_log_file(), 0);
+  write_records(50, 1);
+  EXPECT_EQ(rvs::logger::terminate(), 0);
+  EXPECT_EQ(check_lines(), 150);
+}
+
+TEST_F(JsonlTest, concurrent_runs) {
+  const int runs = 4;
+  const int count = 5000;
+
+  rvs::logger::append(true);
+  for (int i = 0; i < runs; i++) {
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+      rvs::logger::init_log_file();
+      write_records(count, i);
+      rvs::logger::terminate();
+      _exit(0);
+    }
+  }
+
+  for (int i = 0; i < runs; i++) {
+    int status;
+    wait(&status);
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+  }
+
+  EXPECT_EQ(check_lines(), runs * count);
+}
+
+TEST_F(JsonlTest, line_reader) {
+  FILE* f = fopen(file_name.c_str(), "w");
+  ASSERT_NE(f, nullptr);
+  std::string long_line(3 * RVS_LINEREADER_BUFFER_SIZE + 7, 'x');
+  fprintf(f, "first\n\n%s\nlast", long_line.c_str());
+  fclose(f);
+
+  rvs::LineReader reader;
+  std::string line;
+  ASSERT_EQ(reader.open(file_name), 0);
+  EXPECT_EQ(reader.next(&line), 1);
+  EXPECT_EQ(line, "first");
+  EXPECT_EQ(reader.next(&line), 1);
+  EXPECT_EQ(line, "");
+  EXPECT_EQ(reader.next(&line), 1);
+  EXPECT_EQ(line, long_line);
+  EXPECT_EQ(reader.next(&line), 1);
+  EXPECT_EQ(line, "last");
+  EXPECT_EQ(reader.next(&line), 0);
+
+  EXPECT_NE(reader.open(file_name + ".missing"), 0);
+}
@@ -0,0 +1,373 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "include/rvsjsonwriter.h"
+#include "include/rvslognode.h"
+#include "include/rvslognoderec.h"
+#include "include/rvslognodestring.h"
+#include "include/rvslognodeint.h"
+#include "include/rvs_unit_testing_defs.h"
+
+class ext_base : public rvs::LogNodeBase {
+ public:
+  const char* get_Name() { return Name; }
+  rvs::T_LNTYPE get_Type() { return Type; }
+};
+
+class ext_string : public rvs::LogNodeString {
+ public:
+  const char* get_Value() { return Value; }
+};
+
+class ext_int : public rvs::LogNodeInt {
+ public:
+  int get_Value() { return Value; }
+};
+
+class ext_rec : public rvs::LogNodeRec {
+ public:
+  int get_Level() { return Level; }
+  int get_sec() { return sec; }
+  int get_usec() { return usec; }
+};
+
+// previous implementation: recursive string concatenation
+static std::string legacy_json(rvs::LogNodeBase* pNode,
+                               const std::string& Lead) {
+  ext_base* b = static_cast<ext_base*>(pNode);
+  std::string result(RVSENDL);
+
+  switch (b->get_Type()) {
+  case rvs::eLN::String:
+      result += Lead + "\"" + b->get_Name() + "\"" + " : " + "\"" +
+                static_cast<ext_string*>(pNode)->get_Value() + "\"";
+      return result;
+  case rvs::eLN::Integer:
+      result += Lead + "\"" + b->get_Name() + "\"" + " : " +
+                std::to_string(static_cast<ext_int*>(pNode)->get_Value());
+      return result;
+  case rvs::eLN::Record: {
+      ext_rec* r = static_cast<ext_rec*>(pNode);
+      char  buff[64];
+      snprintf(buff, sizeof(buff), "%6d.%-6d", r->get_sec(), r->get_usec());
+      result += Lead + "{";
+      result += RVSENDL;
+      result += Lead + RVSINDENT;
+      result += std::string("\"") + "loglevel" + "\"" + " : " +
+                std::to_string(r->get_Level()) + ",";
+      result += RVSENDL;
+      result += Lead + RVSINDENT;
+      result += std::string("\"") + "time" + "\"" + " : " +
+                std::string("\"") + buff + std::string("\"")  + ",";
+      break;
+    }
+  default:
+      result += Lead + "\"" + b->get_Name() + "\"" + " : {";
+      break;
+  }
+
+  rvs::LogNode* n = static_cast<rvs::LogNode*>(pNode);
+  for (size_t i = 0; i < n->Child.size(); i++) {
+    result += legacy_json(n->Child[i], Lead + RVSINDENT);
+    if (i + 1 < n->Child.size()) {
+      result += ",";
+    }
+  }
+  result += RVSENDL + Lead + "}";
+
+  return result;
+}
+
+// GM style record: 20 metrics for 8 GPUs
+static rvs::LogNodeRec* gm_record() {
+  rvs::LogNodeRec* r = new rvs::LogNodeRec("monitor", 3, 1234, 567);
+  r->Add(new rvs::LogNodeString("action", "monitor", r));
+  r->Add(new rvs::LogNodeString("module", "gm", r));
+  r->Add(new rvs::LogNodeString("loglevelname", "INFO  ", r));
+  for (int g = 0; g < 8; g++) {
+    rvs::LogNode* n = new rvs::LogNode("gpu", r);
+    n->Add(new rvs::LogNodeInt("gpu_id", 3254 + g, n));
+    for (int m = 0; m < 20; m++) {
+      std::string name = "metric_" + std::to_string(m);
+      n->Add(new rvs::LogNodeString(name.c_str(), "1234 MHz", n));
+    }
+    r->Add(n);
+  }
+  return r;
+}
+
+// PQT style record: bandwidth for all pairs of 8 GPUs
+static rvs::LogNodeRec* pqt_record() {
+  rvs::LogNodeRec* r = new rvs::LogNodeRec("pqt_bw", 1, 1234, 567);
+  r->Add(new rvs::LogNodeString("action", "pqt_bw", r));
+  r->Add(new rvs::LogNodeString("module", "pqt", r));
+  r->Add(new rvs::LogNodeString("loglevelname", "RESULT", r));
+  for (int src = 0; src < 8; src++) {
+    for (int dst = 0; dst < 8; dst++) {
+      rvs::LogNode* n = new rvs::LogNode("transfer", r);
+      n->Add(new rvs::LogNodeInt("src", src, n));
+      n->Add(new rvs::LogNodeInt("dst", dst, n));
+      n->Add(new rvs::LogNodeString("bidirectional", "true", n));
+      n->Add(new rvs::LogNodeString("bandwidth", "21.356 GBps", n));
+      n->Add(new rvs::LogNodeString("duration", "1.024 sec", n));
+      r->Add(n);
+    }
+  }
+  return r;
+}
+
+TEST(JsonWriter, escape) {
+  std::string out;
+  rvs::JsonWriter::escape(&out, "plain");
+  EXPECT_STREQ(out.c_str(), "plain");
+
+  out.clear();
+  rvs::JsonWriter::escape(&out, "a\"b\\c\nd\te\x01");
+  EXPECT_STREQ(out.c_str(), "a\\\"b\\\\c\\nd\\te\\u0001");
+
+  rvs::LogNodeString node("path \"x\"", "C:\\dir \"name\"");
+  EXPECT_STREQ(node.ToJson().c_str(),
+               "\n\"path \\\"x\\\"\" : \"C:\\\\dir \\\"name\\\"\"");
+}
+
+TEST(JsonWriter, numbers) {
+  struct {
+    double value;
+    const char* text;
+  } doubles[] = {
+    {0.0, "0"}, {-0.0, "-0"}, {1.0, "1"}, {-42.0, "-42"}, {0.5, "0.5"},
+    {12.345, "12.345"}, {0.001, "0.001"}, {150.25, "150.25"},
+    {0.1 + 0.2, "0.30000000000000004"}, {1.0 / 3, "0.3333333333333333"},
+    {1e21, "1e+21"}, {1.5e-12, "1.5e-12"}, {123456789012345.0,
+    "123456789012345"}, {NAN, "null"}, {-INFINITY, "null"},
+  };
+
+  for (auto& d : doubles) {
+    std::string out;
+    rvs::JsonWriter::number(&out, d.value);
+    EXPECT_STREQ(out.c_str(), d.text);
+  }
+
+  std::string out;
+  rvs::JsonWriter::number(&out, static_cast<uint64_t>(18446744073709551615u));
+  out += " ";
+  rvs::JsonWriter::number(&out, static_cast<int64_t>(INT64_MIN));
+  EXPECT_STREQ(out.c_str(), "18446744073709551615 -9223372036854775808");
+
+  out.clear();
+  rvs::JsonWriter writer(&out, rvs::JsonWriter::compact);
+  writer.begin_object();
+  writer.member("b", true);
+  writer.separator();
+  writer.begin_array("a");
+  writer.element(static_cast<int64_t>(-1));
+  writer.element(static_cast<uint64_t>(2));
+  writer.element(2.5);
+  writer.end_array();
+  writer.separator();
+  writer.begin_array("e");
+  writer.end_array();
+  writer.end_object();
+  EXPECT_STREQ(out.c_str(), "{\"b\":true,\"a\":[-1,2,2.5],\"e\":[]}");
+}
+
+TEST(JsonWriter, double_round_trip) {
+  std::mt19937_64 rng(1234);
+  std::uniform_real_distribution<double> metric(0, 1000);
+  const int count = 200000;
+  std::string out;
+
+  // arbitrary bit patterns and typical metrics rounded to a few decimals
+  int longer = 0;
+  for (int i = 0; i < count; i++) {
+    double d;
+    if (i % 2) {
+      uint64_t bits = rng();
+      memcpy(&d, &bits, sizeof(d));
+    } else {
+      d = round(metric(rng) * 1000) / 1000;
+    }
+    if (!isfinite(d)) {
+      continue;
+    }
+
+    out.clear();
+    rvs::JsonWriter::number(&out, d);
+    double back = strtod(out.c_str(), nullptr);
+    ASSERT_EQ(memcmp(&back, &d, sizeof(d)), 0) << out;
+
+    // compare number of significant digits with the shortest %g output
+    int precision = 1;
+    char buff[32];
+    for (; precision < 17; precision++) {
+      snprintf(buff, sizeof(buff), "%.*g", precision, d);
+      if (strtod(buff, nullptr) == d) {
+        break;
+      }
+    }
+    std::string mantissa = out.substr(0, out.find('e'));
+    mantissa.erase(std::remove(mantissa.begin(), mantissa.end(), '.'),
+                   mantissa.end());
+    size_t first = mantissa.find_first_not_of("-0");
+    size_t last = mantissa.find_last_not_of('0');
+    int digits = static_cast<int>(last - first + 1);
+    ASSERT_LE(digits, 17) << out;
+    if (digits > precision) {
+      longer++;
+    }
+  }
+  // Grisu2 is not always the shortest, but very nearly so
+  EXPECT_LT(longer, count / 1000);
+  std::cout << "doubles: " << longer << " of " << count
+            << " not the shortest" << std::endl;
+
+  // formatting speed against std::to_string() (which does not round trip)
+  double values[1000];
+  for (int i = 0; i < 1000; i++) {
+    values[i] = i % 4 ? round(metric(rng) * 100) / 100 : metric(rng);
+  }
+  size_t bytes = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (int j = 0; j < 500; j++) {
+    for (double v : values) {
+      bytes += std::to_string(v).size();
+    }
+  }
+  std::chrono::duration<double> to_string_time =
+    std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  for (int j = 0; j < 500; j++) {
+    for (double v : values) {
+      out.clear();
+      rvs::JsonWriter::number(&out, v);
+      bytes += out.size();
+    }
+  }
+  std::chrono::duration<double> number_time =
+    std::chrono::steady_clock::now() - start;
+
+  EXPECT_GT(bytes, 0u);
+  std::cout << "doubles: std::to_string " << 500000 / to_string_time.count()
+            << " values/s, JsonWriter::number "
+            << 500000 / number_time.count() << " values/s" << std::endl;
+}
+
+TEST(JsonWriter, compact) {
+  rvs::LogNodeRec* r = new rvs::LogNodeRec("rec", 3, 1, 2);
+  r->Add(new rvs::LogNodeString("module", "gst", r));
+  rvs::LogNode* n = new rvs::LogNode("gpu", r);
+  n->Add(new rvs::LogNodeInt("gpu_id", 3254, n));
+  n->Add(new rvs::LogNodeInt("neg", -1, n));
+  r->Add(n);
+
+  std::string out;
+  rvs::JsonWriter writer(&out, rvs::JsonWriter::compact);
+  r->WriteJson(&writer);
+  EXPECT_STREQ(out.c_str(),
+               "{\"loglevel\":3,\"time\":\"     1.2     \","
+               "\"module\":\"gst\",\"gpu\":{\"gpu_id\":3254,\"neg\":-1}}");
+
+  // empty record stays well-formed in compact layout
+  rvs::LogNodeRec empty("empty", 1, 1, 2);
+  out.clear();
+  rvs::JsonWriter writer2(&out, rvs::JsonWriter::compact);
+  empty.WriteJson(&writer2);
+  EXPECT_STREQ(out.c_str(), "{\"loglevel\":1,\"time\":\"     1.2     \"}");
+
+  delete r;
+}
+
+TEST(JsonWriter, pretty_matches_legacy) {
+  rvs::LogNodeRec* records[] = {gm_record(), pqt_record()};
+
+  for (rvs::LogNodeRec* r : records) {
+    EXPECT_EQ(r->ToJson("  "), legacy_json(r, "  "));
+    EXPECT_EQ(r->ToJson(), legacy_json(r, ""));
+    delete r;
+  }
+}
+
+TEST(JsonWriter, throughput) {
+  const char* names[] = {"GM", "PQT"};
+  rvs::LogNodeRec* records[] = {gm_record(), pqt_record()};
+  const int count = 2000;
+
+  for (int i = 0; i < 2; i++) {
+    rvs::LogNodeRec* r = records[i];
+    std::string out;
+    size_t bytes = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int j = 0; j < count; j++) {
+      out.clear();
+      out += legacy_json(r, "  ");
+      bytes += out.size();
+    }
+    std::chrono::duration<double> legacy_time =
+      std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (int j = 0; j < count; j++) {
+      out.clear();
+      rvs::JsonWriter writer(&out, rvs::JsonWriter::pretty, RVSINDENT);
+      r->WriteJson(&writer);
+      bytes += out.size();
+    }
+    std::chrono::duration<double> stream_time =
+      std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (int j = 0; j < count; j++) {
+      out.clear();
+      rvs::JsonWriter writer(&out, rvs::JsonWriter::compact);
+      r->WriteJson(&writer);
+      bytes += out.size();
+    }
+    std::chrono::duration<double> compact_time =
+      std::chrono::steady_clock::now() - start;
+
+    EXPECT_GT(bytes, 0u);
+    std::cout << names[i] << " record: legacy "
+              << count / legacy_time.count() << " records/s, streaming "
+              << count / stream_time.count() << " records/s, compact "
+              << count / compact_time.count() << " records/s" << std::endl;
+
+    delete r;
+  }
+}
@@ -0,0 +1,205 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <new>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "include/rvsliblogger.h"
+#include "include/rvslogarena.h"
+#include "include/rvslognode.h"
+#include "include/rvslognoderec.h"
+#include "include/rvslognodestring.h"
+#include "include/rvslognodeint.h"
+#include "include/rvs_unit_testing_defs.h"
+
+// count heap allocations made by this test program
+static std::atomic<uint64_t> heap_allocs(0);
+
+static void* counted_alloc(size_t size) {
+  heap_allocs++;
+  void* p = malloc(size ? size : 1);
+  if (p == nullptr) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+// replace scalar and array forms together so every new pairs with free()
+void* operator new(size_t size) {
+  return counted_alloc(size);
+}
+
+void* operator new[](size_t size) {
+  return counted_alloc(size);
+}
+
+void operator delete(void* p) noexcept {
+  free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+  free(p);
+}
+
+void operator delete[](void* p) noexcept {
+  free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+  free(p);
+}
+
+// GM style record: 5 metrics for 8 GPUs
+static const int gpus = 8;
+static const char* metrics[] = {
+  "temp", "clock", "mem_clock", "fan", "power"
+};
+
+static void build_heap_record() {
+  rvs::LogNodeRec* r = new rvs::LogNodeRec("monitor", rvs::loginfo, 1, 2);
+  r->Add(new rvs::LogNodeString("action", "monitor", r));
+  r->Add(new rvs::LogNodeString("module", "gm", r));
+  r->Add(new rvs::LogNodeString("loglevelname", "INFO  ", r));
+  for (int g = 0; g < gpus; g++) {
+    rvs::LogNode* n = new rvs::LogNode("gpu", r);
+    n->Add(new rvs::LogNodeInt("gpu_id", 3254 + g, n));
+    for (int m = 0; m < 5; m++) {
+      n->Add(new rvs::LogNodeString(metrics[m], "1234", n));
+    }
+    r->Add(n);
+  }
+  delete r;
+}
+
+static void build_arena_record() {
+  void* r = rvs::logger::LogRecordCreate("gm", "monitor", rvs::loginfo, 1, 2);
+  for (int g = 0; g < gpus; g++) {
+    void* n = rvs::logger::CreateNode(r, "gpu");
+    rvs::logger::AddInt(n, "gpu_id", 3254 + g);
+    for (int m = 0; m < 5; m++) {
+      rvs::logger::AddString(n, metrics[m], "1234");
+    }
+    rvs::logger::AddNode(r, n);
+  }
+  // JSON output is off, so the record is just released
+  rvs::logger::LogRecordFlush(r);
+}
+
+TEST(LogArenaTest, alloc_reset) {
+  rvs::LogArena arena(256);
+
+  // allocations are aligned and do not overlap
+  char* a = static_cast<char*>(arena.alloc(3));
+  char* b = static_cast<char*>(arena.alloc(5));
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(a) % alignof(max_align_t), 0u);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % alignof(max_align_t), 0u);
+  EXPECT_GE(b - a, 3);
+
+  const char* s = arena.strdup("gpu_id");
+  EXPECT_STREQ(s, "gpu_id");
+
+  // allocation larger than chunk size
+  char* big = static_cast<char*>(arena.alloc(1000));
+  memset(big, 0xA5, 1000);
+
+  for (int i = 0; i < 20; i++) {
+    arena.alloc(50);
+  }
+
+  // chunks are reused after reset without new heap allocations
+  arena.reset();
+  uint64_t before = heap_allocs;
+  char* c = static_cast<char*>(arena.alloc(3));
+  EXPECT_EQ(c, a);
+  arena.alloc(5);
+  arena.strdup("gpu_id");
+  arena.alloc(1000);
+  for (int i = 0; i < 20; i++) {
+    arena.alloc(50);
+  }
+  EXPECT_EQ(heap_allocs, before);
+}
+
+TEST(LogArenaTest, record_json) {
+  // arena and heap records serialize identically
+  rvs::LogNodeRec* h = new rvs::LogNodeRec("act", rvs::loginfo, 1, 2);
+  rvs::LogNode* hn = new rvs::LogNode("node", h);
+  hn->Add(new rvs::LogNodeString("key", "val", hn));
+  hn->Add(new rvs::LogNodeInt("num", 42, hn));
+  h->Add(hn);
+
+  rvs::LogNodeRec* a = rvs::LogNodeRec::Create("act", rvs::loginfo, 1, 2);
+  void* an = rvs::logger::CreateNode(a, "node");
+  rvs::logger::AddString(an, "key", "val");
+  rvs::logger::AddInt(an, "num", 42);
+  rvs::logger::AddNode(a, an);
+
+  EXPECT_STREQ(a->ToJson("  ").c_str(), h->ToJson("  ").c_str());
+
+  delete h;
+  rvs::LogNodeRec::Destroy(a);
+}
+
+TEST(LogArenaTest, allocations_per_record) {
+  const int records = 20000;
+  rvs::logger::to_json(false);
+
+  // warm up arena pool
+  build_arena_record();
+
+  uint64_t a0 = heap_allocs;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < records; i++) {
+    build_heap_record();
+  }
+  std::chrono::duration<double> t_heap =
+    std::chrono::steady_clock::now() - t0;
+  uint64_t heap_per_rec = (heap_allocs - a0) / records;
+
+  a0 = heap_allocs;
+  t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < records; i++) {
+    build_arena_record();
+  }
+  std::chrono::duration<double> t_arena =
+    std::chrono::steady_clock::now() - t0;
+  uint64_t arena_per_rec = (heap_allocs - a0) / records;
+
+  std::cout << "heap nodes:  " << heap_per_rec << " allocations/record, "
+            << records / t_heap.count() << " records/s" << std::endl;
+  std::cout << "arena nodes: " << arena_per_rec << " allocations/record, "
+            << records / t_arena.count() << " records/s" << std::endl;
+
+  EXPECT_EQ(arena_per_rec, 0u);
+  EXPECT_LT(arena_per_rec, heap_per_rec);
+}
@@ -0,0 +1,237 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "include/rvsliblogger.h"
+#include "include/rvslogbin.h"
+#include "include/rvslogcat.h"
+#include "include/rvs_unit_testing_defs.h"
+
+class LogBinTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    for (int i = 0; i < 3; i++) {
+      char name[] = "/tmp/rvs_logbin_XXXXXX";
+      int fd = mkstemp(name);
+      ::close(fd);
+      file[i] = name;
+    }
+    rvs::logger::quiet();
+    rvs::logger::log_level(rvs::loginfo);
+  }
+
+  void TearDown() override {
+    set_mode(false, false, false, false);
+    rvs::logger::append(false);
+    rvs::logger::set_log_file("");
+    rvs::logger::log_level(rvs::logerror);
+    for (int i = 0; i < 3; i++) {
+      unlink(file[i].c_str());
+    }
+  }
+
+  static void set_mode(bool json, bool compact, bool jsonl, bool binary) {
+    rvs::logger::to_json(json);
+    rvs::logger::compact(compact);
+    rvs::logger::jsonl(jsonl);
+    rvs::logger::binary(binary);
+  }
+
+  // GM style log: one text row and one record with 8 GPUs per sample
+  static void write_log(const std::string& fname, int Samples) {
+    static const char* metrics[] = {
+      "temp", "clock", "mem_clock", "fan", "power"
+    };
+
+    rvs::logger::set_log_file(fname);
+    rvs::logger::init_log_file();
+    for (int i = 0; i < Samples; i++) {
+      std::string msg = "[monitor] gm sample " + std::to_string(i) +
+                        " \"quoted\"";
+      rvs::logger::LogExt(msg.c_str(), rvs::loginfo, 100 + i, 7 * i);
+
+      void* r = rvs::logger::LogRecordCreate("gm", "monitor",
+                                             rvs::loginfo, 100 + i, 7 * i);
+      for (int g = 0; g < 8; g++) {
+        void* n = rvs::logger::CreateNode(r, "gpu");
+        rvs::logger::AddInt(n, "gpu_id", 3254 + g);
+        for (int m = 0; m < 5; m++) {
+          std::string val = std::to_string((i * 7 + g * 3 + m) % 100);
+          rvs::logger::AddString(n, metrics[m], val.c_str());
+        }
+        rvs::logger::AddNode(r, n);
+      }
+      rvs::logger::AddInt(r, "delta", -i);
+      rvs::logger::AddUint64(r, "bytes", 0xfffffffff0ull + i);
+      rvs::logger::AddDouble(r, "bandwidth", 24.125 + i / 3.0);
+      rvs::logger::AddBool(r, "pass", i % 2);
+      int64_t deltas[] = {-i, 0, i};
+      uint64_t sizes[] = {4096, 1ull << 40};
+      double ratios[] = {0.5, -1e-9, 1e300};
+      rvs::logger::AddInt64Array(r, "deltas", deltas, 3);
+      rvs::logger::AddUint64Array(r, "sizes", sizes, 2);
+      rvs::logger::AddDoubleArray(r, "ratios", ratios, i % 4);
+      rvs::logger::AddString(r, "note",
+        "a value which is too long to be interned \\ \"quoted\"");
+      rvs::logger::LogRecordFlush(r);
+    }
+    rvs::logger::terminate();
+  }
+
+  static std::string read_file(const std::string& fname) {
+    std::ifstream ifs(fname);
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+    return ss.str();
+  }
+
+  static int convert(const std::string& in, const std::string& out,
+                     rvs::LogCat::eformat format) {
+    int fd = open(out.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    rvs::LogCat logcat(format, fd);
+    int sts = logcat.convert(in);
+    close(fd);
+    return sts;
+  }
+
+  static size_t file_size(const std::string& fname) {
+    struct stat st;
+    stat(fname.c_str(), &st);
+    return st.st_size;
+  }
+
+  std::string file[3];
+};
+
+TEST_F(LogBinTest, round_trip) {
+  // binary log is the same regardless of requested output format
+  set_mode(false, false, false, true);
+  write_log(file[0], 50);
+
+  struct {
+    bool json, compact, jsonl;
+    rvs::LogCat::eformat format;
+  } modes[] = {
+    {false, false, false, rvs::LogCat::text},
+    {true,  false, false, rvs::LogCat::json},
+    {true,  true,  false, rvs::LogCat::compact},
+    {true,  false, true,  rvs::LogCat::jsonl},
+  };
+
+  for (auto& m : modes) {
+    set_mode(m.json, m.compact, m.jsonl, false);
+    write_log(file[1], 50);
+
+    EXPECT_EQ(convert(file[0], file[2], m.format), 0);
+    EXPECT_EQ(read_file(file[2]), read_file(file[1]));
+  }
+}
+
+TEST_F(LogBinTest, appended_sessions) {
+  set_mode(false, false, false, true);
+  write_log(file[0], 5);
+  rvs::logger::append(true);
+  write_log(file[0], 7);
+
+  rvs::logger::append(false);
+  set_mode(false, false, false, false);
+  write_log(file[1], 5);
+  rvs::logger::append(true);
+  write_log(file[1], 7);
+
+  EXPECT_EQ(convert(file[0], file[2], rvs::LogCat::text), 0);
+  EXPECT_EQ(read_file(file[2]), read_file(file[1]));
+}
+
+TEST_F(LogBinTest, async_round_trip) {
+  // rows queued for the writer thread keep level, timestamp and message
+  set_mode(false, false, false, false);
+  write_log(file[1], 50);
+
+  set_mode(false, false, false, true);
+  rvs::logger::async(true, rvs::logger::eoverflow::block);
+  write_log(file[0], 50);
+  rvs::logger::async(false);
+
+  EXPECT_EQ(convert(file[0], file[2], rvs::LogCat::text), 0);
+  EXPECT_EQ(read_file(file[2]), read_file(file[1]));
+}
+
+TEST_F(LogBinTest, corrupted) {
+  set_mode(false, false, false, true);
+  write_log(file[0], 5);
+
+  // truncated last frame
+  EXPECT_EQ(truncate(file[0].c_str(), file_size(file[0]) - 3), 0);
+  EXPECT_NE(convert(file[0], file[2], rvs::LogCat::json), 0);
+
+  // not a binary log
+  std::ofstream(file[1]) << "[INFO  ] text log\n";
+  EXPECT_NE(convert(file[1], file[2], rvs::LogCat::json), 0);
+}
+
+TEST_F(LogBinTest, size_and_speed) {
+  const int samples = 20000;
+
+  set_mode(true, false, false, false);
+  auto start = std::chrono::steady_clock::now();
+  write_log(file[1], samples);
+  std::chrono::duration<double> json_time =
+    std::chrono::steady_clock::now() - start;
+
+  set_mode(false, false, false, true);
+  start = std::chrono::steady_clock::now();
+  write_log(file[0], samples);
+  std::chrono::duration<double> bin_time =
+    std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  EXPECT_EQ(convert(file[0], file[2], rvs::LogCat::json), 0);
+  std::chrono::duration<double> cat_time =
+    std::chrono::steady_clock::now() - start;
+
+  size_t json_size = file_size(file[1]);
+  size_t bin_size = file_size(file[0]);
+  EXPECT_LT(bin_size, json_size);
+
+  std::cout << "JSON log:   " << json_size << " bytes, "
+            << samples / json_time.count() << " samples/s" << std::endl;
+  std::cout << "binary log: " << bin_size << " bytes, "
+            << samples / bin_time.count() << " samples/s" << std::endl;
+  std::cout << "rvs-logcat: " << bin_size / cat_time.count() / 1e6
+            << " MB/s binary in, " << json_size / cat_time.count() / 1e6
+            << " MB/s JSON out" << std::endl;
+}
@@ -0,0 +1,219 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/rvsliblogger.h"
+#include "include/rvslogcoalesce.h"
+#include "include/rvs_unit_testing_defs.h"
+
+namespace {
+
+std::string read_file(const std::string& Name) {
+  std::ifstream f(Name);
+  std::stringstream ss;
+  ss << f.rdbuf();
+  return ss.str();
+}
+
+int count(const std::string& Data, const std::string& What) {
+  int n = 0;
+  for (size_t pos = Data.find(What); pos != std::string::npos;
+       pos = Data.find(What, pos + 1)) {
+    n++;
+  }
+  return n;
+}
+
+}  // namespace
+
+TEST(LogCoalesce, key) {
+  std::string action;
+  std::string module;
+
+  std::string k = rvs::LogCoalesce::key(
+      "[gm_1] gm 3 temp bounds violation 95C", rvs::loginfo, &action, &module);
+  EXPECT_EQ(action, "gm_1");
+  EXPECT_EQ(module, "gm");
+
+  // measured values do not matter
+  EXPECT_EQ(k, rvs::LogCoalesce::key(
+      "[gm_1] gm 3 temp bounds violation 101C", rvs::loginfo, &action,
+      &module));
+  EXPECT_EQ(rvs::LogCoalesce::key("[a] iet 1 power 120.5 W", rvs::loginfo,
+                                  &action, &module),
+            rvs::LogCoalesce::key("[a] iet 1 power 98.25 W", rvs::loginfo,
+                                  &action, &module));
+
+  // device, action and level do
+  EXPECT_NE(k, rvs::LogCoalesce::key(
+      "[gm_1] gm 4 temp bounds violation 95C", rvs::loginfo, &action,
+      &module));
+  EXPECT_NE(k, rvs::LogCoalesce::key(
+      "[gm_2] gm 3 temp bounds violation 95C", rvs::loginfo, &action,
+      &module));
+  EXPECT_NE(k, rvs::LogCoalesce::key(
+      "[gm_1] gm 3 temp bounds violation 95C", rvs::logdebug, &action,
+      &module));
+
+  // messages not following the convention are keyed as a whole
+  rvs::LogCoalesce::key("no prefix 12", rvs::loginfo, &action, &module);
+  EXPECT_EQ(action, "");
+  EXPECT_EQ(module, "");
+}
+
+TEST(LogCoalesce, window) {
+  rvs::LogCoalesce c;
+  std::vector<rvs::T_LOGREPEAT> closed;
+
+  c.set_window(rvs::loginfo, 1000, 2);
+  EXPECT_TRUE(c.enabled());
+  EXPECT_FALSE(c.enabled(rvs::logresults));
+
+  // other levels pass untouched
+  for (int i = 0; i < 10; i++) {
+    EXPECT_TRUE(c.admit("[a] m 0 result", rvs::logresults, i, &closed));
+  }
+
+  EXPECT_TRUE(c.admit("[a] m 0 value 1", rvs::loginfo, 100, &closed));
+  EXPECT_TRUE(c.admit("[a] m 0 value 2", rvs::loginfo, 110, &closed));
+  EXPECT_FALSE(c.admit("[a] m 0 value 3", rvs::loginfo, 120, &closed));
+  EXPECT_FALSE(c.admit("[a] m 0 value 4", rvs::loginfo, 130, &closed));
+  EXPECT_TRUE(c.admit("[a] m 1 value 5", rvs::loginfo, 140, &closed));
+  EXPECT_TRUE(closed.empty());
+
+  // next message after the window closes the previous one
+  EXPECT_TRUE(c.admit("[a] m 0 value 6", rvs::loginfo, 1100, &closed));
+  ASSERT_EQ(closed.size(), 1u);
+  EXPECT_EQ(closed[0].count, 2u);
+  EXPECT_EQ(closed[0].message, "[a] m 0 value 4");
+  EXPECT_EQ(closed[0].action, "a");
+  EXPECT_EQ(closed[0].module, "m");
+  EXPECT_EQ(closed[0].first, 100u);
+  EXPECT_EQ(closed[0].last, 130u);
+
+  // expired windows are closed by the scan, silent ones report nothing
+  closed.clear();
+  EXPECT_TRUE(c.admit("[a] m 0 value 7", rvs::loginfo, 1110, &closed));
+  EXPECT_FALSE(c.admit("[a] m 0 value 8", rvs::loginfo, 1120, &closed));
+  c.expire(2200, &closed);
+  ASSERT_EQ(closed.size(), 1u);
+  EXPECT_EQ(closed[0].count, 1u);
+
+  // nothing left to drain
+  closed.clear();
+  c.drain(&closed);
+  EXPECT_TRUE(closed.empty());
+}
+
+class ext_logger : public rvs::logger {
+ public:
+  static void set_quiet(bool flag) { b_quiet = flag; }
+};
+
+class LogCoalesceTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char name[] = "/tmp/rvs_coalesce_XXXXXX";
+    int fd = mkstemp(name);
+    ::close(fd);
+    file_name = name;
+
+    rvs::logger::quiet();
+    rvs::logger::log_level(rvs::loginfo);
+    rvs::logger::set_log_file(file_name);
+    rvs::logger::append(false);
+    rvs::logger::coalesce(rvs::loginfo, 1000);
+  }
+
+  void TearDown() override {
+    rvs::logger::coalesce(rvs::loginfo, 0);
+    rvs::logger::set_log_file("");
+    rvs::logger::to_json(false);
+    unlink(file_name.c_str());
+  }
+
+  // flood of violations over 'Ms' milliseconds starting at 'Sec'
+  static void flood(int Count, unsigned int Sec, unsigned int Ms) {
+    for (int i = 0; i < Count; i++) {
+      unsigned int ms = Ms * i / Count;
+      std::string msg = "[gm_1] gm 3 temp bounds violation " +
+                        std::to_string(90 + i % 10) + "C";
+      rvs::logger::LogExt(msg.c_str(), rvs::loginfo, Sec + ms / 1000,
+                          (ms % 1000) * 1000 + 1);
+    }
+  }
+
+  std::string file_name;
+};
+
+TEST_F(LogCoalesceTest, text_summary) {
+  EXPECT_EQ(rvs::logger::init_log_file(), 0);
+  flood(100, 10, 500);
+  rvs::logger::LogExt("[gm_1] gm 4 temp bounds violation 95C", rvs::loginfo,
+                      10, 600000);
+  // new window for the same message
+  flood(10, 12, 100);
+  EXPECT_EQ(rvs::logger::terminate(), 0);
+
+  std::string data = read_file(file_name);
+  EXPECT_EQ(count(data, "gm 3 temp bounds violation"), 4);
+  EXPECT_EQ(count(data, "gm 4 temp bounds violation"), 1);
+  EXPECT_EQ(count(data, "(repeated 99 times in 0.5 s)"), 1);
+  // still open window is reported at termination
+  EXPECT_EQ(count(data, "(repeated 9 times in"), 1);
+}
+
+TEST_F(LogCoalesceTest, json_count) {
+  rvs::logger::to_json(true);
+  EXPECT_EQ(rvs::logger::init_log_file(), 0);
+  flood(50, 10, 200);
+  flood(1, 20, 0);
+  EXPECT_EQ(rvs::logger::terminate(), 0);
+
+  std::string data = read_file(file_name);
+  EXPECT_EQ(count(data, "\"repeated\" : 49"), 1);
+  EXPECT_EQ(count(data, "\"module\" : \"gm\""), 1);
+  EXPECT_EQ(count(data, "\"action\" : \"gm_1\""), 1);
+}
+
+TEST_F(LogCoalesceTest, stop_summary) {
+  // summaries go to console as well, Stop() must not hold cout_mutex then
+  ext_logger::set_quiet(false);
+  EXPECT_EQ(rvs::logger::init_log_file(), 0);
+  flood(20, 10, 100);
+  rvs::logger::Stop(0);
+  ext_logger::set_quiet(true);
+
+  std::string data = read_file(file_name);
+  EXPECT_EQ(count(data, "(repeated 19 times in"), 1);
+}
@@ -0,0 +1,124 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <stdint.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "include/rvsliblogger.h"
+#include "include/rvsloglp.h"
+#include "include/rvs_unit_testing_defs.h"
+
+#define MODULE_NAME "gst"
+#define GST_START_MSG "start"
+
+class ext_lp : public rvs::lp {
+ public:
+  template <typename... Args>
+  static std::string format(const Args&... args) {
+    std::string msg;
+    Append(&msg, args...);
+    return msg;
+  }
+};
+
+// per-GEMM trace message as built by GSTWorker::do_gst_stress_test()
+static std::string action_name("gst_stress_test");
+static uint16_t gpu_id = 3254;
+static uint64_t run_duration_ms = 18000;
+
+static void eager_log(uint64_t total_milliseconds) {
+  std::string msg = "[" + action_name + "] " + MODULE_NAME + " " +
+              std::to_string(gpu_id) + " " + GST_START_MSG + " " +
+              " Execution time in milliseconds :" +
+              std::to_string(total_milliseconds) +
+              " run_duration_ms :" + std::to_string(run_duration_ms);
+  rvs::lp::Log(msg, rvs::logtrace);
+}
+
+static void lazy_log(uint64_t total_milliseconds) {
+  rvs::lp::LogLazy(rvs::logtrace, "[", action_name, "] ", MODULE_NAME, " ",
+              gpu_id, " ", GST_START_MSG, " ",
+              " Execution time in milliseconds :", total_milliseconds,
+              " run_duration_ms :", run_duration_ms);
+}
+
+TEST(LogLazy, format) {
+  uint64_t total_milliseconds = 1234;
+  float power = 123.5;
+  std::string expected = "[" + action_name + "] " + MODULE_NAME + " " +
+              std::to_string(gpu_id) + " " + GST_START_MSG + " " +
+              " Execution time in milliseconds :" +
+              std::to_string(total_milliseconds) +
+              " run_duration_ms :" + std::to_string(run_duration_ms) +
+              " power " + std::to_string(power);
+
+  EXPECT_EQ(ext_lp::format("[", action_name, "] ", MODULE_NAME, " ",
+              gpu_id, " ", GST_START_MSG, " ",
+              " Execution time in milliseconds :", total_milliseconds,
+              " run_duration_ms :", run_duration_ms, " power ", power),
+            expected);
+}
+
+TEST(LogLazy, level) {
+  rvs::logger::log_level(rvs::logerror);
+  EXPECT_TRUE(rvs::lp::Enabled(rvs::logresults));
+  EXPECT_TRUE(rvs::lp::Enabled(rvs::logerror));
+  EXPECT_FALSE(rvs::lp::Enabled(rvs::loginfo));
+  EXPECT_FALSE(rvs::lp::Enabled(rvs::logtrace));
+
+  rvs::logger::log_level(rvs::logtrace);
+  EXPECT_TRUE(rvs::lp::Enabled(rvs::logtrace));
+
+  rvs::logger::log_level(rvs::logerror);
+}
+
+TEST(LogLazy, disabled_cost) {
+  const int iterations = 1000000;
+  rvs::logger::log_level(rvs::logerror);
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    eager_log(i);
+  }
+  std::chrono::duration<double, std::nano> eager =
+    std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    lazy_log(i);
+  }
+  std::chrono::duration<double, std::nano> lazy =
+    std::chrono::steady_clock::now() - start;
+
+  std::cout << "disabled trace message: eager "
+            << eager.count() / iterations << " ns/iteration, lazy "
+            << lazy.count() / iterations << " ns/iteration" << std::endl;
+
+  EXPECT_LT(lazy.count(), eager.count());
+}
@@ -0,0 +1,107 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <stdint.h>
+#include <math.h>
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "include/rvsjsonwriter.h"
+#include "include/rvslogarena.h"
+#include "include/rvslognode.h"
+#include "include/rvslognodeuint.h"
+#include "include/rvslognodedouble.h"
+#include "include/rvslognodebool.h"
+#include "include/rvslognodearray.h"
+#include "include/rvs_unit_testing_defs.h"
+
+class ext_numnode : public rvs::LogNodeBase {
+ public:
+  rvs::T_LNTYPE get_Type() { return Type; }
+};
+
+static rvs::T_LNTYPE node_type(rvs::LogNodeBase* pNode) {
+  return static_cast<ext_numnode*>(pNode)->get_Type();
+}
+
+TEST(LogNodeNum, scalars) {
+  rvs::LogNodeUint big("bytes", UINT64_MAX);
+  rvs::LogNodeDouble gflops("gflops", 1234.5);
+  rvs::LogNodeDouble nan("nan", NAN);
+  rvs::LogNodeBool pass("pass", true);
+  rvs::LogNodeBool fail("fail", false);
+
+  EXPECT_EQ(node_type(&big), rvs::eLN::Unsigned);
+  EXPECT_EQ(node_type(&gflops), rvs::eLN::Double);
+  EXPECT_EQ(node_type(&pass), rvs::eLN::Boolean);
+
+  EXPECT_STREQ(big.ToJson().c_str(), "\n\"bytes\" : 18446744073709551615");
+  EXPECT_STREQ(gflops.ToJson("  ").c_str(), "\n  \"gflops\" : 1234.5");
+  EXPECT_STREQ(nan.ToJson().c_str(), "\n\"nan\" : null");
+  EXPECT_STREQ(pass.ToJson().c_str(), "\n\"pass\" : true");
+  EXPECT_STREQ(fail.ToJson().c_str(), "\n\"fail\" : false");
+}
+
+TEST(LogNodeNum, arrays) {
+  int64_t ints[] = {-1, 0, INT64_MAX};
+  uint64_t uints[] = {UINT64_MAX};
+  double doubles[] = {0.25, 1e-7, 3};
+
+  rvs::LogNodeArray a_int("ints", ints, 3);
+  rvs::LogNodeArray a_uint("uints", uints, 1);
+  rvs::LogNodeArray a_dbl("doubles", doubles, 3);
+  rvs::LogNodeArray a_empty("empty", doubles, 0);
+
+  // node keeps its own copy of elements
+  ints[0] = 5;
+
+  EXPECT_EQ(node_type(&a_int), rvs::eLN::Array);
+  EXPECT_STREQ(a_int.ToJson().c_str(),
+               "\n\"ints\" : [-1, 0, 9223372036854775807]");
+  EXPECT_STREQ(a_uint.ToJson().c_str(),
+               "\n\"uints\" : [18446744073709551615]");
+  EXPECT_STREQ(a_dbl.ToJson().c_str(), "\n\"doubles\" : [0.25, 1e-7, 3]");
+  EXPECT_STREQ(a_empty.ToJson().c_str(), "\n\"empty\" : []");
+}
+
+TEST(LogNodeNum, arena_compact) {
+  rvs::LogArena arena;
+  rvs::LogNode* n = new (arena.alloc(sizeof(rvs::LogNode)))
+                    rvs::LogNode("gpu", nullptr, &arena);
+  uint64_t power[] = {150000000, 151250000};
+  n->Add(new (arena.alloc(sizeof(rvs::LogNodeDouble)))
+         rvs::LogNodeDouble("gflops", 10450.75, n, &arena));
+  n->Add(new (arena.alloc(sizeof(rvs::LogNodeArray)))
+         rvs::LogNodeArray("power_uw", power, 2, n, &arena));
+  n->Add(new (arena.alloc(sizeof(rvs::LogNodeBool)))
+         rvs::LogNodeBool("pass", true, n, &arena));
+
+  std::string out;
+  rvs::JsonWriter writer(&out, rvs::JsonWriter::compact);
+  n->WriteJson(&writer);
+  EXPECT_STREQ(out.c_str(), "\"gpu\":{\"gflops\":10450.75,"
+               "\"power_uw\":[150000000,151250000],\"pass\":true}");
+}
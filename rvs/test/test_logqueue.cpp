@@ -0,0 +1,169 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <stdio.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/rvsliblogger.h"
+#include "include/rvslogqueue.h"
+#include "include/rvs_unit_testing_defs.h"
+
+TEST(LogQueueTest, single_thread) {
+  rvs::LogQueue q(5);
+  rvs::T_LOGQENTRY e;
+
+  // size rounded up to power of 2
+  EXPECT_EQ(q.capacity(), 8u);
+  EXPECT_TRUE(q.empty());
+  EXPECT_FALSE(q.pop(&e));
+
+  for (int i = 0; i < 8; i++) {
+    e.row = std::to_string(i);
+    e.msg = i;
+    e.level = rvs::loginfo;
+    e.sec = 100 + i;
+    e.usec = 7 * i;
+    e.rec = nullptr;
+    EXPECT_TRUE(q.push(&e));
+  }
+  EXPECT_FALSE(q.empty());
+
+  // queue full
+  e.row = "x";
+  EXPECT_FALSE(q.push(&e));
+
+  for (int i = 0; i < 8; i++) {
+    EXPECT_TRUE(q.pop(&e));
+    EXPECT_STREQ(e.row.c_str(), std::to_string(i).c_str());
+    EXPECT_EQ(e.msg, static_cast<size_t>(i));
+    EXPECT_EQ(e.level, rvs::loginfo);
+    EXPECT_EQ(e.sec, 100u + i);
+    EXPECT_EQ(e.usec, 7u * i);
+    EXPECT_EQ(e.rec, nullptr);
+  }
+  EXPECT_TRUE(q.empty());
+  EXPECT_FALSE(q.pop(&e));
+
+  // wrap around
+  for (int i = 0; i < 20; i++) {
+    e.row = std::to_string(i);
+    EXPECT_TRUE(q.push(&e));
+    EXPECT_TRUE(q.pop(&e));
+    EXPECT_STREQ(e.row.c_str(), std::to_string(i).c_str());
+  }
+}
+
+TEST(LogQueueTest, multi_producer) {
+  const int producers = 4;
+  const int per_producer = 20000;
+  rvs::LogQueue q(64);
+  std::vector<std::thread> t;
+  std::vector<int> next(producers, 0);
+
+  for (int p = 0; p < producers; p++) {
+    t.push_back(std::thread([&q, p]() {
+      rvs::T_LOGQENTRY e;
+      for (int i = 0; i < per_producer; i++) {
+        e.row = std::to_string(p) + " " + std::to_string(i);
+        e.rec = nullptr;
+        while (!q.push(&e)) {
+          std::this_thread::yield();
+        }
+      }
+    }));
+  }
+
+  // every entry arrives exactly once and in per-producer order
+  rvs::T_LOGQENTRY e;
+  int received = 0;
+  while (received < producers * per_producer) {
+    if (!q.pop(&e)) {
+      std::this_thread::yield();
+      continue;
+    }
+    int p, i;
+    ASSERT_EQ(sscanf(e.row.c_str(), "%d %d", &p, &i), 2);
+    ASSERT_EQ(i, next[p]);
+    next[p]++;
+    received++;
+  }
+
+  for (auto& th : t) {
+    th.join();
+  }
+  EXPECT_TRUE(q.empty());
+}
+
+TEST(LogQueueTest, async_logger) {
+  const int producers = 4;
+  const int per_producer = 5000;
+  char name[] = "/tmp/rvs_logqueue_XXXXXX";
+  int fd = mkstemp(name);
+  ::close(fd);
+
+  rvs::logger::quiet();
+  rvs::logger::to_json(false);
+  rvs::logger::append(false);
+  rvs::logger::log_level(rvs::loginfo);
+  rvs::logger::set_log_file(name);
+  rvs::logger::async(true, rvs::logger::eoverflow::block);
+  ASSERT_EQ(rvs::logger::init_log_file(), 0);
+
+  std::vector<std::thread> t;
+  for (int p = 0; p < producers; p++) {
+    t.push_back(std::thread([p]() {
+      for (int i = 0; i < per_producer; i++) {
+        rvs::logger::Log(("row " + std::to_string(p)).c_str(), rvs::loginfo);
+      }
+    }));
+  }
+  for (auto& th : t) {
+    th.join();
+  }
+
+  // terminate() drains the queue before closing the file
+  rvs::logger::terminate();
+  rvs::logger::async(false);
+  rvs::logger::set_log_file("");
+
+  std::ifstream ifs(name);
+  std::string line;
+  int lines = 0;
+  while (std::getline(ifs, line)) {
+    if (!line.empty()) {
+      lines++;
+    }
+  }
+  EXPECT_EQ(lines, producers * per_producer);
+  EXPECT_EQ(rvs::logger::dropped(), 0u);
+
+  unlink(name);
+}
@@ -0,0 +1,252 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <stdlib.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <zlib.h>
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/rvsliblogger.h"
+#include "include/rvs_unit_testing_defs.h"
+
+class LogRotateTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char name[] = "/tmp/rvs_logrotate_XXXXXX";
+    ASSERT_NE(mkdtemp(name), nullptr);
+    dir_name = name;
+    file_name = dir_name + "/rvs.log";
+
+    rvs::logger::quiet();
+    rvs::logger::log_level(rvs::logtrace);
+    rvs::logger::set_log_file(file_name);
+    rvs::logger::append(false);
+  }
+
+  void TearDown() override {
+    rvs::logger::rotate(0, 0, false);
+    rvs::logger::set_log_file("");
+    rvs::logger::to_json(false);
+    rvs::logger::binary(false);
+    rvs::logger::async(false);
+    rvs::logger::append(false);
+
+    for (auto& f : list_files()) {
+      unlink((dir_name + "/" + f).c_str());
+    }
+    rmdir(dir_name.c_str());
+  }
+
+  static void write_records(int Count) {
+    for (int i = 0; i < Count; i++) {
+      void* r = rvs::logger::LogRecordCreate("test", "rotate",
+                                             rvs::logresults, 1, 2);
+      rvs::logger::AddInt(r, "seq", i);
+      rvs::logger::AddString(r, "msg", "some payload to fill the segment");
+      rvs::logger::LogRecordFlush(r);
+    }
+  }
+
+  std::vector<std::string> list_files() {
+    std::vector<std::string> files;
+    DIR* dir = opendir(dir_name.c_str());
+    if (dir == nullptr) {
+      return files;
+    }
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+      std::string name(entry->d_name);
+      if (name != "." && name != "..") {
+        files.push_back(name);
+      }
+    }
+    closedir(dir);
+    return files;
+  }
+
+  static std::string read_file(const std::string& Name) {
+    std::ifstream f(Name);
+    std::stringstream ss;
+    ss << f.rdbuf();
+    return ss.str();
+  }
+
+  static std::string read_gz(const std::string& Name) {
+    std::string data;
+    gzFile gz = gzopen(Name.c_str(), "rb");
+    if (gz == nullptr) {
+      return data;
+    }
+    char buff[4096];
+    int n;
+    while ((n = gzread(gz, buff, sizeof(buff))) > 0) {
+      data.append(buff, n);
+    }
+    gzclose(gz);
+    return data;
+  }
+
+  static int count(const std::string& Data, const std::string& What) {
+    int n = 0;
+    for (size_t pos = Data.find(What); pos != std::string::npos;
+         pos = Data.find(What, pos + 1)) {
+      n++;
+    }
+    return n;
+  }
+
+  // check that segment is complete JSON array, return number of records
+  static int check_json(const std::string& Data) {
+    size_t first = Data.find_first_not_of(" \n");
+    size_t last = Data.find_last_not_of(" \n");
+    EXPECT_NE(first, std::string::npos);
+    EXPECT_EQ(Data[first], '[');
+    EXPECT_EQ(Data[last], ']');
+    EXPECT_EQ(Data[Data.find_first_not_of(" \n", first + 1)], '{');
+    EXPECT_EQ(Data[Data.find_last_not_of(" \n", last - 1)], '}');
+    int records = count(Data, "\"module\"");
+    std::string packed;
+    for (char c : Data) {
+      if (c != ' ' && c != '\n') {
+        packed += c;
+      }
+    }
+    EXPECT_EQ(count(packed, "},{"), records - 1);
+    return records;
+  }
+
+  std::string dir_name;
+  std::string file_name;
+};
+
+TEST_F(LogRotateTest, json_by_size) {
+  rvs::logger::to_json(true);
+  rvs::logger::rotate(8 * 1024, 0, false);
+
+  EXPECT_EQ(rvs::logger::init_log_file(), 0);
+  write_records(500);
+  EXPECT_EQ(rvs::logger::terminate(), 0);
+
+  int segments = list_files().size() - 1;
+  ASSERT_GT(segments, 2);
+
+  int records = check_json(read_file(file_name));
+  for (int i = 1; i <= segments; i++) {
+    std::string name = file_name + "." + std::to_string(i);
+    std::string data = read_file(name);
+    // segment is closed at the first record boundary at the limit
+    EXPECT_GE(data.size(), 8u * 1024);
+    EXPECT_LT(data.size(), 9u * 1024);
+    records += check_json(data);
+  }
+  EXPECT_EQ(records, 500);
+}
+
+TEST_F(LogRotateTest, async_append_continues_sequence) {
+  rvs::logger::to_json(true);
+  rvs::logger::async(true);
+  rvs::logger::rotate(8 * 1024, 0, false);
+
+  EXPECT_EQ(rvs::logger::init_log_file(), 0);
+  write_records(200);
+  EXPECT_EQ(rvs::logger::terminate(), 0);
+  int first_run = list_files().size() - 1;
+  ASSERT_GT(first_run, 0);
+
+  // second run appends to the active file, new segments follow old ones
+  rvs::logger::append(true);
+  EXPECT_EQ(rvs::logger::init_log_file(), 0);
+  write_records(200);
+  EXPECT_EQ(rvs::logger::terminate(), 0);
+  int segments = list_files().size() - 1;
+  ASSERT_GT(segments, first_run);
+
+  int records = check_json(read_file(file_name));
+  for (int i = 1; i <= segments; i++) {
+    records += check_json(read_file(file_name + "." + std::to_string(i)));
+  }
+  EXPECT_EQ(records, 400);
+}
+
+TEST_F(LogRotateTest, text_by_time) {
+  rvs::logger::rotate(0, 1, false);
+
+  EXPECT_EQ(rvs::logger::init_log_file(), 0);
+  rvs::logger::log("first segment", rvs::logresults);
+  std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+  rvs::logger::log("second segment", rvs::logresults);
+  rvs::logger::log("still second segment", rvs::logresults);
+  EXPECT_EQ(rvs::logger::terminate(), 0);
+
+  ASSERT_EQ(list_files().size(), 2u);
+  std::string first = read_file(file_name + ".1");
+  std::string second = read_file(file_name);
+  EXPECT_EQ(count(first, "\n"), 1);
+  EXPECT_NE(first.find("first segment"), std::string::npos);
+  EXPECT_NE(first[0], '\n');
+  EXPECT_EQ(count(second, "\n"), 2);
+  EXPECT_NE(second.find("still second segment"), std::string::npos);
+  EXPECT_NE(second[0], '\n');
+}
+
+TEST_F(LogRotateTest, binary_compressed) {
+  rvs::logger::binary(true);
+  rvs::logger::rotate(4 * 1024, 0, true);
+
+  EXPECT_EQ(rvs::logger::init_log_file(), 0);
+  for (int i = 0; i < 2000; i++) {
+    rvs::logger::log("binary row " + std::to_string(i), rvs::logresults);
+  }
+  EXPECT_EQ(rvs::logger::terminate(), 0);
+
+  // compression is done when terminate() returns
+  int segments = 0;
+  for (auto& f : list_files()) {
+    if (f == "rvs.log") {
+      continue;
+    }
+    ASSERT_EQ(f.substr(f.size() - 3), ".gz");
+    segments++;
+  }
+  ASSERT_GT(segments, 1);
+
+  // every segment starts with its own session
+  int rows = count(read_file(file_name), "binary row ");
+  EXPECT_EQ(read_file(file_name).find(RVS_LOGBIN_MAGIC), 5u);
+  for (int i = 1; i <= segments; i++) {
+    std::string data = read_gz(file_name + "." + std::to_string(i) + ".gz");
+    EXPECT_EQ(data.find(RVS_LOGBIN_MAGIC), 5u);
+    rows += count(data, "binary row ");
+  }
+  EXPECT_EQ(rows, 2000);
+}
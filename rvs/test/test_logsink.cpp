@@ -0,0 +1,201 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "include/rvsliblogger.h"
+#include "include/rvslogsink.h"
+#include "include/rvslognodebase.h"
+#include "include/rvs_unit_testing_defs.h"
+
+class ext_logger : public rvs::logger {
+ public:
+  static int to_file(const std::string& row) {
+    std::lock_guard<std::mutex> lk(log_mutex);
+    return ToFile(row);
+  }
+};
+
+class LogSinkTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char name[] = "/tmp/rvs_logsink_XXXXXX";
+    int fd = mkstemp(name);
+    ::close(fd);
+    file_name = name;
+    legacy_name = file_name + ".legacy";
+  }
+
+  void TearDown() override {
+    rvs::logger::set_log_file("");
+    unlink(file_name.c_str());
+    unlink(legacy_name.c_str());
+  }
+
+  // previous implementation: open/append/close for every row
+  static void legacy_to_file(const std::string& fname,
+                             const std::string& row) {
+    std::fstream fs;
+    fs.open(fname, std::fstream::out | std::fstream::app);
+    fs << row;
+    fs.close();
+  }
+
+  static std::string read_file(const std::string& fname) {
+    std::ifstream ifs(fname);
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+    return ss.str();
+  }
+
+  static std::string make_row(int i) {
+    return std::string(RVSENDL) + "[RESULT] [ 12345.678   ] [gst] gst 0 "
+           "GFLOPS " + std::to_string(i);
+  }
+
+  std::string file_name;
+  std::string legacy_name;
+};
+
+TEST_F(LogSinkTest, buffered_write) {
+  rvs::LogSink sink;
+
+  sink.set_buffer_size(64);
+  sink.set_flush_interval(1000000);
+
+  EXPECT_EQ(sink.write("x"), -1);
+  ASSERT_EQ(sink.open(file_name, true), 0);
+  EXPECT_TRUE(sink.is_open());
+
+  // small row stays in the buffer
+  EXPECT_EQ(sink.write("0123456789"), 0);
+  EXPECT_STREQ(read_file(file_name).c_str(), "");
+
+  // exceeding buffer size triggers flush
+  EXPECT_EQ(sink.write(std::string(60, 'a')), 0);
+  EXPECT_EQ(read_file(file_name).size(), 70u);
+
+  // rows larger than buffer go straight to the file
+  EXPECT_EQ(sink.write(std::string(100, 'b')), 0);
+  EXPECT_EQ(read_file(file_name).size(), 170u);
+
+  EXPECT_EQ(sink.write("tail"), 0);
+  EXPECT_EQ(sink.flush(), 0);
+  EXPECT_EQ(read_file(file_name).size(), 174u);
+
+  // reopen without truncation keeps content
+  sink.close();
+  EXPECT_FALSE(sink.is_open());
+  ASSERT_EQ(sink.open(file_name, false), 0);
+  EXPECT_EQ(sink.write("!"), 0);
+  sink.close();
+  EXPECT_EQ(read_file(file_name).size(), 175u);
+
+  // reopen with truncation discards content
+  ASSERT_EQ(sink.open(file_name, true), 0);
+  sink.close();
+  EXPECT_EQ(read_file(file_name).size(), 0u);
+}
+
+TEST_F(LogSinkTest, identical_output) {
+  const int rows = 1000;
+
+  rvs::logger::to_json(false);
+  rvs::logger::append(false);
+  rvs::logger::set_log_file(file_name);
+  ASSERT_EQ(rvs::logger::init_log_file(), 0);
+  for (int i = 0; i < rows; i++) {
+    ext_logger::to_file(make_row(i));
+  }
+  rvs::logger::terminate();
+
+  legacy_to_file(legacy_name, "");
+  for (int i = 0; i < rows; i++) {
+    legacy_to_file(legacy_name, make_row(i));
+  }
+  legacy_to_file(legacy_name, RVSENDL);
+
+  EXPECT_EQ(read_file(file_name), read_file(legacy_name));
+}
+
+TEST_F(LogSinkTest, rows_per_second) {
+  const int rows = 20000;
+  std::chrono::duration<double> t_legacy;
+  std::chrono::duration<double> t_sink;
+
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < rows; i++) {
+    legacy_to_file(legacy_name, make_row(i));
+  }
+  t_legacy = std::chrono::steady_clock::now() - t0;
+
+  rvs::logger::to_json(false);
+  rvs::logger::append(false);
+  rvs::logger::set_log_file(file_name);
+  ASSERT_EQ(rvs::logger::init_log_file(), 0);
+  t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < rows; i++) {
+    ext_logger::to_file(make_row(i));
+  }
+  rvs::logger::terminate();
+  t_sink = std::chrono::steady_clock::now() - t0;
+
+  std::cout << "open/append/close: " << rows / t_legacy.count()
+            << " rows/s" << std::endl;
+  std::cout << "buffered sink:     " << rows / t_sink.count()
+            << " rows/s" << std::endl;
+
+  EXPECT_EQ(read_file(file_name).size(),
+            read_file(legacy_name).size() + strlen(RVSENDL));
+}
+
+TEST_F(LogSinkTest, sync_flush) {
+  rvs::logger::to_json(false);
+  rvs::logger::append(false);
+  rvs::logger::log_level(rvs::logresults);
+  rvs::logger::set_log_file(file_name);
+  ASSERT_EQ(rvs::logger::init_log_file(), 0);
+
+  // ordinary row reaches the file once the flush interval expires
+  ext_logger::to_file(make_row(0));
+  EXPECT_EQ(read_file(file_name).find("GFLOPS 0"), std::string::npos);
+  usleep(1500 * 1000);
+  EXPECT_NE(read_file(file_name).find("GFLOPS 0"), std::string::npos);
+
+  // result rows are flushed right away
+  rvs::logger::LogExt("[gst] gst 0 GFLOPS 1", rvs::logresults, 1, 0);
+  EXPECT_NE(read_file(file_name).find("GFLOPS 1"), std::string::npos);
+
+  rvs::logger::terminate();
+}
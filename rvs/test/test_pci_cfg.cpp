@@ -0,0 +1,331 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <dirent.h>
+#include <fcntl.h>
+#include <linux/pci.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/pci_cfg.h"
+
+namespace {
+
+//! capability offsets used by synthetic GPU config space
+const int kPm = 0x50;
+const int kExp = 0x64;
+const int kMsi = 0xA0;
+const int kAer = 0x100;
+const int kDsn = 0x150;
+const int kPwr = 0x200;
+
+void put_word(std::vector<uint8_t>* pCfg, int Pos, uint16_t Value) {
+  (*pCfg)[Pos] = Value & 0xFF;
+  (*pCfg)[Pos + 1] = Value >> 8;
+}
+
+void put_long(std::vector<uint8_t>* pCfg, int Pos, uint32_t Value) {
+  put_word(pCfg, Pos, Value & 0xFFFF);
+  put_word(pCfg, Pos + 2, Value >> 16);
+}
+
+/**
+ * @brief Build config space of a PCI Express GPU
+ * @param Index device index, varies link and serial number
+ * @return 4 KiB config space
+ */
+std::vector<uint8_t> make_gpu(int Index) {
+  std::vector<uint8_t> cfg(PCI_CFG_SPACE_EXP_SIZE, 0);
+  put_word(&cfg, PCI_VENDOR_ID, 0x1002);
+  put_word(&cfg, PCI_DEVICE_ID, 0x74A1);
+  put_word(&cfg, PCI_STATUS, PCI_STATUS_CAP_LIST);
+  put_long(&cfg, PCI_BASE_ADDRESS_0, 0xFC00000C);
+  cfg[PCI_CAPABILITY_LIST] = kPm;
+
+  // standard capabilities: PM -> PCI Express -> MSI
+  cfg[kPm] = PCI_CAP_ID_PM;
+  cfg[kPm + 1] = kExp;
+  put_word(&cfg, kPm + PCI_PM_CTRL, Index % 4);
+  cfg[kExp] = PCI_CAP_ID_EXP;
+  cfg[kExp + 1] = kMsi;
+  put_word(&cfg, kExp + PCI_EXP_FLAGS, 0x0002);
+  put_long(&cfg, kExp + PCI_EXP_LNKCAP, 4 | (16 << 4));
+  put_word(&cfg, kExp + PCI_EXP_LNKSTA, (1 + Index % 3) | (16 << 4));
+  put_long(&cfg, kExp + PCI_EXP_SLTCAP, (75 << 7) | (Index << 19));
+  put_long(&cfg, kExp + PCI_EXP_DEVCAP2, 0x0180);
+  put_word(&cfg, kExp + PCI_EXP_DEVCTL2, 0x0040);
+  cfg[kMsi] = PCI_CAP_ID_MSI;
+  cfg[kMsi + 1] = 0;
+
+  // extended capabilities: AER -> DSN -> power budgeting
+  put_long(&cfg, kAer, PCI_EXT_CAP_ID_ERR | (1 << 16) | (kDsn << 20));
+  put_long(&cfg, kDsn, PCI_EXT_CAP_ID_DSN | (1 << 16) | (kPwr << 20));
+  put_long(&cfg, kDsn + 4, 0x44332211);
+  put_long(&cfg, kDsn + 8, 0x88776600 | (Index & 0xFF));
+  put_long(&cfg, kPwr, PCI_EXT_CAP_ID_PWR | (1 << 16));
+  return cfg;
+}
+
+std::string decode(const rvs::pcicfg& Cfg,
+                   void (rvs::pcicfg::*Decoder)(char*) const) {
+  char buff[PCI_CAP_DATA_MAX_BUF_SIZE];
+  (Cfg.*Decoder)(buff);
+  return buff;
+}
+
+//! all decoders which do not need the device
+void (rvs::pcicfg::*decoders[])(char*) const = {
+  &rvs::pcicfg::link_cap_max_speed, &rvs::pcicfg::link_cap_max_width,
+  &rvs::pcicfg::link_stat_cur_speed, &rvs::pcicfg::link_stat_neg_width,
+  &rvs::pcicfg::slot_pwr_limit_value, &rvs::pcicfg::slot_physical_num,
+  &rvs::pcicfg::device_id, &rvs::pcicfg::vendor_id,
+  &rvs::pcicfg::dev_serial_num, &rvs::pcicfg::pwr_curr_state,
+  &rvs::pcicfg::atomic_op_routing, &rvs::pcicfg::atomic_op_32_completer,
+  &rvs::pcicfg::atomic_op_64_completer,
+  &rvs::pcicfg::atomic_op_128_CAS_completer
+};
+const size_t kDecoders = sizeof(decoders) / sizeof(decoders[0]);
+
+}  // namespace
+
+TEST(PciCfg, decode) {
+  std::vector<uint8_t> blob = make_gpu(5);
+  rvs::pcicfg cfg;
+  ASSERT_EQ(0, cfg.load(blob.data(), blob.size()));
+  EXPECT_TRUE(cfg.snapshot());
+  EXPECT_EQ(static_cast<size_t>(PCI_CFG_SPACE_EXP_SIZE), cfg.size());
+
+  EXPECT_EQ(static_cast<unsigned>(kPm),
+            cfg.cap_offset(PCI_CAP_ID_PM, PCI_CAP_NORMAL));
+  EXPECT_EQ(static_cast<unsigned>(kExp),
+            cfg.cap_offset(PCI_CAP_ID_EXP, PCI_CAP_NORMAL));
+  EXPECT_EQ(static_cast<unsigned>(kMsi),
+            cfg.cap_offset(PCI_CAP_ID_MSI, PCI_CAP_NORMAL));
+  EXPECT_EQ(0u, cfg.cap_offset(PCI_CAP_ID_MSIX, PCI_CAP_NORMAL));
+  EXPECT_EQ(static_cast<unsigned>(kAer),
+            cfg.cap_offset(PCI_EXT_CAP_ID_ERR, PCI_CAP_EXTENDED));
+  EXPECT_EQ(static_cast<unsigned>(kDsn),
+            cfg.cap_offset(PCI_EXT_CAP_ID_DSN, PCI_CAP_EXTENDED));
+  EXPECT_EQ(static_cast<unsigned>(kPwr),
+            cfg.cap_offset(PCI_EXT_CAP_ID_PWR, PCI_CAP_EXTENDED));
+  EXPECT_EQ(0u, cfg.cap_offset(PCI_EXT_CAP_ID_VC, PCI_CAP_EXTENDED));
+
+  EXPECT_EQ("16 GT/s", decode(cfg, &rvs::pcicfg::link_cap_max_speed));
+  EXPECT_EQ("x16", decode(cfg, &rvs::pcicfg::link_cap_max_width));
+  EXPECT_EQ("8 GT/s", decode(cfg, &rvs::pcicfg::link_stat_cur_speed));
+  EXPECT_EQ("x16", decode(cfg, &rvs::pcicfg::link_stat_neg_width));
+  EXPECT_EQ("75.000W", decode(cfg, &rvs::pcicfg::slot_pwr_limit_value));
+  EXPECT_EQ("#5", decode(cfg, &rvs::pcicfg::slot_physical_num));
+  EXPECT_EQ("29857", decode(cfg, &rvs::pcicfg::device_id));
+  EXPECT_EQ("4098", decode(cfg, &rvs::pcicfg::vendor_id));
+  EXPECT_EQ("88-77-66-05-44-33-22-11",
+            decode(cfg, &rvs::pcicfg::dev_serial_num));
+  EXPECT_EQ("D1", decode(cfg, &rvs::pcicfg::pwr_curr_state));
+  EXPECT_EQ("TRUE", decode(cfg, &rvs::pcicfg::atomic_op_routing));
+  EXPECT_EQ("TRUE", decode(cfg, &rvs::pcicfg::atomic_op_32_completer));
+  EXPECT_EQ("TRUE", decode(cfg, &rvs::pcicfg::atomic_op_64_completer));
+  EXPECT_EQ("FALSE",
+            decode(cfg, &rvs::pcicfg::atomic_op_128_CAS_completer));
+  EXPECT_EQ(0x0180, cfg.atomic_op_register_value());
+
+  // not part of config space
+  EXPECT_EQ("NOT SUPPORTED", decode(cfg, &rvs::pcicfg::pci_bus_id));
+  EXPECT_EQ("NOT SUPPORTED", decode(cfg, &rvs::pcicfg::kernel_driver));
+  char buff[PCI_CAP_DATA_MAX_BUF_SIZE];
+  cfg.pwr_budgeting(0, 0, 0, buff);
+  EXPECT_STREQ("NOT SUPPORTED", buff);
+}
+
+TEST(PciCfg, malformed) {
+  std::vector<uint8_t> blob = make_gpu(0);
+  rvs::pcicfg cfg;
+  char buff[PCI_CAP_DATA_MAX_BUF_SIZE];
+
+  // too short
+  EXPECT_EQ(-1, cfg.load(blob.data(), PCI_STD_HEADER_SIZEOF - 1));
+  EXPECT_FALSE(cfg.snapshot());
+
+  // standard space only: no extended capabilities
+  ASSERT_EQ(0, cfg.load(blob.data(), PCI_CFG_SPACE_SIZE));
+  EXPECT_EQ(static_cast<unsigned>(kExp),
+            cfg.cap_offset(PCI_CAP_ID_EXP, PCI_CAP_NORMAL));
+  EXPECT_EQ(0u, cfg.cap_offset(PCI_EXT_CAP_ID_DSN, PCI_CAP_EXTENDED));
+  cfg.dev_serial_num(buff);
+  EXPECT_STREQ("NOT SUPPORTED", buff);
+
+  // capability list not present
+  std::vector<uint8_t> nolist = blob;
+  put_word(&nolist, PCI_STATUS, 0);
+  ASSERT_EQ(0, cfg.load(nolist.data(), nolist.size()));
+  cfg.link_cap_max_speed(buff);
+  EXPECT_STREQ("NOT SUPPORTED", buff);
+
+  // looping lists terminate, first capability of an ID is kept
+  std::vector<uint8_t> loop = blob;
+  loop[kMsi + 1] = kPm;
+  put_long(&loop, kPwr, PCI_EXT_CAP_ID_PWR | (1 << 16) | (kAer << 20));
+  ASSERT_EQ(0, cfg.load(loop.data(), loop.size()));
+  EXPECT_EQ(static_cast<unsigned>(kMsi),
+            cfg.cap_offset(PCI_CAP_ID_MSI, PCI_CAP_NORMAL));
+  EXPECT_EQ(static_cast<unsigned>(kPwr),
+            cfg.cap_offset(PCI_EXT_CAP_ID_PWR, PCI_CAP_EXTENDED));
+
+  // capability pointing outside of config space
+  std::vector<uint8_t> outside = blob;
+  put_long(&outside, kExp + PCI_EXP_LNKCAP, 0);
+  outside[kPm + 1] = 0xFC;
+  ASSERT_EQ(0, cfg.load(outside.data(), outside.size()));
+  EXPECT_EQ(0u, cfg.cap_offset(PCI_CAP_ID_EXP, PCI_CAP_NORMAL));
+  EXPECT_EQ(0xFFFFFFFFu, cfg.read_long(PCI_CFG_SPACE_EXP_SIZE - 2));
+}
+
+TEST(PciCfg, captured) {
+  char name[] = "/tmp/rvs_pcicfg_XXXXXX";
+  ASSERT_NE(mkdtemp(name), nullptr);
+  std::string file = std::string(name) + "/config";
+  std::vector<uint8_t> blob = make_gpu(3);
+  {
+    std::ofstream f(file, std::ios::binary);
+    f.write(reinterpret_cast<const char*>(blob.data()), blob.size());
+  }
+
+  rvs::pcicfg mem, captured;
+  ASSERT_EQ(0, mem.load(blob.data(), blob.size()));
+  ASSERT_EQ(0, captured.load(file));
+  for (size_t i = 0; i < kDecoders; i++) {
+    EXPECT_EQ(decode(mem, decoders[i]), decode(captured, decoders[i]));
+  }
+  EXPECT_EQ(-1, captured.load(file + ".missing"));
+  std::string cmd = std::string("rm -rf ") + name;
+  ASSERT_EQ(0, system(cmd.c_str()));
+
+  // config spaces of this machine, if readable
+  DIR* dir = opendir("/sys/bus/pci/devices");
+  if (dir == nullptr) {
+    return;
+  }
+  struct dirent* entry;
+  while ((entry = readdir(dir)) != nullptr) {
+    if (entry->d_name[0] == '.') {
+      continue;
+    }
+    std::string path = std::string("/sys/bus/pci/devices/") +
+                       entry->d_name;
+    if (captured.load(path + "/config")) {
+      continue;
+    }
+    std::ifstream vendor(path + "/vendor");
+    unsigned int vendor_id = 0;
+    vendor >> std::hex >> vendor_id;
+    EXPECT_EQ(vendor_id, captured.read_word(PCI_VENDOR_ID)) << path;
+    for (size_t i = 0; i < kDecoders; i++) {
+      EXPECT_FALSE(decode(captured, decoders[i]).empty()) << path;
+    }
+  }
+  closedir(dir);
+}
+
+TEST(PciCfg, benchmark) {
+  const int devices = 512;
+  const int rounds = 20;
+  char name[] = "/tmp/rvs_pcicfg_XXXXXX";
+  ASSERT_NE(mkdtemp(name), nullptr);
+  std::vector<std::string> files;
+  for (int d = 0; d < devices; d++) {
+    std::vector<uint8_t> blob = make_gpu(d);
+    files.push_back(std::string(name) + "/" + std::to_string(d));
+    std::ofstream f(files.back(), std::ios::binary);
+    f.write(reinterpret_cast<const char*>(blob.data()), blob.size());
+  }
+
+  std::vector<rvs::pcicfg> snaps(devices);
+  for (int d = 0; d < devices; d++) {
+    ASSERT_EQ(0, snaps[d].load(files[d]));
+  }
+
+  char buff[PCI_CAP_DATA_MAX_BUF_SIZE];
+  size_t out = 0;
+
+  // decode all fields from in-memory snapshots
+  auto t0 = std::chrono::steady_clock::now();
+  for (int r = 0; r < rounds; r++) {
+    for (int d = 0; d < devices; d++) {
+      for (size_t i = 0; i < kDecoders; i++) {
+        (snaps[d].*decoders[i])(buff);
+        out += buff[0];
+      }
+    }
+  }
+  auto t1 = std::chrono::steady_clock::now();
+
+  // one read per device, then decode from memory
+  rvs::pcicfg cfg;
+  for (int d = 0; d < devices; d++) {
+    ASSERT_EQ(0, cfg.load(files[d]));
+    for (size_t i = 0; i < kDecoders; i++) {
+      (cfg.*decoders[i])(buff);
+      out += buff[0];
+    }
+  }
+  auto t2 = std::chrono::steady_clock::now();
+
+  // legacy access pattern: one read per decoded register
+  const int regs[] = {PCI_EXP_LNKCAP, PCI_EXP_LNKCAP, PCI_EXP_LNKSTA,
+                      PCI_EXP_LNKSTA, PCI_EXP_SLTCAP, PCI_EXP_SLTCAP,
+                      PCI_EXP_FLAGS, PCI_EXP_DEVCTL2, PCI_EXP_FLAGS,
+                      PCI_EXP_DEVCAP2, PCI_EXP_FLAGS, PCI_EXP_DEVCAP2,
+                      PCI_EXP_FLAGS, PCI_EXP_DEVCAP2};
+  for (int d = 0; d < devices; d++) {
+    int fd = open(files[d].c_str(), O_RDONLY);
+    ASSERT_GE(fd, 0);
+    uint32_t value;
+    for (int reg : regs) {
+      ASSERT_EQ(4, pread(fd, &value, 4, kExp + reg));
+      out += value;
+    }
+    close(fd);
+  }
+  auto t3 = std::chrono::steady_clock::now();
+
+  double mem_s = std::chrono::duration<double>(t1 - t0).count();
+  double load_s = std::chrono::duration<double>(t2 - t1).count();
+  double pread_s = std::chrono::duration<double>(t3 - t2).count();
+  double decodes = static_cast<double>(devices) * kDecoders;
+  std::cout << "[ BENCH    ] " << devices << " devices, " << kDecoders
+            << " fields: snapshot " << decodes * rounds / mem_s
+            << " decodes/s, load+decode " << decodes / load_s
+            << " decodes/s, per-register pread " << decodes / pread_s
+            << " decodes/s (" << out % 2 << ")" << std::endl;
+
+  std::string cmd = std::string("rm -rf ") + name;
+  ASSERT_EQ(0, system(cmd.c_str()));
+}
@@ -0,0 +1,170 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <stdint.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "yaml-cpp/yaml.h"
+
+#include "include/rvsplan.h"
+#include "include/rvsliblogger.h"
+
+namespace {
+
+// modules known to the test: gst declares schema, rcqt does not
+int schema(const std::string& module, std::string* text) {
+  if (module == "gst") {
+    *text = "target_stress:float;copy_matrix:bool;"
+            "ops_type:string=sgemm|dgemm|hgemm;matrix_size_a:int";
+    return 0;
+  }
+  if (module == "gm") {
+    *text = "monitor:bool;metrics:collection";
+    return 0;
+  }
+  if (module == "rcqt") {
+    *text = "";
+    return 0;
+  }
+  return -1;
+}
+
+bool contains(const std::vector<std::string>& list, const std::string& s) {
+  return std::any_of(list.begin(), list.end(), [&s](const std::string& e) {
+    return e.find(s) != std::string::npos;
+  });
+}
+
+const std::vector<uint16_t> gpus = {3254, 50599};
+
+}  // namespace
+
+TEST(plan, valid) {
+  rvs::logger::quiet();
+  rvs::plan p;
+  EXPECT_EQ(0, p.build(YAML::Load(
+    "- name: a\n"
+    "  module: gst\n"
+    "  device: all\n"
+    "  duration: 10000\n"
+    "  wait: 1000\n"
+    "  count: 2\n"
+    "  target_stress: 5000.5\n"
+    "  ops_type: dgemm\n"
+    "- name: b\n"
+    "  module: gm\n"
+    "  device: 50599\n"
+    "  metrics:\n"
+    "    temp: true 20 0\n"
+    "- name: c\n"
+    "  module: rcqt\n"
+    "  package: rocm\n"), schema, gpus));
+  EXPECT_TRUE(p.warnings().empty());
+
+  ASSERT_EQ(3u, p.steps().size());
+  EXPECT_EQ(2u, p.steps()[0].devices.size());
+  EXPECT_DOUBLE_EQ(22000, p.steps()[0].estimate);
+  ASSERT_EQ(1u, p.steps()[1].devices.size());
+  EXPECT_EQ(50599, p.steps()[1].devices[0]);
+  EXPECT_LT(p.steps()[2].estimate, 0);
+  EXPECT_DOUBLE_EQ(22000, p.estimate());
+
+  std::string t = p.table();
+  EXPECT_NE(std::string::npos, t.find("3254,50599"));
+  EXPECT_NE(std::string::npos, t.find("22.0 s"));
+  EXPECT_NE(std::string::npos, t.find("2 action(s) of unknown duration"));
+}
+
+TEST(plan, errors) {
+  rvs::logger::quiet();
+  rvs::plan p;
+  EXPECT_EQ(7, p.build(YAML::Load(
+    "- name: a\n"
+    "  module: gst\n"
+    "  device: 1 3254\n"
+    "  target_stress: lots\n"
+    "  ops_type: zgemm\n"
+    "  copy_matrix: yes\n"
+    "  count: -1\n"
+    "- name: b\n"
+    "  module: nosuch\n"
+    "- name: c\n"
+    "  device: all\n"), schema, gpus));
+
+  EXPECT_TRUE(contains(p.errors(), "[a] GPU ID 1 not present"));
+  EXPECT_TRUE(contains(p.errors(), "[a] property 'target_stress'"));
+  EXPECT_TRUE(contains(p.errors(), "'zgemm' is not one of: sgemm, dgemm"));
+  EXPECT_TRUE(contains(p.errors(), "[a] property 'copy_matrix'"));
+  EXPECT_TRUE(contains(p.errors(), "[b] module 'nosuch' could not be"));
+  EXPECT_TRUE(contains(p.errors(), "[c] action does not specify module"));
+  // remaining valid device is still resolved
+  ASSERT_EQ(1u, p.steps()[0].devices.size());
+  // launcher properties are checked as well
+  EXPECT_TRUE(contains(p.errors(), "[a] property 'count'"));
+}
+
+TEST(plan, warnings) {
+  rvs::logger::quiet();
+  rvs::plan p;
+  EXPECT_EQ(0, p.build(YAML::Load(
+    "- name: a\n"
+    "  module: gst\n"
+    "  matrix_size: 1024\n"
+    "- name: a\n"
+    "  module: rcqt\n"
+    "  whatever: 1\n"), schema, std::vector<uint16_t>()));
+
+  EXPECT_EQ(3u, p.warnings().size());
+  EXPECT_TRUE(contains(p.warnings(), "no GPUs found"));
+  EXPECT_TRUE(contains(p.warnings(), "[a] unknown property 'matrix_size'"));
+  EXPECT_TRUE(contains(p.warnings(), "[a] action name used more than once"));
+}
+
+TEST(plan, sweep) {
+  rvs::logger::quiet();
+  rvs::plan p;
+  EXPECT_EQ(1, p.build(YAML::Load(
+    "- name: a\n"
+    "  module: gst\n"
+    "  duration: 1000\n"
+    "  sweep:\n"
+    "    matrix_size_a: [1024, 2048, big]\n"
+    "    ops_type: [sgemm, dgemm]\n"), schema, gpus));
+  EXPECT_TRUE(contains(p.errors(), "[a] sweep of property 'matrix_size_a'"));
+  EXPECT_EQ(6u, p.steps()[0].variants);
+  EXPECT_DOUBLE_EQ(6000, p.steps()[0].estimate);
+
+  EXPECT_EQ(1, p.build(YAML::Load(
+    "- name: a\n"
+    "  module: gst\n"
+    "  sweep:\n"
+    "    mode: zip\n"
+    "    matrix_size_a: [1024, 2048]\n"
+    "    ops_type: [sgemm]\n"), schema, gpus));
+  EXPECT_TRUE(contains(p.errors(), "[a] invalid 'sweep' key"));
+}
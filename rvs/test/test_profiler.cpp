@@ -0,0 +1,126 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "include/rvsprofiler.h"
+#include "include/rvsliblogger.h"
+#include "include/rvs_unit_testing_defs.h"
+
+class ProfilerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    rvs::logger::quiet();
+    rvs::profiler::clear();
+    rvs::profiler::enable(true);
+  }
+
+  void TearDown() override {
+    rvs::profiler::enable(false);
+    rvs::profiler::clear();
+  }
+
+  // returns table line holding given phase name
+  static std::string line(const std::string& Table, const std::string& Name) {
+    size_t pos = 0;
+    for (;;) {
+      pos = Table.find(" " + Name, pos + 1);
+      if (pos == std::string::npos) {
+        return "";
+      }
+      char next = Table[pos + Name.size() + 1];
+      if (next == ' ' || next == '\n') {
+        break;
+      }
+    }
+    size_t begin = Table.rfind('\n', pos) + 1;
+    return Table.substr(begin, Table.find('\n', pos) - begin);
+  }
+};
+
+TEST_F(ProfilerTest, disabled) {
+  rvs::profiler::enable(false);
+  EXPECT_EQ(rvs::profiler::begin("load"), -1);
+  rvs::profiler::end(-1);
+  rvs::profiler::record("parse", 0, 10);
+  EXPECT_EQ(line(rvs::profiler::table(), "load"), "");
+  EXPECT_EQ(line(rvs::profiler::table(), "parse"), "");
+}
+
+TEST_F(ProfilerTest, nested_phases) {
+  int a = rvs::profiler::begin("action", "gst", "action_1");
+  int c = rvs::profiler::begin("action create");
+  // phase reported by module through T_MODULE_INIT
+  int m = rvs::profiler::PhaseBegin("gpulist init");
+  rvs::profiler::PhaseEnd(m);
+  rvs::profiler::end(c);
+  rvs::profiler::end(a);
+  int o = rvs::profiler::begin("other");
+  rvs::profiler::end(o);
+
+  std::string table = rvs::profiler::table();
+  std::string l = line(table, "action create");
+  // nested phases are indented and inherit module and action
+  EXPECT_NE(l.find("  action create"), std::string::npos) << table;
+  EXPECT_NE(l.find("gst"), std::string::npos) << table;
+  EXPECT_NE(l.find("action_1"), std::string::npos) << table;
+  l = line(table, "gpulist init");
+  EXPECT_NE(l.find("    gpulist init"), std::string::npos) << table;
+  EXPECT_NE(l.find("action_1"), std::string::npos) << table;
+  // phase started after outer phase ended is not nested
+  l = line(table, "other");
+  EXPECT_EQ(l.find("action_1"), std::string::npos) << table;
+  EXPECT_NE(l.find("  other"), std::string::npos) << table;
+  EXPECT_EQ(l.find("   other"), std::string::npos) << table;
+}
+
+TEST_F(ProfilerTest, durations) {
+  int64_t start = rvs::profiler::now();
+  rvs::profiler::record("cli parse", start, start + 2500000);
+  int p = rvs::profiler::begin("open");
+
+  std::string table = rvs::profiler::table();
+  EXPECT_NE(line(table, "cli parse").find(" 2.500 "), std::string::npos)
+    << table;
+  // phase still running has no duration
+  EXPECT_NE(line(table, "open").find(" - "), std::string::npos) << table;
+  rvs::profiler::end(p);
+}
+
+TEST_F(ProfilerTest, threads) {
+  int a = rvs::profiler::begin("action", "mem", "action_a");
+  std::thread t([]() {
+    int b = rvs::profiler::begin("worker");
+    rvs::profiler::end(b);
+  });
+  t.join();
+  rvs::profiler::end(a);
+
+  // phases of other threads are not nested
+  std::string l = line(rvs::profiler::table(), "worker");
+  EXPECT_EQ(l.find("action_a"), std::string::npos) << l;
+}
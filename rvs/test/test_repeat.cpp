@@ -0,0 +1,89 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/rvsrepeat.h"
+#include "include/rvsactionresult.h"
+#include "include/rvsliblogger.h"
+
+TEST(repeat, stats) {
+  rvs::logger::quiet();
+  rvs::repeatstats rs;
+
+  // two values in the same iteration count as their mean
+  rs.add(1, "gst_1", 3254, "gflops", 9000, "GFLOPS");
+  rs.add(1, "gst_1", 3254, "gflops", 11000, "GFLOPS");
+  rs.add(2, "gst_1", 3254, "gflops", 10500, "GFLOPS");
+  rs.add(3, "gst_1", 3254, "gflops", 9500, "GFLOPS");
+  rs.add(1, "pebb_1", 3254, "bandwidth", 10, "GBps");
+  rs.add(2, "pebb_1", 3254, "bandwidth", 20, "GBps");
+
+  std::vector<rvs::repeatstats::stat> st = rs.stats();
+  ASSERT_EQ(2u, st.size());
+  EXPECT_EQ("gst_1", st[0].action);
+  EXPECT_EQ(3u, st[0].count);
+  EXPECT_DOUBLE_EQ(10000, st[0].mean);
+  EXPECT_DOUBLE_EQ(500, st[0].stddev);
+  EXPECT_DOUBLE_EQ(9500, st[0].min);
+  EXPECT_DOUBLE_EQ(10500, st[0].max);
+  EXPECT_DOUBLE_EQ(5, st[0].cov);
+
+  EXPECT_DOUBLE_EQ(15, st[1].mean);
+  EXPECT_NEAR(47.14, st[1].cov, 0.01);
+
+  // only bandwidth exceeds 10 %
+  EXPECT_EQ(1u, rs.report(10));
+  EXPECT_EQ(2u, rs.report(1));
+  std::string t = rs.table(10);
+  size_t gst = t.find("gst_1");
+  size_t pebb = t.find("pebb_1");
+  ASSERT_NE(std::string::npos, gst);
+  ASSERT_NE(std::string::npos, pebb);
+  EXPECT_EQ(std::string::npos, t.substr(gst, pebb - gst).find("NOISY"));
+  EXPECT_NE(std::string::npos, t.substr(pebb).find("NOISY"));
+}
+
+TEST(repeat, actionresult) {
+  rvs::logger::quiet();
+  rvs::repeatstats rs;
+  for (size_t i = 1; i <= 2; i++) {
+    rvs::actionresult r("pqt", "pqt_1");
+    T_RVS_RESULT_SINK* s = r.sink();
+    (*s->cbMetric)(s->ctx, 1, "p2p-bandwidth", 10.0 * i, "GBps");
+    (*s->cbMetric)(s->ctx, 2, "p2p-bandwidth", 5, "GBps");
+    rs.add(i, "pqt_1", r);
+  }
+
+  std::vector<rvs::repeatstats::stat> st = rs.stats();
+  ASSERT_EQ(2u, st.size());
+  EXPECT_EQ(1, st[0].gpu_id);
+  EXPECT_DOUBLE_EQ(15, st[0].mean);
+  EXPECT_EQ(2, st[1].gpu_id);
+  EXPECT_DOUBLE_EQ(0, st[1].cov);
+  EXPECT_EQ(1u, rs.report(5));
+}
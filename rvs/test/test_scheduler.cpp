@@ -0,0 +1,225 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "yaml-cpp/yaml.h"
+
+#include "include/rvsscheduler.h"
+#include "include/rvsliblogger.h"
+#include "include/rvs_unit_testing_defs.h"
+
+class SchedulerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    rvs::logger::quiet();
+    peak = 0;
+    active = 0;
+  }
+
+  // records execution order and peak concurrency
+  int runner(const YAML::Node& Action) {
+    int now = ++active;
+    int prev = peak;
+    while (now > prev && !peak.compare_exchange_weak(prev, now)) {
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(
+      Action["ms"] ? Action["ms"].as<int>() : 20));
+    {
+      std::lock_guard<std::mutex> lk(order_mutex);
+      order.push_back(Action["name"].as<std::string>());
+    }
+    active--;
+
+    return Action["fail"] ? -7 : 0;
+  }
+
+  int run(const char* Yaml,
+          rvs::scheduler::t_reentrant Reentrant = nullptr) {
+    YAML::Node config = YAML::Load(Yaml);
+    int sts = sched.build(config["actions"], Reentrant);
+    if (sts) {
+      return sts;
+    }
+    return sched.run([this, &config](const YAML::Node& Action,
+                                     const size_t Index) {
+      // runner is given position of the action in .conf file
+      EXPECT_EQ(config["actions"][Index]["name"].as<std::string>(),
+                Action["name"].as<std::string>());
+      return runner(Action);
+    });
+  }
+
+  size_t position(const std::string& Name) {
+    for (size_t i = 0; i < order.size(); i++) {
+      if (order[i] == Name) {
+        return i;
+      }
+    }
+    return order.size();
+  }
+
+  rvs::scheduler sched;
+  std::vector<std::string> order;
+  std::mutex order_mutex;
+  std::atomic<int> active;
+  std::atomic<int> peak;
+};
+
+TEST_F(SchedulerTest, is_scheduled) {
+  YAML::Node plain = YAML::Load(
+    "actions:\n"
+    "- {name: a, module: mem}\n"
+    "- {name: b, module: gst}\n");
+  EXPECT_FALSE(rvs::scheduler::is_scheduled(plain["actions"]));
+
+  YAML::Node grouped = YAML::Load(
+    "actions:\n"
+    "- {name: a, module: mem, group: x}\n"
+    "- {name: b, module: gst}\n");
+  EXPECT_TRUE(rvs::scheduler::is_scheduled(grouped["actions"]));
+}
+
+TEST_F(SchedulerTest, groups_run_concurrently) {
+  EXPECT_EQ(run(
+    "actions:\n"
+    "- {name: mem_a, module: mem, device: 0 1 2 3, group: a}\n"
+    "- {name: mem_b, module: mem, device: 0 1 2 3, group: a}\n"
+    "- {name: babel, module: babel, device: 4 5 6 7, group: b, ms: 60}\n"
+    "- {name: monitor, module: gm, device: all, group: c, ms: 60}\n"), 0);
+
+  EXPECT_EQ(sched.threads(), 3u);
+  EXPECT_EQ(order.size(), 4u);
+  EXPECT_EQ(peak, 3);
+  // same group keeps .conf file order
+  EXPECT_LT(position("mem_a"), position("mem_b"));
+  EXPECT_TRUE(sched.depends("mem_b", "mem_a"));
+  EXPECT_FALSE(sched.depends("babel", "mem_a"));
+}
+
+TEST_F(SchedulerTest, depends_on) {
+  EXPECT_EQ(run(
+    "actions:\n"
+    "- {name: a, module: mem, device: 0, group: x, ms: 50}\n"
+    "- {name: b, module: mem, device: 1, group: y, ms: 10}\n"
+    "- {name: c, module: gst, device: 0 1, group: z, depends_on: [a, b]}\n"
+    "- {name: d, module: gpup, device: all, group: w, depends_on: c}\n"), 0);
+
+  ASSERT_EQ(order.size(), 4u);
+  EXPECT_EQ(order[2], "c");
+  EXPECT_EQ(order[3], "d");
+  EXPECT_TRUE(sched.depends("d", "a"));
+  EXPECT_FALSE(sched.depends("a", "d"));
+}
+
+TEST_F(SchedulerTest, same_module_is_serialized) {
+  // module state is per process, actions of one module must not overlap
+  EXPECT_EQ(run(
+    "actions:\n"
+    "- {name: a, module: mem, device: 0, group: x}\n"
+    "- {name: b, module: mem, device: 1, group: y}\n"
+    "- {name: c, module: mem, device: 2, group: z}\n"), 0);
+  EXPECT_EQ(sched.threads(), 3u);
+  EXPECT_EQ(order.size(), 3u);
+  EXPECT_EQ(peak, 1);
+
+  // unless module declares itself re-entrant
+  order.clear();
+  peak = 0;
+  EXPECT_EQ(run(
+    "actions:\n"
+    "- {name: a, module: gpup, device: 0, group: x, ms: 50}\n"
+    "- {name: b, module: gpup, device: 0, group: y, ms: 50}\n"
+    "- {name: c, module: mem, device: 1, group: z, ms: 50}\n",
+    [](const std::string& Module) { return Module == "gpup"; }), 0);
+  EXPECT_EQ(order.size(), 3u);
+  EXPECT_EQ(peak, 3);
+}
+
+TEST_F(SchedulerTest, default_group_is_sequential) {
+  EXPECT_EQ(run(
+    "actions:\n"
+    "- {name: a, module: mem, device: all}\n"
+    "- {name: b, module: mem, device: all}\n"
+    "- {name: c, module: gst, device: 0, group: other, depends_on: b}\n"), 0);
+
+  EXPECT_EQ(peak, 1);
+  ASSERT_EQ(order.size(), 3u);
+  EXPECT_EQ(order[0], "a");
+  EXPECT_EQ(order[1], "b");
+  EXPECT_EQ(order[2], "c");
+}
+
+TEST_F(SchedulerTest, failure_stops_scheduling) {
+  EXPECT_EQ(run(
+    "actions:\n"
+    "- {name: a, module: mem, device: 0, group: x, fail: 1}\n"
+    "- {name: b, module: mem, device: 0, group: x}\n"
+    "- {name: c, module: gst, device: 1, group: y, ms: 50}\n"), -7);
+
+  // running action completes, dependent action is never started
+  EXPECT_EQ(position("a"), 0u);
+  EXPECT_LT(position("c"), order.size());
+  EXPECT_EQ(position("b"), order.size());
+}
+
+TEST_F(SchedulerTest, invalid_graph) {
+  // unknown dependency
+  EXPECT_NE(run(
+    "actions:\n"
+    "- {name: a, module: mem, device: 0, depends_on: missing}\n"), 0);
+
+  // cycle
+  EXPECT_NE(run(
+    "actions:\n"
+    "- {name: a, module: mem, device: 0, group: x, depends_on: b}\n"
+    "- {name: b, module: mem, device: 1, group: y, depends_on: a}\n"), 0);
+
+  // duplicate name
+  EXPECT_NE(run(
+    "actions:\n"
+    "- {name: a, module: mem, device: 0, group: x}\n"
+    "- {name: a, module: mem, device: 1, group: y}\n"), 0);
+
+  // same device used concurrently
+  EXPECT_NE(run(
+    "actions:\n"
+    "- {name: a, module: mem, device: 0 1, group: x}\n"
+    "- {name: b, module: babel, device: 1 2, group: y}\n"), 0);
+  EXPECT_NE(run(
+    "actions:\n"
+    "- {name: a, module: mem, device: all, group: x}\n"
+    "- {name: b, module: babel, device: 3, group: y}\n"), 0);
+
+  EXPECT_TRUE(order.empty());
+}
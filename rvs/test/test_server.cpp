@@ -0,0 +1,271 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "yaml-cpp/yaml.h"
+
+#include "include/rvsclient.h"
+#include "include/rvsliblogger.h"
+#include "include/rvsoptions.h"
+#include "include/rvsserver.h"
+#include "include/rvs_unit_testing_defs.h"
+
+class ServerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    rvs::logger::quiet();
+    rvs::logger::log_level(rvs::loginfo);
+    active = 0;
+    peak = 0;
+
+    dir = "/tmp/rvs_server_" + std::to_string(getpid());
+    mkdir(dir.c_str(), 0700);
+    socket = dir + "/rvs.sock";
+
+    th = std::thread([this]() {
+      srv.serve(socket, [this](const std::string& Config) {
+        return runner(Config);
+      });
+    });
+
+    // wait for server to start listening
+    for (int i = 0; i < 100 && access(socket.c_str(), F_OK); i++) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+
+  void TearDown() override {
+    srv.stop();
+    th.join();
+    for (auto it = files.begin(); it != files.end(); ++it) {
+      unlink(it->c_str());
+    }
+    rmdir(dir.c_str());
+  }
+
+  // pretends to run actions, logging from job thread and action thread
+  int runner(const std::string& Config) {
+    YAML::Node config = YAML::LoadFile(Config);
+    std::string indexes("-");
+    rvs::options::has_option("-i", &indexes);
+
+    int now = ++active;
+    int prev = peak;
+    while (now > prev && !peak.compare_exchange_weak(prev, now)) {
+    }
+
+    rvs::logger::log("[CLI] indexes " + indexes, rvs::logresults);
+    const YAML::Node& actions = config["actions"];
+    for (auto it = actions.begin(); it != actions.end(); ++it) {
+      std::string name = (*it)["name"].as<std::string>();
+      std::thread t([name]() {
+        rvs::logger::log("[" + name + "] fake pass: TRUE", rvs::logresults);
+        rvs::logger::log("[" + name + "] fake details", rvs::logdebug);
+      });
+      t.join();
+    }
+    int rows = config["rows"] ? config["rows"].as<int>() : 0;
+    for (int i = 0; i < rows; i++) {
+      rvs::logger::log("[CLI] bulk " + std::string(1000, 'x'),
+                       rvs::logresults);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(
+      config["ms"] ? config["ms"].as<int>() : 10));
+
+    active--;
+    return config["status"] ? config["status"].as<int>() : 0;
+  }
+
+  std::string conf(const std::string& Name, const std::string& Yaml) {
+    std::string path = dir + "/" + Name + ".conf";
+    std::ofstream(path) << Yaml;
+    files.push_back(path);
+    return path;
+  }
+
+  int submit(const std::map<std::string, std::string>& Options,
+             std::vector<std::string>* pRows = nullptr,
+             rvs::client* pClient = nullptr) {
+    std::mutex m;
+    rvs::client cl([&](const int, const std::string& Row) {
+      std::lock_guard<std::mutex> lk(m);
+      if (pRows) {
+        pRows->push_back(Row);
+      }
+    });
+    int sts = cl.submit(socket, Options);
+    if (pClient) {
+      *pClient = cl;
+    }
+    return sts;
+  }
+
+  static bool has_row(const std::vector<std::string>& Rows,
+                      const std::string& Text) {
+    for (auto it = Rows.begin(); it != Rows.end(); ++it) {
+      if (it->find(Text) != std::string::npos) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  rvs::server srv;
+  std::thread th;
+  std::string dir;
+  std::string socket;
+  std::vector<std::string> files;
+  std::atomic<int> active;
+  std::atomic<int> peak;
+};
+
+TEST_F(ServerTest, job_rows_and_status) {
+  std::string c = conf("a", "status: 3\n"
+                            "actions:\n"
+                            "- name: act_a\n  module: fake\n  device: 1\n");
+  std::vector<std::string> rows;
+  rvs::client cl(nullptr);
+
+  EXPECT_EQ(submit({{"-c", c}, {"-i", "5,6"}}, &rows, &cl), 3);
+  EXPECT_NE(cl.job_id(), 0u);
+  EXPECT_GT(cl.seconds_run(), 0.0);
+
+  // row from job thread carries job options
+  EXPECT_TRUE(has_row(rows, "[CLI] indexes 5,6"));
+  // row from action thread is matched by action name
+  EXPECT_TRUE(has_row(rows, "[act_a] fake pass: TRUE"));
+  // rows above job logging level are not sent
+  EXPECT_FALSE(has_row(rows, "fake details"));
+
+  rows.clear();
+  EXPECT_EQ(submit({{"-c", c}, {"-d", "4"}}, &rows), 3);
+  EXPECT_TRUE(has_row(rows, "[CLI] indexes -"));
+  // job level is capped by server level
+  EXPECT_FALSE(has_row(rows, "fake details"));
+}
+
+TEST_F(ServerTest, one_job_per_device) {
+  std::string a = conf("a", "ms: 200\nactions:\n"
+                            "- name: act_a\n  module: fake\n  device: 1\n");
+  std::string b = conf("b", "ms: 200\nactions:\n"
+                            "- name: act_b\n  module: other\n  device: 2\n");
+  std::string c = conf("c", "ms: 200\nactions:\n"
+                            "- name: act_c\n  module: fake\n  device: 1 3\n");
+
+  // different devices - jobs run concurrently
+  std::thread ta([&]() { EXPECT_EQ(submit({{"-c", a}}), 0); });
+  std::thread tb([&]() { EXPECT_EQ(submit({{"-c", b}}), 0); });
+  ta.join();
+  tb.join();
+  EXPECT_EQ(peak, 2);
+
+  // shared device - second job waits
+  peak = 0;
+  std::thread tc([&]() { EXPECT_EQ(submit({{"-c", a}}), 0); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  rvs::client cl(nullptr);
+  EXPECT_EQ(submit({{"-c", c}}, nullptr, &cl), 0);
+  tc.join();
+  EXPECT_EQ(peak, 1);
+  EXPECT_GT(cl.seconds_queued(), 0.05);
+}
+
+TEST_F(ServerTest, one_job_per_module) {
+  std::string a = conf("a", "ms: 200\nactions:\n"
+                            "- name: act_a\n  module: fake\n  device: 1\n");
+  std::string b = conf("b", "ms: 200\nactions:\n"
+                            "- name: act_b\n  module: fake\n  device: 2\n");
+
+  // module state is per process - second job waits
+  std::thread ta([&]() { EXPECT_EQ(submit({{"-c", a}}), 0); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  rvs::client cl(nullptr);
+  EXPECT_EQ(submit({{"-c", b}}, nullptr, &cl), 0);
+  ta.join();
+  EXPECT_EQ(peak, 1);
+  EXPECT_GT(cl.seconds_queued(), 0.05);
+}
+
+TEST_F(ServerTest, slow_client) {
+  std::string a = conf("a", "rows: 2000\nactions:\n"
+                            "- name: act_a\n  module: fake\n  device: 1\n");
+  std::string b = conf("b", "actions:\n"
+                            "- name: act_b\n  module: other\n  device: 2\n");
+
+  // client which submits a job and never reads its output
+  struct sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, socket.c_str(), sizeof(addr.sun_path) - 1);
+  int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  ASSERT_EQ(connect(fd, reinterpret_cast<struct sockaddr*>(&addr),
+                    sizeof(addr)), 0);
+  ASSERT_TRUE(rvs::server::send_line(fd, RVS_SERVE_PROTOCOL));
+  ASSERT_TRUE(rvs::server::send_line(fd, "opt -c " + a));
+  ASSERT_TRUE(rvs::server::send_line(fd, "end"));
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+  // output blocked on stalled client does not hold other jobs
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_EQ(submit({{"-c", b}}), 0);
+  std::chrono::duration<double> took =
+    std::chrono::steady_clock::now() - start;
+  EXPECT_LT(took.count(), RVS_SERVE_SEND_TMO / 2.0);
+
+  close(fd);
+}
+
+TEST_F(ServerTest, invalid_jobs) {
+  std::string c = conf("a", "actions:\n- name: act_a\n  module: fake\n");
+
+  // missing configuration file
+  EXPECT_EQ(submit({{"-c", dir + "/none.conf"}}), -1);
+  // relative configuration file
+  EXPECT_EQ(submit({{"-c", "a.conf"}}), -1);
+  // option which can not be set per job
+  EXPECT_EQ(submit({{"-c", c}, {"-l", "x.log"}}), -1);
+  // server still works
+  EXPECT_EQ(submit({{"-c", c}}), 0);
+}
+
+TEST_F(ServerTest, no_server) {
+  rvs::client cl(nullptr);
+  EXPECT_EQ(cl.submit(dir + "/none.sock", {}), -1);
+  EXPECT_EQ(cl.job_id(), 0u);
+}
@@ -0,0 +1,107 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <string>
+
+#include "gtest/gtest.h"
+#include "yaml-cpp/yaml.h"
+
+#include "include/rvssweep.h"
+#include "include/rvsactionresult.h"
+#include "include/rvsliblogger.h"
+
+TEST(sweep, product) {
+  rvs::logger::quiet();
+  YAML::Node action = YAML::Load(
+    "name: s\n"
+    "module: gst\n"
+    "sweep:\n"
+    "  matrix_size_a: [1024, 2048, 4096]\n"
+    "  target_stress: [1000, 2000]\n");
+  ASSERT_TRUE(rvs::sweep::has_sweep(action));
+
+  rvs::sweep sw;
+  ASSERT_EQ(0, sw.build(action["sweep"]));
+  ASSERT_EQ(6u, sw.size());
+
+  rvs::sweep::t_params p = sw.variant(0);
+  ASSERT_EQ(2u, p.size());
+  EXPECT_EQ("matrix_size_a", p[0].first);
+  EXPECT_EQ("1024", p[0].second);
+  EXPECT_EQ("1000", p[1].second);
+
+  p = sw.variant(1);
+  EXPECT_EQ("1024", p[0].second);
+  EXPECT_EQ("2000", p[1].second);
+
+  p = sw.variant(5);
+  EXPECT_EQ("4096", p[0].second);
+  EXPECT_EQ("2000", p[1].second);
+}
+
+TEST(sweep, zip) {
+  rvs::logger::quiet();
+  rvs::sweep sw;
+  ASSERT_EQ(0, sw.build(YAML::Load(
+    "mode: zip\n"
+    "block_size: [1024, 2048]\n"
+    "duration: [100, 200]\n")));
+  ASSERT_EQ(2u, sw.size());
+  EXPECT_EQ("2048", sw.variant(1)[0].second);
+  EXPECT_EQ("200", sw.variant(1)[1].second);
+
+  // lists of different length can not be zipped
+  EXPECT_NE(0, sw.build(YAML::Load(
+    "mode: zip\n"
+    "block_size: [1024, 2048]\n"
+    "duration: [100]\n")));
+  EXPECT_NE(0, sw.build(YAML::Load("mode: shuffle\nx: [1]\n")));
+  EXPECT_NE(0, sw.build(YAML::Load("metric: gflops\n")));
+
+  // single value is one variant
+  ASSERT_EQ(0, sw.build(YAML::Load("count: 3\n")));
+  EXPECT_EQ(1u, sw.size());
+}
+
+TEST(sweep, table) {
+  rvs::logger::quiet();
+  rvs::sweep sw;
+  ASSERT_EQ(0, sw.build(YAML::Load("block_size: [1024, 2048]\n")));
+
+  for (size_t i = 0; i < sw.size(); i++) {
+    rvs::actionresult result("pebb", "s");
+    T_RVS_RESULT_SINK* sink = result.sink();
+    (*sink->cbDevice)(sink->ctx, 1, 1);
+    (*sink->cbMetric)(sink->ctx, 1, "pcie-bandwidth", 10.0 * (i + 1),
+                      "GBps");
+    (*sink->cbMetric)(sink->ctx, 2, "pcie-bandwidth", 20.0 * (i + 1),
+                      "GBps");
+    (*sink->cbMetric)(sink->ctx, 2, "other", 1, "");
+    sw.add_result(i, 0, result);
+  }
+
+  EXPECT_EQ("block_size,status,passed,failed,pcie-bandwidth (GBps)\n"
+            "1024,0,1,0,15\n"
+            "2048,0,1,0,30\n", sw.table());
+}
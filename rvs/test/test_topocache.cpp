@@ -0,0 +1,219 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/gpu_util.h"
+#include "include/rvstopocache.h"
+#include "include/rvstopogen.h"
+
+class TopoCacheTest : public ::testing::Test, public rvs::gpulist {
+ protected:
+  void SetUp() override {
+    char name[] = "/tmp/rvs_topocache_XXXXXX";
+    ASSERT_NE(mkdtemp(name), nullptr);
+    root = name;
+    cache = root + "/cache/topology.cache";
+    nodes_path = root + KFD_SYS_PATH_NODES;
+    setenv(RVS_SYSROOT_ENV, root.c_str(), 1);
+    setenv(RVS_TOPOLOGY_CACHE_ENV, cache.c_str(), 1);
+    rvs::topogen gen;
+    gen.gpus = 16;
+    ASSERT_EQ(0, gen.generate(root));
+  }
+
+  void TearDown() override {
+    unsetenv(RVS_SYSROOT_ENV);
+    unsetenv(RVS_TOPOLOGY_CACHE_ENV);
+    topology.clear();
+    build_index();
+    initialized = false;
+    std::string cmd = "rm -rf " + root;
+    ASSERT_EQ(0, system(cmd.c_str()));
+  }
+
+  void write(const std::string& Path, const std::string& Content) {
+    std::ofstream f(Path);
+    f << Content;
+  }
+
+  std::string root;
+  std::string cache;
+  std::string nodes_path;
+};
+
+TEST_F(TopoCacheTest, roundtrip) {
+  std::vector<rvs::kfd_node> live;
+  std::vector<rvs::kfd_node> cached;
+  uint64_t print;
+
+  ASSERT_EQ(0, gpu_load_topology(nodes_path.c_str(), &live));
+  ASSERT_EQ(0, rvs::topocache::fingerprint(nodes_path, &print));
+  EXPECT_EQ(-1, rvs::topocache::load(cache, print, &cached));
+  ASSERT_EQ(0, rvs::topocache::save(cache, print, live));
+  ASSERT_EQ(0, rvs::topocache::load(cache, print, &cached));
+
+  ASSERT_EQ(live.size(), cached.size());
+  for (size_t i = 0; i < live.size(); i++) {
+    EXPECT_EQ(live[i].node_id, cached[i].node_id);
+    EXPECT_EQ(live[i].gpu_id, cached[i].gpu_id);
+    EXPECT_EQ(live[i].location_id, cached[i].location_id);
+    EXPECT_EQ(live[i].device_id, cached[i].device_id);
+    EXPECT_EQ(live[i].vendor_id, cached[i].vendor_id);
+    EXPECT_EQ(live[i].numa_node, cached[i].numa_node);
+    EXPECT_EQ(live[i].properties, cached[i].properties);
+    ASSERT_EQ(live[i].io_links.size(), cached[i].io_links.size());
+    for (size_t j = 0; j < live[i].io_links.size(); j++) {
+      EXPECT_EQ(live[i].io_links[j].type, cached[i].io_links[j].type);
+      EXPECT_EQ(live[i].io_links[j].node_to, cached[i].io_links[j].node_to);
+      EXPECT_EQ(live[i].io_links[j].weight, cached[i].io_links[j].weight);
+    }
+  }
+
+  // other fingerprint, truncated and foreign files are rejected
+  EXPECT_EQ(-1, rvs::topocache::load(cache, print + 1, &cached));
+  EXPECT_TRUE(cached.empty());
+
+  // node count in header exceeding payload is rejected before allocation
+  {
+    std::fstream f(cache, std::ios::in | std::ios::out | std::ios::binary);
+    uint32_t nodes = 0xffffffff;
+    f.seekp(12);
+    f.write(reinterpret_cast<const char*>(&nodes), sizeof(nodes));
+  }
+  EXPECT_EQ(-1, rvs::topocache::load(cache, print, &cached));
+  EXPECT_TRUE(cached.empty());
+  ASSERT_EQ(0, rvs::topocache::save(cache, print, live));
+  ASSERT_EQ(0, rvs::topocache::load(cache, print, &cached));
+
+  ASSERT_EQ(0, truncate(cache.c_str(), 100));
+  EXPECT_EQ(-1, rvs::topocache::load(cache, print, &cached));
+  write(cache, "not a topology cache, just some text long enough for header");
+  EXPECT_EQ(-1, rvs::topocache::load(cache, print, &cached));
+}
+
+TEST_F(TopoCacheTest, fingerprint) {
+  uint64_t print;
+  uint64_t other;
+
+  ASSERT_EQ(0, rvs::topocache::fingerprint(nodes_path, &print));
+  ASSERT_EQ(0, rvs::topocache::fingerprint(nodes_path, &other));
+  EXPECT_EQ(print, other);
+
+  // driver update
+  ASSERT_EQ(0, system(("mkdir -p " + root + "/sys/module/amdgpu").c_str()));
+  write(root + "/sys/module/amdgpu/version", "6.8.5\n");
+  ASSERT_EQ(0, rvs::topocache::fingerprint(nodes_path, &other));
+  EXPECT_NE(print, other);
+  print = other;
+
+  // GPU replaced
+  write(nodes_path + "/5/gpu_id", "4242\n");
+  ASSERT_EQ(0, rvs::topocache::fingerprint(nodes_path, &other));
+  EXPECT_NE(print, other);
+
+  EXPECT_EQ(-1, rvs::topocache::fingerprint(root + "/none", &other));
+}
+
+TEST_F(TopoCacheTest, initialize) {
+  uint16_t node;
+
+  // first run builds cache, second one uses it
+  ASSERT_EQ(0, Initialize());
+  EXPECT_EQ(0, access(cache.c_str(), F_OK));
+  EXPECT_EQ(0, gpu2node(rvs::topogen::gpu_id(3), &node));
+  EXPECT_EQ(5, node);
+
+  // cached properties are served even if sysfs content changed meanwhile
+  write(nodes_path + "/5/properties", "location_id 77\n");
+  ASSERT_EQ(0, Initialize());
+  EXPECT_EQ(rvs::topogen::location_id(3),
+            gpu2info(rvs::topogen::gpu_id(3))->location_id);
+
+  // refresh rebuilds it
+  ASSERT_EQ(0, Initialize(gpu_sysfs_path(KFD_SYS_PATH_NODES).c_str(), true));
+  EXPECT_EQ(77, gpu2info(rvs::topogen::gpu_id(3))->location_id);
+  write(nodes_path + "/5/properties", "location_id 78\n");
+  ASSERT_EQ(0, Initialize());
+  EXPECT_EQ(77, gpu2info(rvs::topogen::gpu_id(3))->location_id);
+
+  // fingerprint change invalidates cache
+  write(nodes_path + "/5/gpu_id", "4242\n");
+  ASSERT_EQ(0, Initialize());
+  EXPECT_EQ(78, gpu2info(4242)->location_id);
+
+  // empty cache name disables cache
+  unlink(cache.c_str());
+  setenv(RVS_TOPOLOGY_CACHE_ENV, "", 1);
+  ASSERT_EQ(0, Initialize());
+  EXPECT_NE(0, access(cache.c_str(), F_OK));
+
+  // unwritable cache is not an error
+  setenv(RVS_TOPOLOGY_CACHE_ENV, (root + "/none/none/cache").c_str(), 1);
+  EXPECT_EQ(0, Initialize());
+  EXPECT_NE(nullptr, gpu2info(4242));
+}
+
+// times startup discovery with and without cache
+TEST_F(TopoCacheTest, benchmark) {
+  const int loops = 5;
+
+  for (int gpus : {64, 1024}) {
+    rvs::topogen gen;
+    gen.gpus = gpus;
+    gen.cpus = 8;
+    std::string dir = root + "/" + std::to_string(gpus);
+    ASSERT_EQ(0, gen.generate(dir));
+    setenv(RVS_SYSROOT_ENV, dir.c_str(), 1);
+    std::string path = gpu_sysfs_path(KFD_SYS_PATH_NODES);
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < loops; i++) {
+      ASSERT_EQ(0, Initialize(path.c_str(), true));
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (int i = 0; i < loops; i++) {
+      ASSERT_EQ(0, Initialize());
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    ASSERT_EQ(static_cast<size_t>(gpus + gen.cpus), nodes().size());
+
+    std::cout << gpus << " GPUs  uncached: "
+              << std::chrono::duration<double, std::milli>(t1 - t0).count() /
+                 loops
+              << " ms  cached: "
+              << std::chrono::duration<double, std::milli>(t2 - t1).count() /
+                 loops
+              << " ms" << std::endl;
+  }
+}
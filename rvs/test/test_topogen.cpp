@@ -0,0 +1,149 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/gpu_util.h"
+#include "include/rvstopocache.h"
+#include "include/rvstopogen.h"
+
+class TopoGenTest : public ::testing::Test, public rvs::gpulist {
+ protected:
+  void SetUp() override {
+    char name[] = "/tmp/rvs_topogen_XXXXXX";
+    ASSERT_NE(mkdtemp(name), nullptr);
+    root = name;
+    setenv(RVS_SYSROOT_ENV, root.c_str(), 1);
+    setenv(RVS_TOPOLOGY_CACHE_ENV, "", 1);
+  }
+
+  void TearDown() override {
+    unsetenv(RVS_SYSROOT_ENV);
+    topology.clear();
+    build_index();
+    initialized = false;
+    unsetenv(RVS_TOPOLOGY_CACHE_ENV);
+    std::string cmd = "rm -rf " + root;
+    ASSERT_EQ(0, system(cmd.c_str()));
+  }
+
+  std::string root;
+};
+
+TEST_F(TopoGenTest, sysroot) {
+  EXPECT_EQ(root + KFD_SYS_PATH_NODES, gpu_sysfs_path(KFD_SYS_PATH_NODES));
+  setenv(RVS_SYSROOT_ENV, (root + "//").c_str(), 1);
+  EXPECT_EQ(root + KFD_SYS_PATH_NODES, gpu_sysfs_path(KFD_SYS_PATH_NODES));
+  unsetenv(RVS_SYSROOT_ENV);
+  EXPECT_EQ(KFD_SYS_PATH_NODES, gpu_sysfs_path(KFD_SYS_PATH_NODES));
+}
+
+TEST_F(TopoGenTest, generate) {
+  rvs::topogen gen;
+  gen.gpus = 12;
+  gen.cpus = 2;
+  gen.hive_size = 4;
+  ASSERT_EQ(0, gen.generate(root));
+  ASSERT_EQ(0, Initialize());
+  ASSERT_EQ(14u, nodes().size());
+
+  std::vector<uint16_t> gpus;
+  gpu_get_all_gpu_id(&gpus);
+  ASSERT_EQ(12u, gpus.size());
+
+  for (int g = 0; g < gen.gpus; g++) {
+    EXPECT_EQ(rvs::topogen::gpu_id(g), gpus[g]);
+    const rvs::kfd_node* node = gpu2info(gpus[g]);
+    ASSERT_NE(nullptr, node);
+    EXPECT_EQ(2 + g, node->node_id);
+    EXPECT_EQ(rvs::topogen::location_id(g), node->location_id);
+    EXPECT_EQ(0x74a1, node->device_id);
+    EXPECT_EQ(0x1002, node->vendor_id);
+    EXPECT_EQ(g % 2, node->numa_node);
+    // PCIe link to CPU and XGMI links to 3 hive peers
+    ASSERT_EQ(4u, node->io_links.size());
+    EXPECT_EQ(2u, node->io_links[0].type);
+    EXPECT_EQ(11u, node->io_links[1].type);
+    uint64_t val;
+    EXPECT_TRUE(node->property("io_links_count", &val));
+    EXPECT_EQ(4u, val);
+  }
+  // CPU node: link to other CPU and to its 6 GPUs
+  EXPECT_EQ(7u, nodes()[0].io_links.size());
+  EXPECT_EQ(0, nodes()[0].gpu_id);
+
+  EXPECT_EQ(0, access((root + "/sys/class/kfd/kfd/topology/generation_id")
+                     .c_str(), F_OK));
+
+  gen.cpus = 0;
+  EXPECT_EQ(-1, gen.generate(root));
+}
+
+// times discovery and lookups on 8, 64 and 1024 GPU topologies
+TEST_F(TopoGenTest, scaling) {
+  const int loops = 5;
+  const int lookups = 100000;
+
+  for (int gpus : {8, 64, 1024}) {
+    rvs::topogen gen;
+    gen.gpus = gpus;
+    gen.cpus = gpus < 64 ? 2 : 8;
+    std::string dir = root + "/" + std::to_string(gpus);
+    ASSERT_EQ(0, gen.generate(dir));
+    setenv(RVS_SYSROOT_ENV, dir.c_str(), 1);
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < loops; i++) {
+      ASSERT_EQ(0, Initialize());
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    ASSERT_EQ(static_cast<size_t>(gpus + gen.cpus), nodes().size());
+
+    uint64_t sum = 0;
+    for (int i = 0; i < lookups; i++) {
+      uint16_t val = 0;
+      int g = i % gpus;
+      EXPECT_EQ(0, gpu2node(rvs::topogen::gpu_id(g), &val));
+      sum += val;
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    EXPECT_GT(sum, 0u);
+
+    std::cout << gpus << " GPUs  init: "
+              << std::chrono::duration<double, std::milli>(t1 - t0).count() /
+                 loops
+              << " ms  lookup: "
+              << std::chrono::duration<double, std::nano>(t2 - t1).count() /
+                 lookups
+              << " ns" << std::endl;
+  }
+}
@@ -26,21 +26,47 @@
 
 #include <stdlib.h>
 #include <dirent.h>
+#include <fcntl.h>
 #include <string.h>
-#include <fstream>
-#include <map>
+#include <unistd.h>
+#include <algorithm>
+#include <mutex>
 #include <string>
 #include <vector>
-#include <algorithm>
 
-std::vector<uint16_t> rvs::gpulist::location_id;
-std::vector<uint16_t> rvs::gpulist::gpu_id;
-std::vector<uint16_t> rvs::gpulist::device_id;
-std::vector<uint16_t> rvs::gpulist::node_id;
+#include "include/rvsloglp.h"
+#include "include/rvstopocache.h"
+
+bool rvs::gpulist::initialized = false;
+std::vector<rvs::kfd_node> rvs::gpulist::topology;
+std::unordered_map<uint16_t, size_t> rvs::gpulist::gpu_index;
+std::unordered_map<uint16_t, size_t> rvs::gpulist::location_index;
+std::vector<int> rvs::gpulist::node_index;
 
 using std::vector;
 using std::string;
-using std::ifstream;
+
+/**
+ * @brief Prefix sysfs/procfs path with sysroot
+ *
+ * Sysroot is taken from RVS_SYSROOT environment variable so that it is seen
+ * by the launcher and all modules alike. Used to run discovery against
+ * synthetic topology on machines without GPUs.
+ *
+ * @param path absolute path on a live system (e.g. KFD_SYS_PATH_NODES)
+ * @return path under sysroot, or path itself if sysroot is not set
+ */
+std::string gpu_sysfs_path(const char* path) {
+  const char* root = getenv(RVS_SYSROOT_ENV);
+  if (root == nullptr || *root == '\0') {
+    return path;
+  }
+  string result(root);
+  while (result.size() > 1 && result.back() == '/') {
+    result.pop_back();
+  }
+  return result + path;
+}
 
 int gpu_num_subdirs(const char* dirpath, const char* prefix) {
   int count = 0;
@@ -64,77 +90,269 @@ int gpu_num_subdirs(const char* dirpath, const char* prefix) {
   return count;
 }
 
+namespace {
+
 /**
- * gets all GPUS location_id
- * @param pgpus_location_id ptr to vector that will store all the GPU location_id
- * @return
+ * @brief Read whole (small) file relative to directory into buffer
+ * @param DirFd directory file descriptor
+ * @param Name file name relative to DirFd
+ * @param pContent file content
+ * @return 0 if successful, -1 otherwise
  */
-void gpu_get_all_location_id(std::vector<uint16_t>* pgpus_location_id) {
-  ifstream f_id, f_prop;
-  char path[KFD_PATH_MAX_LENGTH];
-
-  std::string prop_name;
-  int gpu_id;
-  uint32_t prop_val;
-
-
-  // Discover the number of nodes: Inside nodes folder there are only folders
-  // that represent the node number
-  int num_nodes = gpu_num_subdirs(KFD_SYS_PATH_NODES, "");
-
-  // get all GPUs device id
-  for (int node_id = 0; node_id < num_nodes; node_id++) {
-    snprintf(path, KFD_PATH_MAX_LENGTH, "%s/%d/gpu_id", KFD_SYS_PATH_NODES,
-           node_id);
-    f_id.open(path);
-    snprintf(path, KFD_PATH_MAX_LENGTH, "%s/%d/properties",
-             KFD_SYS_PATH_NODES, node_id);
-    f_prop.open(path);
-
-    f_id >> gpu_id;
-
-    if (gpu_id != 0) {
-      while (f_prop >> prop_name) {
-        if (prop_name == "location_id") {
-          f_prop >> prop_val;
-          (*pgpus_location_id).push_back(prop_val);
-          break;
-        }
+int read_file(int DirFd, const char* Name, string* pContent) {
+  char buff[4096];
+  ssize_t n;
+
+  pContent->clear();
+  int fd = openat(DirFd, Name, O_RDONLY);
+  if (fd < 0) {
+    return -1;
+  }
+  while ((n = read(fd, buff, sizeof(buff))) > 0) {
+    pContent->append(buff, n);
+  }
+  close(fd);
+  return n < 0 ? -1 : 0;
+}
+
+/**
+ * @brief Parse "name value" lines of KFD properties file
+ * @param Content file content
+ * @param pProps parsed properties in file order
+ */
+void parse_properties(const string& Content,
+                      vector<std::pair<string, uint64_t>>* pProps) {
+  const char* p = Content.c_str();
+  const char* end = p + Content.size();
+
+  while (p < end) {
+    const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+    if (eol == nullptr) {
+      eol = end;
+    }
+    const char* sp = static_cast<const char*>(memchr(p, ' ', eol - p));
+    if (sp != nullptr && sp != p) {
+      char* next;
+      uint64_t val = strtoull(sp + 1, &next, 10);
+      if (next != sp + 1) {
+        pProps->emplace_back(string(p, sp - p), val);
       }
     }
+    p = eol + 1;
+  }
+}
 
-    f_id.close();
-    f_prop.close();
+/**
+ * @brief Parse io_link properties file without keeping the property set
+ * @param Content file content
+ * @param pLink parsed link
+ */
+void parse_iolink(const string& Content, rvs::kfd_iolink* pLink) {
+  const char* p = Content.c_str();
+  const char* end = p + Content.size();
+
+  while (p < end) {
+    const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+    if (eol == nullptr) {
+      eol = end;
+    }
+    const char* sp = static_cast<const char*>(memchr(p, ' ', eol - p));
+    if (sp != nullptr) {
+      size_t len = sp - p;
+      uint64_t val = strtoull(sp + 1, nullptr, 10);
+      if (len == 4 && memcmp(p, "type", 4) == 0) {
+        pLink->type = val;
+      } else if (len == 9 && memcmp(p, "node_from", 9) == 0) {
+        pLink->node_from = val;
+      } else if (len == 7 && memcmp(p, "node_to", 7) == 0) {
+        pLink->node_to = val;
+      } else if (len == 6 && memcmp(p, "weight", 6) == 0) {
+        pLink->weight = val;
+      }
+    }
+    p = eol + 1;
   }
 }
 
 /**
- * gets all GPUS gpu_id
- * @param pgpus_id ptr to vector that will store all the GPU gpu_id
- * @return
+ * @brief List numerically named entries of a directory in ascending order
+ * @param DirFd directory file descriptor (not consumed)
+ * @param pIds resulting entry names
+ * @return 0 if directory could be read, -1 otherwise
  */
-void gpu_get_all_gpu_id(std::vector<uint16_t>* pgpus_id) {
-  ifstream f_id, f_prop;
-  char path[KFD_PATH_MAX_LENGTH];
+int numeric_subdirs(int DirFd, vector<uint32_t>* pIds) {
+  int fd = dup(DirFd);
+  if (fd < 0) {
+    return -1;
+  }
+  DIR* dirp = fdopendir(fd);
+  if (dirp == nullptr) {
+    close(fd);
+    return -1;
+  }
+  struct dirent* dir;
+  while ((dir = readdir(dirp)) != nullptr) {
+    char* next;
+    uint32_t id = strtoul(dir->d_name, &next, 10);
+    if (dir->d_name[0] >= '0' && dir->d_name[0] <= '9' && *next == '\0') {
+      pIds->push_back(id);
+    }
+  }
+  closedir(dirp);
+  std::sort(pIds->begin(), pIds->end());
+  return 0;
+}
 
-  int gpu_id;
+/**
+ * @brief Get topology snapshot, reading it on first use
+ * @return topology nodes in node ID order
+ */
+const vector<rvs::kfd_node>& gpu_snapshot() {
+  static std::mutex mtx;
+  std::lock_guard<std::mutex> lk(mtx);
+  if (!rvs::gpulist::loaded()) {
+    rvs::gpulist::Initialize();
+  }
+  return rvs::gpulist::nodes();
+}
+
+}  // namespace
+
+/**
+ * @brief Get value of a property from node snapshot
+ * @param Name property name
+ * @param pValue property value
+ * @return true if property is present, false otherwise
+ */
+bool rvs::kfd_node::property(const std::string& Name,
+                             uint64_t* pValue) const {
+  for (const auto& prop : properties) {
+    if (prop.first == Name) {
+      *pValue = prop.second;
+      return true;
+    }
+  }
+  return false;
+}
 
-  // Discover the number of nodes: Inside nodes folder there are only folders
-  // that represent the node number
-  int num_nodes = gpu_num_subdirs(KFD_SYS_PATH_NODES, "");
+/**
+ * @brief Load all KFD topology nodes in one pass
+ *
+ * For each node gpu_id, properties and all io_links are read once. NUMA
+ * affinity of a GPU node is taken from its link to a CPU node.
+ *
+ * @param dirpath topology nodes folder (usually KFD_SYS_PATH_NODES under
+ * sysroot)
+ * @param pnodes ptr to vector that will store node snapshots
+ * @return 0 if successful, -1 if topology folder can not be read
+ */
+int gpu_load_topology(const char* dirpath,
+                      std::vector<rvs::kfd_node>* pnodes) {
+  vector<uint32_t> ids;
+  vector<uint32_t> links;
+  string content;
+  char name[32];
+
+  pnodes->clear();
+  int nodes_fd = open(dirpath, O_RDONLY | O_DIRECTORY);
+  if (nodes_fd < 0) {
+    return -1;
+  }
+  numeric_subdirs(nodes_fd, &ids);
+  pnodes->reserve(ids.size());
+
+  for (uint32_t id : ids) {
+    rvs::kfd_node node;
+    node.node_id = id;
+    node.gpu_id = 0;
+    node.location_id = 0;
+    node.device_id = 0;
+    node.vendor_id = 0;
+    node.numa_node = -1;
+
+    snprintf(name, sizeof(name), "%u", id);
+    int node_fd = openat(nodes_fd, name, O_RDONLY | O_DIRECTORY);
+    if (node_fd < 0) {
+      continue;
+    }
+    if (read_file(node_fd, "gpu_id", &content) == 0) {
+      node.gpu_id = strtoul(content.c_str(), nullptr, 10);
+    }
+    if (read_file(node_fd, "properties", &content) == 0) {
+      parse_properties(content, &node.properties);
+    }
+    for (const auto& prop : node.properties) {
+      if (prop.first == "location_id") {
+        node.location_id = prop.second;
+      } else if (prop.first == "device_id") {
+        node.device_id = prop.second;
+      } else if (prop.first == "vendor_id") {
+        node.vendor_id = prop.second;
+      }
+    }
 
-  // get all GPUs device id
-  for (int node_id = 0; node_id < num_nodes; node_id++) {
-    snprintf(path, KFD_PATH_MAX_LENGTH, "%s/%d/gpu_id", KFD_SYS_PATH_NODES,
-             node_id);
-    f_id.open(path);
+    int links_fd = openat(node_fd, "io_links", O_RDONLY | O_DIRECTORY);
+    if (links_fd >= 0) {
+      links.clear();
+      numeric_subdirs(links_fd, &links);
+      for (uint32_t link : links) {
+        snprintf(name, sizeof(name), "%u/properties", link);
+        if (read_file(links_fd, name, &content)) {
+          continue;
+        }
+        rvs::kfd_iolink iolink = {0, node.node_id, 0, 0};
+        parse_iolink(content, &iolink);
+        node.io_links.push_back(iolink);
+      }
+      close(links_fd);
+    }
+    close(node_fd);
+    pnodes->push_back(std::move(node));
+  }
+  close(nodes_fd);
 
-    f_id >> gpu_id;
+  // resolve NUMA affinity now that all nodes are known
+  std::unordered_map<uint16_t, bool> cpu;
+  for (const auto& node : *pnodes) {
+    cpu[node.node_id] = node.gpu_id == 0;
+  }
+  for (auto& node : *pnodes) {
+    if (node.gpu_id == 0) {
+      node.numa_node = node.node_id;
+      continue;
+    }
+    for (const auto& link : node.io_links) {
+      auto it = cpu.find(link.node_to);
+      if (it != cpu.end() && it->second) {
+        node.numa_node = link.node_to;
+        break;
+      }
+    }
+  }
+  return 0;
+}
 
-    if (gpu_id != 0)
-      (*pgpus_id).push_back(gpu_id);
+/**
+ * gets all GPUS location_id
+ * @param pgpus_location_id ptr to vector that will store all the GPU location_id
+ * @return
+ */
+void gpu_get_all_location_id(std::vector<uint16_t>* pgpus_location_id) {
+  for (const auto& node : gpu_snapshot()) {
+    if (node.gpu_id != 0)
+      pgpus_location_id->push_back(node.location_id);
+  }
+}
 
-    f_id.close();
+/**
+ * gets all GPUS gpu_id
+ * @param pgpus_id ptr to vector that will store all the GPU gpu_id
+ * @return
+ */
+void gpu_get_all_gpu_id(std::vector<uint16_t>* pgpus_id) {
+  for (const auto& node : gpu_snapshot()) {
+    if (node.gpu_id != 0)
+      pgpus_id->push_back(node.gpu_id);
   }
 }
 
@@ -144,40 +362,9 @@ void gpu_get_all_gpu_id(std::vector<uint16_t>* pgpus_id) {
  * @return
  */
 void gpu_get_all_device_id(std::vector<uint16_t>* pgpus_device_id) {
-  ifstream f_id, f_prop;
-  char path[KFD_PATH_MAX_LENGTH];
-
-  std::string prop_name;
-  int gpu_id;
-  uint32_t prop_val;
-
-  // Discover the number of nodes: Inside nodes folder there are only folders
-  // that represent the node number
-  int num_nodes = gpu_num_subdirs(KFD_SYS_PATH_NODES, "");
-
-  // get all GPUs device id
-  for (int node_id = 0; node_id < num_nodes; node_id++) {
-    snprintf(path, KFD_PATH_MAX_LENGTH, "%s/%d/gpu_id", KFD_SYS_PATH_NODES,
-             node_id);
-    f_id.open(path);
-    snprintf(path, KFD_PATH_MAX_LENGTH, "%s/%d/properties",
-             KFD_SYS_PATH_NODES, node_id);
-    f_prop.open(path);
-
-    f_id >> gpu_id;
-
-    if (gpu_id != 0) {
-      while (f_prop >> prop_name) {
-        if (prop_name == "device_id") {
-          f_prop >> prop_val;
-          (*pgpus_device_id).push_back(prop_val);
-          break;
-        }
-      }
-    }
-
-    f_id.close();
-    f_prop.close();
+  for (const auto& node : gpu_snapshot()) {
+    if (node.gpu_id != 0)
+      pgpus_device_id->push_back(node.device_id);
   }
 }
 
@@ -187,39 +374,107 @@ void gpu_get_all_device_id(std::vector<uint16_t>* pgpus_device_id) {
  * @return
  */
 void gpu_get_all_node_id(std::vector<uint16_t>* pgpus_node_id) {
-  ifstream f_id;
-  char path[KFD_PATH_MAX_LENGTH];
-  int gpu_id;
-
+  for (const auto& node : gpu_snapshot()) {
+    if (node.gpu_id != 0)
+      pgpus_node_id->push_back(node.node_id);
+  }
+}
 
-  // Discover the number of nodes: Inside nodes folder there are only folders
-  // that represent the node number
-  int num_nodes = gpu_num_subdirs(KFD_SYS_PATH_NODES, "");
+/**
+ * @brief Initialize gpulist helper class
+ * @return 0 if successful, -1 otherwise
+ **/
+int rvs::gpulist::Initialize() {
+  return Initialize(gpu_sysfs_path(KFD_SYS_PATH_NODES).c_str());
+}
 
-  // get all GPUs device id
-  for (int node_id = 0; node_id < num_nodes; node_id++) {
-    snprintf(path, KFD_PATH_MAX_LENGTH, "%s/%d/gpu_id", KFD_SYS_PATH_NODES,
-           node_id);
-    f_id.open(path);
-    f_id >> gpu_id;
+/**
+ * @brief Initialize gpulist helper class from given topology folder
+ *
+ * Snapshot is taken from topology cache if cache fingerprint matches the
+ * topology. Otherwise (or if Refresh is set) topology is read and cache
+ * rewritten. Failure to write cache (e.g. no permission) is not an error.
+ *
+ * @param Path topology nodes folder
+ * @param Refresh ignore cached snapshot and rebuild it
+ * @return 0 if successful, -1 otherwise
+ **/
+int rvs::gpulist::Initialize(const char* Path, bool Refresh) {
+  int prof = rvs::lp::PhaseBegin("gpulist init");
+  int sts = 0;
+  uint64_t print = 0;
+  string cache = topocache::file();
+  bool nocache = cache.empty() || topocache::fingerprint(Path, &print);
+
+  if (nocache || Refresh || topocache::load(cache, print, &topology)) {
+    sts = gpu_load_topology(Path, &topology);
+    if (sts == 0 && !nocache) {
+      topocache::save(cache, print, topology);
+    }
+  }
+  build_index();
+  initialized = true;
+  rvs::lp::PhaseEnd(prof);
+  return sts;
+}
 
-    if (gpu_id != 0) {
-      (*pgpus_node_id).push_back(node_id);
+/**
+ * @brief Build lookup indexes over GPU nodes of topology snapshot
+ **/
+void rvs::gpulist::build_index() {
+  gpu_index.clear();
+  location_index.clear();
+  node_index.clear();
+
+  for (size_t i = 0; i < topology.size(); i++) {
+    const kfd_node& node = topology[i];
+    if (node.gpu_id == 0) {
+      continue;
+    }
+    gpu_index.emplace(node.gpu_id, i);
+    location_index.emplace(node.location_id, i);
+    if (node.node_id >= node_index.size()) {
+      node_index.resize(node.node_id + 1, -1);
+    }
+    if (node_index[node.node_id] < 0) {
+      node_index[node.node_id] = i;
     }
-    f_id.close();
   }
 }
 
 /**
- * @brief Initialize gpulist helper class
- * @return 0 if successful, -1 otherwise
+ * @brief Check if topology snapshot has been read
+ * @return true if Initialize() has been called
  **/
-int rvs::gpulist::Initialize() {
-  gpu_get_all_location_id(&location_id);
-  gpu_get_all_gpu_id(&gpu_id);
-  gpu_get_all_device_id(&device_id);
-  gpu_get_all_node_id(&node_id);
-  return 0;
+bool rvs::gpulist::loaded() {
+  return initialized;
+}
+
+/**
+ * @brief Get snapshot of all topology nodes
+ * @return topology nodes in node ID order
+ **/
+const std::vector<rvs::kfd_node>& rvs::gpulist::nodes() {
+  return topology;
+}
+
+/**
+ * @brief Given GPU ID return its topology node
+ * @param GpuID Gpu ID
+ * @return node snapshot if found, nullptr otherwise
+ **/
+const rvs::kfd_node* rvs::gpulist::gpu2info(const uint16_t GpuID) {
+  return find_gpu(GpuID);
+}
+
+const rvs::kfd_node* rvs::gpulist::find_gpu(const uint16_t GpuID) {
+  auto it = gpu_index.find(GpuID);
+  return it == gpu_index.end() ? nullptr : &topology[it->second];
+}
+
+const rvs::kfd_node* rvs::gpulist::find_location(const uint16_t LocationID) {
+  auto it = location_index.find(LocationID);
+  return it == location_index.end() ? nullptr : &topology[it->second];
 }
 
 
@@ -231,13 +486,11 @@ int rvs::gpulist::Initialize() {
  **/
 int rvs::gpulist::gpu2location(const uint16_t GpuID,
                                uint16_t* pLocationID) {
-  const auto it = std::find(gpu_id.cbegin(),
-                            gpu_id.cend(), GpuID);
-  if (it == gpu_id.cend()) {
+  const kfd_node* node = find_gpu(GpuID);
+  if (node == nullptr) {
     return -1;
   }
-  size_t pos = std::distance(gpu_id.cbegin(), it);
-  *pLocationID = location_id[pos];
+  *pLocationID = node->location_id;
   return 0;
 }
 
@@ -249,13 +502,11 @@ int rvs::gpulist::gpu2location(const uint16_t GpuID,
  * @return 0 if found, -1 otherwise
  **/
 int rvs::gpulist::location2gpu(const uint16_t LocationID, uint16_t* pGpuID) {
-  const auto it = std::find(location_id.cbegin(),
-                            location_id.cend(), LocationID);
-  if (it == location_id.cend()) {
+  const kfd_node* node = find_location(LocationID);
+  if (node == nullptr) {
     return -1;
   }
-  size_t pos = std::distance(location_id.cbegin(), it);
-  *pGpuID = gpu_id[pos];
+  *pGpuID = node->gpu_id;
   return 0;
 }
 
@@ -267,13 +518,10 @@ int rvs::gpulist::location2gpu(const uint16_t LocationID, uint16_t* pGpuID) {
  * @return 0 if found, -1 otherwise
  **/
 int rvs::gpulist::node2gpu(const uint16_t NodeID, uint16_t* pGpuID) {
-  const auto it = std::find(node_id.cbegin(),
-                            node_id.cend(), NodeID);
-  if (it == node_id.cend()) {
+  if (NodeID >= node_index.size() || node_index[NodeID] < 0) {
     return -1;
   }
-  size_t pos = std::distance(node_id.cbegin(), it);
-  *pGpuID = gpu_id[pos];
+  *pGpuID = topology[node_index[NodeID]].gpu_id;
   return 0;
 }
 
@@ -286,13 +534,11 @@ int rvs::gpulist::node2gpu(const uint16_t NodeID, uint16_t* pGpuID) {
  **/
 int rvs::gpulist::location2device(const uint16_t LocationID,
                                   uint16_t* pDeviceID) {
-  const auto it = std::find(location_id.cbegin(),
-                            location_id.cend(), LocationID);
-  if (it == location_id.cend()) {
+  const kfd_node* node = find_location(LocationID);
+  if (node == nullptr) {
     return -1;
   }
-  size_t pos = std::distance(location_id.cbegin(), it);
-  *pDeviceID = device_id[pos];
+  *pDeviceID = node->device_id;
   return 0;
 }
 
@@ -304,14 +550,11 @@ int rvs::gpulist::location2device(const uint16_t LocationID,
  * @return 0 if found, -1 otherwise
  **/
 int rvs::gpulist::gpu2device(const uint16_t GpuID, uint16_t* pDeviceID) {
-  const auto it = std::find(gpu_id.cbegin(),
-                            gpu_id.cend(), GpuID);
-  if (it == gpu_id.cend()) {
+  const kfd_node* node = find_gpu(GpuID);
+  if (node == nullptr) {
     return -1;
   }
-
-  size_t pos = std::distance(gpu_id.cbegin(), it);
-  *pDeviceID = device_id[pos];
+  *pDeviceID = node->device_id;
   return 0;
 }
 
@@ -323,14 +566,11 @@ int rvs::gpulist::gpu2device(const uint16_t GpuID, uint16_t* pDeviceID) {
  * @return 0 if found, -1 otherwise
  **/
 int rvs::gpulist::gpu2node(const uint16_t GpuID, uint16_t* pNodeID) {
-  const auto it = std::find(gpu_id.cbegin(),
-                            gpu_id.cend(), GpuID);
-  if (it == gpu_id.cend()) {
+  const kfd_node* node = find_gpu(GpuID);
+  if (node == nullptr) {
     return -1;
   }
-
-  size_t pos = std::distance(gpu_id.cbegin(), it);
-  *pNodeID = node_id[pos];
+  *pNodeID = node->node_id;
   return 0;
 }
 
@@ -343,14 +583,27 @@ int rvs::gpulist::gpu2node(const uint16_t GpuID, uint16_t* pNodeID) {
  **/
 int rvs::gpulist::location2node(const uint16_t LocationID,
                                     uint16_t* pNodeID) {
-  const auto it = std::find(location_id.cbegin(),
-                            location_id.cend(), LocationID);
-  if (it == location_id.cend()) {
+  const kfd_node* node = find_location(LocationID);
+  if (node == nullptr) {
     return -1;
   }
+  *pNodeID = node->node_id;
+  return 0;
+}
+
 
-  size_t pos = std::distance(location_id.cbegin(), it);
-  *pNodeID = node_id[pos];
+/**
+ * @brief Given Gpu ID return NUMA node closest to the GPU
+ * @param GpuID Gpu ID of a GPU
+ * @param pNumaNode NUMA (CPU) node ID, -1 if not known
+ * @return 0 if found, -1 otherwise
+ **/
+int rvs::gpulist::gpu2numa(const uint16_t GpuID, int* pNumaNode) {
+  const kfd_node* node = find_gpu(GpuID);
+  if (node == nullptr) {
+    return -1;
+  }
+  *pNumaNode = node->numa_node;
   return 0;
 }
 
@@ -0,0 +1,649 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/pci_cfg.h"
+
+extern "C" {
+#include <fcntl.h>
+#include <linux/pci.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+}
+
+#include <string>
+
+#include "include/pci_caps.h"
+
+#define MEM_BAR_MAX_INDEX 5
+
+#ifdef RVS_UNIT_TEST
+  #include "include/rvs_unit_testing_defs.h"
+  #define pci_read_long rvs_pci_read_long
+  #define pci_read_word rvs_pci_read_word
+  #define pci_write_byte rvs_pci_write_byte
+  using rvs::rvs_pci_read_long;
+  using rvs::rvs_pci_read_word;
+  using rvs::rvs_pci_write_byte;
+#endif
+
+/**
+ * @brief Constructor
+ *
+ * Creates live view of a device: registers are read through libpci when
+ * decoded. Use load() to take a snapshot instead.
+ *
+ * @param pDev device (pci_fill_info() with PCI_FILL_CAPS and
+ * PCI_FILL_EXT_CAPS already called)
+ */
+rvs::pcicfg::pcicfg(struct pci_dev* pDev) : dev(pDev) {
+}
+
+/**
+ * @brief Take snapshot of device configuration space
+ *
+ * Standard configuration space is read in one block, extended space (for
+ * PCI Express devices) in another, then capability lists are parsed.
+ * Registers with side effects on read are not expected in configuration
+ * space, power budgeting data is still accessed through the device as it
+ * needs a write to select an entry.
+ *
+ * @param pDev device
+ * @return 0 if successful, -1 otherwise (view falls back to live view)
+ */
+int rvs::pcicfg::load(struct pci_dev* pDev) {
+  dev = pDev;
+  data.resize(PCI_CFG_SPACE_SIZE);
+  if (!pci_read_block(dev, 0, data.data(), PCI_CFG_SPACE_SIZE)) {
+    data.clear();
+    return -1;
+  }
+  parse();
+
+  // only PCI Express devices have extended configuration space
+  if (cap_std[PCI_CAP_ID_EXP] != 0) {
+    data.resize(PCI_CFG_SPACE_EXP_SIZE);
+    if (!pci_read_block(dev, PCI_CFG_SPACE_SIZE, &data[PCI_CFG_SPACE_SIZE],
+                        PCI_CFG_SPACE_EXP_SIZE - PCI_CFG_SPACE_SIZE)) {
+      data.resize(PCI_CFG_SPACE_SIZE);
+    }
+    parse();
+  }
+  return 0;
+}
+
+/**
+ * @brief Load snapshot from captured configuration space
+ *
+ * Data shorter than standard configuration header is rejected, data
+ * longer than 4 KiB is truncated.
+ *
+ * @param pData configuration space starting at offset 0
+ * @param Size size of data
+ * @return 0 if successful, -1 otherwise
+ */
+int rvs::pcicfg::load(const void* pData, const size_t Size) {
+  dev = nullptr;
+  data.clear();
+  if (Size < PCI_STD_HEADER_SIZEOF) {
+    return -1;
+  }
+  const uint8_t* p = static_cast<const uint8_t*>(pData);
+  data.assign(p, p + (Size < PCI_CFG_SPACE_EXP_SIZE ?
+                      Size : PCI_CFG_SPACE_EXP_SIZE));
+  parse();
+  return 0;
+}
+
+/**
+ * @brief Load snapshot from captured configuration space file
+ *
+ * @param File file name (e.g. copy of /sys/bus/pci/devices/<BDF>/config)
+ * @return 0 if successful, -1 otherwise
+ */
+int rvs::pcicfg::load(const std::string& File) {
+  uint8_t buff[PCI_CFG_SPACE_EXP_SIZE];
+  int fd = open(File.c_str(), O_RDONLY);
+  if (fd < 0) {
+    dev = nullptr;
+    data.clear();
+    return -1;
+  }
+  ssize_t len = pread(fd, buff, sizeof(buff), 0);
+  close(fd);
+  return load(buff, len > 0 ? len : 0);
+}
+
+/**
+ * @brief Check for snapshot
+ * @return true if registers are decoded from snapshot, false for live view
+ */
+bool rvs::pcicfg::snapshot() const {
+  return !data.empty();
+}
+
+/**
+ * @brief Get snapshot size
+ * @return number of bytes in snapshot (0 for live view)
+ */
+size_t rvs::pcicfg::size() const {
+  return data.size();
+}
+
+/**
+ * @brief Build capability offset tables from snapshot
+ *
+ * Both lists are bounded so that corrupted or looping lists terminate.
+ * First capability of given ID is kept.
+ */
+void rvs::pcicfg::parse() {
+  memset(cap_std, 0, sizeof(cap_std));
+  memset(cap_ext, 0, sizeof(cap_ext));
+
+  if (read_word(PCI_STATUS) & PCI_STATUS_CAP_LIST) {
+    int where = (read_byte(PCI_HEADER_TYPE) & 0x7F) ==
+                PCI_HEADER_TYPE_CARDBUS ?
+                PCI_CB_CAPABILITY_LIST : PCI_CAPABILITY_LIST;
+    unsigned int pos = read_byte(where) & ~3u;
+    for (int ttl = 48; ttl > 0 && pos >= PCI_STD_HEADER_SIZEOF &&
+         pos + 1 < data.size(); ttl--) {
+      uint8_t id = data[pos];
+      if (id != 0xFF && cap_std[id] == 0) {
+        cap_std[id] = pos;
+      }
+      pos = data[pos + 1] & ~3u;
+    }
+  }
+
+  unsigned int pos = PCI_CFG_SPACE_SIZE;
+  for (int ttl = (PCI_CFG_SPACE_EXP_SIZE - PCI_CFG_SPACE_SIZE) / 8;
+       ttl > 0 && pos + 3 < data.size(); ttl--) {
+    uint32_t header = read_long(pos);
+    if (header == 0 || header == 0xFFFFFFFF) {
+      break;
+    }
+    uint16_t id = PCI_EXT_CAP_ID(header);
+    if (id < PCI_CFG_EXT_CAP_IDS && cap_ext[id] == 0) {
+      cap_ext[id] = pos;
+    }
+    pos = PCI_EXT_CAP_NEXT(header);
+    if (pos < PCI_CFG_SPACE_SIZE) {
+      break;
+    }
+  }
+}
+
+/**
+ * @brief Get offset of a capability
+ * @param Cap capability ID (e.g. PCI_CAP_ID_EXP)
+ * @param Type capability type (PCI_CAP_NORMAL or PCI_CAP_EXTENDED)
+ * @return capability offset, 0 if not present
+ */
+unsigned int rvs::pcicfg::cap_offset(const unsigned char Cap,
+                                     const unsigned char Type) const {
+  if (!snapshot()) {
+    return pci_dev_find_cap_offset(dev, Cap, Type);
+  }
+  if (Type == PCI_CAP_NORMAL) {
+    return cap_std[Cap];
+  }
+  if (Type == PCI_CAP_EXTENDED && Cap < PCI_CFG_EXT_CAP_IDS) {
+    return cap_ext[Cap];
+  }
+  return 0;
+}
+
+/**
+ * @brief Read configuration register byte
+ * @param Pos register offset
+ * @return register value (all ones if outside of snapshot)
+ */
+uint8_t rvs::pcicfg::read_byte(const int Pos) const {
+  if (!snapshot()) {
+    return pci_read_byte(dev, Pos);
+  }
+  if (Pos < 0 || static_cast<size_t>(Pos) >= data.size()) {
+    return 0xFF;
+  }
+  return data[Pos];
+}
+
+/**
+ * @brief Read configuration register word
+ * @param Pos register offset
+ * @return register value (all ones if outside of snapshot)
+ */
+uint16_t rvs::pcicfg::read_word(const int Pos) const {
+  if (!snapshot()) {
+    return pci_read_word(dev, Pos);
+  }
+  if (Pos < 0 || static_cast<size_t>(Pos) + 2 > data.size()) {
+    return 0xFFFF;
+  }
+  return data[Pos] | (data[Pos + 1] << 8);
+}
+
+/**
+ * @brief Read configuration register dword
+ * @param Pos register offset
+ * @return register value (all ones if outside of snapshot)
+ */
+uint32_t rvs::pcicfg::read_long(const int Pos) const {
+  if (!snapshot()) {
+    return pci_read_long(dev, Pos);
+  }
+  if (Pos < 0 || static_cast<size_t>(Pos) + 4 > data.size()) {
+    return 0xFFFFFFFF;
+  }
+  return data[Pos] | (data[Pos + 1] << 8) | (data[Pos + 2] << 16) |
+         (static_cast<uint32_t>(data[Pos + 3]) << 24);
+}
+
+/**
+ * @brief Decode max link speed
+ * @param pBuff pre-allocated char buffer
+ */
+void rvs::pcicfg::link_cap_max_speed(char* pBuff) const {
+  const char* link_max_speed;
+  unsigned int offset = cap_offset(PCI_CAP_ID_EXP, PCI_CAP_NORMAL);
+
+  if (offset == 0) {
+    snprintf(pBuff, PCI_CAP_DATA_MAX_BUF_SIZE, "%s", PCI_CAP_NOT_SUPPORTED);
+    return;
+  }
+
+  // using 1,2,3 & 4 instead of the dedicated constants
+  // (that can be found in pci_regs.h) because in some linux versions
+  // the #define stops at PCI_EXP_LNKCAP_SLS_5_0GB (no 8, 16)
+  switch (read_long(offset + PCI_EXP_LNKCAP) & PCI_EXP_LNKCAP_SLS) {
+  case 1:
+    link_max_speed = "2.5 GT/s";
+    break;
+  case 2:
+    link_max_speed = "5 GT/s";
+    break;
+  case 3:
+    link_max_speed = "8 GT/s";
+    break;
+  case 4:
+    link_max_speed = "16 GT/s";
+    break;
+  default:
+    link_max_speed = "Unknown speed";
+  }
+  snprintf(pBuff, PCI_CAP_DATA_MAX_BUF_SIZE, "%s", link_max_speed);
+}
+
+/**
+ * @brief Decode max link width
+ * @param pBuff pre-allocated char buffer
+ */
+void rvs::pcicfg::link_cap_max_width(char* pBuff) const {
+  unsigned int offset = cap_offset(PCI_CAP_ID_EXP, PCI_CAP_NORMAL);
+
+  if (offset == 0) {
+    snprintf(pBuff, PCI_CAP_DATA_MAX_BUF_SIZE, "%s", PCI_CAP_NOT_SUPPORTED);
+    return;
+  }
+
+  uint32_t lnk_cap = read_long(offset + PCI_EXP_LNKCAP);
+  snprintf(pBuff, PCI_CAP_DATA_MAX_BUF_SIZE, "x%d",
+           ((lnk_cap & PCI_EXP_LNKCAP_MLW) >> 4));
+}
+
+/**
+ * @brief Decode current link speed
+ * @param pBuff pre-allocated char buffer
+ */
+void rvs::pcicfg::link_stat_cur_speed(char* pBuff) const {
+  const char* link_cur_speed;
+  unsigned int offset = cap_offset(PCI_CAP_ID_EXP, PCI_CAP_NORMAL);
+
+  if (offset == 0) {
+    snprintf(pBuff, PCI_CAP_DATA_MAX_BUF_SIZE, "%s", PCI_CAP_NOT_SUPPORTED);
+    return;
+  }
+
+  switch (read_word(offset + PCI_EXP_LNKSTA) & PCI_EXP_LNKSTA_CLS) {
+  case PCI_EXP_LNKSTA_CLS_2_5GB:
+    link_cur_speed = "2.5 GT/s";
+    break;
+  case PCI_EXP_LNKSTA_CLS_5_0GB:
+    link_cur_speed = "5 GT/s";
+    break;
+  case PCI_EXP_LNKSTA_CLS_8_0GB:
+    link_cur_speed = "8 GT/s";
+    break;
+#ifdef PCI_EXP_LNKSTA_CLS_16_0GB
+  case PCI_EXP_LNKSTA_CLS_16_0GB:
+    link_cur_speed = "16 GT/s";
+    break;
+#endif
+  default:
+    link_cur_speed = "Unknown speed";
+  }
+  snprintf(pBuff, PCI_CAP_DATA_MAX_BUF_SIZE, "%s", link_cur_speed);
+}
+
+/**
+ * @brief Decode negotiated link width
+ * @param pBuff pre-allocated char buffer
+ */
+void rvs::pcicfg::link_stat_neg_width(char* pBuff) const {
+  unsigned int offset = cap_offset(PCI_CAP_ID_EXP, PCI_CAP_NORMAL);
+
+  if (offset == 0) {
+    snprintf(pBuff, PCI_CAP_DATA_MAX_BUF_SIZE, "%s", PCI_CAP_NOT_SUPPORTED);
+    return;
+  }
+
+  uint16_t lnk_stat = read_word(offset + PCI_EXP_LNKSTA);
+  snprintf(pBuff, PCI_CAP_DATA_MAX_BUF_SIZE, "x%d",
+           ((lnk_stat & PCI_EXP_LNKSTA_NLW) >> PCI_EXP_LNKSTA_NLW_SHIFT));
+}
+
+/**
+ * @brief Decode slot power limit
+ * @param pBuff pre-allocated char buffer
+ */
+void rvs::pcicfg::slot_pwr_limit_value(char* pBuff) const {
+  unsigned int offset = cap_offset(PCI_CAP_ID_EXP, PCI_CAP_NORMAL);
+  float pwr;
+
+  if (offset == 0) {
+    snprintf(pBuff, PCI_CAP_DATA_MAX_BUF_SIZE, "%s", PCI_CAP_NOT_SUPPORTED);
+    return;
+  }
+
+  uint32_t slot_cap = read_long(offset + PCI_EXP_SLTCAP);
+  unsigned char scale = (slot_cap & PCI_EXP_SLTCAP_SPLS) >> 15;
+  uint16_t value = (slot_cap & PCI_EXP_SLTCAP_SPLV) >> 7;
+
+  // according to the PCI Express Base Specification Revision 3.0
+  if (value > 0xEF) {
+    switch (value) {
+    case 0xF0:
+      pwr = 250.0;
+      break;
+    case 0xF1:
+      pwr = 270.0;
+      break;
+    case 0xF2:
+      pwr = 300.0;
+      break;
+    default:
+      // F3h to FFh = Reserved for Slot Power Limit values above 300W
+      pwr = -1.0;
+    }
+  } else {
+    pwr = static_cast<float>(value) * pow(10, -scale);
+  }
+  snprintf(pBuff, PCI_CAP_DATA_MAX_BUF_SIZE, "%0.3fW", pwr);
+}
+
+/**
+ * @brief Decode physical slot number
+ * @param pBuff pre-allocated char buffer
+ */
+void rvs::pcicfg::slot_physical_num(char* pBuff) const {
+  unsigned int offset = cap_offset(PCI_CAP_ID_EXP, PCI_CAP_NORMAL);
+
+  if (offset == 0) {
+    snprintf(pBuff, PCI_CAP_DATA_MAX_BUF_SIZE, "%s", PCI_CAP_NOT_SUPPORTED);
+    return;
+  }
+
+  uint32_t slot_cap = read_long(offset + PCI_EXP_SLTCAP);
+  snprintf(pBuff, PCI_CAP_DATA_MAX_BUF_SIZE, "#%u",
+           ((slot_cap & PCI_EXP_SLTCAP_PSN) >> 19));
+}
+
+/**
+ * @brief Get bus number
+ *
+ * Bus number is not part of configuration space so it is not known for
+ * snapshot loaded from blob.
+ *
+ * @param pBuff pre-allocated char buffer
+ */
+void rvs::pcicfg::pci_bus_id(char* pBuff) const {
+  if (dev == nullptr) {
+    snprintf(pBuff, PCI_CAP_DATA_MAX_BUF_SIZE, "%s", PCI_CAP_NOT_SUPPORTED);
+    return;
+  }
+  snprintf(pBuff, PCI_CAP_DATA_MAX_BUF_SIZE, "%0X", dev->bus);
+}
+
+/**
+ * @brief Get device ID
+ * @param pBuff pre-allocated char buffer
+ */
+void rvs::pcicfg::device_id(char* pBuff) const {
+  snprintf(pBuff, PCI_CAP_DATA_MAX_BUF_SIZE, "%u",
+           dev ? dev->device_id : read_word(PCI_DEVICE_ID));
+}
+
+/**
+ * @brief Get vendor ID
+ * @param pBuff pre-allocated char buffer
+ */
+void rvs::pcicfg::vendor_id(char* pBuff) const {
+  snprintf(pBuff, PCI_CAP_DATA_MAX_BUF_SIZE, "%u",
+           dev ? dev->vendor_id : read_word(PCI_VENDOR_ID));
+}
+
+/**
+ * @brief Get kernel driver name (not part of configuration space)
+ * @param pBuff pre-allocated char buffer
+ */
+void rvs::pcicfg::kernel_driver(char* pBuff) const {
+  if (dev == nullptr) {
+    snprintf(pBuff, PCI_CAP_DATA_MAX_BUF_SIZE, "%s", PCI_CAP_NOT_SUPPORTED);
+    return;
+  }
+  get_kernel_driver(dev, pBuff);
+}
+
+/**
+ * @brief Decode device serial number
+ * @param pBuff pre-allocated char buffer
+ */
+void rvs::pcicfg::dev_serial_num(char* pBuff) const {
+  unsigned int offset = cap_offset(PCI_EXT_CAP_ID_DSN, PCI_CAP_EXTENDED);
+
+  if (offset == 0) {
+    snprintf(pBuff, PCI_CAP_DATA_MAX_BUF_SIZE, "%s", PCI_CAP_NOT_SUPPORTED);
+    return;
+  }
+
+  uint32_t t1 = read_long(offset + 4);
+  uint32_t t2 = read_long(offset + 8);
+  snprintf(pBuff, PCI_CAP_DATA_MAX_BUF_SIZE,
+           "%02x-%02x-%02x-%02x-%02x-%02x-%02x-%02x", t2 >> 24,
+           (t2 >> 16) & 0xff, (t2 >> 8) & 0xff, t2 & 0xff, t1 >> 24,
+           (t1 >> 16) & 0xff, (t1 >> 8) & 0xff, t1 & 0xff);
+}
+
+/**
+ * @brief Decode power budgeting for given operating condition
+ *
+ * Entries are selected by writing Data Select register so they are always
+ * read from the device, also for a snapshot. Not supported for snapshot
+ * loaded from blob.
+ *
+ * @param PmState the PM State for the given operating condition
+ * @param Type the type of the given operating condition
+ * @param PowerRail thermal load or power rail for the given operating
+ * condition
+ * @param pBuff pre-allocated char buffer
+ */
+void rvs::pcicfg::pwr_budgeting(const uint8_t PmState, const uint8_t Type,
+                                const uint8_t PowerRail, char* pBuff) const {
+  unsigned int offset = cap_offset(PCI_EXT_CAP_ID_PWR, PCI_CAP_EXTENDED);
+
+  snprintf(pBuff, PCI_CAP_DATA_MAX_BUF_SIZE, "%s", PCI_CAP_NOT_SUPPORTED);
+
+  if (offset == 0 || dev == nullptr) {
+    return;
+  }
+
+  // Data Select register is 8 bit wide
+  for (int i = 0; i < 256; i++) {
+    pci_write_byte(dev, offset + PCI_PWR_DSR, i);
+    uint16_t w = pci_read_word(dev, offset + PCI_PWR_DATA);
+
+    if (!w) {
+      return;
+    }
+
+    if (PCI_PWR_DATA_PM_STATE(w) == PmState && PCI_PWR_DATA_TYPE(w) == Type &&
+        PCI_PWR_DATA_RAIL(w) == PowerRail) {
+      snprintf(pBuff, PCI_CAP_DATA_MAX_BUF_SIZE, "%.3fW",
+               PCI_PWR_DATA_BASE(w) * pow(10, -PCI_PWR_DATA_SCALE(w)));
+      return;
+    }
+  }
+}
+
+/**
+ * @brief Decode current power state
+ * @param pBuff pre-allocated char buffer
+ */
+void rvs::pcicfg::pwr_curr_state(char* pBuff) const {
+  static const char* const states[] = {"D0", "D1", "D2", "D3"};
+  unsigned int offset = cap_offset(PCI_CAP_ID_PM, PCI_CAP_NORMAL);
+
+  if (offset == 0) {
+    snprintf(pBuff, PCI_CAP_DATA_MAX_BUF_SIZE, "%s", PCI_CAP_NOT_SUPPORTED);
+    return;
+  }
+
+  uint16_t pmcsr = read_word(offset + PCI_PM_CTRL);
+  snprintf(pBuff, PCI_CAP_DATA_MAX_BUF_SIZE, "%s",
+           states[pmcsr & PCI_PM_CTRL_STATE_MASK]);
+}
+
+/**
+ * @brief Decode atomic operation routing (requester enable)
+ * @param pBuff pre-allocated char buffer
+ */
+void rvs::pcicfg::atomic_op_routing(char* pBuff) const {
+  unsigned int offset = cap_offset(PCI_CAP_ID_EXP, PCI_CAP_NORMAL);
+
+  // Device Control 2 is present from capability version 2
+  if (offset == 0 ||
+      (read_word(offset + PCI_EXP_FLAGS) & PCI_EXP_FLAGS_VERS) < 2) {
+    snprintf(pBuff, PCI_CAP_DATA_MAX_BUF_SIZE, "%s", PCI_CAP_NOT_SUPPORTED);
+    return;
+  }
+
+  // hardcoded 0x0040 because PCI_EXP_DEVCTL2_ATOMIC_REQ
+  // is not present on all versions of pci_regs.h
+  bool enabled = read_word(offset + PCI_EXP_DEVCTL2) & 0x0040;
+  snprintf(pBuff, PCI_CAP_DATA_MAX_BUF_SIZE, "%s", enabled ? "TRUE" : "FALSE");
+}
+
+/**
+ * @brief Check whether device has a memory space BAR
+ * @return true if at least one memory BAR is present
+ */
+bool rvs::pcicfg::has_memory_bar() const {
+  for (int i = 0; i < MEM_BAR_MAX_INDEX + 1; i++) {
+    if (dev) {
+      if (dev->base_addr[i] && dev->size[i] &&
+          !(dev->base_addr[i] & PCI_BASE_ADDRESS_SPACE_IO)) {
+        return true;
+      }
+    } else {
+      uint32_t bar = read_long(PCI_BASE_ADDRESS_0 + 4 * i);
+      if (bar && bar != 0xFFFFFFFF && !(bar & PCI_BASE_ADDRESS_SPACE_IO)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Get Device Capabilities 2 register (atomic completer support)
+ * @return register value, -1 if not available
+ */
+int64_t rvs::pcicfg::atomic_op_register_value() const {
+  unsigned int offset = cap_offset(PCI_CAP_ID_EXP, PCI_CAP_NORMAL);
+
+  // Device Capabilities 2 is present from capability version 2
+  if (offset == 0 ||
+      (read_word(offset + PCI_EXP_FLAGS) & PCI_EXP_FLAGS_VERS) < 2) {
+    return -1;
+  }
+
+  // check if the device has memory space BAR
+  // (basically it should have but let us be sure about it)
+  if (!has_memory_bar()) {
+    return -1;
+  }
+  return read_long(offset + PCI_EXP_DEVCAP2);
+}
+
+/**
+ * @brief Decode atomic completer support bit
+ * @param Mask bit in Device Capabilities 2 register
+ * @param pBuff pre-allocated char buffer
+ */
+void rvs::pcicfg::atomic_op_completer(const uint32_t Mask,
+                                      char* pBuff) const {
+  int64_t value = atomic_op_register_value();
+
+  if (value == -1) {
+    snprintf(pBuff, PCI_CAP_DATA_MAX_BUF_SIZE, "%s", PCI_CAP_NOT_SUPPORTED);
+    return;
+  }
+  snprintf(pBuff, PCI_CAP_DATA_MAX_BUF_SIZE, "%s",
+           (static_cast<uint32_t>(value) & Mask) ? "TRUE" : "FALSE");
+}
+
+/**
+ * @brief Decode atomic 32-bit completer support
+ * @param pBuff pre-allocated char buffer
+ */
+void rvs::pcicfg::atomic_op_32_completer(char* pBuff) const {
+  atomic_op_completer(0x0080, pBuff);
+}
+
+/**
+ * @brief Decode atomic 64-bit completer support
+ * @param pBuff pre-allocated char buffer
+ */
+void rvs::pcicfg::atomic_op_64_completer(char* pBuff) const {
+  atomic_op_completer(0x0100, pBuff);
+}
+
+/**
+ * @brief Decode atomic 128-bit CAS completer support
+ * @param pBuff pre-allocated char buffer
+ */
+void rvs::pcicfg::atomic_op_128_CAS_completer(char* pBuff) const {
+  atomic_op_completer(0x0200, pBuff);
+}
@@ -25,6 +25,10 @@
 #include "include/rsmi_util.h"
 
 #include <cassert>
+#include <mutex>
+#include <vector>
+
+#include "include/rvsdevreg.h"
 
 namespace rvs {
 
@@ -57,4 +61,33 @@ rsmi_status_t  rsmi_dev_ind_get(uint64_t bdfid, uint32_t* pdv_ind) {
 
 }  // namespace rvs
 
+/**
+ * @brief Resolve ROCm SMI device indexes of registered GPUs
+ *
+ * ROCm SMI has to be initialized (rsmi_init()) by the caller. Indexes are
+ * resolved once per process.
+ *
+ * @return 0 if successful, -1 otherwise
+ */
+int rvs::devreg::attach_smi() {
+  if (Initialize()) {
+    return -1;
+  }
+  std::lock_guard<std::mutex> lk(preg->smi_mutex);
+  if (preg->smi_attached) {
+    return 0;
+  }
+  uint32_t num_devices = 0;
+  if (RSMI_STATUS_SUCCESS != rsmi_num_monitor_devices(&num_devices)) {
+    return -1;
+  }
+  std::vector<uint64_t> bdf(num_devices, UINT64_MAX);
+  for (uint32_t ix = 0; ix < num_devices; ix++) {
+    rsmi_dev_pci_id_get(ix, &bdf[ix]);
+  }
+  set_smi(preg, bdf);
+  preg->smi_attached = true;
+  return 0;
+}
+
 
@@ -24,6 +24,7 @@
  *******************************************************************************/
 #include "include/rvs_util.h"
 
+#include <map>
 #include <vector>
 #include <string>
 #include <regex>
@@ -64,6 +65,45 @@ bool is_positive_integer(const std::string& str_val) {
                     [](char c) {return !std::isdigit(c);}) == str_val.end();
 }
 
+/**
+ * @brief Parse unsigned number with optional single character unit suffix
+ *
+ * @param Val string to parse, e.g. "100M" or "2h"
+ * @param Units unit suffixes and corresponding multipliers
+ * @param pResult [out] parsed value multiplied by the unit
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int parse_with_unit(const std::string& Val,
+                    const std::map<char, uint64_t>& Units,
+                    uint64_t* pResult) {
+  size_t pos;
+  uint64_t num;
+
+  if (Val.empty() || Val[0] < '0' || Val[0] > '9') {
+    return -1;
+  }
+
+  try {
+    num = std::stoull(Val, &pos);
+  }
+  catch(...) {
+    return -1;
+  }
+
+  uint64_t mult = 1;
+  if (pos < Val.size()) {
+    auto it = Units.find(Val[pos]);
+    if (pos + 1 != Val.size() || it == Units.end()) {
+      return -1;
+    }
+    mult = it->second;
+  }
+
+  *pResult = num * mult;
+  return 0;
+}
+
 int rvs_util_parse(const std::string& buff, bool* pval) {
   if (buff.empty()) {  // method empty
     return 2;  // not found
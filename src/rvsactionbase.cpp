@@ -25,6 +25,7 @@
 #include "include/rvsactionbase.h"
 
 #include <unistd.h>
+#include <algorithm>
 #include <chrono>
 #include <utility>
 #include <regex>
@@ -50,6 +51,8 @@ rvs::actionbase::actionbase() {
   property_log_level = 2;
   property_device_all = true;
   property_device_id = 0u;
+  result_sink = nullptr;
+  property_table_valid = false;
 }
 
 /**
@@ -69,9 +72,99 @@ rvs::actionbase::~actionbase() {
  * */
 int rvs::actionbase::property_set(const char* pKey, const char* pVal) {
   property.insert(property.cend(), std::pair<string, string>(pKey, pVal));
+  property_table_valid = false;
   return 0;
 }
 
+/**
+ * @brief Sets all action properties in one call (IF2)
+ *
+ * Default implementation stores textual value of each property as if given
+ * through property_set(). Derived classes may override it to consume typed
+ * values directly.
+ *
+ * @param pConfig pre-parsed action configuration
+ * @return 0 - success. non-zero otherwise
+ *
+ * */
+int rvs::actionbase::configure(const T_RVS_CONFIG* pConfig) {
+  if (pConfig == nullptr) {
+    return -1;
+  }
+  for (size_t i = 0; i < pConfig->count; i++) {
+    const T_RVS_PROPERTY& p = pConfig->props[i];
+    int sts = property_set(p.key, p.text ? p.text : "");
+    if (sts) {
+      return sts;
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief Runs action reporting structured results into given sink
+ *
+ * Properties are parsed once here, before run() is called. Also used for
+ * IF1 run with no sink.
+ * @param pSink result receiver, may be nullptr
+ * @return result of run()
+ *
+ * */
+int rvs::actionbase::execute(T_RVS_RESULT_SINK* pSink) {
+  property_table_build();
+  result_sink = pSink;
+  int sts = run();
+  result_sink = nullptr;
+  return sts;
+}
+
+/**
+ * @brief Reports pass/fail status for a device. No-op outside of execute().
+ *
+ * @param gpu_id GPU ID
+ * @param pass true if the device passed the action
+ *
+ * */
+void rvs::actionbase::result_device(const uint16_t gpu_id, const bool pass) {
+  if (result_sink && result_sink->cbDevice) {
+    (*result_sink->cbDevice)(result_sink->ctx, gpu_id, pass ? 1 : 0);
+  }
+}
+
+/**
+ * @brief Reports named metric. No-op outside of execute().
+ *
+ * @param gpu_id GPU ID (0 if not device specific)
+ * @param name metric name
+ * @param value metric value
+ * @param unit unit of measure
+ *
+ * */
+void rvs::actionbase::result_metric(const uint16_t gpu_id,
+                                    const std::string& name,
+                                    const double value,
+                                    const std::string& unit) {
+  if (result_sink && result_sink->cbMetric) {
+    (*result_sink->cbMetric)(result_sink->ctx, gpu_id, name.c_str(), value,
+                             unit.c_str());
+  }
+}
+
+/**
+ * @brief Reports duration of a named part of the action.
+ * No-op outside of execute().
+ *
+ * @param name name of the measured part
+ * @param seconds duration in seconds
+ *
+ * */
+void rvs::actionbase::result_duration(const std::string& name,
+                                      const double seconds) {
+  if (result_sink && result_sink->cbDuration) {
+    (*result_sink->cbDuration)(result_sink->ctx, name.c_str(), seconds);
+  }
+}
+
 /**
  * @brief Pauses current thread for the given time period
  *
@@ -94,9 +187,9 @@ void rvs::actionbase::sleep(const unsigned int ms) {
  *
  * */
 bool rvs::actionbase::has_property(const std::string& key, std::string* pval) {
-  auto it = property.find(key);
-  if (it != property.end()) {
-    *pval = it->second;
+  const typed_property* p = property_lookup(key);
+  if (p) {
+    *pval = p->text;
     return true;
   }
   return false;
@@ -110,8 +203,115 @@ bool rvs::actionbase::has_property(const std::string& key, std::string* pval) {
  *
  * */
 bool rvs::actionbase::has_property(const std::string& key) {
-  string val;
-  return has_property(key, &val);
+  return property_lookup(key) != nullptr;
+}
+
+/**
+ * @brief Parses all properties into property table
+ *
+ * Each value is converted into every supported type so that getters only
+ * look up the key and pick the result.
+ *
+ * */
+void rvs::actionbase::property_table_build() {
+  property_table.clear();
+  property_table.reserve(property.size());
+  for (auto it = property.begin(); it != property.end(); ++it) {
+    typed_property p;
+    const string& val = it->second;
+    p.text = val;
+
+    p.uval = 0;
+    p.uint_sts = rvs_util_parse<uint64_t>(val, &p.uval);
+
+    p.bval = false;
+    p.bool_sts = rvs_util_parse(val, &p.bval);
+
+    p.fval = 0;
+    p.float_sts = 0;
+    try {
+      p.fval = std::stof(val);
+    } catch (...) {
+      p.float_sts = 1;
+    }
+
+    p.all = val == "all";
+    p.list_sts = 0;
+    if (!p.all) {
+      auto strarray = str_split(val, YAML_DEVICE_PROP_DELIMITER);
+      if (rvs_util_strarr_to_uintarr<uint64_t>(strarray, &p.list) < 0) {
+        p.list.clear();
+        p.list_sts = 1;
+      }
+    }
+
+    property_table.insert(std::make_pair(it->first, std::move(p)));
+  }
+  property_table_valid = true;
+}
+
+/**
+ * @brief Finds pre-parsed property, rebuilding property table if needed
+ *
+ * @param key Property key
+ * @return pointer to property, nullptr if property is not set
+ *
+ * */
+const rvs::actionbase::typed_property*
+rvs::actionbase::property_lookup(const std::string& key) {
+  // 'property' may also be changed directly by derived classes
+  if (!property_table_valid || property_table.size() != property.size()) {
+    property_table_build();
+  }
+  auto it = property_table.find(key);
+  return it == property_table.end() ? nullptr : &it->second;
+}
+
+/**
+ * @brief Records property conversion error
+ *
+ * @param key Property key
+ * @param val Property value
+ * @param expected description of expected value
+ *
+ * */
+void rvs::actionbase::property_error(const std::string& key,
+                                     const std::string& val,
+                                     const std::string& expected) {
+  string msg = "property '" + key + "': value '" + val + "' is not a " +
+               expected;
+  if (std::find(property_error_list.begin(), property_error_list.end(), msg)
+      == property_error_list.end()) {
+    property_error_list.push_back(msg);
+  }
+}
+
+/**
+ * @brief Returns conversion errors reported by property getters so far
+ *
+ * */
+const std::vector<std::string>& rvs::actionbase::property_errors() const {
+  return property_error_list;
+}
+
+/**
+ * @brief Gets names of properties in "<parent>.<name>" collection
+ *
+ * @param parent collection name (e.g. "properties")
+ * @param pnames ptr to resulting names, in alphabetical order
+ * @return number of names found
+ *
+ * */
+int rvs::actionbase::property_get_collection(const std::string& parent,
+                                             std::vector<std::string>* pnames) {
+  pnames->clear();
+  const string prefix = parent + ".";
+  for (auto it = property.lower_bound(prefix);
+       it != property.end() && it->first.compare(0, prefix.size(), prefix) == 0;
+       ++it) {
+    pnames->push_back(it->first.substr(prefix.size()));
+  }
+  return pnames->size();
 }
 
 
@@ -134,11 +334,16 @@ int rvs::actionbase::property_get_device() {
  */
 int rvs::actionbase::property_get(const std::string& prop_name,
                                        bool* pVal) {
-  std::string sval;
-  if (!has_property(prop_name, &sval)) {
+  const typed_property* p = property_lookup(prop_name);
+  if (!p) {
     return 2;
   }
-  return rvs_util_parse(sval, pVal);
+  if (p->bool_sts == 0) {
+    *pVal = p->bval;
+  } else if (p->bool_sts == 1) {
+    property_error(prop_name, p->text, "boolean");
+  }
+  return p->bool_sts;
 }
 
 /**
@@ -157,14 +362,14 @@ int rvs::actionbase::property_get(const std::string& prop_name,
  */
 int rvs::actionbase::property_get(const std::string& prop_name,
                                        float* pVal) {
-  std::string sval;
-  if (!has_property(prop_name, &sval)) {
+  const typed_property* p = property_lookup(prop_name);
+  if (!p) {
     return 2;
   }
-  try {
-    *pVal = std::stof(sval);
-  } catch (...) {
-      return 1;  // something went wrong with the regex
+  if (p->float_sts) {
+    property_error(prop_name, p->text, "number");
+    return 1;
   }
+  *pVal = p->fval;
   return 0;
 }
@@ -0,0 +1,193 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvsdevreg.h"
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "include/gpu_util.h"
+
+rvs::devreg::registry* rvs::devreg::preg = nullptr;
+
+/**
+ * @brief Build registry from HIP devices and KFD topology
+ *
+ * HIP device is matched to the first not yet matched KFD GPU node in the
+ * same PCI domain with the same PCI bus and device. Function bits are
+ * ignored as HIP does not report them, so partitions of one device are
+ * matched in order. HIP devices without KFD node are left out.
+ *
+ * @param Hip HIP devices in HIP index order
+ * @return new registry
+ */
+rvs::devreg::registry* rvs::devreg::build(const std::vector<hipdev>& Hip) {
+  if (!gpulist::loaded()) {
+    gpulist::Initialize();
+  }
+
+  registry* reg = new registry;
+  reg->props_size = 0;
+  reg->smi_attached = false;
+
+  const std::vector<kfd_node>& nodes = gpulist::nodes();
+  std::vector<bool> taken(nodes.size(), false);
+
+  for (const hipdev& dev : Hip) {
+    uint16_t location = (dev.bus << 8) | (dev.device << 3);
+    for (size_t i = 0; i < nodes.size(); i++) {
+      const kfd_node& node = nodes[i];
+      uint64_t domain = 0;
+      node.property("domain", &domain);
+      if (taken[i] || node.gpu_id == 0 || domain != dev.domain ||
+          (node.location_id & 0xFFF8) != location) {
+        continue;
+      }
+      taken[i] = true;
+      devinfo info;
+      info.gpu_id = node.gpu_id;
+      info.node_id = node.node_id;
+      info.location_id = node.location_id;
+      info.device_id = node.device_id;
+      info.domain = domain;
+      info.numa_node = node.numa_node;
+      info.hip_index = dev.index;
+      info.smi_index = -1;
+      reg->devices.push_back(info);
+      break;
+    }
+  }
+  return reg;
+}
+
+/**
+ * @brief Resolve ROCm SMI device indexes
+ * @param pReg registry
+ * @param Bdf BDF IDs reported by ROCm SMI, indexed by ROCm SMI device index
+ */
+void rvs::devreg::set_smi(registry* pReg, const std::vector<uint64_t>& Bdf) {
+  for (devinfo& dev : pReg->devices) {
+    dev.smi_index = -1;
+    for (size_t ix = 0; ix < Bdf.size(); ix++) {
+      if ((Bdf[ix] >> 32) == dev.domain &&
+          (Bdf[ix] & 0xFFFF) == dev.location_id) {
+        dev.smi_index = ix;
+        break;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Get all registered GPUs
+ * @return GPUs in HIP index order (empty if registry is not initialized)
+ */
+const std::vector<rvs::devinfo>& rvs::devreg::devices() {
+  static const std::vector<devinfo> none;
+  return preg ? preg->devices : none;
+}
+
+/**
+ * @brief Find GPU by GPU ID
+ * @param GpuID GPU ID
+ * @return GPU info, nullptr if not found
+ */
+const rvs::devinfo* rvs::devreg::find_gpu(const uint16_t GpuID) {
+  for (const devinfo& dev : devices()) {
+    if (dev.gpu_id == GpuID) {
+      return &dev;
+    }
+  }
+  return nullptr;
+}
+
+/**
+ * @brief Find GPU by HIP device index
+ * @param HipIndex HIP device index
+ * @return GPU info, nullptr if not found
+ */
+const rvs::devinfo* rvs::devreg::find_hip(const int HipIndex) {
+  for (const devinfo& dev : devices()) {
+    if (dev.hip_index == HipIndex) {
+      return &dev;
+    }
+  }
+  return nullptr;
+}
+
+/**
+ * @brief Find GPU by KFD node ID
+ * @param NodeID node ID
+ * @return GPU info, nullptr if not found
+ */
+const rvs::devinfo* rvs::devreg::find_node(const uint16_t NodeID) {
+  for (const devinfo& dev : devices()) {
+    if (dev.node_id == NodeID) {
+      return &dev;
+    }
+  }
+  return nullptr;
+}
+
+/**
+ * @brief Select GPUs according to "device" and "deviceid" properties
+ *
+ * @param All true if "device: all" is given
+ * @param Gpus GPU IDs listed in "device" (ignored if All is set)
+ * @param DeviceID required PCI device ID, 0 for any
+ * @param pSelected HIP device index -> GPU ID map of selected GPUs
+ * @return number of selected GPUs
+ */
+int rvs::devreg::select(const bool All, const std::vector<uint16_t>& Gpus,
+                        const uint16_t DeviceID,
+                        std::map<int, uint16_t>* pSelected) {
+  pSelected->clear();
+  for (const devinfo& dev : devices()) {
+    if (DeviceID > 0 && dev.device_id != DeviceID) {
+      continue;
+    }
+    if (!All && std::find(Gpus.begin(), Gpus.end(), dev.gpu_id) ==
+                Gpus.end()) {
+      continue;
+    }
+    pSelected->emplace(dev.hip_index, dev.gpu_id);
+  }
+  return pSelected->size();
+}
+
+/**
+ * @brief Get cached HIP device properties
+ * @param HipIndex HIP device index
+ * @param Size expected size of properties structure
+ * @return properties, nullptr if not known
+ */
+const void* rvs::devreg::hip_properties(const int HipIndex,
+                                        const size_t Size) {
+  if (preg == nullptr || Size != preg->props_size || HipIndex < 0 ||
+      (HipIndex + 1) * Size > preg->props.size()) {
+    return nullptr;
+  }
+  return &preg->props[HipIndex * Size];
+}
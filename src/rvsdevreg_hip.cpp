@@ -0,0 +1,85 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <mutex>
+#include <vector>
+
+#include "hip/hip_runtime.h"
+#include "hip/hip_runtime_api.h"
+
+#include "include/rvsdevreg.h"
+#include "include/rvsloglp.h"
+
+/**
+ * @brief Create registry from HIP devices
+ *
+ * Called through rvs::lp::Shared() once per process.
+ *
+ * @return new registry
+ */
+void* rvs::devreg::create() {
+  int prof = rvs::lp::PhaseBegin("device registry init");
+  int count = 0;
+  if (hipGetDeviceCount(&count) != hipSuccess) {
+    count = 0;
+  }
+
+  std::vector<hipDeviceProp_t> props(count);
+  std::vector<hipdev> hip;
+  for (int i = 0; i < count; i++) {
+    if (hipGetDeviceProperties(&props[i], i) != hipSuccess) {
+      continue;
+    }
+    hipdev dev;
+    dev.index = i;
+    dev.domain = props[i].pciDomainID;
+    dev.bus = props[i].pciBusID;
+    dev.device = props[i].pciDeviceID;
+    hip.push_back(dev);
+  }
+
+  registry* reg = build(hip);
+  reg->props_size = sizeof(hipDeviceProp_t);
+  const char* raw = reinterpret_cast<const char*>(props.data());
+  reg->props.assign(raw, raw + count * sizeof(hipDeviceProp_t));
+  rvs::lp::PhaseEnd(prof);
+  return reg;
+}
+
+/**
+ * @brief Initialize device registry
+ *
+ * First call in the process enumerates HIP devices, later calls (from any
+ * module) reuse the result.
+ *
+ * @return 0 if successful, -1 otherwise
+ */
+int rvs::devreg::Initialize() {
+  static std::mutex mtx;
+  std::lock_guard<std::mutex> lk(mtx);
+  if (preg == nullptr) {
+    preg = static_cast<registry*>(rvs::lp::Shared("devreg", &create));
+  }
+  return preg ? 0 : -1;
+}
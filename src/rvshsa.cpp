@@ -50,9 +50,10 @@ const uint32_t rvs::hsa::NO_CONN;
  * */
 void rvs::hsa::Init() {
   if (pDsc == nullptr) {
+    int prof = rvs::lp::PhaseBegin("hsa init");
     pDsc = new rvs::hsa();
     pDsc->InitAgents();
-
+    rvs::lp::PhaseEnd(prof);
   }
 }
 
@@ -0,0 +1,601 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvsjsonwriter.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <math.h>
+
+#include <string>
+
+#include "include/rvslognodebase.h"
+
+namespace {
+
+/*
+ * Shortest round-trip double to text conversion (Grisu2 algorithm by
+ * Florian Loitsch, "Printing Floating-Point Numbers Quickly and Accurately
+ * with Integers"). Generates the shortest digit string that converts back
+ * to the same double in virtually all cases; in the remaining ones output
+ * is one digit longer but still round-trips.
+ */
+
+//! floating point number f * 2^e with 64-bit significand
+struct diyfp {
+  uint64_t  f;
+  int       e;
+
+  diyfp(const uint64_t F, const int E) : f(F), e(E) {}
+
+  //! exact decomposition of positive double
+  explicit diyfp(const double d) {
+    uint64_t bits;
+    memcpy(&bits, &d, sizeof(bits));
+    int biased_e = static_cast<int>((bits >> 52) & 0x7ff);
+    f = bits & ((uint64_t(1) << 52) - 1);
+    if (biased_e) {
+      f += uint64_t(1) << 52;
+      e = biased_e - 1075;
+    } else {
+      e = -1074;
+    }
+  }
+
+  diyfp operator-(const diyfp& rhs) const {
+    return diyfp(f - rhs.f, e);
+  }
+
+  //! product rounded to 64 bits
+  diyfp operator*(const diyfp& rhs) const {
+    unsigned __int128 p = static_cast<unsigned __int128>(f) * rhs.f;
+    uint64_t h = static_cast<uint64_t>(p >> 64);
+    if (static_cast<uint64_t>(p) & (uint64_t(1) << 63)) {
+      h++;
+    }
+    return diyfp(h, e + rhs.e + 64);
+  }
+
+  diyfp normalize() const {
+    int s = __builtin_clzll(f);
+    return diyfp(f << s, e - s);
+  }
+};
+
+//! normalized significands of 10^-348, 10^-340, ..., 10^340
+const uint64_t cached_f[] = {
+  0xfa8fd5a0081c0288ULL, 0xbaaee17fa23ebf76ULL, 0x8b16fb203055ac76ULL,
+  0xcf42894a5dce35eaULL, 0x9a6bb0aa55653b2dULL, 0xe61acf033d1a45dfULL,
+  0xab70fe17c79ac6caULL, 0xff77b1fcbebcdc4fULL, 0xbe5691ef416bd60cULL,
+  0x8dd01fad907ffc3cULL, 0xd3515c2831559a83ULL, 0x9d71ac8fada6c9b5ULL,
+  0xea9c227723ee8bcbULL, 0xaecc49914078536dULL, 0x823c12795db6ce57ULL,
+  0xc21094364dfb5637ULL, 0x9096ea6f3848984fULL, 0xd77485cb25823ac7ULL,
+  0xa086cfcd97bf97f4ULL, 0xef340a98172aace5ULL, 0xb23867fb2a35b28eULL,
+  0x84c8d4dfd2c63f3bULL, 0xc5dd44271ad3cdbaULL, 0x936b9fcebb25c996ULL,
+  0xdbac6c247d62a584ULL, 0xa3ab66580d5fdaf6ULL, 0xf3e2f893dec3f126ULL,
+  0xb5b5ada8aaff80b8ULL, 0x87625f056c7c4a8bULL, 0xc9bcff6034c13053ULL,
+  0x964e858c91ba2655ULL, 0xdff9772470297ebdULL, 0xa6dfbd9fb8e5b88fULL,
+  0xf8a95fcf88747d94ULL, 0xb94470938fa89bcfULL, 0x8a08f0f8bf0f156bULL,
+  0xcdb02555653131b6ULL, 0x993fe2c6d07b7facULL, 0xe45c10c42a2b3b06ULL,
+  0xaa242499697392d3ULL, 0xfd87b5f28300ca0eULL, 0xbce5086492111aebULL,
+  0x8cbccc096f5088ccULL, 0xd1b71758e219652cULL, 0x9c40000000000000ULL,
+  0xe8d4a51000000000ULL, 0xad78ebc5ac620000ULL, 0x813f3978f8940984ULL,
+  0xc097ce7bc90715b3ULL, 0x8f7e32ce7bea5c70ULL, 0xd5d238a4abe98068ULL,
+  0x9f4f2726179a2245ULL, 0xed63a231d4c4fb27ULL, 0xb0de65388cc8ada8ULL,
+  0x83c7088e1aab65dbULL, 0xc45d1df942711d9aULL, 0x924d692ca61be758ULL,
+  0xda01ee641a708deaULL, 0xa26da3999aef774aULL, 0xf209787bb47d6b85ULL,
+  0xb454e4a179dd1877ULL, 0x865b86925b9bc5c2ULL, 0xc83553c5c8965d3dULL,
+  0x952ab45cfa97a0b3ULL, 0xde469fbd99a05fe3ULL, 0xa59bc234db398c25ULL,
+  0xf6c69a72a3989f5cULL, 0xb7dcbf5354e9beceULL, 0x88fcf317f22241e2ULL,
+  0xcc20ce9bd35c78a5ULL, 0x98165af37b2153dfULL, 0xe2a0b5dc971f303aULL,
+  0xa8d9d1535ce3b396ULL, 0xfb9b7cd9a4a7443cULL, 0xbb764c4ca7a44410ULL,
+  0x8bab8eefb6409c1aULL, 0xd01fef10a657842cULL, 0x9b10a4e5e9913129ULL,
+  0xe7109bfba19c0c9dULL, 0xac2820d9623bf429ULL, 0x80444b5e7aa7cf85ULL,
+  0xbf21e44003acdd2dULL, 0x8e679c2f5e44ff8fULL, 0xd433179d9c8cb841ULL,
+  0x9e19db92b4e31ba9ULL, 0xeb96bf6ebadf77d9ULL, 0xaf87023b9bf0ee6bULL
+};
+
+//! binary exponents of cached powers of ten
+const int16_t cached_e[] = {
+  -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954,
+  -927, -901, -874, -847, -821, -794, -768, -741, -715, -688, -661, -635,
+  -608, -582, -555, -529, -502, -475, -449, -422, -396, -369, -343, -316,
+  -289, -263, -236, -210, -183, -157, -130, -103, -77, -50, -24, 3, 30, 56,
+  83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348, 375, 402, 428, 455,
+  481, 508, 534, 561, 588, 614, 641, 667, 694, 720, 747, 774, 800, 827, 853,
+  880, 907, 933, 960, 986, 1013, 1039, 1066
+};
+
+const uint64_t powers10[] = {
+  1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL,
+  10000000ULL, 100000000ULL, 1000000000ULL, 10000000000ULL,
+  100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+  100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+  100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL
+};
+
+//! cached power of ten c = 10^-K bringing w * c into [2^-60, 2^-32) range
+diyfp cached_power(const int E, int* pK) {
+  double dk = (-61 - E) * 0.30102999566398114 + 347;
+  int k = static_cast<int>(dk);
+  if (dk - k > 0.0) {
+    k++;
+  }
+  unsigned index = static_cast<unsigned>((k >> 3) + 1);
+  *pK = -(-348 + static_cast<int>(index << 3));
+  return diyfp(cached_f[index], cached_e[index]);
+}
+
+//! move last digit closer to the exact value while staying in range
+void grisu_round(char* pBuf, const int Len, const uint64_t Delta,
+                 uint64_t Rest, const uint64_t TenKappa, const uint64_t WpW) {
+  while (Rest < WpW && Delta - Rest >= TenKappa &&
+         (Rest + TenKappa < WpW || WpW - Rest > Rest + TenKappa - WpW)) {
+    pBuf[Len - 1]--;
+    Rest += TenKappa;
+  }
+}
+
+//! generate digits of Mp until value is within Delta of it
+void digit_gen(const diyfp& W, const diyfp& Mp, uint64_t Delta, char* pBuf,
+               int* pLen, int* pK) {
+  const diyfp one(uint64_t(1) << -Mp.e, Mp.e);
+  const diyfp wp_w = Mp - W;
+  uint32_t p1 = static_cast<uint32_t>(Mp.f >> -one.e);
+  uint64_t p2 = Mp.f & (one.f - 1);
+
+  int kappa = 1;
+  while (kappa < 10 && p1 >= powers10[kappa]) {
+    kappa++;
+  }
+
+  *pLen = 0;
+  while (kappa > 0) {
+    uint32_t d = static_cast<uint32_t>(p1 / powers10[kappa - 1]);
+    p1 %= static_cast<uint32_t>(powers10[kappa - 1]);
+    if (d || *pLen) {
+      pBuf[(*pLen)++] = static_cast<char>('0' + d);
+    }
+    kappa--;
+    uint64_t rest = (static_cast<uint64_t>(p1) << -one.e) + p2;
+    if (rest <= Delta) {
+      *pK += kappa;
+      grisu_round(pBuf, *pLen, Delta, rest, powers10[kappa] << -one.e, wp_w.f);
+      return;
+    }
+  }
+
+  for (;;) {
+    p2 *= 10;
+    Delta *= 10;
+    char d = static_cast<char>(p2 >> -one.e);
+    if (d || *pLen) {
+      pBuf[(*pLen)++] = static_cast<char>('0' + d);
+    }
+    p2 &= one.f - 1;
+    kappa--;
+    if (p2 < Delta) {
+      *pK += kappa;
+      int index = -kappa;
+      grisu_round(pBuf, *pLen, Delta, p2, one.f,
+                  wp_w.f * (index < 20 ? powers10[index] : 0));
+      return;
+    }
+  }
+}
+
+//! digits of positive finite double: Value = digits * 10^K
+void grisu2(const double Value, char* pBuf, int* pLen, int* pK) {
+  const diyfp v(Value);
+
+  // boundaries m- and m+ halfway to neighbouring doubles
+  diyfp plus = diyfp((v.f << 1) + 1, v.e - 1).normalize();
+  diyfp minus = (v.f == (uint64_t(1) << 52)) ?
+                diyfp((v.f << 2) - 1, v.e - 2) :
+                diyfp((v.f << 1) - 1, v.e - 1);
+  minus.f <<= minus.e - plus.e;
+  minus.e = plus.e;
+
+  const diyfp c_mk = cached_power(plus.e, pK);
+  const diyfp w = v.normalize() * c_mk;
+  diyfp wp = plus * c_mk;
+  diyfp wm = minus * c_mk;
+  wm.f++;
+  wp.f--;
+  digit_gen(w, wp, wp.f - wm.f, pBuf, pLen, pK);
+}
+
+}  // namespace
+
+/**
+ * @brief Constructor
+ *
+ * @param pOut string JSON output is appended to
+ * @param Layout output layout
+ * @param Lead indentation of the outermost level (pretty layout only)
+ *
+ */
+rvs::JsonWriter::JsonWriter(std::string* pOut, const elayout Layout,
+                            const std::string& Lead)
+:
+out(pOut),
+layout_m(Layout),
+base(Lead),
+depth(0),
+first_element(true) {
+}
+
+/**
+ * @brief Get output layout
+ *
+ * @return output layout
+ *
+ */
+rvs::JsonWriter::elayout rvs::JsonWriter::layout() const {
+  return layout_m;
+}
+
+/**
+ * @brief Start new line at current indentation (pretty layout only)
+ *
+ */
+void rvs::JsonWriter::lead() {
+  if (layout_m == compact) {
+    return;
+  }
+
+  out->append(RVSENDL);
+  out->append(base);
+  for (int i = 0; i < depth; i++) {
+    out->append(RVSINDENT);
+  }
+}
+
+/**
+ * @brief Output member name followed by name separator
+ *
+ * @param Name member name
+ *
+ */
+void rvs::JsonWriter::key(const char* Name) {
+  out->push_back('"');
+  escape(out, Name);
+  out->append(layout_m == compact ? "\":" : "\" : ");
+}
+
+/**
+ * @brief Open JSON object
+ *
+ * @param Name member name (nullptr for anonymous object)
+ *
+ */
+void rvs::JsonWriter::begin_object(const char* Name) {
+  lead();
+  if (Name) {
+    key(Name);
+  }
+  out->push_back('{');
+  depth++;
+}
+
+/**
+ * @brief Close JSON object opened with begin_object()
+ *
+ */
+void rvs::JsonWriter::end_object() {
+  depth--;
+  lead();
+  out->push_back('}');
+}
+
+/**
+ * @brief Output string member
+ *
+ * @param Name member name
+ * @param Value member value (escaped as needed)
+ *
+ */
+void rvs::JsonWriter::member(const char* Name, const char* Value) {
+  lead();
+  key(Name);
+  out->push_back('"');
+  escape(out, Value);
+  out->push_back('"');
+}
+
+/**
+ * @brief Output integer member
+ *
+ * @param Name member name
+ * @param Value member value
+ *
+ */
+void rvs::JsonWriter::member(const char* Name, const int64_t Value) {
+  lead();
+  key(Name);
+  number(out, Value);
+}
+
+/**
+ * @brief Output unsigned integer member
+ *
+ * @param Name member name
+ * @param Value member value
+ *
+ */
+void rvs::JsonWriter::member(const char* Name, const uint64_t Value) {
+  lead();
+  key(Name);
+  number(out, Value);
+}
+
+/**
+ * @brief Output floating point member
+ *
+ * @param Name member name
+ * @param Value member value
+ *
+ */
+void rvs::JsonWriter::member(const char* Name, const double Value) {
+  lead();
+  key(Name);
+  number(out, Value);
+}
+
+/**
+ * @brief Output boolean member
+ *
+ * @param Name member name
+ * @param Value member value
+ *
+ */
+void rvs::JsonWriter::member(const char* Name, const bool Value) {
+  lead();
+  key(Name);
+  out->append(Value ? "true" : "false");
+}
+
+/**
+ * @brief Open array of numbers
+ *
+ * Array is output on a single line regardless of layout.
+ *
+ * @param Name member name
+ *
+ */
+void rvs::JsonWriter::begin_array(const char* Name) {
+  lead();
+  key(Name);
+  out->push_back('[');
+  first_element = true;
+}
+
+/**
+ * @brief Output integer array element
+ *
+ * @param Value element value
+ *
+ */
+void rvs::JsonWriter::element(const int64_t Value) {
+  next_element();
+  number(out, Value);
+}
+
+/**
+ * @brief Output unsigned integer array element
+ *
+ * @param Value element value
+ *
+ */
+void rvs::JsonWriter::element(const uint64_t Value) {
+  next_element();
+  number(out, Value);
+}
+
+/**
+ * @brief Output floating point array element
+ *
+ * @param Value element value
+ *
+ */
+void rvs::JsonWriter::element(const double Value) {
+  next_element();
+  number(out, Value);
+}
+
+/**
+ * @brief Close array opened with begin_array()
+ *
+ */
+void rvs::JsonWriter::end_array() {
+  out->push_back(']');
+}
+
+/**
+ * @brief Output separator ahead of array element (if not the first one)
+ *
+ */
+void rvs::JsonWriter::next_element() {
+  if (first_element) {
+    first_element = false;
+    return;
+  }
+  out->append(layout_m == compact ? "," : ", ");
+}
+
+/**
+ * @brief Output value separator
+ *
+ */
+void rvs::JsonWriter::separator() {
+  out->push_back(',');
+}
+
+/**
+ * @brief Append JSON escaped string
+ *
+ * Escapes quotation mark, reverse solidus and control characters.
+ * Characters which need no escaping are copied in runs.
+ *
+ * @param pOut string output is appended to
+ * @param Str string to escape
+ *
+ */
+void rvs::JsonWriter::escape(std::string* pOut, const char* Str) {
+  static const char hex[] = "0123456789abcdef";
+  const char* run = Str;
+  const char* p = Str;
+
+  for (; *p; p++) {
+    unsigned char c = static_cast<unsigned char>(*p);
+    if (c >= 0x20 && c != '"' && c != '\\') {
+      continue;
+    }
+
+    pOut->append(run, p - run);
+    run = p + 1;
+
+    switch (c) {
+    case '"':
+        pOut->append("\\\"");
+        break;
+    case '\\':
+        pOut->append("\\\\");
+        break;
+    case '\b':
+        pOut->append("\\b");
+        break;
+    case '\f':
+        pOut->append("\\f");
+        break;
+    case '\n':
+        pOut->append("\\n");
+        break;
+    case '\r':
+        pOut->append("\\r");
+        break;
+    case '\t':
+        pOut->append("\\t");
+        break;
+    default:
+        pOut->append("\\u00");
+        pOut->push_back(hex[c >> 4]);
+        pOut->push_back(hex[c & 0xf]);
+        break;
+    }
+  }
+
+  pOut->append(run, p - run);
+}
+
+/**
+ * @brief Append integer number
+ *
+ * @param pOut string output is appended to
+ * @param Value number
+ *
+ */
+void rvs::JsonWriter::number(std::string* pOut, const int64_t Value) {
+  if (Value < 0) {
+    pOut->push_back('-');
+    number(pOut, 0 - static_cast<uint64_t>(Value));
+  } else {
+    number(pOut, static_cast<uint64_t>(Value));
+  }
+}
+
+/**
+ * @brief Append unsigned integer number
+ *
+ * @param pOut string output is appended to
+ * @param Value number
+ *
+ */
+void rvs::JsonWriter::number(std::string* pOut, const uint64_t Value) {
+  // convert from the last digit backwards
+  char buff[24];
+  char* p = buff + sizeof(buff);
+  uint64_t v = Value;
+  do {
+    *--p = static_cast<char>('0' + v % 10);
+    v /= 10;
+  } while (v);
+
+  pOut->append(p, buff + sizeof(buff) - p);
+}
+
+/**
+ * @brief Append floating point number
+ *
+ * Outputs the shortest text which converts back to the same double,
+ * formatted the way JavaScript does (e.g. 150.25, 0.001, 1e+21, 1.5e-7).
+ * NaN and infinity, having no JSON representation, are output as null.
+ *
+ * @param pOut string output is appended to
+ * @param Value number
+ *
+ */
+void rvs::JsonWriter::number(std::string* pOut, const double Value) {
+  if (!isfinite(Value)) {
+    pOut->append("null");
+    return;
+  }
+
+  if (signbit(Value)) {
+    pOut->push_back('-');
+  }
+  if (Value == 0) {
+    pOut->push_back('0');
+    return;
+  }
+
+  char digits[32];
+  int len;
+  int k;
+  grisu2(fabs(Value), digits, &len, &k);
+
+  // position of decimal point relative to the first digit
+  int point = len + k;
+  if (k >= 0 && point <= 21) {
+    pOut->append(digits, len);
+    pOut->append(k, '0');
+  } else if (point > 0 && point <= 21) {
+    pOut->append(digits, point);
+    pOut->push_back('.');
+    pOut->append(digits + point, len - point);
+  } else if (point > -6 && point <= 0) {
+    pOut->append("0.");
+    pOut->append(-point, '0');
+    pOut->append(digits, len);
+  } else {
+    pOut->push_back(digits[0]);
+    if (len > 1) {
+      pOut->push_back('.');
+      pOut->append(digits + 1, len - 1);
+    }
+    pOut->append(point > 0 ? "e+" : "e-");
+    number(pOut, static_cast<uint64_t>(point > 0 ? point - 1 : 1 - point));
+  }
+}
@@ -27,34 +27,93 @@
 #include <unistd.h>
 #include <time.h>
 #include <stdio.h>
+#include <errno.h>
+#include <inttypes.h>
 #include <cstring>
 
 #include <iostream>
 #include <chrono>
 #include <iomanip>
-#include <fstream>
 #include <string>
 #include <mutex>
+#include <thread>
+#include <utility>
+#include <new>
 
 #include "include/rvstrace.h"
+#include "include/rvslogsink.h"
+#include "include/rvsjsonwriter.h"
+#include "include/rvslogbin.h"
 #include "include/rvslognode.h"
 #include "include/rvslognodestring.h"
 #include "include/rvslognodeint.h"
+#include "include/rvslognodeuint.h"
+#include "include/rvslognodedouble.h"
+#include "include/rvslognodebool.h"
+#include "include/rvslognodearray.h"
 #include "include/rvslognoderec.h"
 
 using std::cerr;
 using std::cout;
 
+namespace {
+
+/**
+ * @brief Create log node in the given arena (or on the heap if no arena)
+ *
+ * @param pArena arena to allocate node from
+ * @param args node constructor arguments (except the arena)
+ * @return Pointer to new node
+ *
+ */
+template <typename T, typename... Args>
+T* new_node(rvs::LogArena* pArena, Args... args) {
+  if (pArena == nullptr) {
+    return new T(args..., nullptr);
+  }
+  return new (pArena->alloc(sizeof(T))) T(args..., pArena);
+}
+
+}  // namespace
+
 int   rvs::logger::loglevel_m(2);
 bool  rvs::logger::tojson_m(false);
+bool  rvs::logger::compact_m(false);
+bool  rvs::logger::jsonl_m(false);
+bool  rvs::logger::binary_m(false);
 bool  rvs::logger::append_m(false);
 bool  rvs::logger::isfirstrecord_m(true);
+bool  rvs::logger::appending_m(false);
 std::mutex  rvs::logger::cout_mutex;
 std::mutex  rvs::logger::log_mutex;
 bool  rvs::logger::bStop(false);
 uint16_t rvs::logger::stop_flags(0u);
 bool rvs::logger::b_quiet(false);
 char rvs::logger::log_file[1024];
+rvs::LogSink rvs::logger::sink;
+rvs::LogBinWriter rvs::logger::binwriter;
+rvs::LogRotate rvs::logger::rotator;
+rvs::LogCoalesce rvs::logger::coalescer;
+rvs::logger::t_tap rvs::logger::tap_m;
+bool rvs::logger::async_m(false);
+rvs::logger::eoverflow rvs::logger::overflow_m(rvs::logger::eoverflow::block);
+rvs::LogQueue* rvs::logger::queue(nullptr);
+std::thread rvs::logger::writer;
+std::mutex rvs::logger::async_mutex;
+std::mutex rvs::logger::writer_mutex;
+std::condition_variable rvs::logger::writer_cv;
+std::atomic<bool> rvs::logger::async_on(false);
+std::atomic<bool> rvs::logger::writer_run(false);
+std::atomic<int> rvs::logger::inflight(0);
+std::atomic<int> rvs::logger::waiting(0);
+std::mutex rvs::logger::space_mutex;
+std::condition_variable rvs::logger::space_cv;
+std::condition_variable rvs::logger::leave_cv;
+std::atomic<uint64_t> rvs::logger::dropped_m(0);
+std::thread rvs::logger::flusher;
+std::mutex rvs::logger::flusher_mutex;
+std::condition_variable rvs::logger::flusher_cv;
+bool rvs::logger::flusher_run(false);
 
 const char*  rvs::logger::loglevelname[] = {
   "NONE  ", "RESULT", "ERROR ", "INFO  ", "DEBUG ", "TRACE " };
@@ -79,6 +138,91 @@ bool rvs::logger::append() {
   return append_m;
 }
 
+/**
+ * @brief Set log file rotation
+ *
+ * Log file is rolled over, at a record boundary, once it reaches given size
+ * or age. Each segment is complete text/JSON/binary log on its own.
+ * Takes effect in the next init_log_file() call.
+ *
+ * @param Size segment size in bytes (0 - no size limit)
+ * @param Interval segment age in seconds (0 - no time limit)
+ * @param Compress 'true' if closed segments are to be gzip-ed
+ *
+ */
+void rvs::logger::rotate(const uint64_t Size, const unsigned int Interval,
+                         const bool Compress) {
+  rotator.set_max_size(Size);
+  rotator.set_interval(Interval);
+  rotator.set_compress(Compress);
+}
+
+/**
+ * @brief Set coalescing of repeated messages for the given logging level
+ *
+ * Repeats of the same message (numbers disregarded) within the window are
+ * suppressed after first Burst messages. When the window closes, single
+ * summary row with the number of suppressed messages is output.
+ *
+ * @param Level logging level
+ * @param WindowMs window length in milliseconds (0 - no coalescing)
+ * @param Burst number of messages passed in each window
+ *
+ */
+void rvs::logger::coalesce(const int Level, const unsigned int WindowMs,
+                           const unsigned int Burst) {
+  coalescer.set_window(Level, WindowMs, Burst);
+}
+
+/**
+ * @brief Set function receiving copy of every output row
+ *
+ * Tap is called from the thread producing the row, before the row is
+ * queued or written. It has to be set while no logging is in progress.
+ *
+ * @param Tap function receiving rows (empty function - no tap)
+ *
+ */
+void rvs::logger::tap(t_tap Tap) {
+  tap_m = Tap;
+}
+
+/**
+ * @brief Set asynchronous logging mode
+ *
+ * When set, log rows and records are passed to a dedicated writer thread
+ * which outputs them to console and log file. Takes effect in the next
+ * init_log_file() call.
+ *
+ * @param flag new value
+ * @param policy what to do when logging queue is full
+ *
+ */
+void rvs::logger::async(const bool flag, const eoverflow policy) {
+  async_m = flag;
+  overflow_m = policy;
+}
+
+/**
+ * @brief Get asynchronous logging flag
+ *
+ * @return Current flag value
+ *
+ */
+bool rvs::logger::async() {
+  return async_m;
+}
+
+/**
+ * @brief Get number of log entries dropped due to full logging queue
+ *
+ * @return Number of dropped entries
+ *
+ */
+uint64_t rvs::logger::dropped() {
+  return dropped_m;
+}
+
 void rvs::logger::set_log_file(const std::string& fname) {
     strncpy(log_file, fname.c_str(), sizeof(log_file));
 }
@@ -93,6 +237,29 @@ void rvs::logger::log_level(const int rLevel) {
   loglevel_m = rLevel;
 }
 
+/**
+ * @brief Get logging level
+ *
+ * @return Current logging level
+ *
+ */
+int rvs::logger::log_level() {
+  return loglevel_m;
+}
+
+/**
+ * @brief Get address of logging level
+ *
+ * Passed to modules so that they can skip formatting of messages which
+ * would be discarded anyway. Always reflects the current logging level.
+ *
+ * @return Pointer to current logging level
+ *
+ */
+const int* rvs::logger::log_level_ptr() {
+  return &loglevel_m;
+}
+
 /**
  * @brief Fetches times since system start
  *
@@ -131,6 +298,91 @@ bool rvs::logger::to_json() {
   return tojson_m;
 }
 
+/**
+ * @brief Set 'compact' flag
+ *
+ * When set, each JSON record is output on a single line without
+ * indentation.
+ *
+ * @param flag new value
+ *
+ */
+void rvs::logger::compact(const bool flag) {
+  compact_m = flag;
+}
+
+/**
+ * @brief Get 'compact' flag
+ *
+ * @return Current flag value
+ *
+ */
+bool rvs::logger::compact() {
+  return compact_m;
+}
+
+/**
+ * @brief Set 'jsonl' flag
+ *
+ * When set, JSON records are output in JSON Lines format: one
+ * self-contained record per line without enclosing array. Such log file
+ * needs no patching when appended to and can be processed incrementally.
+ *
+ * @param flag new value
+ *
+ */
+void rvs::logger::jsonl(const bool flag) {
+  jsonl_m = flag;
+}
+
+/**
+ * @brief Get 'jsonl' flag
+ *
+ * @return Current flag value
+ *
+ */
+bool rvs::logger::jsonl() {
+  return jsonl_m;
+}
+
+/**
+ * @brief Set 'binary' flag
+ *
+ * When set, log rows and records are written to log file in compact
+ * binary format regardless of requested output format. Use rvs-logcat
+ * to convert binary log into text or JSON.
+ *
+ * @param flag new value
+ *
+ */
+void rvs::logger::binary(const bool flag) {
+  binary_m = flag;
+}
+
+/**
+ * @brief Get 'binary' flag
+ *
+ * @return Current flag value
+ *
+ */
+bool rvs::logger::binary() {
+  return binary_m;
+}
+
+/**
+ * @brief Get logging level name
+ *
+ * @param Level logging level
+ * @return level name as output in text log, "UNKNOWN" for invalid level
+ *
+ */
+const char* rvs::logger::level_name(const int Level) {
+  if (Level < lognone || Level > logtrace) {
+    return "UNKNOWN";
+  }
+  return loglevelname[Level];
+}
+
 /**
  * @brief Output log message
  *
@@ -204,23 +456,135 @@ int rvs::logger::LogExt(const char* Message, const int LogLevel,
     get_ticks(&secs, &usecs);
   }
 
+  // suppress repeats of the same message
+  if (coalescer.enabled()) {
+    DTRACE_
+    std::vector<T_LOGREPEAT> closed;
+    uint64_t now = static_cast<uint64_t>(secs) * 1000 + usecs / 1000;
+
+    coalescer.expire(now, &closed);
+    bool pass = coalescer.admit(Message, LogLevel, now, &closed);
+    RepeatsOut(closed, secs, usecs);
+
+    if (!pass) {
+      DTRACE_
+      return 0;
+    }
+  }
+
+  return RowEmit(Message, LogLevel, secs, usecs);
+}
+
+/**
+ * @brief Format log row and pass it for output
+ *
+ * @param Message Message to log
+ * @param LogLevel Logging level
+ * @param Sec secconds from system start
+ * @param uSec microseconds in current second
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int rvs::logger::RowEmit(const char* Message, const int LogLevel,
+                         const uint32_t Sec, const uint32_t uSec) {
   DTRACE_
   char  buff[64];
-  snprintf(buff, sizeof(buff), "%6d.%-6d", secs, usecs);
+  snprintf(buff, sizeof(buff), "%6d.%-6d", Sec, uSec);
 
-  std::string row("[");
+  T_LOGQENTRY entry;
+  entry.rec = nullptr;
+  entry.level = LogLevel;
+  entry.sec = Sec;
+  entry.usec = uSec;
+
+  std::string& row = entry.row;
+  row = "[";
   row += loglevelname[LogLevel];
   row +="] [";
   row += buff;
   row +="] ";
+  entry.msg = row.size();
   row += Message;
 
+  if (tap_m) {
+    tap_m(LogLevel, row, entry.msg);
+  }
+
+  // hand the row over to writer thread if asynchronous logging is active
+  if (async_m) {
+    if (Enqueue(&entry)) {
+      return 0;
+    }
+  }
+
+  return RowOut(&entry);
+}
+
+/**
+ * @brief Output summaries of suppressed messages
+ *
+ * Each summary is output as a row and, if JSON or binary log is requested,
+ * as a log record holding the raw count.
+ *
+ * @param Repeats summaries of closed coalescing windows
+ * @param Sec secconds from system start
+ * @param uSec microseconds in current second
+ *
+ */
+void rvs::logger::RepeatsOut(const std::vector<T_LOGREPEAT>& Repeats,
+                             const uint32_t Sec, const uint32_t uSec) {
+  for (auto it = Repeats.begin(); it != Repeats.end(); ++it) {
+    double interval = (it->last - it->first) / 1000.0;
+    char buff[128];
+    snprintf(buff, sizeof(buff), " (repeated %" PRIu64 " times in %.1f s)",
+             it->count, interval);
+    std::string msg = it->message + buff;
+
+    RowEmit(msg.c_str(), it->level, Sec, uSec);
+
+    if (to_json() || binary_m) {
+      void* r = LogRecordCreate(it->module.c_str(), it->action.c_str(),
+                                it->level, Sec, uSec);
+      AddString(r, "message", it->message.c_str());
+      AddUint64(r, "repeated", it->count);
+      AddDouble(r, "interval (sec)", interval);
+      LogRecordFlush(r);
+    }
+  }
+}
+
+/**
+ * @brief Output formatted row to console and log file
+ *
+ * @param pEntry log entry holding formatted row
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int rvs::logger::RowOut(T_LOGQENTRY* pEntry) {
+  std::string* pRow = &pEntry->row;
+
   // if no quiet option given, output to cout
   if (!b_quiet) {
     DTRACE_
     // lock cout_mutex for the duration of this block
     std::lock_guard<std::mutex> lk(cout_mutex);
-    cout << row << '\n';
+    cout << *pRow << '\n';
+  }
+
+  // binary log keeps rows regardless of output format
+  if (binary_m) {
+    // lock log_mutex for the duration of this block
+    std::lock_guard<std::mutex> lk(log_mutex);
+    RotateCheck();
+    std::string* pOut = FileBuffer();
+    if (pOut) {
+      binwriter.output(pOut);
+      binwriter.row(pEntry->level, pEntry->sec, pEntry->usec,
+                    pRow->c_str() + pEntry->msg);
+      sink.commit();
+      FileUrgent(pEntry->level);
+    }
+    return 0;
   }
 
   // this stream does not output JSON
@@ -230,20 +594,23 @@ int rvs::logger::LogExt(const char* Message, const int LogLevel,
   }
 
   DTRACE_
-  // send to file if requested
-  if (isfirstrecord_m) {
-    DTRACE_
-    isfirstrecord_m = false;
-  } else {
-    DTRACE_
-    row = RVSENDL + row;
-  }
-  DTRACE_
-
   if (true) {
     // lock log_mutex for the duration of this block
     std::lock_guard<std::mutex> lk(log_mutex);
-    ToFile(row);
+    RotateCheck();
+
+    // send to file if requested
+    if (isfirstrecord_m) {
+      DTRACE_
+      isfirstrecord_m = false;
+    } else {
+      DTRACE_
+      pRow->insert(0, RVSENDL);
+    }
+    DTRACE_
+
+    ToFile(*pRow);
+    FileUrgent(pEntry->level);
   }
 
   DTRACE_
@@ -276,7 +643,7 @@ void* rvs::logger::LogRecordCreate(const char* Module, const char* Action,
     get_ticks(&sec, &usec);
   }
 
-  rvs::LogNodeRec* rec = new LogNodeRec(Action, LogLevel, sec, usec);
+  rvs::LogNodeRec* rec = LogNodeRec::Create(Action, LogLevel, sec, usec);
   AddString(rec, "action", Action);
   AddString(rec, "module", Module);
   AddString(rec, "loglevelname", (LogLevel >= lognone && LogLevel < logtrace) ?
@@ -295,16 +662,14 @@ void* rvs::logger::LogRecordCreate(const char* Module, const char* Action,
  *
  */
 int   rvs::logger::LogRecordFlush(void* pLogRecord) {
-  // lock log_mutex for the duration of this block
-  std::lock_guard<std::mutex> lk(log_mutex);
   std::string val;
   DTRACE_
 
   LogNodeRec* r = static_cast<LogNodeRec*>(pLogRecord);
-  // no JSON loggin requested
-  if (!to_json()) {
+  // no JSON loggin requested (binary log keeps records for conversion)
+  if (!to_json() && !binary_m) {
     DTRACE_
-    delete r;
+    LogNodeRec::Destroy(r);
     return 0;
   }
 
@@ -314,75 +679,469 @@ int   rvs::logger::LogRecordFlush(void* pLogRecord) {
     char buff[128];
     snprintf(buff, sizeof(buff), "unknown logging level: %d", r->LogLevel());
     Err(buff, "CLI");
-    delete r;
+    LogNodeRec::Destroy(r);
     return -1;
   }
 
   // if too high, ignore record
   if (level > loglevel_m) {
     DTRACE_
-    delete r;
+    LogNodeRec::Destroy(r);
     return 0;
   }
 
-  // do not pre-pend "," separator for the first row
-  std::string row;
-  if (append_m) {
-    DTRACE_
-    row = ",";
-  } else {
-    DTRACE_
-    if (!isfirstrecord_m) {
-      DTRACE_
-      row = ",";
+  // hand the record over to writer thread if asynchronous logging is active
+  if (async_m) {
+    T_LOGQENTRY entry;
+    entry.rec = r;
+    if (Enqueue(&entry)) {
+      return 0;
     }
   }
+
+  return RecordOut(r);
+}
+
+/**
+ * @brief Output JSON log record to log file
+ *
+ * @param pRec log record (deleted by this method)
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int rvs::logger::RecordOut(LogNodeRec* pRec) {
   DTRACE_
-  // get JSON formatted log record
-  row += r->ToJson("  ");
+  if (true) {
+    // lock log_mutex for the duration of this block
+    std::lock_guard<std::mutex> lk(log_mutex);
+    RotateCheck();
+
+    // serialize record straight into the log sink buffer
+    std::string* pOut = FileBuffer();
+    if (pOut && binary_m) {
+      binwriter.output(pOut);
+      pRec->WriteBin(&binwriter);
+
+      sink.commit();
+    } else if (pOut && jsonl_m) {
+      // self-contained record terminated by new line
+      JsonWriter writer(pOut, JsonWriter::compact);
+      pRec->WriteJson(&writer);
+      pOut->append(RVSENDL);
+
+      sink.commit();
+    } else if (pOut) {
+      // do not pre-pend "," separator for the first row
+      if (appending_m || !isfirstrecord_m) {
+        DTRACE_
+        pOut->push_back(',');
+      }
 
-  // send it to file
-  ToFile(row);
+      if (compact_m) {
+        // one record per line
+        pOut->append(RVSENDL);
+        JsonWriter writer(pOut, JsonWriter::compact);
+        pRec->WriteJson(&writer);
+      } else {
+        JsonWriter writer(pOut, JsonWriter::pretty, RVSINDENT);
+        pRec->WriteJson(&writer);
+      }
 
-  // dealloc memory
-  delete r;
+      sink.commit();
+    }
+    FileUrgent(pRec->LogLevel());
 
-  if (isfirstrecord_m) {
-    DTRACE_
-    isfirstrecord_m = false;
+    if (isfirstrecord_m) {
+      DTRACE_
+      isfirstrecord_m = false;
+    }
   }
+
+  // dealloc memory
+  LogNodeRec::Destroy(pRec);
+
   DTRACE_
   // return OK
   return 0;
 }
 
+/**
+ * @brief Pass log entry to writer thread
+ *
+ * Depending on overflow policy, blocks while logging queue is full or
+ * drops the entry and increments dropped entries counter.
+ *
+ * @param pEntry entry to pass (content is moved into the queue)
+ * @return 'true' if entry is taken care of, 'false' if writer thread is not
+ * running and entry has to be output by the caller
+ *
+ */
+bool rvs::logger::Enqueue(T_LOGQENTRY* pEntry) {
+  // announce producer so that StopWriter() can wait for it
+  inflight++;
+  if (!async_on) {
+    LeaveQueue();
+    return false;
+  }
+
+  if (!queue->push(pEntry)) {
+    if (overflow_m == eoverflow::drop) {
+      dropped_m++;
+      if (pEntry->rec) {
+        LogNodeRec::Destroy(pEntry->rec);
+      }
+      pEntry->rec = nullptr;
+      LeaveQueue();
+      return true;
+    }
+
+    // wake up writer and sleep until it frees a slot
+    writer_cv.notify_one();
+    std::unique_lock<std::mutex> lk(space_mutex);
+    waiting++;
+    while (!queue->push(pEntry)) {
+      space_cv.wait(lk);
+    }
+    waiting--;
+  }
+
+  LeaveQueue();
+  writer_cv.notify_one();
+
+  return true;
+}
+
+/**
+ * @brief Mark end of Enqueue() call
+ *
+ * Wakes up StopWriter() when the last producer leaves.
+ *
+ */
+void rvs::logger::LeaveQueue() {
+  if (--inflight == 0 && !async_on) {
+    std::lock_guard<std::mutex> lk(space_mutex);
+    leave_cv.notify_all();
+  }
+}
+
+/**
+ * @brief Start writer thread if asynchronous logging is requested
+ *
+ */
+void rvs::logger::StartWriter() {
+  std::lock_guard<std::mutex> lk(async_mutex);
+
+  if (!async_m || writer.joinable()) {
+    return;
+  }
+
+  if (queue == nullptr) {
+    queue = new LogQueue();
+  }
+
+  dropped_m = 0;
+  writer_run = true;
+  writer = std::thread(&rvs::logger::WriterRun);
+  async_on = true;
+}
+
+/**
+ * @brief Stop writer thread
+ *
+ * New entries are routed back to calling threads, while all entries already
+ * queued are written out before this method returns.
+ *
+ */
+void rvs::logger::StopWriter() {
+  uint64_t lost;
+
+  {
+    std::lock_guard<std::mutex> lk(async_mutex);
+
+    if (!writer.joinable()) {
+      return;
+    }
+
+    // no more new entries; wait for producers already past the check
+    async_on = false;
+    {
+      std::unique_lock<std::mutex> lk(space_mutex);
+      leave_cv.wait(lk, [] { return inflight == 0; });
+    }
+
+    // let writer drain the queue and exit
+    writer_run = false;
+    writer_cv.notify_one();
+    writer.join();
+
+    lost = dropped_m.exchange(0);
+  }
+
+  if (lost) {
+    std::string msg = "[CLI] logging queue full, " + std::to_string(lost) +
+                      " log entries dropped";
+    LogExt(msg.c_str(), logerror, 0, 0);
+  }
+}
+
+/**
+ * @brief Writer thread function
+ *
+ * Outputs queued entries. While idle, flushes log file buffer
+ * when flush interval expires.
+ *
+ */
+void rvs::logger::WriterRun() {
+  T_LOGQENTRY entry;
+  entry.rec = nullptr;
+
+  for (;;) {
+    // read the flag before draining so nothing queued before stop is missed
+    bool running = writer_run;
+
+    while (queue->pop(&entry)) {
+      // slot is free; order pop before reading the waiter count
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (waiting) {
+        std::lock_guard<std::mutex> lk(space_mutex);
+        space_cv.notify_all();
+      }
+
+      if (entry.rec) {
+        RecordOut(entry.rec);
+        entry.rec = nullptr;
+      } else {
+        RowOut(&entry);
+      }
+    }
+
+    if (!running) {
+      break;
+    }
+
+    {
+      std::lock_guard<std::mutex> lk(log_mutex);
+      sink.flush_expired();
+    }
+
+    std::unique_lock<std::mutex> lk(writer_mutex);
+    writer_cv.wait_for(lk, std::chrono::milliseconds(RVS_LOGWRITER_IDLE_MS));
+  }
+}
+
+/**
+ * @brief Start thread flushing log file buffer in synchronous mode
+ *
+ * Without it buffered rows would only reach the file with the next write,
+ * so the last rows of a hung run would never be written.
+ *
+ */
+void rvs::logger::StartFlusher() {
+  std::lock_guard<std::mutex> lk(async_mutex);
+
+  if (async_m || flusher.joinable()) {
+    return;
+  }
+
+  flusher_run = true;
+  flusher = std::thread(&rvs::logger::FlusherRun);
+}
+
+/**
+ * @brief Stop flusher thread
+ *
+ */
+void rvs::logger::StopFlusher() {
+  std::lock_guard<std::mutex> lk(async_mutex);
+
+  if (!flusher.joinable()) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> flk(flusher_mutex);
+    flusher_run = false;
+  }
+  flusher_cv.notify_one();
+  flusher.join();
+}
+
+/**
+ * @brief Flusher thread function
+ *
+ * Writes buffered log file data out once flush interval expires.
+ *
+ */
+void rvs::logger::FlusherRun() {
+  std::unique_lock<std::mutex> lk(flusher_mutex);
+
+  while (flusher_run) {
+    flusher_cv.wait_for(lk,
+                        std::chrono::milliseconds(RVS_LOGFLUSHER_IDLE_MS));
+    if (!flusher_run) {
+      break;
+    }
+
+    std::lock_guard<std::mutex> llk(log_mutex);
+    sink.flush_expired();
+  }
+}
+
+/**
+ * @brief Write buffered output right away for important rows
+ *
+ * Results and errors are written to the file as soon as they are logged so
+ * that they survive a crash of the process.
+ *
+ * Note: caller is expected to hold log_mutex.
+ *
+ * @param Level logging level of the row or record just buffered
+ *
+ */
+void rvs::logger::FileUrgent(const int Level) {
+  if (Level > lognone && Level <= logerror && sink.is_open()) {
+    sink.flush();
+  }
+}
+
 /**
  * @brief Output log record to file
  *
- * Sends out string representing record to a log file
+ * Sends out string representing record to a log file. Output is buffered
+ * in the log sink and written to the file in larger chunks.
+ *
+ * Note: caller is expected to hold log_mutex.
  *
  * @param Row string representing log record
  * @return 0 - success, non-zero otherwise
  *
  */
 int rvs::logger::ToFile(const std::string& Row) {
+  if (FileBuffer() == nullptr)
+    return -1;
+
+  return sink.write(Row);
+}
+
+/**
+ * @brief Get log sink buffer for direct output
+ *
+ * Opens log file if needed. Data appended to the buffer is written to the
+ * file by LogSink::commit().
+ *
+ * Note: caller is expected to hold log_mutex.
+ *
+ * @return sink buffer, nullptr if no file output is to be done
+ *
+ */
+std::string* rvs::logger::FileBuffer() {
   if (bStop) {
     if (stop_flags)
-      return 0;
+      return nullptr;
   }
 
-  std::string logfile(log_file);
-  if (logfile == "")
-    return -1;
+  if (log_file[0] == '\0')
+    return nullptr;
 
-  std::fstream fs;
-  fs.open(logfile, std::fstream::out | std::fstream::app);
+  // (re)open log file if needed, keeping existing content
+  if (!sink.is_open()) {
+    if (sink.open(log_file, false))
+      return nullptr;
+  }
 
-  fs << Row;
+  return sink.output();
+}
 
-  fs.close();
+/**
+ * @brief Start new log file segment
+ *
+ * Writes opening "[" of JSON log or session header of binary log.
+ *
+ * Note: caller is expected to hold log_mutex.
+ *
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int rvs::logger::FileHeader() {
+  if (binary()) {
+    // binary log starts new session in each run and each segment
+    binwriter.output(sink.output());
+    binwriter.session();
+    return sink.commit();
+  }
 
-  return 0;
+  // existing content is already framed
+  if (appending_m || !to_json() || jsonl()) {
+    return 0;
+  }
+
+  return ToFile("[");
+}
+
+/**
+ * @brief Finish log file segment
+ *
+ * Terminates last text row or closes JSON array.
+ *
+ * Note: caller is expected to hold log_mutex.
+ *
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int rvs::logger::FileTrailer() {
+  // JSON Lines records are already terminated, no framing needed
+  if ((to_json() && jsonl()) || binary()) {
+    return 0;
+  }
+
+  std::string row(RVSENDL);
+  if (to_json()) {
+    row += "]";
+  }
+
+  return ToFile(row);
+}
+
+/**
+ * @brief Roll log file over if rotation limit is reached
+ *
+ * Called before each row or record is written, so that segments end at
+ * record boundary and no empty segment is left behind at the end.
+ * Active file is renamed to the next segment, properly terminated and
+ * closed. Logging continues into a new file under the original name.
+ * Compression of the closed segment, if requested, is left to background
+ * thread so that logging threads are not held up.
+ *
+ * Note: caller is expected to hold log_mutex.
+ *
+ */
+void rvs::logger::RotateCheck() {
+  if (!rotator.enabled() || !sink.is_open() || !rotator.due(sink.size())) {
+    return;
+  }
+
+  // rename first so that failure leaves active file intact
+  std::string segment;
+  if (rotator.rotate(&segment)) {
+    std::string msg = std::string("could not rotate log file ") + log_file +
+                      ": " + strerror(errno) + ", rotation disabled";
+    rotator.set_max_size(0);
+    rotator.set_interval(0);
+    Err(msg.c_str(), "CLI");
+    return;
+  }
+
+  FileTrailer();
+  sink.close();
+  rotator.retire(segment);
+
+  if (sink.open(log_file, true)) {
+    return;
+  }
+
+  appending_m = false;
+  isfirstrecord_m = true;
+  FileHeader();
 }
 
 /**
@@ -391,6 +1150,7 @@ int rvs::logger::ToFile(const std::string& Row) {
  * In case when append "-a" option is given along with "-l --json",
  * replaces "]" terminating character with " " in order to
  * ensure well-formed JSON content.
+ * Not needed for JSON Lines output, which has no closing bracket.
  *
  * @param pSts non zero if patching took place
  * @return 0 - success, non-zero otherwise
@@ -422,7 +1182,8 @@ int rvs::logger::JsonPatchAppend(int* pSts) {
  *
  */
 void* rvs::logger::CreateNode(void* Parent, const char* Name) {
-  rvs::LogNode* p = new LogNode(Name, static_cast<rvs::LogNodeBase*>(Parent));
+  rvs::LogNodeBase* pp = static_cast<rvs::LogNodeBase*>(Parent);
+  rvs::LogNode* p = new_node<LogNode>(pp ? pp->Arena() : nullptr, Name, pp);
   return p;
 }
 
@@ -438,7 +1199,8 @@ void* rvs::logger::CreateNode(void* Parent, const char* Name) {
  */
 void  rvs::logger::AddString(void* Parent, const char* Key, const char* Val) {
   rvs::LogNode* pp = static_cast<rvs::LogNode*>(Parent);
-  rvs::LogNodeString* p = new LogNodeString(Key, Val, pp);
+  rvs::LogNodeString* p = new_node<LogNodeString>(pp->Arena(), Key, Val,
+                                                  pp);
   pp->Add(p);
 }
 
@@ -454,7 +1216,133 @@ void  rvs::logger::AddString(void* Parent, const char* Key, const char* Val) {
  */
 void  rvs::logger::AddInt(void* Parent, const char* Key, const int Val) {
   rvs::LogNode* pp = static_cast<rvs::LogNode*>(Parent);
-  rvs::LogNodeInt* p = new LogNodeInt(Key, Val, pp);
+  rvs::LogNodeInt* p = new_node<LogNodeInt>(pp->Arena(), Key, Val, pp);
+  pp->Add(p);
+}
+
+/**
+ * @brief Create and add child node of type 64-bit int to the given parent
+ *
+ * Note: this API is used to construct JSON output.
+ *
+ * @param Parent Parent node
+ * @param Key Key as C string
+ * @param Val Value as 64-bit integer
+ *
+ */
+void  rvs::logger::AddInt64(void* Parent, const char* Key, const int64_t Val) {
+  rvs::LogNode* pp = static_cast<rvs::LogNode*>(Parent);
+  rvs::LogNodeInt* p = new_node<LogNodeInt>(pp->Arena(), Key, Val, pp);
+  pp->Add(p);
+}
+
+/**
+ * @brief Create and add child node of type unsigned 64-bit int to the given
+ * parent node
+ *
+ * Note: this API is used to construct JSON output.
+ *
+ * @param Parent Parent node
+ * @param Key Key as C string
+ * @param Val Value as unsigned 64-bit integer
+ *
+ */
+void  rvs::logger::AddUint64(void* Parent, const char* Key,
+                             const uint64_t Val) {
+  rvs::LogNode* pp = static_cast<rvs::LogNode*>(Parent);
+  rvs::LogNodeUint* p = new_node<LogNodeUint>(pp->Arena(), Key, Val, pp);
+  pp->Add(p);
+}
+
+/**
+ * @brief Create and add child node of type double to the given parent node
+ *
+ * Note: this API is used to construct JSON output.
+ *
+ * @param Parent Parent node
+ * @param Key Key as C string
+ * @param Val Value as double
+ *
+ */
+void  rvs::logger::AddDouble(void* Parent, const char* Key, const double Val) {
+  rvs::LogNode* pp = static_cast<rvs::LogNode*>(Parent);
+  rvs::LogNodeDouble* p = new_node<LogNodeDouble>(pp->Arena(), Key, Val, pp);
+  pp->Add(p);
+}
+
+/**
+ * @brief Create and add child node of type bool to the given parent node
+ *
+ * Note: this API is used to construct JSON output.
+ *
+ * @param Parent Parent node
+ * @param Key Key as C string
+ * @param Val Value as bool
+ *
+ */
+void  rvs::logger::AddBool(void* Parent, const char* Key, const bool Val) {
+  rvs::LogNode* pp = static_cast<rvs::LogNode*>(Parent);
+  rvs::LogNodeBool* p = new_node<LogNodeBool>(pp->Arena(), Key, Val, pp);
+  pp->Add(p);
+}
+
+/**
+ * @brief Create and add child node holding array of 64-bit ints to the
+ * given parent node
+ *
+ * Note: this API is used to construct JSON output.
+ *
+ * @param Parent Parent node
+ * @param Key Key as C string
+ * @param Vals Array elements (copied into the node)
+ * @param Count Number of elements
+ *
+ */
+void  rvs::logger::AddInt64Array(void* Parent, const char* Key,
+                                 const int64_t* Vals, const size_t Count) {
+  rvs::LogNode* pp = static_cast<rvs::LogNode*>(Parent);
+  rvs::LogNodeArray* p = new_node<LogNodeArray>(pp->Arena(), Key, Vals, Count,
+                                                pp);
+  pp->Add(p);
+}
+
+/**
+ * @brief Create and add child node holding array of unsigned 64-bit ints to
+ * the given parent node
+ *
+ * Note: this API is used to construct JSON output.
+ *
+ * @param Parent Parent node
+ * @param Key Key as C string
+ * @param Vals Array elements (copied into the node)
+ * @param Count Number of elements
+ *
+ */
+void  rvs::logger::AddUint64Array(void* Parent, const char* Key,
+                                  const uint64_t* Vals, const size_t Count) {
+  rvs::LogNode* pp = static_cast<rvs::LogNode*>(Parent);
+  rvs::LogNodeArray* p = new_node<LogNodeArray>(pp->Arena(), Key, Vals, Count,
+                                                pp);
+  pp->Add(p);
+}
+
+/**
+ * @brief Create and add child node holding array of doubles to the given
+ * parent node
+ *
+ * Note: this API is used to construct JSON output.
+ *
+ * @param Parent Parent node
+ * @param Key Key as C string
+ * @param Vals Array elements (copied into the node)
+ * @param Count Number of elements
+ *
+ */
+void  rvs::logger::AddDoubleArray(void* Parent, const char* Key,
+                                  const double* Vals, const size_t Count) {
+  rvs::LogNode* pp = static_cast<rvs::LogNode*>(Parent);
+  rvs::LogNodeArray* p = new_node<LogNodeArray>(pp->Arena(), Key, Vals, Count,
+                                                pp);
   pp->Add(p);
 }
 
@@ -483,18 +1371,31 @@ void  rvs::logger::AddNode(void* Parent, void* Child) {
  *
  */
 int rvs::logger::init_log_file() {
+  // start writer thread if asynchronous logging is requested
+  StartWriter();
+
+  // otherwise flush file buffer periodically from own thread
+  if (log_file[0] != '\0') {
+    StartFlusher();
+  }
+
+  // lock log_mutex for the duration of this block
+  std::lock_guard<std::mutex> lk(log_mutex);
+
   isfirstrecord_m = true;
   bStop = false;
   stop_flags = 0;
 
-  std::string row;
   std::string logfile(log_file);
 
+  // close log file left open by previous run, if any
+  sink.close();
+
   // if no logg to file requested, just return
   if (logfile == "")
     return 0;
 
-  if (append()) {
+  if (append() && !jsonl() && !binary()) {
     // appnd to file, replace the closing "]" with "," in order to
     // have well formed JSON after appending
     int patch_status = -1;
@@ -505,46 +1406,82 @@ int rvs::logger::init_log_file() {
         return -1;
       }
     }
-  }  else {
-    // logging but not appending - just truncate the file.
-    std::fstream fs;
-    fs.open(logfile, std::fstream::out);
-    bool berror = fs.fail();
-    fs.close();
-    if (berror) {
-      return -1;
-    }
-    if (to_json()) {
-      row = "[";
-    }
   }
 
-  // print to log file if requested
-  ToFile(row);
+  // logging but not appending - truncate the file.
+  // Log file is kept open until terminate()
+  if (sink.open(logfile, !append())) {
+    return -1;
+  }
+
+  appending_m = append();
+  rotator.start(logfile);
+
+  FileHeader();
 
   return 0;
 }
 
+/**
+ * @brief Report messages suppressed in coalescing windows still open
+ *
+ * Summaries are output through the regular row path, so cout_mutex must
+ * not be held by the caller.
+ *
+ */
+void rvs::logger::RepeatsDrain() {
+  std::vector<T_LOGREPEAT> closed;
+  coalescer.drain(&closed);
+  if (!closed.empty()) {
+    uint32_t sec;
+    uint32_t usec;
+    get_ticks(&sec, &usec);
+    RepeatsOut(closed, sec, usec);
+  }
+}
+
 /**
  * @brief Performs proper termination of log file contents
  *
+ * Flushes all buffered output and closes log file.
+ *
  * @return 0 - success, non-zero otherwise
  *
  */
 int rvs::logger::terminate() {
+  RepeatsDrain();
+  return CloseLog();
+}
+
+/**
+ * @brief Write out queued entries, terminate and close log file
+ *
+ * Does not output anything to console so it may be called while
+ * cout_mutex is held.
+ *
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int rvs::logger::CloseLog() {
+  // write out all queued entries
+  StopWriter();
+  StopFlusher();
+
+  // lock log_mutex for the duration of this block
+  std::lock_guard<std::mutex> lk(log_mutex);
+
   // if no logg to file requested, just return
   std::string logfile(log_file);
   if (logfile == "")
     return 0;
 
-  std::string row(RVSENDL);
+  FileTrailer();
 
-  if (to_json()) {
-    row += "]";
-  }
+  // flush buffered output and close the file
+  sink.close();
 
-  // print to log file if requested
-  ToFile(row);
+  // wait for closed segments to be compressed
+  rotator.stop();
 
   return 0;
 }
@@ -558,6 +1495,12 @@ int rvs::logger::terminate() {
  *
  */
 void rvs::logger::Stop(uint16_t flags) {
+  // summaries are output as rows, so emit them before taking cout_mutex
+  RepeatsDrain();
+
+  // write out all queued entries (writer thread needs cout_mutex)
+  StopWriter();
+
   // lock cout_mutex for the duration of this block
   std::lock_guard<std::mutex> lk(cout_mutex);
 
@@ -566,7 +1509,7 @@ void rvs::logger::Stop(uint16_t flags) {
   stop_flags = flags;
 
   // properly terminate log file if needed
-  terminate();
+  CloseLog();
 }
 
 /**
@@ -606,6 +1549,13 @@ int rvs::logger::Err(const char* Message, const char* Module
   std::string out;
   out = "RVS-ERROR";
   out += module + action + std::string(" ") + message;
+
+  if (tap_m) {
+    // message of interest starts with action name if there is one
+    size_t msg = std::string("RVS-ERROR").size() +
+                 (Action != nullptr ? module.size() + 1 : 1);
+    tap_m(logerror, out, msg);
+  }
   {
     // lock cout_mutex for the duration of this block
     std::lock_guard<std::mutex> lk(cout_mutex);
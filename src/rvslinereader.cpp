@@ -0,0 +1,153 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvslinereader.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+
+#include <string>
+
+/**
+ * @brief Constructor
+ *
+ */
+rvs::LineReader::LineReader()
+:
+fd(-1),
+buffer(nullptr),
+pos(0),
+len(0) {
+}
+
+//! Destructor
+rvs::LineReader::~LineReader() {
+  close();
+}
+
+/**
+ * @brief Open file for reading
+ *
+ * @param FileName file name
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int rvs::LineReader::open(const std::string& FileName) {
+  close();
+
+  fd = ::open(FileName.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return -1;
+  }
+
+  buffer = new char[RVS_LINEREADER_BUFFER_SIZE];
+  pos = 0;
+  len = 0;
+
+  return 0;
+}
+
+/**
+ * @brief Read next line
+ *
+ * Line terminator is not stored. Last line of the file is returned even if
+ * it is not terminated.
+ *
+ * @param pLine [out] line content
+ * @return 1 - line read, 0 - end of file, -1 - error
+ *
+ */
+int rvs::LineReader::next(std::string* pLine) {
+  if (fd < 0) {
+    return -1;
+  }
+
+  pLine->clear();
+  bool got_data = false;
+
+  for (;;) {
+    if (pos == len) {
+      int sts = fill();
+      if (sts < 0) {
+        return -1;
+      }
+      if (sts == 0) {
+        return got_data ? 1 : 0;
+      }
+    }
+
+    got_data = true;
+    const char* start = buffer + pos;
+    const char* eol = static_cast<const char*>(memchr(start, '\n', len - pos));
+    if (eol) {
+      pLine->append(start, eol - start);
+      pos += eol - start + 1;
+      return 1;
+    }
+
+    pLine->append(start, len - pos);
+    pos = len;
+  }
+}
+
+/**
+ * @brief Close file
+ *
+ */
+void rvs::LineReader::close() {
+  if (fd >= 0) {
+    ::close(fd);
+    fd = -1;
+  }
+
+  delete [] buffer;
+  buffer = nullptr;
+  pos = 0;
+  len = 0;
+}
+
+/**
+ * @brief Read next chunk of file into buffer
+ *
+ * @return number of bytes read, 0 on end of file, -1 on error
+ *
+ */
+int rvs::LineReader::fill() {
+  ssize_t n;
+
+  do {
+    n = ::read(fd, buffer, RVS_LINEREADER_BUFFER_SIZE);
+  } while (n < 0 && errno == EINTR);
+
+  if (n < 0) {
+    return -1;
+  }
+
+  pos = 0;
+  len = n;
+
+  return static_cast<int>(n);
+}
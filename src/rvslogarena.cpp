@@ -0,0 +1,179 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvslogarena.h"
+
+#include <string.h>
+
+#include <new>
+#include <mutex>
+#include <vector>
+
+//! allocation granularity
+#define RVS_LOGARENA_ALIGN              alignof(max_align_t)
+
+std::mutex rvs::LogArena::pool_mutex;
+std::vector<rvs::LogArena*> rvs::LogArena::pool;
+
+/**
+ * @brief Constructor
+ *
+ * @param ChunkSize size of regular memory chunk
+ *
+ */
+rvs::LogArena::LogArena(const size_t ChunkSize)
+:
+first(nullptr),
+current(nullptr),
+offset(0),
+chunk_size(ChunkSize) {
+}
+
+//! Destructor
+rvs::LogArena::~LogArena() {
+  chunk* c = first;
+  while (c) {
+    chunk* next = c->next;
+    ::operator delete(c);
+    c = next;
+  }
+}
+
+/**
+ * @brief Allocate memory block from the arena
+ *
+ * @param Size block size
+ * @return Pointer to the block (aligned for any fundamental type)
+ *
+ */
+void* rvs::LogArena::alloc(const size_t Size) {
+  size_t size = (Size + RVS_LOGARENA_ALIGN - 1) & ~(RVS_LOGARENA_ALIGN - 1);
+
+  if (current == nullptr) {
+    first = current = new_chunk(size > chunk_size ? size : chunk_size);
+    offset = 0;
+  }
+
+  if (offset + size > current->size) {
+    // reuse chunk left from previous records if large enough
+    if (current->next && current->next->size >= size) {
+      current = current->next;
+    } else {
+      chunk* c = new_chunk(size > chunk_size ? size : chunk_size);
+      c->next = current->next;
+      current->next = c;
+      current = c;
+    }
+    offset = 0;
+  }
+
+  char* data = reinterpret_cast<char*>(current) +
+               ((sizeof(chunk) + RVS_LOGARENA_ALIGN - 1) &
+               ~(RVS_LOGARENA_ALIGN - 1));
+  void* p = data + offset;
+  offset += size;
+
+  return p;
+}
+
+/**
+ * @brief Copy C string into the arena
+ *
+ * @param Str string to copy
+ * @return Pointer to the copy
+ *
+ */
+const char* rvs::LogArena::strdup(const char* Str) {
+  size_t len = strlen(Str) + 1;
+  char* p = static_cast<char*>(alloc(len));
+  memcpy(p, Str, len);
+  return p;
+}
+
+/**
+ * @brief Release all blocks allocated from the arena
+ *
+ * Chunks are kept for reuse. Destructors of objects constructed in the arena
+ * are not called.
+ *
+ */
+void rvs::LogArena::reset() {
+  current = first;
+  offset = 0;
+}
+
+/**
+ * @brief Get arena from the pool of free arenas or create new one
+ *
+ * @return Pointer to empty arena
+ *
+ */
+rvs::LogArena* rvs::LogArena::acquire() {
+  {
+    std::lock_guard<std::mutex> lk(pool_mutex);
+    if (!pool.empty()) {
+      LogArena* p = pool.back();
+      pool.pop_back();
+      return p;
+    }
+  }
+
+  return new LogArena();
+}
+
+/**
+ * @brief Reset arena and return it to the pool of free arenas
+ *
+ * @param pArena arena obtained through acquire()
+ *
+ */
+void rvs::LogArena::release(LogArena* pArena) {
+  pArena->reset();
+
+  {
+    std::lock_guard<std::mutex> lk(pool_mutex);
+    if (pool.size() < RVS_LOGARENA_POOL_SIZE) {
+      pool.push_back(pArena);
+      return;
+    }
+  }
+
+  delete pArena;
+}
+
+/**
+ * @brief Allocate new chunk
+ *
+ * @param Size size of data area
+ * @return Pointer to new chunk
+ *
+ */
+rvs::LogArena::chunk* rvs::LogArena::new_chunk(const size_t Size) {
+  size_t header = (sizeof(chunk) + RVS_LOGARENA_ALIGN - 1) &
+                  ~(RVS_LOGARENA_ALIGN - 1);
+  chunk* c = static_cast<chunk*>(::operator new(header + Size));
+  c->next = nullptr;
+  c->size = Size;
+  return c;
+}
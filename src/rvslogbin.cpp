@@ -0,0 +1,589 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvslogbin.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+
+#include <string>
+
+/**
+ * @brief Constructor
+ *
+ */
+rvs::LogBinWriter::LogBinWriter()
+:
+out(nullptr),
+values(0) {
+}
+
+//! Destructor
+rvs::LogBinWriter::~LogBinWriter() {
+}
+
+/**
+ * @brief Set string encoded frames are appended to
+ *
+ * @param pOut output string
+ *
+ */
+void rvs::LogBinWriter::output(std::string* pOut) {
+  out = pOut;
+}
+
+/**
+ * @brief Start new logging session
+ *
+ * Outputs session frame and clears symbol table.
+ *
+ */
+void rvs::LogBinWriter::session() {
+  symbols.clear();
+  values = 0;
+
+  body.clear();
+  body.push_back(FrameSession);
+  body.append(RVS_LOGBIN_MAGIC);
+  body.push_back(RVS_LOGBIN_VERSION);
+  frame(body.data(), body.size());
+}
+
+/**
+ * @brief Output text row
+ *
+ * @param Level logging level
+ * @param Sec seconds since system start
+ * @param uSec microseconds in current second
+ * @param Message message text
+ *
+ */
+void rvs::LogBinWriter::row(const int Level, const uint32_t Sec,
+                            const uint32_t uSec, const char* Message) {
+  body.clear();
+  body.push_back(FrameRow);
+  body.push_back(static_cast<char>(Level));
+  put_varint(&body, Sec);
+  put_varint(&body, uSec);
+  body.append(Message);
+  frame(body.data(), body.size());
+}
+
+/**
+ * @brief Start encoding log record
+ *
+ * @param Level logging level
+ * @param Sec seconds since system start
+ * @param uSec microseconds in current second
+ *
+ */
+void rvs::LogBinWriter::record_begin(const int Level, const uint32_t Sec,
+                                     const uint32_t uSec) {
+  body.clear();
+  body.push_back(FrameRecord);
+  body.push_back(static_cast<char>(Level));
+  put_varint(&body, Sec);
+  put_varint(&body, uSec);
+}
+
+/**
+ * @brief Output log record started with record_begin()
+ *
+ */
+void rvs::LogBinWriter::record_end() {
+  frame(body.data(), body.size());
+}
+
+/**
+ * @brief Start nested node
+ *
+ * @param Name node name
+ *
+ */
+void rvs::LogBinWriter::begin_object(const char* Name) {
+  uint32_t name = symbol(Name, strlen(Name));
+  body.push_back(ItemBegin);
+  put_varint(&body, name);
+}
+
+/**
+ * @brief End nested node started with begin_object()
+ *
+ */
+void rvs::LogBinWriter::end_object() {
+  body.push_back(ItemEnd);
+}
+
+/**
+ * @brief Output string member
+ *
+ * Short values are interned while symbol table has room for them.
+ *
+ * @param Name member name
+ * @param Value member value
+ *
+ */
+void rvs::LogBinWriter::member(const char* Name, const char* Value) {
+  uint32_t name = symbol(Name, strlen(Name));
+  size_t len = strlen(Value);
+  uint32_t id;
+
+  if (find_value(Value, len, &id)) {
+    body.push_back(ItemStrRef);
+    put_varint(&body, name);
+    put_varint(&body, id);
+    return;
+  }
+
+  body.push_back(ItemString);
+  put_varint(&body, name);
+  put_varint(&body, len);
+  body.append(Value, len);
+}
+
+/**
+ * @brief Output integer member
+ *
+ * @param Name member name
+ * @param Value member value
+ *
+ */
+void rvs::LogBinWriter::member(const char* Name, const int64_t Value) {
+  uint32_t name = symbol(Name, strlen(Name));
+  uint64_t zigzag = (static_cast<uint64_t>(Value) << 1) ^
+                    static_cast<uint64_t>(Value >> 63);
+
+  body.push_back(ItemInt);
+  put_varint(&body, name);
+  put_varint(&body, zigzag);
+}
+
+/**
+ * @brief Output unsigned integer member
+ *
+ * @param Name member name
+ * @param Value member value
+ *
+ */
+void rvs::LogBinWriter::member(const char* Name, const uint64_t Value) {
+  uint32_t name = symbol(Name, strlen(Name));
+
+  body.push_back(ItemUint);
+  put_varint(&body, name);
+  put_varint(&body, Value);
+}
+
+/**
+ * @brief Output floating point member
+ *
+ * @param Name member name
+ * @param Value member value
+ *
+ */
+void rvs::LogBinWriter::member(const char* Name, const double Value) {
+  uint32_t name = symbol(Name, strlen(Name));
+
+  body.push_back(ItemDouble);
+  put_varint(&body, name);
+  put_double(&body, Value);
+}
+
+/**
+ * @brief Output boolean member
+ *
+ * @param Name member name
+ * @param Value member value
+ *
+ */
+void rvs::LogBinWriter::member(const char* Name, const bool Value) {
+  uint32_t name = symbol(Name, strlen(Name));
+
+  body.push_back(ItemBool);
+  put_varint(&body, name);
+  body.push_back(Value ? 1 : 0);
+}
+
+/**
+ * @brief Output array of integers
+ *
+ * @param Name member name
+ * @param Values array elements
+ * @param Count number of elements
+ *
+ */
+void rvs::LogBinWriter::member(const char* Name, const int64_t* Values,
+                               const size_t Count) {
+  uint32_t name = symbol(Name, strlen(Name));
+
+  body.push_back(ItemArray);
+  put_varint(&body, name);
+  body.push_back(ItemInt);
+  put_varint(&body, Count);
+  for (size_t i = 0; i < Count; i++) {
+    put_varint(&body, (static_cast<uint64_t>(Values[i]) << 1) ^
+                      static_cast<uint64_t>(Values[i] >> 63));
+  }
+}
+
+/**
+ * @brief Output array of unsigned integers
+ *
+ * @param Name member name
+ * @param Values array elements
+ * @param Count number of elements
+ *
+ */
+void rvs::LogBinWriter::member(const char* Name, const uint64_t* Values,
+                               const size_t Count) {
+  uint32_t name = symbol(Name, strlen(Name));
+
+  body.push_back(ItemArray);
+  put_varint(&body, name);
+  body.push_back(ItemUint);
+  put_varint(&body, Count);
+  for (size_t i = 0; i < Count; i++) {
+    put_varint(&body, Values[i]);
+  }
+}
+
+/**
+ * @brief Output array of doubles
+ *
+ * @param Name member name
+ * @param Values array elements
+ * @param Count number of elements
+ *
+ */
+void rvs::LogBinWriter::member(const char* Name, const double* Values,
+                               const size_t Count) {
+  uint32_t name = symbol(Name, strlen(Name));
+
+  body.push_back(ItemArray);
+  put_varint(&body, name);
+  body.push_back(ItemDouble);
+  put_varint(&body, Count);
+  for (size_t i = 0; i < Count; i++) {
+    put_double(&body, Values[i]);
+  }
+}
+
+/**
+ * @brief Append LEB128 encoded unsigned integer
+ *
+ * @param pOut output string
+ * @param Value value to encode
+ *
+ */
+void rvs::LogBinWriter::put_varint(std::string* pOut, uint64_t Value) {
+  while (Value >= 0x80) {
+    pOut->push_back(static_cast<char>((Value & 0x7f) | 0x80));
+    Value >>= 7;
+  }
+  pOut->push_back(static_cast<char>(Value));
+}
+
+/**
+ * @brief Append little endian IEEE 754 double
+ *
+ * @param pOut output string
+ * @param Value value to encode
+ *
+ */
+void rvs::LogBinWriter::put_double(std::string* pOut, const double Value) {
+  uint64_t bits;
+  memcpy(&bits, &Value, sizeof(bits));
+  for (int i = 0; i < 8; i++) {
+    pOut->push_back(static_cast<char>((bits >> (8 * i)) & 0xff));
+  }
+}
+
+/**
+ * @brief Get symbol id of the string, interning it if needed
+ *
+ * New symbols are output as Symbol frames ahead of the record using them.
+ *
+ * @param Str string
+ * @param Len string length
+ * @return symbol id
+ *
+ */
+uint32_t rvs::LogBinWriter::symbol(const char* Str, const size_t Len) {
+  key.assign(Str, Len);
+  auto it = symbols.find(key);
+  if (it != symbols.end()) {
+    return it->second;
+  }
+
+  uint32_t id = static_cast<uint32_t>(symbols.size());
+  symbols.emplace(key, id);
+
+  // record body is still being built, so use lookup key as scratch
+  key.clear();
+  key.push_back(FrameSymbol);
+  put_varint(&key, id);
+  key.append(Str, Len);
+  frame(key.data(), key.size());
+
+  return id;
+}
+
+/**
+ * @brief Find or intern string value
+ *
+ * @param Str string value
+ * @param Len string length
+ * @param pId [out] symbol id
+ * @return 'true' if value is interned, 'false' if it is to be output inline
+ *
+ */
+bool rvs::LogBinWriter::find_value(const char* Str, const size_t Len,
+                                   uint32_t* pId) {
+  if (Len > RVS_LOGBIN_INTERN_LEN) {
+    return false;
+  }
+
+  key.assign(Str, Len);
+  auto it = symbols.find(key);
+  if (it != symbols.end()) {
+    *pId = it->second;
+    return true;
+  }
+
+  if (values >= RVS_LOGBIN_INTERN_MAX) {
+    return false;
+  }
+
+  values++;
+  *pId = symbol(Str, Len);
+  return true;
+}
+
+/**
+ * @brief Output frame
+ *
+ * @param pBody frame body
+ * @param Len frame body length
+ *
+ */
+void rvs::LogBinWriter::frame(const char* pBody, const size_t Len) {
+  uint32_t frame_len = static_cast<uint32_t>(Len);
+  for (int i = 0; i < 4; i++) {
+    out->push_back(static_cast<char>((frame_len >> (8 * i)) & 0xff));
+  }
+  out->append(pBody, Len);
+}
+
+/**
+ * @brief Constructor
+ *
+ */
+rvs::LogBinReader::LogBinReader()
+:
+fd(-1),
+buffer(nullptr),
+size(0),
+pos(0),
+len(0) {
+}
+
+//! Destructor
+rvs::LogBinReader::~LogBinReader() {
+  close();
+}
+
+/**
+ * @brief Open binary log file
+ *
+ * @param FileName file name
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int rvs::LogBinReader::open(const std::string& FileName) {
+  close();
+
+  fd = ::open(FileName.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return -1;
+  }
+
+  size = RVS_LOGBIN_READ_SIZE;
+  buffer = new char[size];
+  pos = 0;
+  len = 0;
+
+  return 0;
+}
+
+/**
+ * @brief Read next frame
+ *
+ * Returned frame body stays valid until the next call.
+ *
+ * @param ppBody [out] frame body
+ * @param pLen [out] frame body length
+ * @return 1 - frame read, 0 - end of file, -1 - error or truncated file
+ *
+ */
+int rvs::LogBinReader::next(const char** ppBody, size_t* pLen) {
+  if (fd < 0) {
+    return -1;
+  }
+
+  int sts = fill(4);
+  if (sts <= 0) {
+    // clean end of file only if there are no leftover bytes
+    return (sts == 0 && pos == len) ? 0 : -1;
+  }
+
+  const unsigned char* p = reinterpret_cast<unsigned char*>(buffer + pos);
+  size_t frame_len = p[0] | (p[1] << 8) | (p[2] << 16) |
+                     (static_cast<size_t>(p[3]) << 24);
+
+  if (fill(4 + frame_len) <= 0) {
+    return -1;
+  }
+
+  *ppBody = buffer + pos + 4;
+  *pLen = frame_len;
+  pos += 4 + frame_len;
+
+  return 1;
+}
+
+/**
+ * @brief Close file
+ *
+ */
+void rvs::LogBinReader::close() {
+  if (fd >= 0) {
+    ::close(fd);
+    fd = -1;
+  }
+
+  delete [] buffer;
+  buffer = nullptr;
+  size = 0;
+  pos = 0;
+  len = 0;
+}
+
+/**
+ * @brief Decode LEB128 encoded unsigned integer
+ *
+ * @param ppData [in/out] data pointer, advanced past the value
+ * @param pEnd end of data
+ * @param pValue [out] decoded value
+ * @return 'true' - success, 'false' if data ends prematurely
+ *
+ */
+bool rvs::LogBinReader::get_varint(const char** ppData, const char* pEnd,
+                                   uint64_t* pValue) {
+  uint64_t value = 0;
+  int shift = 0;
+  const char* p = *ppData;
+
+  while (p < pEnd && shift < 64) {
+    unsigned char c = static_cast<unsigned char>(*p++);
+    value |= static_cast<uint64_t>(c & 0x7f) << shift;
+    if ((c & 0x80) == 0) {
+      *ppData = p;
+      *pValue = value;
+      return true;
+    }
+    shift += 7;
+  }
+
+  return false;
+}
+
+/**
+ * @brief Decode little endian IEEE 754 double
+ *
+ * @param ppData [in/out] data pointer, advanced past the value
+ * @param pEnd end of data
+ * @param pValue [out] decoded value
+ * @return 'true' - success, 'false' if data ends prematurely
+ *
+ */
+bool rvs::LogBinReader::get_double(const char** ppData, const char* pEnd,
+                                   double* pValue) {
+  const unsigned char* p = reinterpret_cast<const unsigned char*>(*ppData);
+  if (pEnd - *ppData < 8) {
+    return false;
+  }
+
+  uint64_t bits = 0;
+  for (int i = 0; i < 8; i++) {
+    bits |= static_cast<uint64_t>(p[i]) << (8 * i);
+  }
+  memcpy(pValue, &bits, sizeof(bits));
+  *ppData += 8;
+
+  return true;
+}
+
+/**
+ * @brief Make sure buffer holds at least given number of unconsumed bytes
+ *
+ * @param Size number of bytes needed
+ * @return 1 - success, 0 - end of file reached first, -1 - error
+ *
+ */
+int rvs::LogBinReader::fill(const size_t Size) {
+  if (len - pos >= Size) {
+    return 1;
+  }
+
+  // move unconsumed data to the start, growing buffer for large frames
+  if (Size > size) {
+    size_t new_size = size * 2 > Size ? size * 2 : Size;
+    char* p = new char[new_size];
+    memcpy(p, buffer + pos, len - pos);
+    delete [] buffer;
+    buffer = p;
+    size = new_size;
+  } else {
+    memmove(buffer, buffer + pos, len - pos);
+  }
+  len -= pos;
+  pos = 0;
+
+  while (len < Size) {
+    ssize_t n = ::read(fd, buffer + len, size - len);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return -1;
+    }
+    if (n == 0) {
+      return 0;
+    }
+    len += n;
+  }
+
+  return 1;
+}
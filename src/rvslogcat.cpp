@@ -0,0 +1,482 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvslogcat.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include <string>
+#include <vector>
+
+#include "include/rvsliblogger.h"
+#include "include/rvslogbin.h"
+#include "include/rvslognodebase.h"
+
+/**
+ * @brief Constructor
+ *
+ * @param Format output format
+ * @param OutFd file descriptor converted output is written to
+ *
+ */
+rvs::LogCat::LogCat(const eformat Format, const int OutFd)
+:
+format(Format),
+fd(OutFd),
+sessions(0),
+first_row(true),
+first_record(true) {
+  out.reserve(RVS_LOGCAT_BUFFER_SIZE + RVS_LOGCAT_BUFFER_SIZE / 4);
+}
+
+//! Destructor
+rvs::LogCat::~LogCat() {
+}
+
+/**
+ * @brief Convert binary log file
+ *
+ * @param FileName binary log file name
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int rvs::LogCat::convert(const std::string& FileName) {
+  LogBinReader reader;
+  const char* body;
+  size_t len;
+  int sts;
+
+  if (reader.open(FileName)) {
+    return -1;
+  }
+
+  if (format == json || format == compact) {
+    out += "[";
+  }
+
+  while ((sts = reader.next(&body, &len)) == 1) {
+    if (len == 0) {
+      return -1;
+    }
+
+    const char* end = body + len;
+    switch (body[0]) {
+    case FrameSession:
+        sts = do_session(body + 1, end);
+        break;
+    case FrameSymbol:
+        sts = do_symbol(body + 1, end);
+        break;
+    case FrameRow:
+        sts = do_row(body + 1, end);
+        break;
+    case FrameRecord:
+        sts = do_record(body + 1, end);
+        break;
+    default:
+        sts = -1;
+        break;
+    }
+
+    if (sts) {
+      return -1;
+    }
+
+    if (write_out(false)) {
+      return -1;
+    }
+  }
+
+  if (sts < 0) {
+    return -1;
+  }
+
+  // closing as done by rvs::logger::terminate()
+  if (format == text && sessions > 0) {
+    out += RVSENDL;
+  } else if (format == json || format == compact) {
+    out += RVSENDL "]";
+  }
+
+  return write_out(true);
+}
+
+/**
+ * @brief Process session frame
+ *
+ * @param pBody frame body (after frame type)
+ * @param pEnd end of frame body
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int rvs::LogCat::do_session(const char* pBody, const char* pEnd) {
+  size_t magic_len = strlen(RVS_LOGBIN_MAGIC);
+  if (static_cast<size_t>(pEnd - pBody) != magic_len + 1 ||
+      memcmp(pBody, RVS_LOGBIN_MAGIC, magic_len) != 0 ||
+      pBody[magic_len] < 1 || pBody[magic_len] > RVS_LOGBIN_VERSION) {
+    return -1;
+  }
+
+  // previous session was terminated with new line
+  if (format == text && sessions > 0) {
+    out += RVSENDL;
+  }
+
+  sessions++;
+  first_row = true;
+  symbols.clear();
+
+  return 0;
+}
+
+/**
+ * @brief Process symbol frame
+ *
+ * @param pBody frame body (after frame type)
+ * @param pEnd end of frame body
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int rvs::LogCat::do_symbol(const char* pBody, const char* pEnd) {
+  uint64_t id;
+  if (!LogBinReader::get_varint(&pBody, pEnd, &id) || id != symbols.size()) {
+    return -1;
+  }
+
+  symbols.emplace_back(pBody, pEnd - pBody);
+
+  return 0;
+}
+
+/**
+ * @brief Process text row frame
+ *
+ * @param pBody frame body (after frame type)
+ * @param pEnd end of frame body
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int rvs::LogCat::do_row(const char* pBody, const char* pEnd) {
+  uint64_t sec;
+  uint64_t usec;
+
+  if (pBody >= pEnd) {
+    return -1;
+  }
+  int level = *pBody++;
+  if (!LogBinReader::get_varint(&pBody, pEnd, &sec) ||
+      !LogBinReader::get_varint(&pBody, pEnd, &usec)) {
+    return -1;
+  }
+
+  // text rows are not part of JSON output
+  if (format != text) {
+    return 0;
+  }
+
+  if (!first_row) {
+    out += RVSENDL;
+  }
+  first_row = false;
+
+  char  buff[64];
+  snprintf(buff, sizeof(buff), "%6d.%-6d", static_cast<int>(sec),
+           static_cast<int>(usec));
+
+  out += "[";
+  out += logger::level_name(level);
+  out += "] [";
+  out += buff;
+  out += "] ";
+  out.append(pBody, pEnd - pBody);
+
+  return 0;
+}
+
+/**
+ * @brief Process log record frame
+ *
+ * @param pBody frame body (after frame type)
+ * @param pEnd end of frame body
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int rvs::LogCat::do_record(const char* pBody, const char* pEnd) {
+  uint64_t sec;
+  uint64_t usec;
+
+  if (pBody >= pEnd) {
+    return -1;
+  }
+  int level = *pBody++;
+  if (!LogBinReader::get_varint(&pBody, pEnd, &sec) ||
+      !LogBinReader::get_varint(&pBody, pEnd, &usec)) {
+    return -1;
+  }
+
+  // records are not part of text output
+  if (format == text) {
+    return 0;
+  }
+
+  // record separators as output by rvs::logger::RecordOut()
+  if (format != jsonl && !first_record) {
+    out += ",";
+  }
+  first_record = false;
+  if (format == compact) {
+    out += RVSENDL;
+  }
+
+  JsonWriter writer(&out,
+    format == json ? JsonWriter::pretty : JsonWriter::compact,
+    format == json ? RVSINDENT : "");
+
+  writer.begin_object();
+  writer.member("loglevel", static_cast<int64_t>(level));
+  writer.separator();
+
+  char  buff[64];
+  snprintf(buff, sizeof(buff), "%6d.%-6d", static_cast<int>(sec),
+           static_cast<int>(usec));
+  writer.member("time", buff);
+  if (pBody < pEnd || format == json) {
+    writer.separator();
+  }
+
+  if (do_items(&writer, pBody, pEnd)) {
+    return -1;
+  }
+
+  writer.end_object();
+
+  if (format == jsonl) {
+    out += RVSENDL;
+  }
+
+  return 0;
+}
+
+/**
+ * @brief Convert record items into JSON
+ *
+ * @param pWriter JSON writer
+ * @param pData first item
+ * @param pEnd end of items
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int rvs::LogCat::do_items(JsonWriter* pWriter, const char* pData,
+                          const char* pEnd) {
+  // per nesting level: 'true' until the first member is output
+  std::vector<bool> first(1, true);
+  uint64_t val;
+
+  while (pData < pEnd) {
+    char tag = *pData++;
+
+    if (tag == ItemEnd) {
+      if (first.size() < 2) {
+        return -1;
+      }
+      first.pop_back();
+      pWriter->end_object();
+      continue;
+    }
+
+    if (!first.back()) {
+      pWriter->separator();
+    }
+    first.back() = false;
+
+    const char* name = get_symbol(&pData, pEnd);
+    if (name == nullptr) {
+      return -1;
+    }
+
+    switch (tag) {
+    case ItemBegin:
+        pWriter->begin_object(name);
+        first.push_back(true);
+        break;
+    case ItemString:
+        if (!LogBinReader::get_varint(&pData, pEnd, &val) ||
+            val > static_cast<uint64_t>(pEnd - pData)) {
+          return -1;
+        }
+        value.assign(pData, val);
+        pData += val;
+        pWriter->member(name, value.c_str());
+        break;
+    case ItemStrRef: {
+        const char* ref = get_symbol(&pData, pEnd);
+        if (ref == nullptr) {
+          return -1;
+        }
+        pWriter->member(name, ref);
+        break;
+      }
+    case ItemInt:
+        if (!LogBinReader::get_varint(&pData, pEnd, &val)) {
+          return -1;
+        }
+        pWriter->member(name, static_cast<int64_t>(val >> 1) ^
+                              -static_cast<int64_t>(val & 1));
+        break;
+    case ItemUint:
+        if (!LogBinReader::get_varint(&pData, pEnd, &val)) {
+          return -1;
+        }
+        pWriter->member(name, val);
+        break;
+    case ItemDouble: {
+        double d;
+        if (!LogBinReader::get_double(&pData, pEnd, &d)) {
+          return -1;
+        }
+        pWriter->member(name, d);
+        break;
+      }
+    case ItemBool:
+        if (pData >= pEnd) {
+          return -1;
+        }
+        pWriter->member(name, *pData++ != 0);
+        break;
+    case ItemArray:
+        pWriter->begin_array(name);
+        if (do_array(pWriter, &pData, pEnd)) {
+          return -1;
+        }
+        pWriter->end_array();
+        break;
+    default:
+        return -1;
+    }
+  }
+
+  return first.size() == 1 ? 0 : -1;
+}
+
+/**
+ * @brief Convert elements of array item into JSON
+ *
+ * @param pWriter JSON writer
+ * @param ppData [in/out] data pointer (at element tag), advanced past
+ * the array
+ * @param pEnd end of items
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int rvs::LogCat::do_array(JsonWriter* pWriter, const char** ppData,
+                          const char* pEnd) {
+  uint64_t count;
+  uint64_t val;
+  double d;
+
+  if (*ppData >= pEnd) {
+    return -1;
+  }
+  char tag = *(*ppData)++;
+  if ((tag != ItemInt && tag != ItemUint && tag != ItemDouble) ||
+      !LogBinReader::get_varint(ppData, pEnd, &count)) {
+    return -1;
+  }
+
+  for (uint64_t i = 0; i < count; i++) {
+    switch (tag) {
+    case ItemInt:
+        if (!LogBinReader::get_varint(ppData, pEnd, &val)) {
+          return -1;
+        }
+        pWriter->element(static_cast<int64_t>(val >> 1) ^
+                         -static_cast<int64_t>(val & 1));
+        break;
+    case ItemUint:
+        if (!LogBinReader::get_varint(ppData, pEnd, &val)) {
+          return -1;
+        }
+        pWriter->element(val);
+        break;
+    case ItemDouble:
+        if (!LogBinReader::get_double(ppData, pEnd, &d)) {
+          return -1;
+        }
+        pWriter->element(d);
+        break;
+    default:
+        return -1;
+    }
+  }
+
+  return 0;
+}
+
+/**
+ * @brief Decode symbol reference
+ *
+ * @param ppData [in/out] data pointer, advanced past the reference
+ * @param pEnd end of data
+ * @return symbol text, nullptr if reference is not valid
+ *
+ */
+const char* rvs::LogCat::get_symbol(const char** ppData, const char* pEnd) {
+  uint64_t id;
+  if (!LogBinReader::get_varint(ppData, pEnd, &id) || id >= symbols.size()) {
+    return nullptr;
+  }
+
+  return symbols[id].c_str();
+}
+
+/**
+ * @brief Write converted output
+ *
+ * @param Force 'true' to write regardless of the amount of buffered output
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int rvs::LogCat::write_out(const bool Force) {
+  if (!Force && out.size() < RVS_LOGCAT_BUFFER_SIZE) {
+    return 0;
+  }
+
+  size_t done = 0;
+  while (done < out.size()) {
+    ssize_t n = ::write(fd, out.data() + done, out.size() - done);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return -1;
+    }
+    done += n;
+  }
+  out.clear();
+
+  return 0;
+}
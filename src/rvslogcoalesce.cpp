@@ -0,0 +1,313 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvslogcoalesce.h"
+
+#include <ctype.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Constructor
+ *
+ */
+rvs::LogCoalesce::LogCoalesce()
+:
+last_scan(0) {
+  for (int i = 0; i < RVS_LOGCOALESCE_LEVELS; i++) {
+    window_ms[i] = 0;
+    burst[i] = 1;
+  }
+}
+
+//! Destructor
+rvs::LogCoalesce::~LogCoalesce() {
+}
+
+/**
+ * @brief Configure coalescing for the given logging level
+ *
+ * @param Level logging level
+ * @param WindowMs window length in milliseconds (0 - no coalescing)
+ * @param Burst number of messages passed in each window (at least 1)
+ *
+ */
+void rvs::LogCoalesce::set_window(const int Level, const unsigned int WindowMs,
+                                  const unsigned int Burst) {
+  if (Level < 0 || Level >= RVS_LOGCOALESCE_LEVELS) {
+    return;
+  }
+
+  window_ms[Level] = WindowMs;
+  burst[Level] = Burst ? Burst : 1;
+}
+
+/**
+ * @brief Check if coalescing is configured for the given logging level
+ *
+ * @param Level logging level
+ * @return 'true' if messages of this level are coalesced
+ *
+ */
+bool rvs::LogCoalesce::enabled(const int Level) const {
+  if (Level < 0 || Level >= RVS_LOGCOALESCE_LEVELS) {
+    return false;
+  }
+
+  return window_ms[Level] > 0;
+}
+
+/**
+ * @brief Check if coalescing is configured for any logging level
+ *
+ * @return 'true' if messages of at least one level are coalesced
+ *
+ */
+bool rvs::LogCoalesce::enabled() const {
+  for (int i = 0; i < RVS_LOGCOALESCE_LEVELS; i++) {
+    if (window_ms[i] > 0) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * @brief Decide whether message is to be output
+ *
+ * If the message closes previous window of the same message, summary of
+ * that window is appended to pClosed.
+ *
+ * @param Message message text
+ * @param Level logging level
+ * @param Now current time (ms)
+ * @param pClosed [out] summaries of closed windows
+ * @return 'true' if message is to be output, 'false' if suppressed
+ *
+ */
+bool rvs::LogCoalesce::admit(const char* Message, const int Level,
+                             const uint64_t Now,
+                             std::vector<T_LOGREPEAT>* pClosed) {
+  if (!enabled(Level)) {
+    return true;
+  }
+
+  std::string action;
+  std::string module;
+  std::string k = key(Message, Level, &action, &module);
+
+  std::lock_guard<std::mutex> lk(mtx);
+
+  auto it = windows.find(k);
+  if (it != windows.end() &&
+      Now - it->second.repeat.first >= window_ms[Level]) {
+    close(it->second, pClosed);
+    windows.erase(it);
+    it = windows.end();
+  }
+
+  if (it == windows.end()) {
+    if (windows.size() >= RVS_LOGCOALESCE_MAX) {
+      scan(Now, pClosed);
+      // too many distinct messages, pass the rest through
+      if (windows.size() >= RVS_LOGCOALESCE_MAX) {
+        return true;
+      }
+    }
+
+    window& w = windows[k];
+    w.passed = 1;
+    w.repeat.action = action;
+    w.repeat.module = module;
+    w.repeat.level = Level;
+    w.repeat.count = 0;
+    w.repeat.first = Now;
+    w.repeat.last = Now;
+    return true;
+  }
+
+  window& w = it->second;
+  if (w.passed < burst[Level]) {
+    w.passed++;
+    return true;
+  }
+
+  w.repeat.count++;
+  w.repeat.message = Message;
+  w.repeat.last = Now;
+
+  return false;
+}
+
+/**
+ * @brief Close expired windows
+ *
+ * Scans for expired windows at most once per RVS_LOGCOALESCE_SCAN_MS.
+ *
+ * @param Now current time (ms)
+ * @param pClosed [out] summaries of closed windows
+ *
+ */
+void rvs::LogCoalesce::expire(const uint64_t Now,
+                              std::vector<T_LOGREPEAT>* pClosed) {
+  if (Now - last_scan < RVS_LOGCOALESCE_SCAN_MS) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lk(mtx);
+  scan(Now, pClosed);
+}
+
+/**
+ * @brief Close all open windows
+ *
+ * @param pClosed [out] summaries of closed windows
+ *
+ */
+void rvs::LogCoalesce::drain(std::vector<T_LOGREPEAT>* pClosed) {
+  std::lock_guard<std::mutex> lk(mtx);
+
+  for (auto it = windows.begin(); it != windows.end(); ++it) {
+    close(it->second, pClosed);
+  }
+  windows.clear();
+}
+
+/**
+ * @brief Build coalescing key of the message
+ *
+ * Message is expected to follow "[action] module device text" pattern, where
+ * device is optional numeric id. Numbers in the text are masked, so that
+ * messages differing only in measured values map to the same key.
+ *
+ * @param Message message text
+ * @param Level logging level
+ * @param pAction [out] action name (empty if not present)
+ * @param pModule [out] module name (empty if not present)
+ * @return coalescing key
+ *
+ */
+std::string rvs::LogCoalesce::key(const char* Message, const int Level,
+                                  std::string* pAction,
+                                  std::string* pModule) {
+  const char* p = Message;
+  std::string device;
+
+  pAction->clear();
+  pModule->clear();
+
+  const char* end = (*p == '[') ? strchr(p, ']') : nullptr;
+  if (end) {
+    pAction->assign(p + 1, end);
+    p = end + 1;
+    while (*p == ' ') {
+      p++;
+    }
+
+    const char* word = p;
+    while (*p && *p != ' ') {
+      p++;
+    }
+    pModule->assign(word, p);
+    while (*p == ' ') {
+      p++;
+    }
+
+    word = p;
+    while (isdigit(*p)) {
+      p++;
+    }
+    if (p > word && (*p == ' ' || *p == '\0')) {
+      device.assign(word, p);
+    } else {
+      p = word;
+    }
+  }
+
+  std::string k;
+  k.reserve(strlen(Message) + 8);
+  k += static_cast<char>('0' + Level);
+  k += '\x1f';
+  k += *pAction;
+  k += '\x1f';
+  k += *pModule;
+  k += '\x1f';
+  k += device;
+  k += '\x1f';
+
+  while (*p) {
+    if (isdigit(*p)) {
+      // mask number including decimal part
+      k += '#';
+      while (isdigit(*p) || (*p == '.' && isdigit(p[1]))) {
+        p++;
+      }
+      continue;
+    }
+    k += *p++;
+  }
+
+  return k;
+}
+
+/**
+ * @brief Report window summary if any message was suppressed in it
+ *
+ * @param Window window being closed
+ * @param pClosed [out] summaries of closed windows
+ *
+ */
+void rvs::LogCoalesce::close(const window& Window,
+                             std::vector<T_LOGREPEAT>* pClosed) {
+  if (Window.repeat.count) {
+    pClosed->push_back(Window.repeat);
+  }
+}
+
+/**
+ * @brief Close expired windows
+ *
+ * Note: caller is expected to hold mtx.
+ *
+ * @param Now current time (ms)
+ * @param pClosed [out] summaries of closed windows
+ *
+ */
+void rvs::LogCoalesce::scan(const uint64_t Now,
+                            std::vector<T_LOGREPEAT>* pClosed) {
+  last_scan = Now;
+
+  for (auto it = windows.begin(); it != windows.end();) {
+    const T_LOGREPEAT& r = it->second.repeat;
+    if (Now - r.first >= window_ms[r.level]) {
+      close(it->second, pClosed);
+      it = windows.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
@@ -25,7 +25,10 @@
 #include "include/rvsloglp.h"
 
 #include <chrono>
+#include <map>
+#include <mutex>
 #include <string>
+#include <vector>
 
 
 using std::string;
@@ -51,10 +54,32 @@ int   rvs::lp::Initialize(const T_MODULE_INIT* pMi) {
   mi.cbStop            = pMi->cbStop;
   mi.cbStopping        = pMi->cbStopping;
   mi.cbErr             = pMi->cbErr;
+  mi.pLogLevel         = pMi->pLogLevel;
+  mi.cbAddInt64        = pMi->cbAddInt64;
+  mi.cbAddUint64       = pMi->cbAddUint64;
+  mi.cbAddDouble       = pMi->cbAddDouble;
+  mi.cbAddBool         = pMi->cbAddBool;
+  mi.cbAddInt64Array   = pMi->cbAddInt64Array;
+  mi.cbAddUint64Array  = pMi->cbAddUint64Array;
+  mi.cbAddDoubleArray  = pMi->cbAddDoubleArray;
+  mi.cbPhaseBegin      = pMi->cbPhaseBegin;
+  mi.cbPhaseEnd        = pMi->cbPhaseEnd;
+  mi.cbShared          = pMi->cbShared;
 
   return 0;
 }
 
+/**
+ * @brief Check if messages of given logging level are output
+ *
+ * @param level Logging level
+ * @return 'true' if messages of this level are output
+ *
+ */
+bool rvs::lp::Enabled(const int level) {
+  return mi.pLogLevel == nullptr || level <= *mi.pLogLevel;
+}
+
 /**
  * @brief Output log message
  *
@@ -184,6 +209,162 @@ void  rvs::lp::AddInt(void* Parent, const char* Key, const int Val) {
   (*mi.cbAddInt)(Parent, Key, Val);
 }
 
+/**
+ * @brief Create and add child node of type 64-bit int to the given parent
+ *
+ * Note: this API is used to construct JSON output.
+ *
+ * @param Parent Parent node
+ * @param Key Key as C string
+ * @param Val Value as 64-bit int
+ *
+ */
+void  rvs::lp::AddInt64(void* Parent, const char* Key, const int64_t Val) {
+  (*mi.cbAddInt64)(Parent, Key, Val);
+}
+
+/**
+ * @brief Create and add child node of type unsigned 64-bit int to the given
+ * parent node
+ *
+ * Note: this API is used to construct JSON output.
+ *
+ * @param Parent Parent node
+ * @param Key Key as C string
+ * @param Val Value as unsigned 64-bit int
+ *
+ */
+void  rvs::lp::AddUint64(void* Parent, const char* Key, const uint64_t Val) {
+  (*mi.cbAddUint64)(Parent, Key, Val);
+}
+
+/**
+ * @brief Create and add child node of type double to the given parent node
+ *
+ * Note: this API is used to construct JSON output.
+ *
+ * @param Parent Parent node
+ * @param Key Key as C string
+ * @param Val Value as double
+ *
+ */
+void  rvs::lp::AddDouble(void* Parent, const char* Key, const double Val) {
+  (*mi.cbAddDouble)(Parent, Key, Val);
+}
+
+/**
+ * @brief Create and add child node of type bool to the given parent node
+ *
+ * Note: this API is used to construct JSON output.
+ *
+ * @param Parent Parent node
+ * @param Key Key as C string
+ * @param Val Value as bool
+ *
+ */
+void  rvs::lp::AddBool(void* Parent, const char* Key, const bool Val) {
+  (*mi.cbAddBool)(Parent, Key, Val);
+}
+
+/**
+ * @brief Create and add child node holding array of 64-bit ints to the given
+ * parent node
+ *
+ * Note: this API is used to construct JSON output.
+ *
+ * @param Parent Parent node
+ * @param Key Key as C string
+ * @param Vals Array elements (copied into the node)
+ * @param Count Number of elements
+ *
+ */
+void  rvs::lp::AddArray(void* Parent, const char* Key, const int64_t* Vals,
+                        const size_t Count) {
+  (*mi.cbAddInt64Array)(Parent, Key, Vals, Count);
+}
+
+/**
+ * @brief Create and add child node holding array of 64-bit ints to the given
+ * parent node
+ *
+ * Note: this API is used to construct JSON output.
+ *
+ * @param Parent Parent node
+ * @param Key Key as C string
+ * @param Vals Array elements (copied into the node)
+ *
+ */
+void  rvs::lp::AddArray(void* Parent, const char* Key,
+                        const std::vector<int64_t>& Vals) {
+  (*mi.cbAddInt64Array)(Parent, Key, Vals.data(), Vals.size());
+}
+
+/**
+ * @brief Create and add child node holding array of unsigned 64-bit ints to
+ * the given parent node
+ *
+ * Note: this API is used to construct JSON output.
+ *
+ * @param Parent Parent node
+ * @param Key Key as C string
+ * @param Vals Array elements (copied into the node)
+ * @param Count Number of elements
+ *
+ */
+void  rvs::lp::AddArray(void* Parent, const char* Key, const uint64_t* Vals,
+                        const size_t Count) {
+  (*mi.cbAddUint64Array)(Parent, Key, Vals, Count);
+}
+
+/**
+ * @brief Create and add child node holding array of unsigned 64-bit ints to
+ * the given parent node
+ *
+ * Note: this API is used to construct JSON output.
+ *
+ * @param Parent Parent node
+ * @param Key Key as C string
+ * @param Vals Array elements (copied into the node)
+ *
+ */
+void  rvs::lp::AddArray(void* Parent, const char* Key,
+                        const std::vector<uint64_t>& Vals) {
+  (*mi.cbAddUint64Array)(Parent, Key, Vals.data(), Vals.size());
+}
+
+/**
+ * @brief Create and add child node holding array of doubles to the given
+ * parent node
+ *
+ * Note: this API is used to construct JSON output.
+ *
+ * @param Parent Parent node
+ * @param Key Key as C string
+ * @param Vals Array elements (copied into the node)
+ * @param Count Number of elements
+ *
+ */
+void  rvs::lp::AddArray(void* Parent, const char* Key, const double* Vals,
+                        const size_t Count) {
+  (*mi.cbAddDoubleArray)(Parent, Key, Vals, Count);
+}
+
+/**
+ * @brief Create and add child node holding array of doubles to the given
+ * parent node
+ *
+ * Note: this API is used to construct JSON output.
+ *
+ * @param Parent Parent node
+ * @param Key Key as C string
+ * @param Vals Array elements (copied into the node)
+ *
+ */
+void  rvs::lp::AddArray(void* Parent, const char* Key,
+                        const std::vector<double>& Vals) {
+  (*mi.cbAddDoubleArray)(Parent, Key, Vals.data(), Vals.size());
+}
+
 /**
  * @brief Add child node to parent
  *
@@ -265,3 +446,59 @@ int rvs::lp::Err(const std::string &Message
       , const std::string &Module, const std::string &Action) {
   return (*mi.cbErr)(Message.c_str(), Module.c_str(), Action.c_str());
 }
+
+/**
+ * @brief Start timing startup phase
+ *
+ * Phase is recorded by launcher startup profiler (if enabled) as nested in
+ * the launcher phase currently running on this thread.
+ *
+ * @param Phase phase name
+ * @return phase ID to be passed to PhaseEnd()
+ *
+ */
+int   rvs::lp::PhaseBegin(const char* Phase) {
+  if (mi.cbPhaseBegin == nullptr) {
+    return -1;
+  }
+  return (*mi.cbPhaseBegin)(Phase);
+}
+
+/**
+ * @brief Stop timing startup phase
+ *
+ * @param Id phase ID returned by PhaseBegin()
+ *
+ */
+void  rvs::lp::PhaseEnd(const int Id) {
+  if (mi.cbPhaseEnd != nullptr) {
+    (*mi.cbPhaseEnd)(Id);
+  }
+}
+
+/**
+ * @brief Get object shared by all modules of the process
+ *
+ * Each module links its own copy of rvslib, so data which should be built
+ * once per process (e.g. device registry) is kept by launcher. Object is
+ * created by the first module asking for it and never destroyed.
+ *
+ * @param Name object name
+ * @param Create function creating the object, called at most once
+ * @return object, nullptr if it could not be created
+ *
+ */
+void* rvs::lp::Shared(const char* Name, t_cbSharedCreate Create) {
+  if (mi.cbShared == nullptr) {
+    // module not loaded by launcher: object is private to this module
+    static std::mutex mtx;
+    static std::map<std::string, void*> objects;
+    std::lock_guard<std::mutex> lk(mtx);
+    auto it = objects.find(Name);
+    if (it == objects.end()) {
+      it = objects.emplace(Name, (*Create)()).first;
+    }
+    return it->second;
+  }
+  return (*mi.cbShared)(Name, Create);
+}
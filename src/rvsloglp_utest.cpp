@@ -25,7 +25,10 @@
 #include "include/rvsloglp.h"
 
 #include <chrono>
+#include <map>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include "include/rvsliblogger.h"
 
@@ -53,10 +56,32 @@ int   rvs::lp::Initialize(const T_MODULE_INIT* pMi) {
   mi.cbStop            = pMi->cbStop;
   mi.cbStopping        = pMi->cbStopping;
   mi.cbErr             = pMi->cbErr;
+  mi.pLogLevel         = pMi->pLogLevel;
+  mi.cbAddInt64        = pMi->cbAddInt64;
+  mi.cbAddUint64       = pMi->cbAddUint64;
+  mi.cbAddDouble       = pMi->cbAddDouble;
+  mi.cbAddBool         = pMi->cbAddBool;
+  mi.cbAddInt64Array   = pMi->cbAddInt64Array;
+  mi.cbAddUint64Array  = pMi->cbAddUint64Array;
+  mi.cbAddDoubleArray  = pMi->cbAddDoubleArray;
+  mi.cbPhaseBegin      = pMi->cbPhaseBegin;
+  mi.cbPhaseEnd        = pMi->cbPhaseEnd;
+  mi.cbShared          = pMi->cbShared;
 
   return 0;
 }
 
+/**
+ * @brief Check if messages of given logging level are output
+ *
+ * @param level Logging level
+ * @return 'true' if messages of this level are output
+ *
+ */
+bool rvs::lp::Enabled(const int level) {
+  return level <= rvs::logger::log_level();
+}
+
 /**
  * @brief Output log message
  *
@@ -186,6 +211,162 @@ void  rvs::lp::AddInt(void* Parent, const char* Key, const int Val) {
   rvs::logger::AddInt(Parent, Key, Val);
 }
 
+/**
+ * @brief Create and add child node of type 64-bit int to the given parent
+ *
+ * Note: this API is used to construct JSON output.
+ *
+ * @param Parent Parent node
+ * @param Key Key as C string
+ * @param Val Value as 64-bit int
+ *
+ */
+void  rvs::lp::AddInt64(void* Parent, const char* Key, const int64_t Val) {
+  rvs::logger::AddInt64(Parent, Key, Val);
+}
+
+/**
+ * @brief Create and add child node of type unsigned 64-bit int to the given
+ * parent node
+ *
+ * Note: this API is used to construct JSON output.
+ *
+ * @param Parent Parent node
+ * @param Key Key as C string
+ * @param Val Value as unsigned 64-bit int
+ *
+ */
+void  rvs::lp::AddUint64(void* Parent, const char* Key, const uint64_t Val) {
+  rvs::logger::AddUint64(Parent, Key, Val);
+}
+
+/**
+ * @brief Create and add child node of type double to the given parent node
+ *
+ * Note: this API is used to construct JSON output.
+ *
+ * @param Parent Parent node
+ * @param Key Key as C string
+ * @param Val Value as double
+ *
+ */
+void  rvs::lp::AddDouble(void* Parent, const char* Key, const double Val) {
+  rvs::logger::AddDouble(Parent, Key, Val);
+}
+
+/**
+ * @brief Create and add child node of type bool to the given parent node
+ *
+ * Note: this API is used to construct JSON output.
+ *
+ * @param Parent Parent node
+ * @param Key Key as C string
+ * @param Val Value as bool
+ *
+ */
+void  rvs::lp::AddBool(void* Parent, const char* Key, const bool Val) {
+  rvs::logger::AddBool(Parent, Key, Val);
+}
+
+/**
+ * @brief Create and add child node holding array of 64-bit ints to the given
+ * parent node
+ *
+ * Note: this API is used to construct JSON output.
+ *
+ * @param Parent Parent node
+ * @param Key Key as C string
+ * @param Vals Array elements (copied into the node)
+ * @param Count Number of elements
+ *
+ */
+void  rvs::lp::AddArray(void* Parent, const char* Key, const int64_t* Vals,
+                        const size_t Count) {
+  rvs::logger::AddInt64Array(Parent, Key, Vals, Count);
+}
+
+/**
+ * @brief Create and add child node holding array of 64-bit ints to the given
+ * parent node
+ *
+ * Note: this API is used to construct JSON output.
+ *
+ * @param Parent Parent node
+ * @param Key Key as C string
+ * @param Vals Array elements (copied into the node)
+ *
+ */
+void  rvs::lp::AddArray(void* Parent, const char* Key,
+                        const std::vector<int64_t>& Vals) {
+  rvs::logger::AddInt64Array(Parent, Key, Vals.data(), Vals.size());
+}
+
+/**
+ * @brief Create and add child node holding array of unsigned 64-bit ints to
+ * the given parent node
+ *
+ * Note: this API is used to construct JSON output.
+ *
+ * @param Parent Parent node
+ * @param Key Key as C string
+ * @param Vals Array elements (copied into the node)
+ * @param Count Number of elements
+ *
+ */
+void  rvs::lp::AddArray(void* Parent, const char* Key, const uint64_t* Vals,
+                        const size_t Count) {
+  rvs::logger::AddUint64Array(Parent, Key, Vals, Count);
+}
+
+/**
+ * @brief Create and add child node holding array of unsigned 64-bit ints to
+ * the given parent node
+ *
+ * Note: this API is used to construct JSON output.
+ *
+ * @param Parent Parent node
+ * @param Key Key as C string
+ * @param Vals Array elements (copied into the node)
+ *
+ */
+void  rvs::lp::AddArray(void* Parent, const char* Key,
+                        const std::vector<uint64_t>& Vals) {
+  rvs::logger::AddUint64Array(Parent, Key, Vals.data(), Vals.size());
+}
+
+/**
+ * @brief Create and add child node holding array of doubles to the given
+ * parent node
+ *
+ * Note: this API is used to construct JSON output.
+ *
+ * @param Parent Parent node
+ * @param Key Key as C string
+ * @param Vals Array elements (copied into the node)
+ * @param Count Number of elements
+ *
+ */
+void  rvs::lp::AddArray(void* Parent, const char* Key, const double* Vals,
+                        const size_t Count) {
+  rvs::logger::AddDoubleArray(Parent, Key, Vals, Count);
+}
+
+/**
+ * @brief Create and add child node holding array of doubles to the given
+ * parent node
+ *
+ * Note: this API is used to construct JSON output.
+ *
+ * @param Parent Parent node
+ * @param Key Key as C string
+ * @param Vals Array elements (copied into the node)
+ *
+ */
+void  rvs::lp::AddArray(void* Parent, const char* Key,
+                        const std::vector<double>& Vals) {
+  rvs::logger::AddDoubleArray(Parent, Key, Vals.data(), Vals.size());
+}
+
 /**
  * @brief Add child node to parent
  *
@@ -267,3 +448,43 @@ int rvs::lp::Err(const std::string &Message
       , const std::string &Module, const std::string &Action) {
   return rvs::logger::Err(Message.c_str(), Module.c_str(), Action.c_str());
 }
+
+/**
+ * @brief Start timing startup phase
+ *
+ * Phases are not timed in unit tests.
+ *
+ * @return -1 (no phase ID)
+ *
+ */
+int   rvs::lp::PhaseBegin(const char*) {
+  return -1;
+}
+
+/**
+ * @brief Stop timing startup phase
+ *
+ * Phases are not timed in unit tests.
+ *
+ */
+void  rvs::lp::PhaseEnd(const int) {
+}
+
+/**
+ * @brief Get object shared by all modules of the process
+ *
+ * @param Name object name
+ * @param Create function creating the object, called at most once
+ * @return object, nullptr if it could not be created
+ *
+ */
+void* rvs::lp::Shared(const char* Name, t_cbSharedCreate Create) {
+  static std::mutex mtx;
+  static std::map<std::string, void*> objects;
+  std::lock_guard<std::mutex> lk(mtx);
+  auto it = objects.find(Name);
+  if (it == objects.end()) {
+    it = objects.emplace(Name, (*Create)()).first;
+  }
+  return it->second;
+}
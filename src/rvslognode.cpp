@@ -25,6 +25,8 @@
 #include <string>
 
 #include "include/rvslognode.h"
+#include "include/rvsjsonwriter.h"
+#include "include/rvslogbin.h"
 #include "include/rvstrace.h"
 
 using std::string;
@@ -34,18 +36,30 @@ using std::string;
  *
  * @param Name Node name
  * @param Parent Pointer to parent node
+ * @param Arena Arena node is allocated from (nullptr if allocated with new)
  *
  */
-rvs::LogNode::LogNode(const char* Name, const LogNodeBase* Parent)
+rvs::LogNode::LogNode(const char* Name, const LogNodeBase* Parent,
+                      LogArena* Arena)
 :
-LogNodeBase(Name, Parent) {
+LogNodeBase(Name, Parent, Arena) {
   Type = eLN::List;
 }
 
 //! Destructor
 rvs::LogNode::~LogNode() {
-  for (auto it = Child.begin(); it != Child.end(); ++it) {
-    delete (*it);
+  // arena allocated nodes are released together with the arena
+  if (pArena) {
+    return;
+  }
+
+  LogNodeBase* p = Child.first();
+  while (p) {
+    LogNodeBase* next = LogNodeList::next(p);
+    if (p->Arena() == nullptr) {
+      delete p;
+    }
+    p = next;
   }
 }
 
@@ -60,28 +74,39 @@ void rvs::LogNode::Add(LogNodeBase* pChild) {
 }
 
 /**
- * @brief Provides JSON representation of Node
+ * @brief Writes JSON representation of Node
  *
- * Traverses list of child nodes and converts them into proper string representation.
- * Also ensures proper indentation and line breaks for formatted output.
+ * Traverses list of child nodes and streams them into the writer.
  *
- * @param Lead String of blanks " " representing current indentation
- * @return Node as JSON string
+ * @param pWriter JSON writer
  *
  */
-std::string rvs::LogNode::ToJson(const std::string& Lead) {
+void rvs::LogNode::WriteJson(JsonWriter* pWriter) {
   DTRACE_
-  string result(RVSENDL);
-  result += Lead + "\"" + Name + "\"" + " : {";
+  pWriter->begin_object(Name);
 
-  int  size = Child.size();
-  for (int i = 0; i < size; i++) {
-    result += Child[i]->ToJson(Lead + RVSINDENT);
-    if (i+ 1 < size) {
-      result += ",";
+  for (LogNodeBase* p = Child.first(); p; p = LogNodeList::next(p)) {
+    p->WriteJson(pWriter);
+    if (LogNodeList::next(p)) {
+      pWriter->separator();
     }
   }
-  result += RVSENDL + Lead + "}";
 
-  return result;
+  pWriter->end_object();
+}
+
+/**
+ * @brief Writes binary representation of Node
+ *
+ * @param pWriter binary log writer
+ *
+ */
+void rvs::LogNode::WriteBin(LogBinWriter* pWriter) {
+  pWriter->begin_object(Name);
+
+  for (LogNodeBase* p = Child.first(); p; p = LogNodeList::next(p)) {
+    p->WriteBin(pWriter);
+  }
+
+  pWriter->end_object();
 }
@@ -0,0 +1,165 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <string.h>
+
+#include <string>
+
+#include "include/rvslognodearray.h"
+#include "include/rvsjsonwriter.h"
+#include "include/rvslogbin.h"
+
+/**
+ * @brief Constructor
+ *
+ * @param Name Node name
+ * @param Vals Array of signed integers
+ * @param Num Number of elements
+ * @param Parent Pointer to parent node
+ * @param Arena Arena node is allocated from (nullptr if allocated with new)
+ *
+ */
+rvs::LogNodeArray::LogNodeArray(const char* Name, const int64_t* Vals,
+                                const size_t Num,
+                                const LogNodeBase* Parent, LogArena* Arena)
+:
+LogNodeBase(Name, Parent, Arena),
+ElemType(eLN::Integer),
+Count(Num) {
+  Type = eLN::Array;
+  Values.Int = static_cast<int64_t*>(CopyValues(Vals, Num * sizeof(*Vals)));
+}
+
+/**
+ * @brief Constructor
+ *
+ * @param Name Node name
+ * @param Vals Array of unsigned integers
+ * @param Num Number of elements
+ * @param Parent Pointer to parent node
+ * @param Arena Arena node is allocated from (nullptr if allocated with new)
+ *
+ */
+rvs::LogNodeArray::LogNodeArray(const char* Name, const uint64_t* Vals,
+                                const size_t Num,
+                                const LogNodeBase* Parent, LogArena* Arena)
+:
+LogNodeBase(Name, Parent, Arena),
+ElemType(eLN::Unsigned),
+Count(Num) {
+  Type = eLN::Array;
+  Values.Uint = static_cast<uint64_t*>(CopyValues(Vals,
+                                                  Num * sizeof(*Vals)));
+}
+
+/**
+ * @brief Constructor
+ *
+ * @param Name Node name
+ * @param Vals Array of doubles
+ * @param Num Number of elements
+ * @param Parent Pointer to parent node
+ * @param Arena Arena node is allocated from (nullptr if allocated with new)
+ *
+ */
+rvs::LogNodeArray::LogNodeArray(const char* Name, const double* Vals,
+                                const size_t Num,
+                                const LogNodeBase* Parent, LogArena* Arena)
+:
+LogNodeBase(Name, Parent, Arena),
+ElemType(eLN::Double),
+Count(Num) {
+  Type = eLN::Array;
+  Values.Dbl = static_cast<double*>(CopyValues(Vals, Num * sizeof(*Vals)));
+}
+
+//! Destructor
+rvs::LogNodeArray::~LogNodeArray() {
+  // arena memory is released all at once
+  if (pArena == nullptr) {
+    delete[] static_cast<char*>(static_cast<void*>(Values.Int));
+  }
+}
+
+/**
+ * @brief Make node's own copy of array elements
+ *
+ * Copy is placed in the node's arena if any, or on the heap otherwise.
+ *
+ * @param Vals elements to copy
+ * @param Size size of elements in bytes
+ * @return Pointer to the copy
+ *
+ */
+void* rvs::LogNodeArray::CopyValues(const void* Vals, const size_t Size) {
+  void* p = pArena ? pArena->alloc(Size) : new char[Size];
+  if (Size) {
+    memcpy(p, Vals, Size);
+  }
+  return p;
+}
+
+/**
+ * @brief Writes JSON representation of Node
+ *
+ * @param pWriter JSON writer
+ *
+ */
+void rvs::LogNodeArray::WriteJson(JsonWriter* pWriter) {
+  pWriter->begin_array(Name);
+  for (size_t i = 0; i < Count; i++) {
+    switch (ElemType) {
+    case eLN::Unsigned:
+        pWriter->element(Values.Uint[i]);
+        break;
+    case eLN::Double:
+        pWriter->element(Values.Dbl[i]);
+        break;
+    default:
+        pWriter->element(Values.Int[i]);
+        break;
+    }
+  }
+  pWriter->end_array();
+}
+
+/**
+ * @brief Writes binary representation of Node
+ *
+ * @param pWriter binary log writer
+ *
+ */
+void rvs::LogNodeArray::WriteBin(LogBinWriter* pWriter) {
+  switch (ElemType) {
+  case eLN::Unsigned:
+      pWriter->member(Name, Values.Uint, Count);
+      break;
+  case eLN::Double:
+      pWriter->member(Name, Values.Dbl, Count);
+      break;
+  default:
+      pWriter->member(Name, Values.Int, Count);
+      break;
+  }
+}
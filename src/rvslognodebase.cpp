@@ -22,23 +22,163 @@
  * SOFTWARE.
  *
  *******************************************************************************/
+#include <string.h>
+
 #include <string>
 
 #include "include/rvslognodebase.h"
+#include "include/rvsjsonwriter.h"
 
 /**
  * @brief Constructor
  *
  * @param pName Node name
  * @param pParent Pointer to parent node
+ * @param pArena Arena node is allocated from (nullptr if allocated with new)
  *
  */
-rvs::LogNodeBase::LogNodeBase(const char* pName, const LogNodeBase* pParent)
-: Name(pName),
+rvs::LogNodeBase::LogNodeBase(const char* pName, const LogNodeBase* pParent,
+                              LogArena* pArena)
+: Name(nullptr),
 Parent(pParent),
-Type(eLN::Unknown) {
+Type(eLN::Unknown),
+pArena(pArena),
+Next(nullptr) {
+  Name = CopyString(pName);
 }
 
 //! Destructor
 rvs::LogNodeBase::~LogNodeBase() {
+  FreeString(Name);
+}
+
+/**
+ * @brief Get arena node is allocated from
+ *
+ * @return Pointer to arena, nullptr if node is allocated on heap
+ *
+ */
+rvs::LogArena* rvs::LogNodeBase::Arena() const {
+  return pArena;
+}
+
+/**
+ * @brief Provides JSON representation of Node
+ *
+ * Convenience wrapper around WriteJson() producing pretty layout.
+ *
+ * @param Lead String of blanks " " representing current indentation
+ * @return Node as JSON string
+ *
+ */
+std::string rvs::LogNodeBase::ToJson(const std::string& Lead) {
+  std::string result;
+  JsonWriter writer(&result, JsonWriter::pretty, Lead);
+  WriteJson(&writer);
+
+  return result;
+}
+
+/**
+ * @brief Make node's own copy of a string
+ *
+ * Copy is placed in the node's arena if any, or on the heap otherwise.
+ *
+ * @param Str string to copy
+ * @return Pointer to the copy
+ *
+ */
+const char* rvs::LogNodeBase::CopyString(const char* Str) {
+  if (pArena) {
+    return pArena->strdup(Str);
+  }
+
+  size_t len = strlen(Str) + 1;
+  char* p = new char[len];
+  memcpy(p, Str, len);
+  return p;
+}
+
+/**
+ * @brief Free string obtained through CopyString()
+ *
+ * @param Str string to free
+ *
+ */
+void rvs::LogNodeBase::FreeString(const char* Str) {
+  // arena memory is released all at once
+  if (pArena == nullptr) {
+    delete[] Str;
+  }
+}
+
+//! Constructor
+rvs::LogNodeList::LogNodeList()
+:
+head(nullptr),
+tail(nullptr),
+count(0) {
+}
+
+/**
+ * @brief Append node to the list
+ *
+ * @param pNode node to append
+ *
+ */
+void rvs::LogNodeList::push_back(LogNodeBase* pNode) {
+  pNode->Next = nullptr;
+  if (tail) {
+    tail->Next = pNode;
+  } else {
+    head = pNode;
+  }
+  tail = pNode;
+  count++;
+}
+
+/**
+ * @brief Get number of nodes in the list
+ *
+ * @return Number of nodes
+ *
+ */
+size_t rvs::LogNodeList::size() const {
+  return count;
+}
+
+/**
+ * @brief Get node at given position (linear time)
+ *
+ * @param Index node position
+ * @return Pointer to node, nullptr if Index is out of range
+ *
+ */
+rvs::LogNodeBase* rvs::LogNodeList::operator[](const size_t Index) const {
+  LogNodeBase* p = head;
+  for (size_t i = 0; p && i < Index; i++) {
+    p = p->Next;
+  }
+  return p;
+}
+
+/**
+ * @brief Get first node in the list
+ *
+ * @return Pointer to node, nullptr if list is empty
+ *
+ */
+rvs::LogNodeBase* rvs::LogNodeList::first() const {
+  return head;
+}
+
+/**
+ * @brief Get node following given node in the list
+ *
+ * @param pNode list node
+ * @return Pointer to node, nullptr if pNode is the last one
+ *
+ */
+rvs::LogNodeBase* rvs::LogNodeList::next(const LogNodeBase* pNode) {
+  return pNode->Next;
 }
@@ -25,6 +25,8 @@
 #include <string>
 
 #include "include/rvslognodeint.h"
+#include "include/rvsjsonwriter.h"
+#include "include/rvslogbin.h"
 
 using std::string;
 
@@ -34,12 +36,13 @@ using std::string;
  * @param Name Node name
  * @param Val Node value
  * @param Parent Pointer to parent node
+ * @param Arena Arena node is allocated from (nullptr if allocated with new)
  *
  */
-rvs::LogNodeInt::LogNodeInt(const char* Name, const int Val,
-                            const LogNodeBase* Parent)
+rvs::LogNodeInt::LogNodeInt(const char* Name, const int64_t Val,
+                            const LogNodeBase* Parent, LogArena* Arena)
 :
-LogNodeBase(Name, Parent),
+LogNodeBase(Name, Parent, Arena),
 Value(Val) {
   Type = eLN::Integer;
 }
@@ -49,18 +52,21 @@ rvs::LogNodeInt::~LogNodeInt() {
 }
 
 /**
- * @brief Provides JSON representation of Node
+ * @brief Writes JSON representation of Node
  *
- * Traverses list of child nodes and converts them into proper string representation.
- * Also ensures proper indentation and line breaks for formatted output.
- *
- * @param Lead String of blanks " " representing current indentation
- * @return Node as JSON string
+ * @param pWriter JSON writer
  *
  */
-std::string rvs::LogNodeInt::ToJson(const std::string& Lead) {
-  string result(RVSENDL);
-  result += Lead + "\"" + Name + "\"" + " : " + std::to_string(Value);
+void rvs::LogNodeInt::WriteJson(JsonWriter* pWriter) {
+  pWriter->member(Name, Value);
+}
 
-  return result;
+/**
+ * @brief Writes binary representation of Node
+ *
+ * @param pWriter binary log writer
+ *
+ */
+void rvs::LogNodeInt::WriteBin(LogBinWriter* pWriter) {
+  pWriter->member(Name, Value);
 }
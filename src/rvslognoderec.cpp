@@ -25,7 +25,10 @@
 
 #include "include/rvslognoderec.h"
 
+#include <new>
 #include <string>
+#include "include/rvsjsonwriter.h"
+#include "include/rvslogbin.h"
 #include "include/rvstrace.h"
 
 /**
@@ -36,12 +39,14 @@
  * @param Sec secconds since system start
  * @param uSec microseconds in current second
  * @param Parent Pointer to parent node
+ * @param Arena Arena node is allocated from (nullptr if allocated with new)
  *
  */
 rvs::LogNodeRec::LogNodeRec(const char* Name, int LoggingLevel,
-  const unsigned Sec, const unsigned uSec, const LogNodeBase* Parent)
+  const unsigned Sec, const unsigned uSec, const LogNodeBase* Parent,
+  LogArena* Arena)
 :
-LogNode(Name, Parent),
+LogNode(Name, Parent, Arena),
 Level(LoggingLevel),
 sec(Sec),
 usec(uSec) {
@@ -63,40 +68,91 @@ int rvs::LogNodeRec::LogLevel() {
 }
 
 /**
- * @brief Provides JSON representation of Node
+ * @brief Create log record in its own arena
  *
- * Traverses list of child nodes and converts them into proper string representation.
- * Also ensures proper indentation and line breaks for formatted output.
+ * Record and all nodes subsequently added to it are allocated from an arena
+ * taken from the arena pool. Use Destroy() to release the record.
  *
- * @param Lead String of blanks " " representing current indentation
- * @return Node as JSON string
+ * @param Name Node name
+ * @param LoggingLevel Logging level
+ * @param Sec secconds since system start
+ * @param uSec microseconds in current second
+ * @return Pointer to new record
+ *
+ */
+rvs::LogNodeRec* rvs::LogNodeRec::Create(const char* Name, int LoggingLevel,
+  const unsigned Sec, const unsigned uSec) {
+  LogArena* arena = LogArena::acquire();
+  void* p = arena->alloc(sizeof(LogNodeRec));
+  return new (p) LogNodeRec(Name, LoggingLevel, Sec, uSec, nullptr, arena);
+}
+
+/**
+ * @brief Release log record together with all of its child nodes
+ *
+ * @param pRec record obtained through Create() or allocated with new
+ *
+ */
+void rvs::LogNodeRec::Destroy(LogNodeRec* pRec) {
+  LogArena* arena = pRec->Arena();
+
+  if (arena == nullptr) {
+    delete pRec;
+    return;
+  }
+
+  // all nodes live in the arena, so there is nothing to destruct
+  LogArena::release(arena);
+}
+
+/**
+ * @brief Writes JSON representation of Node
+ *
+ * Outputs logging level and timestamp followed by the list of child nodes.
+ *
+ * @param pWriter JSON writer
  *
  */
-std::string rvs::LogNodeRec::ToJson(const std::string& Lead) {
+void rvs::LogNodeRec::WriteJson(JsonWriter* pWriter) {
   DTRACE_
-  std::string result(RVSENDL);
-  result += Lead + "{";
+  pWriter->begin_object();
 
-  result += RVSENDL;
-  result += Lead + RVSINDENT;
-  result += std::string("\"") + "loglevel" + "\"" + " : " +
-            std::to_string(Level) + ",";
+  pWriter->member("loglevel", static_cast<int64_t>(Level));
+  pWriter->separator();
 
   char  buff[64];
   snprintf(buff, sizeof(buff), "%6d.%-6d", sec, usec);
-  result += RVSENDL;
-  result += Lead + RVSINDENT;
-  result += std::string("\"") + "time" + "\"" + " : " +
-            std::string("\"") + buff + std::string("\"")  + ",";
-
-  int  size = Child.size();
-  for (int i = 0; i < size; i++) {
-    result += Child[i]->ToJson(Lead + RVSINDENT);
-    if (i+ 1 < size) {
-      result += ",";
+  pWriter->member("time", buff);
+  // pretty layout has always emitted separator here, even with no children
+  if (Child.first() || pWriter->layout() == JsonWriter::pretty) {
+    pWriter->separator();
+  }
+
+  for (LogNodeBase* p = Child.first(); p; p = LogNodeList::next(p)) {
+    p->WriteJson(pWriter);
+    if (LogNodeList::next(p)) {
+      pWriter->separator();
     }
   }
-  result += RVSENDL + Lead + "}";
 
-  return result;
+  pWriter->end_object();
+}
+
+/**
+ * @brief Writes binary representation of Node
+ *
+ * Outputs logging level and raw timestamp followed by the list of child
+ * nodes.
+ *
+ * @param pWriter binary log writer
+ *
+ */
+void rvs::LogNodeRec::WriteBin(LogBinWriter* pWriter) {
+  pWriter->record_begin(Level, sec, usec);
+
+  for (LogNodeBase* p = Child.first(); p; p = LogNodeList::next(p)) {
+    p->WriteBin(pWriter);
+  }
+
+  pWriter->record_end();
 }
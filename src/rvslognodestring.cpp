@@ -25,6 +25,8 @@
 #include <string>
 
 #include "include/rvslognodestring.h"
+#include "include/rvsjsonwriter.h"
+#include "include/rvslogbin.h"
 
 using std::string;
 
@@ -34,33 +36,39 @@ using std::string;
  * @param Name Node name
  * @param Val Node value
  * @param Parent Pointer to parent node
+ * @param Arena Arena node is allocated from (nullptr if allocated with new)
  *
  */
 rvs::LogNodeString::LogNodeString(const char* Name, const char* Val,
-                                  const LogNodeBase* Parent)
+                                  const LogNodeBase* Parent, LogArena* Arena)
 :
-LogNodeBase(Name, Parent),
-Value(Val) {
+LogNodeBase(Name, Parent, Arena),
+Value(nullptr) {
   Type = eLN::String;
+  Value = CopyString(Val);
 }
 
 //! Destructor
 rvs::LogNodeString::~LogNodeString() {
+  FreeString(Value);
 }
 
 /**
- * @brief Provides JSON representation of Node
+ * @brief Writes JSON representation of Node
  *
- * Traverses list of child nodes and converts them into proper string representation.
- * Also ensures proper indentation and line breaks for formatted output.
- *
- * @param Lead String of blanks " " representing current indentation
- * @return Node as JSON string
+ * @param pWriter JSON writer
  *
  */
-std::string rvs::LogNodeString::ToJson(const std::string& Lead) {
-  string result(RVSENDL);
-  result += Lead + "\"" + Name + "\"" + " : " + "\"" + Value + "\"";
+void rvs::LogNodeString::WriteJson(JsonWriter* pWriter) {
+  pWriter->member(Name, Value);
+}
 
-  return result;
+/**
+ * @brief Writes binary representation of Node
+ *
+ * @param pWriter binary log writer
+ *
+ */
+void rvs::LogNodeString::WriteBin(LogBinWriter* pWriter) {
+  pWriter->member(Name, Value);
 }
@@ -0,0 +1,72 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <string>
+
+#include "include/rvslognodeuint.h"
+#include "include/rvsjsonwriter.h"
+#include "include/rvslogbin.h"
+
+using std::string;
+
+/**
+ * @brief Constructor
+ *
+ * @param Name Node name
+ * @param Val Node value
+ * @param Parent Pointer to parent node
+ * @param Arena Arena node is allocated from (nullptr if allocated with new)
+ *
+ */
+rvs::LogNodeUint::LogNodeUint(const char* Name, const uint64_t Val,
+                              const LogNodeBase* Parent, LogArena* Arena)
+:
+LogNodeBase(Name, Parent, Arena),
+Value(Val) {
+  Type = eLN::Unsigned;
+}
+
+//! Destructor
+rvs::LogNodeUint::~LogNodeUint() {
+}
+
+/**
+ * @brief Writes JSON representation of Node
+ *
+ * @param pWriter JSON writer
+ *
+ */
+void rvs::LogNodeUint::WriteJson(JsonWriter* pWriter) {
+  pWriter->member(Name, Value);
+}
+
+/**
+ * @brief Writes binary representation of Node
+ *
+ * @param pWriter binary log writer
+ *
+ */
+void rvs::LogNodeUint::WriteBin(LogBinWriter* pWriter) {
+  pWriter->member(Name, Value);
+}
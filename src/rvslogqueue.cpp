@@ -0,0 +1,150 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvslogqueue.h"
+
+#include <utility>
+
+/**
+ * @brief Constructor
+ *
+ * @param Size requested number of entries (rounded up to power of 2)
+ *
+ */
+rvs::LogQueue::LogQueue(const size_t Size)
+:
+head(0),
+tail(0) {
+  size_t cap = 2;
+  while (cap < Size) {
+    cap <<= 1;
+  }
+
+  ring = std::vector<slot>(cap);
+  mask = cap - 1;
+
+  for (size_t i = 0; i < cap; i++) {
+    ring[i].seq.store(i, std::memory_order_relaxed);
+    ring[i].entry.msg = 0;
+    ring[i].entry.level = 0;
+    ring[i].entry.sec = 0;
+    ring[i].entry.usec = 0;
+    ring[i].entry.rec = nullptr;
+  }
+}
+
+//! Destructor
+rvs::LogQueue::~LogQueue() {
+}
+
+/**
+ * @brief Add entry to the queue (may be called from any thread)
+ *
+ * Whole entry (row, message offset, level, timestamp and record) is
+ * moved into the queue.
+ *
+ * @param pEntry entry to add
+ * @return 'true' - success, 'false' if queue is full
+ *
+ */
+bool rvs::LogQueue::push(T_LOGQENTRY* pEntry) {
+  size_t pos = head.load(std::memory_order_relaxed);
+  slot* s;
+
+  for (;;) {
+    s = &ring[pos & mask];
+    size_t seq = s->seq.load(std::memory_order_acquire);
+    intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+    if (diff == 0) {
+      // slot is free, try to claim it
+      if (head.compare_exchange_weak(pos, pos + 1,
+                                     std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      // slot still holds data not yet consumed - queue is full
+      return false;
+    } else {
+      // another producer claimed this slot, retry with fresh position
+      pos = head.load(std::memory_order_relaxed);
+    }
+  }
+
+  s->entry = std::move(*pEntry);
+  pEntry->rec = nullptr;
+
+  // publish to consumer
+  s->seq.store(pos + 1, std::memory_order_release);
+
+  return true;
+}
+
+/**
+ * @brief Take entry from the queue (consumer thread only)
+ *
+ * @param pEntry destination entry
+ * @return 'true' - success, 'false' if queue is empty
+ *
+ */
+bool rvs::LogQueue::pop(T_LOGQENTRY* pEntry) {
+  size_t pos = tail.load(std::memory_order_relaxed);
+  slot* s = &ring[pos & mask];
+
+  size_t seq = s->seq.load(std::memory_order_acquire);
+  if (seq != pos + 1) {
+    return false;
+  }
+
+  *pEntry = std::move(s->entry);
+  s->entry.row.clear();
+  s->entry.rec = nullptr;
+
+  tail.store(pos + 1, std::memory_order_relaxed);
+
+  // release slot to producers
+  s->seq.store(pos + mask + 1, std::memory_order_release);
+
+  return true;
+}
+
+/**
+ * @brief Check if queue is empty
+ *
+ * @return 'true' if there is no published entry at the consumer position
+ *
+ */
+bool rvs::LogQueue::empty() const {
+  size_t pos = tail.load(std::memory_order_relaxed);
+  return ring[pos & mask].seq.load(std::memory_order_acquire) != pos + 1;
+}
+
+/**
+ * @brief Get queue capacity
+ *
+ * @return max number of entries
+ *
+ */
+size_t rvs::LogQueue::capacity() const {
+  return mask + 1;
+}
@@ -0,0 +1,341 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvslogrotate.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <errno.h>
+#include <dirent.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <zlib.h>
+
+#include <string>
+
+/**
+ * @brief Constructor
+ *
+ */
+rvs::LogRotate::LogRotate()
+:
+max_size(0),
+interval(0),
+compress_m(false),
+sequence(0),
+started(0),
+compressor_run(false) {
+}
+
+//! Destructor
+rvs::LogRotate::~LogRotate() {
+  stop();
+}
+
+/**
+ * @brief Set segment size which triggers rotation
+ *
+ * @param Size size in bytes (0 - no size limit)
+ *
+ */
+void rvs::LogRotate::set_max_size(const uint64_t Size) {
+  max_size = Size;
+}
+
+/**
+ * @brief Set segment age which triggers rotation
+ *
+ * @param Sec interval in seconds (0 - no time limit)
+ *
+ */
+void rvs::LogRotate::set_interval(const unsigned int Sec) {
+  interval = Sec;
+}
+
+/**
+ * @brief Enable/disable compression of closed segments
+ *
+ * @param Flag 'true' if closed segments are to be compressed
+ *
+ */
+void rvs::LogRotate::set_compress(const bool Flag) {
+  compress_m = Flag;
+}
+
+/**
+ * @brief Check if rotation is configured
+ *
+ * @return 'true' if either size or time limit is set
+ *
+ */
+bool rvs::LogRotate::enabled() const {
+  return max_size > 0 || interval > 0;
+}
+
+/**
+ * @brief Start tracking new active log file
+ *
+ * Sequence numbering continues after segments of the same log file
+ * already present on disk.
+ *
+ * @param FileName active log file name
+ *
+ */
+void rvs::LogRotate::start(const std::string& FileName) {
+  file_name = FileName;
+  sequence = enabled() ? last_sequence() : 0;
+  started = now_sec();
+}
+
+/**
+ * @brief Check if active segment is to be rotated
+ *
+ * @param Size current size of the active segment (in bytes)
+ * @return 'true' if size or time limit is reached
+ *
+ */
+bool rvs::LogRotate::due(const uint64_t Size) const {
+  if (max_size > 0 && Size >= max_size) {
+    return true;
+  }
+
+  return interval > 0 && now_sec() - started >= interval;
+}
+
+/**
+ * @brief Move active segment out of the way
+ *
+ * Active log file is renamed to the next segment name. File may still be
+ * open, caller is expected to finish it through the existing descriptor,
+ * close it and then pass it to retire().
+ *
+ * @param pSegment [out] segment name
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int rvs::LogRotate::rotate(std::string* pSegment) {
+  std::string segment = file_name + "." + std::to_string(sequence + 1);
+
+  started = now_sec();
+
+  if (::rename(file_name.c_str(), segment.c_str())) {
+    return -1;
+  }
+  sequence++;
+
+  *pSegment = segment;
+
+  return 0;
+}
+
+/**
+ * @brief Hand over closed segment
+ *
+ * Queues segment for compression if requested.
+ *
+ * @param Segment segment name returned by rotate()
+ *
+ */
+void rvs::LogRotate::retire(const std::string& Segment) {
+  if (!compress_m) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lk(compress_mutex);
+  pending.push_back(Segment);
+  if (!compressor.joinable()) {
+    compressor_run = true;
+    compressor = std::thread(&rvs::LogRotate::CompressorRun, this);
+  }
+  compress_cv.notify_one();
+}
+
+/**
+ * @brief Stop compressor thread
+ *
+ * Returns after all queued segments are compressed.
+ *
+ */
+void rvs::LogRotate::stop() {
+  {
+    std::lock_guard<std::mutex> lk(compress_mutex);
+    if (!compressor.joinable()) {
+      return;
+    }
+    compressor_run = false;
+    compress_cv.notify_one();
+  }
+
+  compressor.join();
+}
+
+/**
+ * @brief Compress file into \<file\>.gz and remove the original
+ *
+ * Compressed data is written into temporary file first, so that
+ * incomplete .gz file never appears under the final name.
+ *
+ * @param FileName file to compress
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int rvs::LogRotate::compress(const std::string& FileName) {
+  std::string gz_name = FileName + ".gz";
+  std::string tmp_name = gz_name + ".tmp";
+
+  int fd = ::open(FileName.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return -1;
+  }
+
+  gzFile gz = gzopen(tmp_name.c_str(), "wb");
+  if (gz == nullptr) {
+    ::close(fd);
+    return -1;
+  }
+
+  std::string chunk(RVS_LOGROTATE_CHUNK, '\0');
+  int sts = 0;
+
+  for (;;) {
+    ssize_t n = ::read(fd, &chunk[0], chunk.size());
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      sts = n < 0 ? -1 : 0;
+      break;
+    }
+    if (gzwrite(gz, chunk.data(), static_cast<unsigned>(n)) != n) {
+      sts = -1;
+      break;
+    }
+  }
+
+  ::close(fd);
+  if (gzclose(gz) != Z_OK) {
+    sts = -1;
+  }
+
+  if (sts || ::rename(tmp_name.c_str(), gz_name.c_str())) {
+    ::unlink(tmp_name.c_str());
+    return -1;
+  }
+
+  ::unlink(FileName.c_str());
+
+  return 0;
+}
+
+/**
+ * @brief Fetches monotonic time in seconds
+ *
+ * @return seconds since system start
+ *
+ */
+uint64_t rvs::LogRotate::now_sec() {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<uint64_t>(ts.tv_sec);
+}
+
+/**
+ * @brief Find the highest sequence number of existing segments
+ *
+ * Both plain (\<log file\>.\<N\>) and compressed (\<log file\>.\<N\>.gz)
+ * segments are taken into account.
+ *
+ * @return highest sequence number found, 0 if none
+ *
+ */
+unsigned int rvs::LogRotate::last_sequence() const {
+  std::string dir_name(".");
+  std::string base(file_name);
+
+  size_t pos = file_name.rfind('/');
+  if (pos != std::string::npos) {
+    dir_name = pos ? file_name.substr(0, pos) : "/";
+    base = file_name.substr(pos + 1);
+  }
+  base += ".";
+
+  DIR* dir = opendir(dir_name.c_str());
+  if (dir == nullptr) {
+    return 0;
+  }
+
+  unsigned int last = 0;
+  struct dirent* entry;
+  while ((entry = readdir(dir)) != nullptr) {
+    std::string name(entry->d_name);
+    if (name.compare(0, base.size(), base)) {
+      continue;
+    }
+
+    const char* p = name.c_str() + base.size();
+    char* end;
+    if (*p < '0' || *p > '9') {
+      continue;
+    }
+    unsigned long seq = strtoul(p, &end, 10);
+    if (*end != '\0' && std::string(end) != ".gz") {
+      continue;
+    }
+    if (seq > last) {
+      last = static_cast<unsigned int>(seq);
+    }
+  }
+
+  closedir(dir);
+
+  return last;
+}
+
+/**
+ * @brief Compressor thread function
+ *
+ * Compresses queued segments one by one. Exits when requested to stop
+ * and the queue is empty.
+ *
+ */
+void rvs::LogRotate::CompressorRun() {
+  for (;;) {
+    std::string segment;
+    {
+      std::unique_lock<std::mutex> lk(compress_mutex);
+      compress_cv.wait(lk, [this] {
+        return !pending.empty() || !compressor_run;
+      });
+      if (pending.empty()) {
+        break;
+      }
+      segment = pending.front();
+      pending.pop_front();
+    }
+
+    compress(segment);
+  }
+}
@@ -0,0 +1,275 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvslogsink.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <errno.h>
+
+#include <string>
+
+/**
+ * @brief Constructor
+ *
+ */
+rvs::LogSink::LogSink()
+:
+fd(-1),
+buffer_size(RVS_LOGSINK_BUFFER_SIZE),
+flush_interval(RVS_LOGSINK_FLUSH_INTERVAL),
+last_flush(0),
+file_size(0) {
+}
+
+//! Destructor
+rvs::LogSink::~LogSink() {
+  close();
+}
+
+/**
+ * @brief Open log file
+ *
+ * If sink is already open, pending data is flushed and the file is closed
+ * first.
+ *
+ * @param FileName log file name
+ * @param Truncate 'true' if existing content is to be discarded
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int rvs::LogSink::open(const std::string& FileName, const bool Truncate) {
+  close();
+
+  int flags = O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC;
+  if (Truncate) {
+    flags |= O_TRUNC;
+  }
+
+  fd = ::open(FileName.c_str(), flags, 0644);
+  if (fd < 0) {
+    return -1;
+  }
+
+  struct stat st;
+  file_size = fstat(fd, &st) ? 0 : st.st_size;
+
+  file_name = FileName;
+  buffer.reserve(buffer_size);
+  last_flush = now_ms();
+
+  return 0;
+}
+
+/**
+ * @brief Add row to the sink
+ *
+ * Row is copied into the buffer. Buffer is written out if it exceeds
+ * configured size or if flush interval has expired.
+ *
+ * @param Row data to write
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int rvs::LogSink::write(const std::string& Row) {
+  if (fd < 0) {
+    return -1;
+  }
+
+  // bypass buffer for rows that would not fit into it anyway
+  if (Row.size() >= buffer_size) {
+    if (flush()) {
+      return -1;
+    }
+    return write_fd(Row.c_str(), Row.size());
+  }
+
+  buffer += Row;
+
+  return commit();
+}
+
+/**
+ * @brief Get buffer for direct output
+ *
+ * Allows callers to serialize data straight into the sink buffer instead
+ * of building an intermediate string. Call commit() when done appending.
+ *
+ * @return pointer to sink buffer
+ *
+ */
+std::string* rvs::LogSink::output() {
+  return &buffer;
+}
+
+/**
+ * @brief Flush data appended to the buffer if needed
+ *
+ * Buffer is written out if it exceeds configured size or if flush interval
+ * has expired.
+ *
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int rvs::LogSink::commit() {
+  if (fd < 0) {
+    return -1;
+  }
+
+  if (buffer.size() >= buffer_size ||
+      now_ms() - last_flush >= flush_interval) {
+    return flush();
+  }
+
+  return 0;
+}
+
+/**
+ * @brief Write buffered data to the file
+ *
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int rvs::LogSink::flush() {
+  last_flush = now_ms();
+
+  if (buffer.empty()) {
+    return 0;
+  }
+
+  int sts = write_fd(buffer.c_str(), buffer.size());
+  buffer.clear();
+
+  return sts;
+}
+
+/**
+ * @brief Write buffered data to the file if flush interval has expired
+ *
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int rvs::LogSink::flush_expired() {
+  if (buffer.empty() || now_ms() - last_flush < flush_interval) {
+    return 0;
+  }
+
+  return flush();
+}
+
+/**
+ * @brief Flush pending data and close log file
+ *
+ */
+void rvs::LogSink::close() {
+  if (fd < 0) {
+    buffer.clear();
+    return;
+  }
+
+  flush();
+  ::close(fd);
+  fd = -1;
+}
+
+/**
+ * @brief Check if log file is open
+ *
+ * @return 'true' if log file is open
+ *
+ */
+bool rvs::LogSink::is_open() const {
+  return fd >= 0;
+}
+
+/**
+ * @brief Get log file size including buffered data
+ *
+ * @return size in bytes
+ *
+ */
+uint64_t rvs::LogSink::size() const {
+  return file_size + buffer.size();
+}
+
+/**
+ * @brief Set buffer size which triggers flush
+ *
+ * @param Size buffer size in bytes (0 - unbuffered)
+ *
+ */
+void rvs::LogSink::set_buffer_size(const size_t Size) {
+  buffer_size = Size;
+}
+
+/**
+ * @brief Set max time data is kept in buffer before flush
+ *
+ * @param Ms interval in milliseconds
+ *
+ */
+void rvs::LogSink::set_flush_interval(const unsigned int Ms) {
+  flush_interval = Ms;
+}
+
+/**
+ * @brief Fetches monotonic time in milliseconds
+ *
+ * @return milliseconds since system start
+ *
+ */
+uint64_t rvs::LogSink::now_ms() {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+}
+
+/**
+ * @brief Write data to the file retrying on partial writes
+ *
+ * @param pData data to write
+ * @param Size data size
+ * @return 0 - success, non-zero otherwise
+ *
+ */
+int rvs::LogSink::write_fd(const char* pData, const size_t Size) {
+  size_t done = 0;
+
+  while (done < Size) {
+    ssize_t n = ::write(fd, pData + done, Size - done);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return -1;
+    }
+    done += n;
+    file_size += n;
+  }
+
+  return 0;
+}
@@ -0,0 +1,365 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvstopocache.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+//! cache file magic
+#define TOPOCACHE_MAGIC                 "RVSTOPO"
+//! amdgpu driver version
+#define TOPOCACHE_DRIVER_VERSION        "/sys/module/amdgpu/version"
+//! topology generation, changes on hot plug
+#define TOPOCACHE_GENERATION \
+  "/sys/class/kfd/kfd/topology/generation_id"
+
+namespace {
+
+//! cache file header
+struct header {
+  char     magic[8];
+  uint32_t version;
+  uint32_t nodes;
+  uint64_t print;
+  uint64_t size;
+};
+
+/**
+ * @brief 64-bit FNV-1a hash step
+ * @param Hash running hash
+ * @param pData data to add
+ * @param Size data size
+ * @return updated hash
+ */
+uint64_t fnv1a(uint64_t Hash, const void* pData, size_t Size) {
+  const unsigned char* p = static_cast<const unsigned char*>(pData);
+  for (size_t i = 0; i < Size; i++) {
+    Hash ^= p[i];
+    Hash *= 0x100000001b3ull;
+  }
+  return Hash;
+}
+
+/**
+ * @brief Read small file relative to directory into buffer
+ * @param DirFd directory file descriptor (AT_FDCWD for absolute path)
+ * @param Name file name
+ * @param pContent file content (empty if file can not be read)
+ */
+void read_small(int DirFd, const char* Name, string* pContent) {
+  char buff[256];
+  pContent->clear();
+  int fd = openat(DirFd, Name, O_RDONLY);
+  if (fd < 0) {
+    return;
+  }
+  ssize_t n;
+  while ((n = read(fd, buff, sizeof(buff))) > 0) {
+    pContent->append(buff, n);
+  }
+  close(fd);
+}
+
+template <typename T>
+void put(string* pOut, T Val) {
+  pOut->append(reinterpret_cast<const char*>(&Val), sizeof(Val));
+}
+
+template <typename T>
+bool get(const char** ppData, const char* pEnd, T* pVal) {
+  if (static_cast<size_t>(pEnd - *ppData) < sizeof(T)) {
+    return false;
+  }
+  memcpy(pVal, *ppData, sizeof(T));
+  *ppData += sizeof(T);
+  return true;
+}
+
+/**
+ * @brief Deserialize nodes from mapped cache payload
+ * @param pData payload start
+ * @param pEnd payload end
+ * @param Count number of nodes (rejected if payload can not hold them)
+ * @param pNodes resulting nodes
+ * @return true if payload is well formed
+ */
+bool parse(const char* pData, const char* pEnd, uint32_t Count,
+           vector<rvs::kfd_node>* pNodes) {
+  // smallest serialized node: fixed fields plus property and link counts
+  const size_t min_node = sizeof(rvs::kfd_node::node_id) +
+                          sizeof(rvs::kfd_node::gpu_id) +
+                          sizeof(rvs::kfd_node::location_id) +
+                          sizeof(rvs::kfd_node::device_id) +
+                          sizeof(rvs::kfd_node::vendor_id) +
+                          sizeof(rvs::kfd_node::numa_node) +
+                          2 * sizeof(uint32_t);
+  if (Count > static_cast<size_t>(pEnd - pData) / min_node) {
+    return false;
+  }
+  pNodes->resize(Count);
+  for (rvs::kfd_node& node : *pNodes) {
+    uint32_t props;
+    uint32_t links;
+    if (!get(&pData, pEnd, &node.node_id) ||
+        !get(&pData, pEnd, &node.gpu_id) ||
+        !get(&pData, pEnd, &node.location_id) ||
+        !get(&pData, pEnd, &node.device_id) ||
+        !get(&pData, pEnd, &node.vendor_id) ||
+        !get(&pData, pEnd, &node.numa_node) ||
+        !get(&pData, pEnd, &props) ||
+        !get(&pData, pEnd, &links)) {
+      return false;
+    }
+    node.properties.resize(std::min<size_t>(props, pEnd - pData));
+    if (node.properties.size() != props) {
+      return false;
+    }
+    for (auto& prop : node.properties) {
+      uint16_t len;
+      if (!get(&pData, pEnd, &len) ||
+          static_cast<size_t>(pEnd - pData) < len) {
+        return false;
+      }
+      prop.first.assign(pData, len);
+      pData += len;
+      if (!get(&pData, pEnd, &prop.second)) {
+        return false;
+      }
+    }
+    node.io_links.resize(std::min<size_t>(links, pEnd - pData));
+    if (node.io_links.size() != links) {
+      return false;
+    }
+    for (auto& link : node.io_links) {
+      if (!get(&pData, pEnd, &link.type) ||
+          !get(&pData, pEnd, &link.node_from) ||
+          !get(&pData, pEnd, &link.node_to) ||
+          !get(&pData, pEnd, &link.weight)) {
+        return false;
+      }
+    }
+  }
+  return pData == pEnd;
+}
+
+}  // namespace
+
+/**
+ * @brief Get topology cache file name
+ * @return RVS_TOPOLOGY_CACHE if set (possibly empty - cache disabled),
+ * RVS_TOPOLOGY_CACHE_FILE otherwise
+ */
+std::string rvs::topocache::file() {
+  const char* env = getenv(RVS_TOPOLOGY_CACHE_ENV);
+  return env ? env : RVS_TOPOLOGY_CACHE_FILE;
+}
+
+/**
+ * @brief Compute topology fingerprint
+ *
+ * Only gpu_id files of nodes are read, not node properties and io_links.
+ *
+ * @param NodesPath topology nodes folder
+ * @param pPrint resulting fingerprint
+ * @return 0 if successful, -1 if topology folder can not be read
+ */
+int rvs::topocache::fingerprint(const std::string& NodesPath,
+                                uint64_t* pPrint) {
+  uint64_t hash = 0xcbf29ce484222325ull;
+  string content;
+
+  int nodes_fd = open(NodesPath.c_str(), O_RDONLY | O_DIRECTORY);
+  if (nodes_fd < 0) {
+    return -1;
+  }
+  int fd = dup(nodes_fd);
+  DIR* dirp = fd < 0 ? nullptr : fdopendir(fd);
+  if (dirp == nullptr) {
+    if (fd >= 0) {
+      close(fd);
+    }
+    close(nodes_fd);
+    return -1;
+  }
+  vector<uint32_t> ids;
+  struct dirent* dir;
+  while ((dir = readdir(dirp)) != nullptr) {
+    char* next;
+    uint32_t id = strtoul(dir->d_name, &next, 10);
+    if (dir->d_name[0] >= '0' && dir->d_name[0] <= '9' && *next == '\0') {
+      ids.push_back(id);
+    }
+  }
+  closedir(dirp);
+  std::sort(ids.begin(), ids.end());
+
+  hash = fnv1a(hash, NodesPath.c_str(), NodesPath.size() + 1);
+  for (uint32_t id : ids) {
+    char name[32];
+    snprintf(name, sizeof(name), "%u/gpu_id", id);
+    read_small(nodes_fd, name, &content);
+    hash = fnv1a(hash, &id, sizeof(id));
+    hash = fnv1a(hash, content.c_str(), content.size() + 1);
+  }
+  close(nodes_fd);
+
+  read_small(AT_FDCWD, gpu_sysfs_path(TOPOCACHE_DRIVER_VERSION).c_str(),
+             &content);
+  hash = fnv1a(hash, content.c_str(), content.size() + 1);
+  read_small(AT_FDCWD, gpu_sysfs_path(TOPOCACHE_GENERATION).c_str(),
+             &content);
+  hash = fnv1a(hash, content.c_str(), content.size() + 1);
+
+  *pPrint = hash;
+  return 0;
+}
+
+/**
+ * @brief Load topology snapshot from cache file
+ * @param File cache file
+ * @param Print expected topology fingerprint
+ * @param pNodes loaded nodes
+ * @return 0 if cache is valid and matches fingerprint, -1 otherwise
+ */
+int rvs::topocache::load(const std::string& File, uint64_t Print,
+                         std::vector<kfd_node>* pNodes) {
+  struct stat st;
+  if (File.empty()) {
+    return -1;
+  }
+  int fd = open(File.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return -1;
+  }
+  if (fstat(fd, &st) || st.st_size < static_cast<off_t>(sizeof(header))) {
+    close(fd);
+    return -1;
+  }
+  size_t size = st.st_size;
+  void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    return -1;
+  }
+
+  int sts = -1;
+  const char* data = static_cast<const char*>(map);
+  header hdr;
+  memcpy(&hdr, data, sizeof(hdr));
+  if (memcmp(hdr.magic, TOPOCACHE_MAGIC, sizeof(hdr.magic)) == 0 &&
+      hdr.version == RVS_TOPOLOGY_CACHE_VERSION && hdr.print == Print &&
+      hdr.size == size - sizeof(hdr) &&
+      parse(data + sizeof(hdr), data + size, hdr.nodes, pNodes)) {
+    sts = 0;
+  }
+  munmap(map, size);
+  if (sts) {
+    pNodes->clear();
+  }
+  return sts;
+}
+
+/**
+ * @brief Save topology snapshot into cache file
+ *
+ * File is written next to its final location and renamed so that
+ * concurrent readers never see partial content. Missing cache folder is
+ * created.
+ *
+ * @param File cache file
+ * @param Print topology fingerprint
+ * @param Nodes nodes to save
+ * @return 0 if successful, -1 otherwise
+ */
+int rvs::topocache::save(const std::string& File, uint64_t Print,
+                         const std::vector<kfd_node>& Nodes) {
+  if (File.empty()) {
+    return -1;
+  }
+
+  string out;
+  header hdr;
+  memset(&hdr, 0, sizeof(hdr));
+  memcpy(hdr.magic, TOPOCACHE_MAGIC, sizeof(hdr.magic));
+  hdr.version = RVS_TOPOLOGY_CACHE_VERSION;
+  hdr.nodes = Nodes.size();
+  hdr.print = Print;
+  out.append(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+
+  for (const kfd_node& node : Nodes) {
+    put(&out, node.node_id);
+    put(&out, node.gpu_id);
+    put(&out, node.location_id);
+    put(&out, node.device_id);
+    put(&out, node.vendor_id);
+    put(&out, node.numa_node);
+    put(&out, static_cast<uint32_t>(node.properties.size()));
+    put(&out, static_cast<uint32_t>(node.io_links.size()));
+    for (const auto& prop : node.properties) {
+      put(&out, static_cast<uint16_t>(prop.first.size()));
+      out.append(prop.first);
+      put(&out, prop.second);
+    }
+    for (const auto& link : node.io_links) {
+      put(&out, link.type);
+      put(&out, link.node_from);
+      put(&out, link.node_to);
+      put(&out, link.weight);
+    }
+  }
+  hdr.size = out.size() - sizeof(hdr);
+  memcpy(&out[0], &hdr, sizeof(hdr));
+
+  size_t slash = File.rfind('/');
+  if (slash != string::npos && slash > 0) {
+    mkdir(File.substr(0, slash).c_str(), 0755);
+  }
+  string tmp = File + ".tmp." + std::to_string(getpid());
+  int fd = open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    return -1;
+  }
+  ssize_t sz = write(fd, out.c_str(), out.size());
+  close(fd);
+  if (sz != static_cast<ssize_t>(out.size()) ||
+      rename(tmp.c_str(), File.c_str())) {
+    unlink(tmp.c_str());
+    return -1;
+  }
+  return 0;
+}
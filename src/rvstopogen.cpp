@@ -0,0 +1,278 @@
+/********************************************************************************
+ *
+ * Copyright (c) 2018 ROCm Developer Tools
+ *
+ * MIT LICENSE:
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "include/rvstopogen.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "include/gpu_util.h"
+
+using std::string;
+using std::to_string;
+
+//! GPUs per PCI domain (bus numbers 1..250)
+#define TOPOGEN_BUSES_PER_DOMAIN        250
+//! largest number of GPUs with unique 16-bit GPU ID
+#define TOPOGEN_MAX_GPUS                60000
+
+namespace {
+
+/**
+ * @brief Create directory and all missing parents
+ * @param Path directory path
+ * @return 0 if successful, -1 otherwise
+ */
+int make_dirs(const string& Path) {
+  for (size_t pos = 0; pos != string::npos; ) {
+    pos = Path.find('/', pos + 1);
+    string dir = Path.substr(0, pos);
+    if (mkdir(dir.c_str(), 0755) && errno != EEXIST) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief Write file content
+ * @param Path file path
+ * @param Content file content
+ * @return 0 if successful, -1 otherwise
+ */
+int write_file(const string& Path, const string& Content) {
+  int fd = open(Path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    return -1;
+  }
+  ssize_t sz = write(fd, Content.c_str(), Content.size());
+  close(fd);
+  return sz == static_cast<ssize_t>(Content.size()) ? 0 : -1;
+}
+
+}  // namespace
+
+//! Default constructor: single 8 GPU hive on 2 CPU nodes
+rvs::topogen::topogen()
+: gpus(8), cpus(2), hive_size(8), device_id(0x74a1), pcie_weight(20),
+  xgmi_weight(15), cpu_weight(21) {
+}
+
+/**
+ * @brief GPU ID of given GPU
+ * @param Gpu GPU index (0 based)
+ * @return unique non zero GPU ID
+ */
+uint16_t rvs::topogen::gpu_id(int Gpu) {
+  return 0x1000 + Gpu;
+}
+
+/**
+ * @brief PCI location ID (bus/device/function) of given GPU
+ * @param Gpu GPU index (0 based)
+ * @return location ID, unique within GPU's PCI domain
+ */
+uint16_t rvs::topogen::location_id(int Gpu) {
+  return (1 + Gpu % TOPOGEN_BUSES_PER_DOMAIN) << 8;
+}
+
+/**
+ * @brief PCI domain of given GPU
+ * @param Gpu GPU index (0 based)
+ * @return PCI domain
+ */
+uint32_t rvs::topogen::domain(int Gpu) {
+  return Gpu / TOPOGEN_BUSES_PER_DOMAIN;
+}
+
+int rvs::topogen::cpu_of(int Gpu) const {
+  return Gpu % cpus;
+}
+
+int rvs::topogen::hive_of(int Gpu) const {
+  return hive_size > 1 ? Gpu / hive_size : Gpu;
+}
+
+/**
+ * @brief Generate topology tree
+ *
+ * Tree is written to Root + KFD_SYS_PATH_NODES. Existing files are
+ * overwritten but extra nodes from earlier, larger trees are not removed.
+ *
+ * @param Root sysroot to generate topology in
+ * @return 0 if successful, -1 otherwise
+ */
+int rvs::topogen::generate(const std::string& Root) {
+  if (gpus < 0 || gpus > TOPOGEN_MAX_GPUS || cpus < 1) {
+    return -1;
+  }
+
+  string nodes = Root + KFD_SYS_PATH_NODES;
+  string topology = nodes.substr(0, nodes.rfind('/'));
+  if (make_dirs(nodes)) {
+    return -1;
+  }
+  if (write_file(topology + "/generation_id", "1\n") ||
+      write_file(topology + "/system_properties",
+                 "platform_oem 0\nplatform_id 0\nplatform_rev 0\n")) {
+    return -1;
+  }
+
+  for (int node = 0; node < cpus + gpus; node++) {
+    if (write_node(nodes + "/" + to_string(node), node)) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief Write single node with its io_links
+ * @param Path node folder
+ * @param Node node ID
+ * @return 0 if successful, -1 otherwise
+ */
+int rvs::topogen::write_node(const std::string& Path, int Node) {
+  bool gpu = Node >= cpus;
+  int g = Node - cpus;
+
+  if (make_dirs(Path + "/io_links")) {
+    return -1;
+  }
+  if (write_file(Path + "/name", gpu ? "gfx942\n" : "\n") ||
+      write_file(Path + "/gpu_id", gpu ? to_string(gpu_id(g)) + "\n" :
+                                         "0\n")) {
+    return -1;
+  }
+
+  int links = 0;
+  if (gpu) {
+    if (write_link(Path, links++, iolink_pcie, Node, cpu_of(g),
+                   pcie_weight)) {
+      return -1;
+    }
+    for (int peer = 0; peer < gpus; peer++) {
+      if (peer != g && hive_size > 1 && hive_of(peer) == hive_of(g) &&
+          write_link(Path, links++, iolink_xgmi, Node, cpus + peer,
+                     xgmi_weight)) {
+        return -1;
+      }
+    }
+  } else {
+    for (int peer = 0; peer < cpus; peer++) {
+      if (peer != Node &&
+          write_link(Path, links++, iolink_qpi, Node, peer, cpu_weight)) {
+        return -1;
+      }
+    }
+    for (int peer = 0; peer < gpus; peer++) {
+      if (cpu_of(peer) == Node &&
+          write_link(Path, links++, iolink_pcie, Node, cpus + peer,
+                     pcie_weight)) {
+        return -1;
+      }
+    }
+  }
+
+  string props;
+  props += "cpu_cores_count " + to_string(gpu ? 0 : 64) + "\n";
+  props += "simd_count " + to_string(gpu ? 1216 : 0) + "\n";
+  props += "mem_banks_count 1\n";
+  props += "caches_count " + to_string(gpu ? 498 : 0) + "\n";
+  props += "io_links_count " + to_string(links) + "\n";
+  props += "p2p_links_count 0\n";
+  props += "cpu_core_id_base " + to_string(gpu ? 0 : Node * 64) + "\n";
+  props += "simd_id_base " +
+           to_string(gpu ? 2147487744u + g * 1216 : 0) + "\n";
+  props += "max_waves_per_simd " + to_string(gpu ? 8 : 0) + "\n";
+  props += "lds_size_in_kb " + to_string(gpu ? 64 : 0) + "\n";
+  props += "gds_size_in_kb 0\n";
+  props += "num_gws " + to_string(gpu ? 64 : 0) + "\n";
+  props += "wave_front_size " + to_string(gpu ? 64 : 0) + "\n";
+  props += "array_count " + to_string(gpu ? 32 : 0) + "\n";
+  props += "simd_arrays_per_engine " + to_string(gpu ? 2 : 0) + "\n";
+  props += "cu_per_simd_array " + to_string(gpu ? 10 : 0) + "\n";
+  props += "simd_per_cu " + to_string(gpu ? 4 : 0) + "\n";
+  props += "max_slots_scratch_cu " + to_string(gpu ? 32 : 0) + "\n";
+  props += "gfx_target_version " + to_string(gpu ? 90402 : 0) + "\n";
+  props += "vendor_id " + to_string(gpu ? 0x1002 : 0) + "\n";
+  props += "device_id " + to_string(gpu ? device_id : 0) + "\n";
+  props += "location_id " + to_string(gpu ? location_id(g) : 0) + "\n";
+  props += "domain " + to_string(gpu ? domain(g) : 0) + "\n";
+  props += "drm_render_minor " + to_string(gpu ? 128 + g : 0) + "\n";
+  props += "hive_id " +
+           to_string(gpu && hive_size > 1 ? 0x1000000 + hive_of(g) : 0) +
+           "\n";
+  props += "num_sdma_engines " + to_string(gpu ? 2 : 0) + "\n";
+  props += "num_sdma_xgmi_engines " + to_string(gpu ? 14 : 0) + "\n";
+  props += "num_sdma_queues_per_engine " + to_string(gpu ? 8 : 0) + "\n";
+  props += "num_cp_queues " + to_string(gpu ? 64 : 0) + "\n";
+  props += "max_engine_clk_fcompute " + to_string(gpu ? 2100 : 0) + "\n";
+  props += "local_mem_size 0\n";
+  props += "fw_version " + to_string(gpu ? 177 : 0) + "\n";
+  props += "capability " + to_string(gpu ? 746720384 : 0) + "\n";
+  props += "debug_prop " + to_string(gpu ? 1495 : 0) + "\n";
+  props += "sdma_fw_version " + to_string(gpu ? 19 : 0) + "\n";
+  props += "unique_id " + to_string(gpu ? 0x100000000ull + g : 0) + "\n";
+  props += "num_xcc " + to_string(gpu ? 8 : 0) + "\n";
+  props += "max_engine_clk_ccompute 3700\n";
+  return write_file(Path + "/properties", props);
+}
+
+/**
+ * @brief Write single io_link
+ * @param Path node folder
+ * @param Link link index within node
+ * @param Type link type
+ * @param From source node ID
+ * @param To destination node ID
+ * @param Weight link weight
+ * @return 0 if successful, -1 otherwise
+ */
+int rvs::topogen::write_link(const std::string& Path, int Link, int Type,
+                             int From, int To, int Weight) {
+  string link = Path + "/io_links/" + to_string(Link);
+  if (mkdir(link.c_str(), 0755) && errno != EEXIST) {
+    return -1;
+  }
+  string props;
+  props += "type " + to_string(Type) + "\n";
+  props += "version_major 0\nversion_minor 0\n";
+  props += "node_from " + to_string(From) + "\n";
+  props += "node_to " + to_string(To) + "\n";
+  props += "weight " + to_string(Weight) + "\n";
+  props += "min_latency 0\nmax_latency 0\n";
+  props += "min_bandwidth " + to_string(Type == iolink_xgmi ? 50000 : 312) +
+           "\n";
+  props += "max_bandwidth " + to_string(Type == iolink_xgmi ? 50000 : 64000) +
+           "\n";
+  props += "recommended_transfer_size 0\n";
+  props += "recommended_sdma_engine_id_mask 0\n";
+  props += "flags 3\n";
+  return write_file(link + "/properties", props);
+}